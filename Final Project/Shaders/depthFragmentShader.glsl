@@ -0,0 +1,11 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthFragmentShader.glsl
+// ============
+// write only the depth of the fragments in the depth pre-pass
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+void main()
+{
+}
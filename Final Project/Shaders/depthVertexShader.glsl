@@ -0,0 +1,35 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthVertexShader.glsl
+// ============
+// transform the mesh vertices for the depth pre-pass
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+layout (location = 0) in vec3 inVertexPosition;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+// the camera is read like in the scene vertex shader
+uniform bool bUseCameraBlock = false;
+layout (std140) uniform CameraBlock
+{
+	mat4 cameraView;
+	mat4 cameraProjection;
+	vec4 cameraPosition;
+};
+
+// the position is computed exactly like in the scene vertex shader,
+// so the depth of the main pass is as close as the driver allows to
+// the depth written here
+invariant gl_Position;
+
+void main()
+{
+	mat4 viewMatrix = bUseCameraBlock ? cameraView : view;
+	mat4 projectionMatrix = bUseCameraBlock ? cameraProjection : projection;
+
+	gl_Position = projectionMatrix * viewMatrix * model * vec4(inVertexPosition, 1.0f);
+}
@@ -0,0 +1,332 @@
+///////////////////////////////////////////////////////////////////////////////
+// fragmentShader.glsl
+// ============
+// color, texture and light the fragments of the 3D scene
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+// the clustered lights are read from shader storage buffers, which
+// are optional, so the uniform lights are used when they are missing
+#extension GL_ARB_shader_storage_buffer_object : enable
+
+struct Material
+{
+	vec3 ambientColor;
+	float ambientStrength;
+	vec3 diffuseColor;
+	vec3 specularColor;
+	float shininess;
+};
+
+struct LightSource
+{
+	vec3 position;
+	// distance where the light fades out, or 0 to reach everywhere
+	float radius;
+	vec3 ambientColor;
+	vec3 diffuseColor;
+	vec3 specularColor;
+	float focalStrength;
+	float specularIntensity;
+	// shadow map of the light, or -1 when it casts no shadows
+	int shadowIndex;
+};
+
+#define TOTAL_LIGHTS 4
+
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+in vec2 fragmentTextureCoordinate;
+in float fragmentViewDepth;
+
+out vec4 outFragmentColor;
+
+uniform bool bUseTexture = false;
+uniform bool bUseLighting = false;
+uniform vec4 objectColor = vec4(1.0f);
+uniform sampler2D objectTexture;
+uniform vec3 viewPosition;
+// the camera block replaces the view position when it is used
+uniform bool bUseCameraBlock = false;
+layout (std140) uniform CameraBlock
+{
+	mat4 cameraView;
+	mat4 cameraProjection;
+	vec4 cameraPosition;
+};
+// the UV offset selects the tile of a texture packed into an atlas
+uniform vec2 UVscale = vec2(1.0f, 1.0f);
+uniform vec2 UVoffset = vec2(0.0f, 0.0f);
+uniform Material material;
+uniform LightSource lightSources[TOTAL_LIGHTS];
+
+// with clustered lighting, the view frustum is split into a grid of
+// clusters, and only the lights listed for the cluster of the
+// fragment are evaluated, so the scene can hold many lights
+uniform bool bUseClusteredLighting = false;
+uniform vec3 clusterGridSize;
+uniform vec2 clusterScreenScale;
+uniform float clusterDepthScale;
+uniform float clusterDepthBias;
+#ifdef GL_ARB_shader_storage_buffer_object
+struct ClusterLight
+{
+	vec4 positionRadius;
+	// the w components hold the focal strength and specular intensity
+	vec4 ambientColor;
+	vec4 diffuseColor;
+	// the w component holds the shadow map index
+	vec4 specularColor;
+};
+layout (std430) buffer LightBuffer
+{
+	ClusterLight clusterLights[];
+};
+// offset and count of the light indices of every cluster
+layout (std430) buffer ClusterBuffer
+{
+	uvec2 clusterRanges[];
+};
+layout (std430) buffer LightIndexBuffer
+{
+	uint clusterLightIndices[];
+};
+#endif
+
+// shadow casting lights compare the depth of the fragment with the
+// depth seen from the light in the face of their cube map
+uniform bool bShadowPass = false;
+uniform bool bUseShadows = false;
+uniform samplerCubeShadow shadowMap0;
+uniform samplerCubeShadow shadowMap1;
+uniform float shadowNearPlane = 0.1f;
+uniform float shadowFarPlane = 100.0f;
+
+// virtual textures are sampled from the shared page cache through
+// a page table that holds the cache page and mip level of every
+// virtual page, falling back to the nearest coarser resident page
+uniform bool bUseVirtualTexture = false;
+// the feedback pass outputs the virtual pages instead of colors
+uniform bool bVirtualFeedback = false;
+uniform usampler2D vtPageTable;
+uniform sampler2D vtPageCache;
+uniform vec2 vtVirtualSize;
+uniform int vtMipCount;
+uniform int vtIndex;
+uniform float vtPageSize;
+uniform float vtPageBorder;
+uniform vec2 vtCacheSize;
+uniform float vtLodBias = 0.0f;
+
+vec3 CalcLightSource(LightSource light, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection);
+vec3 CalcClusteredLights(vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection);
+float CalcShadowVisibility(LightSource light, vec3 lightNormal, vec3 vertexPosition);
+vec4 SampleObjectTexture(vec2 textureCoordinate);
+int CalcVirtualMip(vec2 textureCoordinate);
+vec4 SampleVirtualTexture(vec2 textureCoordinate);
+vec4 CalcVirtualFeedback(vec2 textureCoordinate);
+
+void main()
+{
+	// the shadow pass only writes the depth
+	if (bShadowPass == true)
+	{
+		return;
+	}
+
+	vec2 textureCoordinate = fragmentTextureCoordinate * UVscale + UVoffset;
+
+	if (bVirtualFeedback == true)
+	{
+		outFragmentColor = CalcVirtualFeedback(textureCoordinate);
+		return;
+	}
+
+	if (bUseLighting == true)
+	{
+		vec3 lightNormal = normalize(fragmentVertexNormal);
+		vec3 eyePosition = bUseCameraBlock ? cameraPosition.xyz : viewPosition;
+		vec3 viewDirection = normalize(eyePosition - fragmentPosition);
+		vec3 phongResult = vec3(0.0f);
+
+		if (bUseClusteredLighting == true)
+		{
+			phongResult = CalcClusteredLights(lightNormal, fragmentPosition, viewDirection);
+		}
+		else
+		{
+			// accumulate the contribution of every light source
+			for (int i = 0; i < TOTAL_LIGHTS; i++)
+			{
+				phongResult += CalcLightSource(lightSources[i], lightNormal, fragmentPosition, viewDirection);
+			}
+		}
+
+		if (bUseTexture == true)
+		{
+			vec4 textureColor = SampleObjectTexture(textureCoordinate);
+			outFragmentColor = vec4(phongResult * textureColor.xyz, textureColor.w);
+		}
+		else
+		{
+			outFragmentColor = vec4(phongResult * objectColor.xyz, objectColor.w);
+		}
+	}
+	else
+	{
+		if (bUseTexture == true)
+		{
+			outFragmentColor = SampleObjectTexture(textureCoordinate);
+		}
+		else
+		{
+			outFragmentColor = objectColor;
+		}
+	}
+}
+
+// calculate the Phong lighting contribution of one light source
+vec3 CalcLightSource(LightSource light, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection)
+{
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+
+	// a light with a radius fades out smoothly before reaching it
+	float attenuation = 1.0f;
+	if (light.radius > 0.0f)
+	{
+		float lightDistance = length(light.position - vertexPosition);
+		float ratio = lightDistance / light.radius;
+		float window = clamp(1.0f - ratio * ratio * ratio * ratio, 0.0f, 1.0f);
+		attenuation = window * window / (1.0f + lightDistance * lightDistance);
+	}
+
+	// ambient lighting
+	ambient = light.ambientColor * material.ambientColor * material.ambientStrength;
+
+	// diffuse lighting
+	vec3 lightDirection = normalize(light.position - vertexPosition);
+	float impact = max(dot(lightNormal, lightDirection), 0.0f);
+	diffuse = impact * light.diffuseColor * material.diffuseColor;
+
+	// specular lighting
+	vec3 reflectDirection = reflect(-lightDirection, lightNormal);
+	float specularComponent = pow(max(dot(viewDirection, reflectDirection), 0.0f), light.focalStrength);
+	specular = light.specularIntensity * specularComponent * light.specularColor * material.specularColor;
+
+	// shadows only block the direct light
+	float visibility = CalcShadowVisibility(light, lightNormal, vertexPosition);
+
+	return((ambient + (diffuse + specular) * visibility) * attenuation);
+}
+
+// calculate the lighting of the lights listed for the cluster of the fragment
+vec3 CalcClusteredLights(vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection)
+{
+	vec3 result = vec3(0.0f);
+
+#ifdef GL_ARB_shader_storage_buffer_object
+	// the depth slices grow exponentially with the distance
+	vec2 tile = clamp(floor(gl_FragCoord.xy * clusterScreenScale), vec2(0.0f), clusterGridSize.xy - 1.0f);
+	float slice = clamp(floor(log(max(fragmentViewDepth, 0.0001f)) * clusterDepthScale - clusterDepthBias), 0.0f, clusterGridSize.z - 1.0f);
+	uint cluster = uint(tile.x + clusterGridSize.x * (tile.y + clusterGridSize.y * slice));
+	uvec2 range = clusterRanges[cluster];
+
+	for (uint i = 0u; i < range.y; i++)
+	{
+		ClusterLight clusterLight = clusterLights[clusterLightIndices[range.x + i]];
+		LightSource light;
+		light.position = clusterLight.positionRadius.xyz;
+		light.radius = clusterLight.positionRadius.w;
+		light.ambientColor = clusterLight.ambientColor.xyz;
+		light.diffuseColor = clusterLight.diffuseColor.xyz;
+		light.specularColor = clusterLight.specularColor.xyz;
+		light.focalStrength = clusterLight.ambientColor.w;
+		light.specularIntensity = clusterLight.diffuseColor.w;
+		light.shadowIndex = int(clusterLight.specularColor.w);
+		result += CalcLightSource(light, lightNormal, vertexPosition, viewDirection);
+	}
+#endif
+
+	return(result);
+}
+
+// calculate how much of the light reaches the fragment past the shadow casters
+float CalcShadowVisibility(LightSource light, vec3 lightNormal, vec3 vertexPosition)
+{
+	if ((bUseShadows == false) || (light.shadowIndex < 0))
+	{
+		return(1.0f);
+	}
+
+	// the depth in a cube face comes from the distance along its
+	// major axis, pushed toward the light more on grazing surfaces
+	vec3 lightToFragment = vertexPosition - light.position;
+	vec3 axisDistance = abs(lightToFragment);
+	float bias = mix(0.15f, 0.02f, max(dot(lightNormal, normalize(-lightToFragment)), 0.0f));
+	float faceDistance = max(max(axisDistance.x, axisDistance.y), axisDistance.z) - bias;
+	float depthRange = shadowFarPlane - shadowNearPlane;
+	float depth = (shadowFarPlane + shadowNearPlane) / depthRange - (2.0f * shadowFarPlane * shadowNearPlane) / (depthRange * faceDistance);
+	depth = depth * 0.5f + 0.5f;
+
+	// sampler arrays cannot be indexed dynamically in GLSL 3.30
+	if (light.shadowIndex == 0)
+	{
+		return(texture(shadowMap0, vec4(lightToFragment, depth)));
+	}
+
+	return(texture(shadowMap1, vec4(lightToFragment, depth)));
+}
+
+// sample the texture of the object from a regular or a virtual texture
+vec4 SampleObjectTexture(vec2 textureCoordinate)
+{
+	if (bUseVirtualTexture == true)
+	{
+		return(SampleVirtualTexture(textureCoordinate));
+	}
+
+	return(texture(objectTexture, textureCoordinate));
+}
+
+// calculate the virtual mip level from the texel footprint of the fragment
+int CalcVirtualMip(vec2 textureCoordinate)
+{
+	vec2 dx = dFdx(textureCoordinate * vtVirtualSize);
+	vec2 dy = dFdy(textureCoordinate * vtVirtualSize);
+	float lod = 0.5f * log2(max(dot(dx, dx), dot(dy, dy))) + vtLodBias;
+
+	return(int(clamp(floor(lod), 0.0f, float(vtMipCount - 1))));
+}
+
+// sample a virtual texture from the page that the page table points to
+vec4 SampleVirtualTexture(vec2 textureCoordinate)
+{
+	int mip = CalcVirtualMip(textureCoordinate);
+	vec2 wrappedCoordinate = fract(textureCoordinate);
+	ivec2 pageCount = textureSize(vtPageTable, mip);
+	uvec4 entry = texelFetch(vtPageTable, ivec2(wrappedCoordinate * vec2(pageCount)), mip);
+
+	// the resident page may come from a coarser mip level
+	vec2 residentPages = vtVirtualSize / (vtPageSize * exp2(float(entry.z)));
+	vec2 pageCoordinate = fract(wrappedCoordinate * residentPages);
+	vec2 cacheTexel = vec2(entry.xy) * (vtPageSize + 2.0f * vtPageBorder) + vtPageBorder + pageCoordinate * vtPageSize;
+
+	return(textureLod(vtPageCache, cacheTexel / vtCacheSize, 0.0f));
+}
+
+// output the virtual page and mip level that the fragment needs
+vec4 CalcVirtualFeedback(vec2 textureCoordinate)
+{
+	if ((bUseTexture == false) || (bUseVirtualTexture == false))
+	{
+		return(vec4(0.0f));
+	}
+
+	int mip = CalcVirtualMip(textureCoordinate);
+	ivec2 pageCount = textureSize(vtPageTable, mip);
+	ivec2 page = ivec2(fract(textureCoordinate) * vec2(pageCount));
+
+	return(vec4(float(page.x), float(page.y), float(mip), float(vtIndex + 1)) / 255.0f);
+}
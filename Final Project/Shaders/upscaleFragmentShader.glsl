@@ -0,0 +1,40 @@
+///////////////////////////////////////////////////////////////////////////////
+// upscaleFragmentShader.glsl
+// ============
+// upscale the frame to the window and sharpen it
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+in vec2 fragmentTextureCoordinate;
+
+out vec4 fragmentColor;
+
+uniform sampler2D sourceTexture;
+uniform vec2 sourceScale;
+uniform vec2 sourceTexelSize;
+uniform float sharpness = 0.5;
+
+void main()
+{
+	// keep the taps inside the part that the scene was rendered into,
+	// so the unused part of the texture does not bleed into the edges
+	vec2 minCoordinate = sourceTexelSize * 0.5;
+	vec2 maxCoordinate = sourceScale - sourceTexelSize * 0.5;
+	vec2 uv = clamp(fragmentTextureCoordinate, minCoordinate, maxCoordinate);
+
+	vec3 center = texture(sourceTexture, uv).rgb;
+	vec3 left = texture(sourceTexture, clamp(uv - vec2(sourceTexelSize.x, 0.0), minCoordinate, maxCoordinate)).rgb;
+	vec3 right = texture(sourceTexture, clamp(uv + vec2(sourceTexelSize.x, 0.0), minCoordinate, maxCoordinate)).rgb;
+	vec3 down = texture(sourceTexture, clamp(uv - vec2(0.0, sourceTexelSize.y), minCoordinate, maxCoordinate)).rgb;
+	vec3 up = texture(sourceTexture, clamp(uv + vec2(0.0, sourceTexelSize.y), minCoordinate, maxCoordinate)).rgb;
+
+	// subtract the blur of the neighbors to bring back the edges that
+	// the bilinear filter softened, limited to the range of the taps
+	// so the sharpening does not ring around strong edges
+	vec3 sharpened = center + (4.0 * center - (left + right + down + up)) * sharpness * 0.25;
+	vec3 minColor = min(center, min(min(left, right), min(down, up)));
+	vec3 maxColor = max(center, max(max(left, right), max(down, up)));
+
+	fragmentColor = vec4(clamp(sharpened, minColor, maxColor), 1.0);
+}
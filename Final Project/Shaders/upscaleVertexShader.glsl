@@ -0,0 +1,20 @@
+///////////////////////////////////////////////////////////////////////////////
+// upscaleVertexShader.glsl
+// ============
+// cover the window with one triangle for the upscale of the frame
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+// part of the source texture that the scene was rendered into
+uniform vec2 sourceScale;
+
+out vec2 fragmentTextureCoordinate;
+
+void main()
+{
+	// the triangle is made from the vertex index, without vertex data
+	vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	fragmentTextureCoordinate = corner * sourceScale;
+	gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,61 @@
+///////////////////////////////////////////////////////////////////////////////
+// vertexShader.glsl
+// ============
+// transform the mesh vertices for the 3D scene
+///////////////////////////////////////////////////////////////////////////////
+
+#version 330 core
+
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+// distance in front of the camera, which selects the light cluster
+out float fragmentViewDepth;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+// the camera is read from a uniform block that is written right
+// before the draws of the frame, when the buffer is supported
+uniform bool bUseCameraBlock = false;
+layout (std140) uniform CameraBlock
+{
+	mat4 cameraView;
+	mat4 cameraProjection;
+	vec4 cameraPosition;
+};
+
+// the shadow pass draws the scene from a face of a light's cube map
+uniform bool bShadowPass = false;
+uniform mat4 shadowViewProjection;
+
+// the depth pre-pass computes the position the same way, and the
+// main pass only shades the fragments that are not behind its depth
+invariant gl_Position;
+
+void main()
+{
+	mat4 viewMatrix = bUseCameraBlock ? cameraView : view;
+	mat4 projectionMatrix = bUseCameraBlock ? cameraProjection : projection;
+
+	// transform the vertex into clip space
+	if (bShadowPass == true)
+	{
+		gl_Position = shadowViewProjection * model * vec4(inVertexPosition, 1.0f);
+	}
+	else
+	{
+		gl_Position = projectionMatrix * viewMatrix * model * vec4(inVertexPosition, 1.0f);
+	}
+
+	// pass the world space position and normal to the lighting
+	fragmentPosition = vec3(model * vec4(inVertexPosition, 1.0f));
+	fragmentVertexNormal = mat3(transpose(inverse(model))) * inVertexNormal;
+	fragmentTextureCoordinate = inTextureCoordinate;
+	fragmentViewDepth = -(viewMatrix * model * vec4(inVertexPosition, 1.0f)).z;
+}
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+// vulkanFragmentShader.glsl
+// ============
+// color, texture and light the fragments for the Vulkan backend
+//
+// compiled into SPIR-V next to this file with
+//   glslc -fshader-stage=frag vulkanFragmentShader.glsl -o vulkanFragmentShader.spv
+///////////////////////////////////////////////////////////////////////////////
+
+#version 450
+
+#define TOTAL_LIGHTS 4
+
+struct LightSource
+{
+	vec4 positionRadius;
+	// the w components hold the focal strength and specular intensity
+	vec4 ambientColor;
+	vec4 diffuseColor;
+	vec4 specularColor;
+};
+
+layout (location = 0) in vec3 fragmentPosition;
+layout (location = 1) in vec3 fragmentVertexNormal;
+layout (location = 2) in vec2 fragmentTextureCoordinate;
+
+layout (location = 0) out vec4 outFragmentColor;
+
+// the camera and the lights are shared by all of the draws
+layout (std140, set = 0, binding = 0) uniform FrameBlock
+{
+	vec4 viewPosition;
+	LightSource lightSources[TOTAL_LIGHTS];
+} frame;
+
+// the ambient strength and the shininess are in the w components
+// of the material colors, and the options tell whether the draw
+// uses its texture and the lighting
+layout (std140, set = 0, binding = 1) uniform DrawBlock
+{
+	mat4 model;
+	mat4 viewProjection;
+	vec4 objectColor;
+	vec4 uvTransform;
+	vec4 ambientColor;
+	vec4 diffuseColor;
+	vec4 specularColor;
+	ivec4 options;
+} draw;
+
+layout (set = 1, binding = 0) uniform sampler2D objectTexture;
+
+vec3 CalcLightSource(LightSource light, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection);
+
+void main()
+{
+	vec4 baseColor = draw.objectColor;
+	if (draw.options.x != 0)
+	{
+		baseColor = texture(objectTexture, fragmentTextureCoordinate * draw.uvTransform.xy + draw.uvTransform.zw);
+	}
+
+	if (draw.options.y == 0)
+	{
+		outFragmentColor = baseColor;
+		return;
+	}
+
+	vec3 lightNormal = normalize(fragmentVertexNormal);
+	vec3 viewDirection = normalize(frame.viewPosition.xyz - fragmentPosition);
+	vec3 phongResult = vec3(0.0f);
+
+	// accumulate the contribution of every light source
+	for (int i = 0; i < TOTAL_LIGHTS; i++)
+	{
+		phongResult += CalcLightSource(frame.lightSources[i], lightNormal, fragmentPosition, viewDirection);
+	}
+
+	outFragmentColor = vec4(phongResult * baseColor.xyz, baseColor.w);
+}
+
+// calculate the Phong lighting contribution of one light source
+vec3 CalcLightSource(LightSource light, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection)
+{
+	vec3 lightPosition = light.positionRadius.xyz;
+	float radius = light.positionRadius.w;
+
+	// a light with a radius fades out smoothly before reaching it
+	float attenuation = 1.0f;
+	if (radius > 0.0f)
+	{
+		float lightDistance = length(lightPosition - vertexPosition);
+		float ratio = lightDistance / radius;
+		float window = clamp(1.0f - ratio * ratio * ratio * ratio, 0.0f, 1.0f);
+		attenuation = window * window / (1.0f + lightDistance * lightDistance);
+	}
+
+	// ambient lighting
+	vec3 ambient = light.ambientColor.xyz * draw.ambientColor.xyz * draw.ambientColor.w;
+
+	// diffuse lighting
+	vec3 lightDirection = normalize(lightPosition - vertexPosition);
+	float impact = max(dot(lightNormal, lightDirection), 0.0f);
+	vec3 diffuse = impact * light.diffuseColor.xyz * draw.diffuseColor.xyz;
+
+	// specular lighting
+	vec3 reflectDirection = reflect(-lightDirection, lightNormal);
+	float specularComponent = pow(max(dot(viewDirection, reflectDirection), 0.0f), light.ambientColor.w);
+	vec3 specular = light.diffuseColor.w * specularComponent * light.specularColor.xyz * draw.specularColor.xyz;
+
+	return((ambient + diffuse + specular) * attenuation);
+}
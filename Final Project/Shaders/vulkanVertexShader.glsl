@@ -0,0 +1,47 @@
+///////////////////////////////////////////////////////////////////////////////
+// vulkanVertexShader.glsl
+// ============
+// transform the mesh vertices for the Vulkan backend
+//
+// compiled into SPIR-V next to this file with
+//   glslc -fshader-stage=vert vulkanVertexShader.glsl -o vulkanVertexShader.spv
+///////////////////////////////////////////////////////////////////////////////
+
+#version 450
+
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+
+layout (location = 0) out vec3 fragmentPosition;
+layout (location = 1) out vec3 fragmentVertexNormal;
+layout (location = 2) out vec2 fragmentTextureCoordinate;
+
+// the uniforms of every draw are packed into one block, which is
+// selected with a dynamic offset into the buffer of the frame
+layout (std140, set = 0, binding = 1) uniform DrawBlock
+{
+	mat4 model;
+	mat4 viewProjection;
+	vec4 objectColor;
+	vec4 uvTransform;
+	vec4 ambientColor;
+	vec4 diffuseColor;
+	vec4 specularColor;
+	ivec4 options;
+} draw;
+
+void main()
+{
+	vec4 worldPosition = draw.model * vec4(inVertexPosition, 1.0f);
+
+	// the projection maps the depth from -1 to 1 like OpenGL, and
+	// Vulkan clips it from 0 to 1
+	gl_Position = draw.viewProjection * worldPosition;
+	gl_Position.z = (gl_Position.z + gl_Position.w) * 0.5f;
+
+	// pass the world space position and normal to the lighting
+	fragmentPosition = worldPosition.xyz;
+	fragmentVertexNormal = mat3(transpose(inverse(draw.model))) * inVertexNormal;
+	fragmentTextureCoordinate = inTextureCoordinate;
+}
@@ -0,0 +1,387 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationtracker.cpp
+// ============
+// count the heap allocations of every frame and the phases that make them
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AllocationTracker.h"
+
+#include <iostream>
+#include <fstream>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// allocations of the steady state counted for a phase
+	struct PHASE_STATS
+	{
+		const char* name;
+		uint64_t allocations;
+		uint64_t bytes;
+	};
+
+	// the phases are kept in a fixed table, since the counting
+	// cannot allocate, and the last entry takes the phases that
+	// do not fit
+	const int g_MaxPhases = 64;
+	PHASE_STATS g_Phases[g_MaxPhases] = {};
+	int g_PhaseCount = 0;
+	std::atomic_flag g_PhaseLock = ATOMIC_FLAG_INIT;
+
+	// the allocations outside of the profiled scopes, and of
+	// the threads that have none
+	const char* g_NoPhaseName = "(no scope)";
+	const char* g_OtherPhaseName = "(other scopes)";
+
+	// innermost profiled scope of every thread
+	thread_local const char* g_pCurrentPhase = NULL;
+
+	std::atomic<bool> g_bEnabled(false);
+	std::atomic<bool> g_bSteadyState(false);
+	int g_WarmupFrames = 0;
+
+	// counters of the frame that is being rendered
+	std::atomic<uint64_t> g_FrameAllocations(0);
+	std::atomic<uint64_t> g_FrameBytes(0);
+
+	// totals of the finished frames
+	bool g_bFrameStarted = false;
+	uint64_t g_FrameCount = 0;
+	uint64_t g_StartupAllocations = 0;
+	uint64_t g_WarmupAllocations = 0;
+	uint64_t g_SteadyFrames = 0;
+	uint64_t g_AllocatingFrames = 0;
+	uint64_t g_SteadyAllocations = 0;
+	uint64_t g_SteadyBytes = 0;
+	uint64_t g_PeakFrameAllocations = 0;
+
+	/***********************************************************
+	 *  FindPhase()
+	 *
+	 *  Find the counters of a phase, adding them to the table
+	 *  when the phase has not allocated before.  The names are
+	 *  compared as strings, since the same scope name can be at
+	 *  different addresses in different source files.
+	 ***********************************************************/
+	PHASE_STATS& FindPhase(const char* name)
+	{
+		if (NULL == name)
+		{
+			name = g_NoPhaseName;
+		}
+
+		for (int i = 0; i < g_PhaseCount; i++)
+		{
+			if ((g_Phases[i].name == name) || (strcmp(g_Phases[i].name, name) == 0))
+			{
+				return(g_Phases[i]);
+			}
+		}
+
+		if (g_PhaseCount == g_MaxPhases - 1)
+		{
+			name = g_OtherPhaseName;
+		}
+		if (g_PhaseCount < g_MaxPhases)
+		{
+			g_Phases[g_PhaseCount].name = name;
+			g_PhaseCount++;
+		}
+
+		return(g_Phases[g_PhaseCount - 1]);
+	}
+}
+
+/***********************************************************
+ *  Enable()
+ *
+ *  This method is used to start counting the allocations.
+ *  The frames up to the given number load their data and
+ *  grow their buffers, and the frames after them are the
+ *  steady state that should not allocate.
+ ***********************************************************/
+void AllocationTracker::Enable(int warmupFrames)
+{
+	g_WarmupFrames = (warmupFrames > 0) ? warmupFrames : 0;
+	g_bEnabled = true;
+}
+
+/***********************************************************
+ *  IsEnabled()
+ *
+ *  This method is used to check whether the allocations are
+ *  being counted.
+ ***********************************************************/
+bool AllocationTracker::IsEnabled()
+{
+	return(g_bEnabled.load(std::memory_order_relaxed));
+}
+
+/***********************************************************
+ *  EnterPhase()
+ *
+ *  This method is used to attribute the next allocations of
+ *  the calling thread to a phase, like a profiled scope.  The
+ *  phase that was replaced is returned so that it is restored
+ *  when the scope ends.
+ ***********************************************************/
+const char* AllocationTracker::EnterPhase(const char* name)
+{
+	const char* previousName = g_pCurrentPhase;
+	g_pCurrentPhase = name;
+
+	return(previousName);
+}
+
+/***********************************************************
+ *  LeavePhase()
+ *
+ *  This method is used to restore the phase that the
+ *  calling thread was in before the last phase was entered.
+ ***********************************************************/
+void AllocationTracker::LeavePhase(const char* previousName)
+{
+	g_pCurrentPhase = previousName;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used to finish the counters of the frame
+ *  that was rendered and to start counting a new frame.  The
+ *  allocations made before the first frame are counted as
+ *  the startup of the application.
+ ***********************************************************/
+void AllocationTracker::BeginFrame()
+{
+	if (IsEnabled() == false)
+	{
+		return;
+	}
+
+	uint64_t allocations = g_FrameAllocations.exchange(0);
+	uint64_t bytes = g_FrameBytes.exchange(0);
+	if (g_bFrameStarted == false)
+	{
+		g_StartupAllocations += allocations;
+	}
+	else if (g_bSteadyState == false)
+	{
+		g_WarmupAllocations += allocations;
+		g_FrameCount++;
+	}
+	else
+	{
+		g_SteadyFrames++;
+		g_SteadyAllocations += allocations;
+		g_SteadyBytes += bytes;
+		if (allocations > 0)
+		{
+			g_AllocatingFrames++;
+		}
+		if (allocations > g_PeakFrameAllocations)
+		{
+			g_PeakFrameAllocations = allocations;
+		}
+		g_FrameCount++;
+	}
+	g_bFrameStarted = true;
+
+	g_bSteadyState = (g_FrameCount >= (uint64_t)g_WarmupFrames);
+}
+
+/***********************************************************
+ *  Finish()
+ *
+ *  This method is used to finish the counters of the last
+ *  frame and to stop counting, so that the allocations of
+ *  the reports written afterwards are not counted with it.
+ ***********************************************************/
+void AllocationTracker::Finish()
+{
+	BeginFrame();
+	g_bEnabled = false;
+}
+
+/***********************************************************
+ *  RecordAllocation()
+ *
+ *  This method is used to count an allocation with the
+ *  current frame, and with the phase of the calling thread
+ *  when the frames are in the steady state.  It is called
+ *  from the replaced operator new, so it cannot allocate.
+ ***********************************************************/
+void AllocationTracker::RecordAllocation(size_t size)
+{
+	if (IsEnabled() == false)
+	{
+		return;
+	}
+
+	g_FrameAllocations.fetch_add(1, std::memory_order_relaxed);
+	g_FrameBytes.fetch_add(size, std::memory_order_relaxed);
+
+	if (g_bSteadyState.load(std::memory_order_relaxed) == true)
+	{
+		while (g_PhaseLock.test_and_set(std::memory_order_acquire) == true)
+		{
+		}
+		PHASE_STATS& phase = FindPhase(g_pCurrentPhase);
+		phase.allocations++;
+		phase.bytes += size;
+		g_PhaseLock.clear(std::memory_order_release);
+	}
+}
+
+/***********************************************************
+ *  GetAllocatingFrameCount()
+ *
+ *  This method is used to get the number of frames in the
+ *  steady state that made any heap allocations.
+ ***********************************************************/
+uint64_t AllocationTracker::GetAllocatingFrameCount()
+{
+	return(g_AllocatingFrames);
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the allocations of the
+ *  startup, the warmup and the steady state frames, and the
+ *  phases that allocated in the steady state.
+ ***********************************************************/
+void AllocationTracker::WriteReport(std::ostream& stream)
+{
+	stream << "# heap allocations per frame" << std::endl;
+	stream << "startup_allocations: " << g_StartupAllocations << std::endl;
+	stream << "warmup_frames: " << (g_FrameCount - g_SteadyFrames) << std::endl;
+	stream << "warmup_allocations: " << g_WarmupAllocations << std::endl;
+	stream << "steady_frames: " << g_SteadyFrames << std::endl;
+	stream << "allocating_steady_frames: " << g_AllocatingFrames << std::endl;
+	stream << "steady_allocations: " << g_SteadyAllocations << std::endl;
+	stream << "steady_bytes: " << g_SteadyBytes << std::endl;
+	stream << "peak_frame_allocations: " << g_PeakFrameAllocations << std::endl;
+
+	// the table is copied first, since writing can allocate
+	PHASE_STATS phases[g_MaxPhases];
+	while (g_PhaseLock.test_and_set(std::memory_order_acquire) == true)
+	{
+	}
+	int phaseCount = g_PhaseCount;
+	memcpy(phases, g_Phases, sizeof(PHASE_STATS) * phaseCount);
+	g_PhaseLock.clear(std::memory_order_release);
+
+	stream << "# steady state allocations by phase: allocations bytes" << std::endl;
+	for (int i = 0; i < phaseCount; i++)
+	{
+		stream << phases[i].name << ": " << phases[i].allocations << " " << phases[i].bytes << std::endl;
+	}
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the report into a file.
+ ***********************************************************/
+bool AllocationTracker::WriteReport(const char* filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create allocation report file:" << filename << std::endl;
+		return(false);
+	}
+
+	WriteReport(file);
+	if (!file)
+	{
+		std::cout << "Could not write allocation report file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote allocation report file:" << filename << std::endl;
+
+	return(true);
+}
+
+// the global allocation functions are replaced to count every
+// allocation that the standard containers, the strings and the
+// new expressions of the application make, and the others call
+// these ones, so that the memory is always freed with free()
+
+/***********************************************************
+ *  operator new()
+ *
+ *  Count the allocation and take the memory from malloc().
+ ***********************************************************/
+void* operator new(size_t size)
+{
+	AllocationTracker::RecordAllocation(size);
+
+	void* pMemory = malloc((size > 0) ? size : 1);
+	if (NULL == pMemory)
+	{
+		throw std::bad_alloc();
+	}
+
+	return(pMemory);
+}
+
+void* operator new[](size_t size)
+{
+	return(operator new(size));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	AllocationTracker::RecordAllocation(size);
+
+	return(malloc((size > 0) ? size : 1));
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+	return(operator new(size, tag));
+}
+
+/***********************************************************
+ *  operator delete()
+ *
+ *  Give the memory of an allocation back to free().
+ ***********************************************************/
+void operator delete(void* pMemory) noexcept
+{
+	free(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept
+{
+	free(pMemory);
+}
+
+void operator delete(void* pMemory, size_t) noexcept
+{
+	free(pMemory);
+}
+
+void operator delete[](void* pMemory, size_t) noexcept
+{
+	free(pMemory);
+}
+
+void operator delete(void* pMemory, const std::nothrow_t&) noexcept
+{
+	free(pMemory);
+}
+
+void operator delete[](void* pMemory, const std::nothrow_t&) noexcept
+{
+	free(pMemory);
+}
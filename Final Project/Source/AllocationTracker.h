@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationtracker.h
+// ============
+// count the heap allocations of every frame and the phases that make them
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************
+ *  AllocationTracker
+ *
+ *  This class contains the counters of the heap allocations
+ *  made by every frame.  The global operator new is replaced
+ *  to count every allocation while the tracker is enabled,
+ *  and the allocations are attributed to the innermost
+ *  profiled scope of the thread that makes them, so the
+ *  frame phases that allocate can be found.  The first frames
+ *  load and stream their data and grow their buffers, so only
+ *  the frames after them, in the steady state, are expected
+ *  to make no allocations at all.
+ ***********************************************************/
+class AllocationTracker
+{
+public:
+	// start counting the allocations, with the steady state
+	// starting after a number of frames
+	static void Enable(int warmupFrames);
+	static bool IsEnabled();
+
+	// attribute the allocations of the calling thread to a phase,
+	// and get the phase that it replaced to restore it afterwards
+	static const char* EnterPhase(const char* name);
+	static void LeavePhase(const char* previousName);
+
+	// finish the counters of the current frame and start a new frame
+	static void BeginFrame();
+	// finish the counters of the last frame and stop counting,
+	// before the reports are written
+	static void Finish();
+
+	// count an allocation of the current frame and its phase
+	static void RecordAllocation(size_t size);
+
+	// get the number of frames in the steady state that allocated
+	static uint64_t GetAllocatingFrameCount();
+
+	// write the allocations of the frames and of the phases that
+	// allocated in the steady state
+	static void WriteReport(std::ostream& stream);
+	static bool WriteReport(const char* filename);
+};
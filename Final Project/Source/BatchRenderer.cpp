@@ -0,0 +1,485 @@
+///////////////////////////////////////////////////////////////////////////////
+// batchrenderer.cpp
+// ============
+// render still images of the scene from a list of camera poses
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BatchRenderer.h"
+#include "FramePacer.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// framebuffers in flight, enough to hide the readback latency
+	const int g_DefaultPoolSize = 3;
+	// longest wait for a readback before the fence is checked again
+	const GLuint64 g_FenceTimeout = 1000000000;
+}
+
+/***********************************************************
+ *  BatchRenderer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+BatchRenderer::BatchRenderer()
+{
+	m_width = 0;
+	m_height = 0;
+	m_poolSize = g_DefaultPoolSize;
+	m_currentSlot = 0;
+	m_encoderThreadCount = (int)std::thread::hardware_concurrency();
+	if (m_encoderThreadCount < 1)
+	{
+		m_encoderThreadCount = 1;
+	}
+	m_jobCount = 0;
+	m_bStopping = false;
+	m_renderedImages = 0;
+	m_writtenImages = 0;
+	m_failedImages = 0;
+	m_startTime = 0.0;
+	m_endTime = 0.0;
+}
+
+/***********************************************************
+ *  ~BatchRenderer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+BatchRenderer::~BatchRenderer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  LoadPoses()
+ *
+ *  This method is used to read the camera poses of the
+ *  batch from a text file.  Every line holds the position of
+ *  the camera and the direction it looks at, as six numbers,
+ *  and empty lines and lines starting with # are skipped.
+ ***********************************************************/
+bool BatchRenderer::LoadPoses(const char* filename)
+{
+	std::ifstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not open camera pose file:" << filename << std::endl;
+		return(false);
+	}
+
+	m_poses.clear();
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+		size_t start = line.find_first_not_of(" \t\r");
+		if ((start == std::string::npos) || (line[start] == '#'))
+		{
+			continue;
+		}
+
+		CAMERA_POSE pose;
+		std::istringstream values(line);
+		values >> pose.position.x >> pose.position.y >> pose.position.z
+			>> pose.front.x >> pose.front.y >> pose.front.z;
+		if (!values)
+		{
+			std::cout << "Invalid camera pose on line " << lineNumber << " of:" << filename << std::endl;
+			return(false);
+		}
+		m_poses.push_back(pose);
+	}
+
+	if (m_poses.empty() == true)
+	{
+		std::cout << "No camera poses in file:" << filename << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetPoseCount()
+ *
+ *  This method is used to get the number of images of the
+ *  batch.
+ ***********************************************************/
+int BatchRenderer::GetPoseCount() const
+{
+	return((int)m_poses.size());
+}
+
+/***********************************************************
+ *  SetPoolSize()
+ *
+ *  This method is used to set the number of framebuffers
+ *  that the images are rendered into in turn.
+ ***********************************************************/
+void BatchRenderer::SetPoolSize(int poolSize)
+{
+	m_poolSize = (poolSize > 0) ? poolSize : 1;
+}
+
+/***********************************************************
+ *  SetEncoderThreadCount()
+ *
+ *  This method is used to set the number of threads that
+ *  encode the image files.
+ ***********************************************************/
+void BatchRenderer::SetEncoderThreadCount(int threadCount)
+{
+	m_encoderThreadCount = (threadCount > 0) ? threadCount : 1;
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used to create the framebuffers and pixel
+ *  buffers of the pool and to start the encoder threads.
+ *  The images are written into an existing directory.
+ ***********************************************************/
+bool BatchRenderer::Begin(int width, int height, const char* outputDirectory)
+{
+	if ((width <= 0) || (height <= 0))
+	{
+		std::cout << "Invalid batch image size " << width << "x" << height << std::endl;
+		return(false);
+	}
+
+	m_width = width;
+	m_height = height;
+	m_outputDirectory = (NULL != outputDirectory) ? outputDirectory : ".";
+
+	GLsizeiptr imageSize = (GLsizeiptr)width * height * 4;
+	RENDER_SLOT emptySlot = { 0, 0, 0, 0, NULL, -1, false };
+	m_slots.assign(m_poolSize, emptySlot);
+	for (int i = 0; i < m_poolSize; i++)
+	{
+		RENDER_SLOT& slot = m_slots[i];
+
+		glGenRenderbuffers(1, &slot.colorBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, slot.colorBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glGenRenderbuffers(1, &slot.depthBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, slot.depthBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		glGenFramebuffers(1, &slot.framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, slot.framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, slot.colorBuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, slot.depthBuffer);
+		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		glGenBuffers(1, &slot.pixelBuffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelBuffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, imageSize, NULL, GL_STREAM_READ);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		if (status != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cout << "Batch framebuffer is incomplete" << std::endl;
+			Destroy();
+			return(false);
+		}
+	}
+	m_currentSlot = 0;
+
+	m_bStopping = false;
+	for (int i = 0; i < m_encoderThreadCount; i++)
+	{
+		m_encoders.push_back(std::thread(&BatchRenderer::EncodeImages, this));
+	}
+
+	m_renderedImages = 0;
+	m_writtenImages = 0;
+	m_failedImages = 0;
+	m_startTime = FramePacer::GetTime();
+	m_endTime = m_startTime;
+
+	return(true);
+}
+
+/***********************************************************
+ *  BeginImage()
+ *
+ *  This method is used to bind the next framebuffer of the
+ *  pool for an image, and to get the camera pose that it is
+ *  rendered from.  When the framebuffer still holds an
+ *  earlier image, its pixels are passed on first.
+ ***********************************************************/
+void BatchRenderer::BeginImage(int poseIndex, glm::vec3& position, glm::vec3& front)
+{
+	RENDER_SLOT& slot = m_slots[m_currentSlot];
+	if (slot.bPending == true)
+	{
+		CompleteSlot(slot);
+	}
+
+	slot.imageIndex = poseIndex;
+	position = m_poses[poseIndex].position;
+	front = m_poses[poseIndex].front;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, slot.framebuffer);
+	glViewport(0, 0, m_width, m_height);
+}
+
+/***********************************************************
+ *  EndImage()
+ *
+ *  This method is used to start the copy of the rendered
+ *  image into the pixel buffer of its framebuffer, which the
+ *  GPU does after the draws without stopping the CPU.
+ ***********************************************************/
+void BatchRenderer::EndImage()
+{
+	RENDER_SLOT& slot = m_slots[m_currentSlot];
+
+	glReadBuffer(GL_COLOR_ATTACHMENT0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelBuffer);
+	glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.bPending = true;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	m_currentSlot = (m_currentSlot + 1) % m_poolSize;
+	m_renderedImages++;
+}
+
+/***********************************************************
+ *  Finish()
+ *
+ *  This method is used to pass on the images that are still
+ *  being read back, oldest first, and to wait until the
+ *  encoder threads have written every image.
+ ***********************************************************/
+bool BatchRenderer::Finish()
+{
+	for (int i = 0; i < (int)m_slots.size(); i++)
+	{
+		RENDER_SLOT& slot = m_slots[(m_currentSlot + i) % m_slots.size()];
+		if (slot.bPending == true)
+		{
+			CompleteSlot(slot);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+	}
+	m_jobReady.notify_all();
+	for (size_t i = 0; i < m_encoders.size(); i++)
+	{
+		m_encoders[i].join();
+	}
+	m_encoders.clear();
+	m_endTime = FramePacer::GetTime();
+
+	return(m_failedImages == 0);
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the number of images and the
+ *  rate that they were rendered and written at.
+ ***********************************************************/
+void BatchRenderer::WriteReport(std::ostream& stream)
+{
+	double seconds = m_endTime - m_startTime;
+
+	stream << "# batch rendering of the camera poses" << std::endl;
+	stream << "image_size: " << m_width << "x" << m_height << std::endl;
+	stream << "framebuffers: " << m_poolSize << std::endl;
+	stream << "encoder_threads: " << m_encoderThreadCount << std::endl;
+	stream << "rendered_images: " << m_renderedImages << std::endl;
+	stream << "written_images: " << m_writtenImages << std::endl;
+	stream << "failed_images: " << m_failedImages << std::endl;
+	stream << "seconds: " << seconds << std::endl;
+	if (seconds > 0.0)
+	{
+		stream << "images_per_second: " << m_writtenImages / seconds << std::endl;
+	}
+}
+
+/***********************************************************
+ *  CompleteSlot()
+ *
+ *  This method is used to wait for the readback of a slot,
+ *  and to copy its pixels into a buffer for the encoders.
+ *  When all the buffers are waiting to be written, the
+ *  rendering waits for an encoder, which keeps the memory of
+ *  the batch bounded when the encoding is the slower part.
+ ***********************************************************/
+void BatchRenderer::CompleteSlot(RENDER_SLOT& slot)
+{
+	GLenum result = GL_TIMEOUT_EXPIRED;
+	while (result == GL_TIMEOUT_EXPIRED)
+	{
+		result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, g_FenceTimeout);
+	}
+	glDeleteSync(slot.fence);
+	slot.fence = NULL;
+	slot.bPending = false;
+
+	ENCODE_JOB* pJob = NULL;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		int maxJobs = m_poolSize + 2 * m_encoderThreadCount;
+		while ((m_freeJobs.empty() == true) && (m_jobCount >= maxJobs))
+		{
+			m_jobDone.wait(lock);
+		}
+		if (m_freeJobs.empty() == false)
+		{
+			pJob = m_freeJobs.back();
+			m_freeJobs.pop_back();
+		}
+		else
+		{
+			pJob = new ENCODE_JOB();
+			m_jobCount++;
+		}
+	}
+
+	size_t imageSize = (size_t)m_width * m_height * 4;
+	pJob->imageIndex = slot.imageIndex;
+	pJob->pixels.resize(imageSize);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelBuffer);
+	void* pPixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)imageSize, GL_MAP_READ_BIT);
+	bool bMapped = (NULL != pPixels);
+	if (true == bMapped)
+	{
+		memcpy(pJob->pixels.data(), pPixels, imageSize);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (true == bMapped)
+		{
+			m_jobs.push_back(pJob);
+		}
+		else
+		{
+			std::cout << "Could not map the pixels of image " << slot.imageIndex << std::endl;
+			m_failedImages++;
+			m_freeJobs.push_back(pJob);
+		}
+	}
+	m_jobReady.notify_one();
+}
+
+/***********************************************************
+ *  EncodeImages()
+ *
+ *  This method is run by every encoder thread, and writes
+ *  the queued images until the batch is finished and the
+ *  queue is empty.
+ ***********************************************************/
+void BatchRenderer::EncodeImages()
+{
+	ImageWriter writer;
+	std::vector<char> filename(m_outputDirectory.size() + 32);
+
+	while (true)
+	{
+		ENCODE_JOB* pJob = NULL;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while ((m_jobs.empty() == true) && (m_bStopping == false))
+			{
+				m_jobReady.wait(lock);
+			}
+			if (m_jobs.empty() == true)
+			{
+				break;
+			}
+			pJob = m_jobs.front();
+			m_jobs.pop_front();
+		}
+
+		snprintf(filename.data(), filename.size(), "%s/image_%05d.png",
+			m_outputDirectory.c_str(), pJob->imageIndex);
+		bool bWritten = writer.WritePNG(filename.data(), m_width, m_height, pJob->pixels.data(), true);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (true == bWritten)
+			{
+				m_writtenImages++;
+			}
+			else
+			{
+				m_failedImages++;
+			}
+			m_freeJobs.push_back(pJob);
+		}
+		m_jobDone.notify_one();
+	}
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used to stop the encoder threads and free
+ *  the framebuffers and the pixel buffers.
+ ***********************************************************/
+void BatchRenderer::Destroy()
+{
+	if (m_encoders.empty() == false)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bStopping = true;
+		}
+		m_jobReady.notify_all();
+		for (size_t i = 0; i < m_encoders.size(); i++)
+		{
+			m_encoders[i].join();
+		}
+		m_encoders.clear();
+	}
+
+	for (size_t i = 0; i < m_slots.size(); i++)
+	{
+		RENDER_SLOT& slot = m_slots[i];
+		if (NULL != slot.fence)
+		{
+			glDeleteSync(slot.fence);
+		}
+		glDeleteFramebuffers(1, &slot.framebuffer);
+		glDeleteRenderbuffers(1, &slot.colorBuffer);
+		glDeleteRenderbuffers(1, &slot.depthBuffer);
+		glDeleteBuffers(1, &slot.pixelBuffer);
+	}
+	m_slots.clear();
+
+	for (size_t i = 0; i < m_jobs.size(); i++)
+	{
+		delete m_jobs[i];
+	}
+	m_jobs.clear();
+	for (size_t i = 0; i < m_freeJobs.size(); i++)
+	{
+		delete m_freeJobs[i];
+	}
+	m_freeJobs.clear();
+	m_jobCount = 0;
+}
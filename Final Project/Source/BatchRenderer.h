@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////
+// batchrenderer.h
+// ============
+// render still images of the scene from a list of camera poses
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ImageWriter.h"
+
+#include <GL/glew.h>
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/***********************************************************
+ *  BatchRenderer
+ *
+ *  This class contains the code for rendering many images of
+ *  the scene without a window.  Every image is rendered into
+ *  one of a pool of framebuffers and read back into a pixel
+ *  buffer object, which is only mapped when the framebuffer
+ *  is used again, so the readback of an image overlaps the
+ *  rendering of the next ones.  The pixels are then handed to
+ *  a set of encoder threads that write the PNG files while
+ *  the rendering goes on.
+ ***********************************************************/
+class BatchRenderer
+{
+public:
+	// constructor
+	BatchRenderer();
+	// destructor
+	~BatchRenderer();
+
+	// read the camera poses, one position and direction per line
+	bool LoadPoses(const char* filename);
+	int GetPoseCount() const;
+
+	// set the number of framebuffers and encoder threads
+	void SetPoolSize(int poolSize);
+	void SetEncoderThreadCount(int threadCount);
+
+	// create the framebuffers and start the encoder threads
+	bool Begin(int width, int height, const char* outputDirectory);
+
+	// bind the framebuffer of an image and get its camera pose
+	void BeginImage(int poseIndex, glm::vec3& position, glm::vec3& front);
+	// start the readback of the image
+	void EndImage();
+
+	// wait for the remaining images to be written
+	bool Finish();
+
+	// write the images per second of the batch
+	void WriteReport(std::ostream& stream);
+
+private:
+	struct CAMERA_POSE
+	{
+		glm::vec3 position;
+		glm::vec3 front;
+	};
+
+	struct RENDER_SLOT
+	{
+		GLuint framebuffer;
+		GLuint colorBuffer;
+		GLuint depthBuffer;
+		GLuint pixelBuffer;
+		GLsync fence;
+		int imageIndex;
+		bool bPending;
+	};
+
+	struct ENCODE_JOB
+	{
+		int imageIndex;
+		std::vector<unsigned char> pixels;
+	};
+
+	std::vector<CAMERA_POSE> m_poses;
+	int m_width;
+	int m_height;
+	std::string m_outputDirectory;
+
+	// framebuffers that the images are rendered into in turn
+	std::vector<RENDER_SLOT> m_slots;
+	int m_poolSize;
+	int m_currentSlot;
+
+	// images waiting for an encoder, and the buffers that are free
+	std::vector<std::thread> m_encoders;
+	int m_encoderThreadCount;
+	std::mutex m_mutex;
+	std::condition_variable m_jobReady;
+	std::condition_variable m_jobDone;
+	std::deque<ENCODE_JOB*> m_jobs;
+	std::vector<ENCODE_JOB*> m_freeJobs;
+	int m_jobCount;
+	bool m_bStopping;
+
+	// progress of the batch
+	int m_renderedImages;
+	int m_writtenImages;
+	int m_failedImages;
+	double m_startTime;
+	double m_endTime;
+
+	// map the pixels of a slot and queue them for an encoder
+	void CompleteSlot(RENDER_SLOT& slot);
+	// write the images of the queue until the batch is finished
+	void EncodeImages();
+	// free the framebuffers and stop the encoder threads
+	void Destroy();
+};
@@ -0,0 +1,199 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerabuffer.cpp
+// ============
+// hold the camera matrices of every frame in a persistently mapped buffer
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CameraBuffer.h"
+
+#include <iostream>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// name of the camera block in the shaders
+	const char* g_CameraBlockName = "CameraBlock";
+	// longest wait for the GPU to release a slot, in nanoseconds
+	const GLuint64 g_FenceTimeout = 1000000000;
+}
+
+/***********************************************************
+ *  CameraBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+CameraBuffer::CameraBuffer()
+{
+	m_buffer = 0;
+	m_pMapped = NULL;
+	m_slotSize = 0;
+	m_slot = -1;
+	for (int i = 0; i < SLOT_COUNT; i++)
+	{
+		m_fences[i] = NULL;
+	}
+}
+
+/***********************************************************
+ *  ~CameraBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+CameraBuffer::~CameraBuffer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used to create the buffer with immutable
+ *  storage and to map it persistently.  The mapping is
+ *  coherent, so the written values are seen by the commands
+ *  that are issued afterwards without any flush.
+ ***********************************************************/
+bool CameraBuffer::Create()
+{
+	if (0 != m_buffer)
+	{
+		return(true);
+	}
+
+	if ((GLEW_VERSION_4_4 == GL_FALSE) && (GLEW_ARB_buffer_storage == GL_FALSE))
+	{
+		std::cout << "Persistent buffer mapping is not supported, the camera uniforms are set directly" << std::endl;
+		return(false);
+	}
+
+	// every slot has to start on the uniform buffer offset alignment
+	GLint alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	if (alignment < 1)
+	{
+		alignment = 256;
+	}
+	m_slotSize = ((GLsizeiptr)sizeof(CAMERA_BLOCK) + alignment - 1) / alignment * alignment;
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &m_buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+	glBufferStorage(GL_UNIFORM_BUFFER, m_slotSize * SLOT_COUNT, NULL, flags);
+	m_pMapped = (GLubyte*)glMapBufferRange(GL_UNIFORM_BUFFER, 0, m_slotSize * SLOT_COUNT, flags);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	if (NULL == m_pMapped)
+	{
+		std::cout << "Could not map the camera uniform buffer" << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	m_slot = -1;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used to unmap and delete the buffer.
+ ***********************************************************/
+void CameraBuffer::Destroy()
+{
+	for (int i = 0; i < SLOT_COUNT; i++)
+	{
+		if (NULL != m_fences[i])
+		{
+			glDeleteSync(m_fences[i]);
+			m_fences[i] = NULL;
+		}
+	}
+
+	if (0 != m_buffer)
+	{
+		if (NULL != m_pMapped)
+		{
+			glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+			glUnmapBuffer(GL_UNIFORM_BUFFER);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			m_pMapped = NULL;
+		}
+		glDeleteBuffers(1, &m_buffer);
+		m_buffer = 0;
+	}
+}
+
+/***********************************************************
+ *  IsCreated()
+ *
+ *  This method is used to check whether the buffer exists
+ *  and is mapped.
+ ***********************************************************/
+bool CameraBuffer::IsCreated() const
+{
+	return(NULL != m_pMapped);
+}
+
+/***********************************************************
+ *  BindProgram()
+ *
+ *  This method is used to connect the camera block of a
+ *  shader program to the binding point of the buffer.
+ ***********************************************************/
+void CameraBuffer::BindProgram(GLuint program)
+{
+	GLuint blockIndex = glGetUniformBlockIndex(program, g_CameraBlockName);
+	if (GL_INVALID_INDEX == blockIndex)
+	{
+		std::cout << "The shader program has no camera block" << std::endl;
+		return;
+	}
+
+	glUniformBlockBinding(program, blockIndex, BINDING_POINT);
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method is used to write the camera of the frame into
+ *  the next slot and to bind that slot to the camera block.
+ *  The commands of the last frame have all been issued at
+ *  this point, so a fence is placed behind them for the slot
+ *  they read.  Before a slot is reused, its fence is waited
+ *  on, which only blocks when the GPU is several frames late.
+ ***********************************************************/
+void CameraBuffer::Write(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition)
+{
+	if (NULL == m_pMapped)
+	{
+		return;
+	}
+
+	if (m_slot >= 0)
+	{
+		m_fences[m_slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	m_slot = (m_slot + 1) % SLOT_COUNT;
+
+	if (NULL != m_fences[m_slot])
+	{
+		GLenum waitResult = GL_TIMEOUT_EXPIRED;
+		while (GL_TIMEOUT_EXPIRED == waitResult)
+		{
+			waitResult = glClientWaitSync(m_fences[m_slot], GL_SYNC_FLUSH_COMMANDS_BIT, g_FenceTimeout);
+		}
+		glDeleteSync(m_fences[m_slot]);
+		m_fences[m_slot] = NULL;
+	}
+
+	CAMERA_BLOCK block;
+	block.view = view;
+	block.projection = projection;
+	block.viewPosition = glm::vec4(viewPosition, 1.0f);
+	memcpy(m_pMapped + m_slot * m_slotSize, &block, sizeof(block));
+
+	glBindBufferRange(GL_UNIFORM_BUFFER, BINDING_POINT, m_buffer, m_slot * m_slotSize, sizeof(CAMERA_BLOCK));
+}
@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerabuffer.h
+// ============
+// hold the camera matrices of every frame in a persistently mapped buffer
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  CameraBuffer
+ *
+ *  This class contains the uniform buffer that the camera
+ *  block of the shaders is read from.  The buffer is mapped
+ *  once for its whole lifetime, so writing the camera of a
+ *  frame is a plain memory copy that can be done right
+ *  before the draws are submitted.  It holds one slot per
+ *  frame in flight, and a fence keeps a slot from being
+ *  overwritten while the GPU may still read it.  Persistent
+ *  mapping needs OpenGL 4.4 or ARB_buffer_storage, without
+ *  it the buffer is not created and the camera uniforms are
+ *  set one by one instead.
+ ***********************************************************/
+class CameraBuffer
+{
+public:
+	// constructor
+	CameraBuffer();
+	// destructor
+	~CameraBuffer();
+
+	// create and map the buffer, false when it is not supported
+	bool Create();
+	void Destroy();
+	bool IsCreated() const;
+
+	// connect the camera block of a shader program to the buffer
+	void BindProgram(GLuint program);
+
+	// write the camera of a frame into the next slot and bind it
+	void Write(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition);
+
+private:
+	// frames that can be in flight before a slot is reused
+	static const int SLOT_COUNT = 3;
+	// uniform buffer binding point of the camera block
+	static const GLuint BINDING_POINT = 0;
+
+	// layout of the camera block, matching std140
+	struct CAMERA_BLOCK
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec4 viewPosition;
+	};
+
+	GLuint m_buffer;
+	GLubyte* m_pMapped;
+	// size of a slot, rounded up to the uniform buffer alignment
+	GLsizeiptr m_slotSize;
+	int m_slot;
+	GLsync m_fences[SLOT_COUNT];
+};
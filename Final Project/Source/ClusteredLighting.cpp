@@ -0,0 +1,625 @@
+///////////////////////////////////////////////////////////////////////////////
+// clusteredlighting.cpp
+// ============
+// assign the point lights of the scene to the clusters of the view frustum
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ClusteredLighting.h"
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <cfloat>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define CLUSTEREDLIGHTING_USE_SSE2
+#endif
+
+// declaration of global variables
+namespace
+{
+	// names of the storage blocks in the fragment shader
+	const char* g_LightBlockName = "LightBuffer";
+	const char* g_ClusterBlockName = "ClusterBuffer";
+	const char* g_IndexBlockName = "LightIndexBuffer";
+	// storage buffer binding points of the blocks
+	const GLuint g_LightBinding = 1;
+	const GLuint g_ClusterBinding = 2;
+	const GLuint g_IndexBinding = 3;
+
+	// most threads that assign the lights, including the render thread
+	const int g_MaxThreads = 8;
+	// fewer light and cluster pairs than this are assigned on the
+	// render thread alone, since waking the workers costs more
+	const size_t g_ParallelThreshold = 32768;
+}
+
+/***********************************************************
+ *  ClusteredLighting()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ClusteredLighting::ClusteredLighting(ShaderManager* pShaderManager)
+{
+	m_pShaderManager = pShaderManager;
+	m_bClustered = false;
+	m_bLightsChanged = true;
+	m_lightBuffer = 0;
+	m_clusterBuffer = 0;
+	m_indexBuffer = 0;
+	m_nearPlane = 0.0f;
+	m_farPlane = 0.0f;
+	m_viewportWidth = 0;
+	m_viewportHeight = 0;
+	m_bBoundsValid = false;
+	m_generation = 0;
+	m_busyWorkers = 0;
+	m_bShutdown = false;
+}
+
+/***********************************************************
+ *  ~ClusteredLighting()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ClusteredLighting::~ClusteredLighting()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bShutdown = true;
+	}
+	m_startCondition.notify_all();
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+
+	GLuint buffers[3] = { m_lightBuffer, m_clusterBuffer, m_indexBuffer };
+	if (0 != m_lightBuffer)
+	{
+		glDeleteBuffers(3, buffers);
+	}
+	m_pShaderManager = NULL;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used to create the storage buffers and to
+ *  connect them to the storage blocks of the shader program.
+ *  Clustering needs OpenGL 4.3 or ARB_shader_storage_buffer_
+ *  object, and a shader that was compiled with its blocks.
+ ***********************************************************/
+bool ClusteredLighting::Create(GLuint program)
+{
+	m_bClustered = false;
+	m_bLightsChanged = true;
+
+	if ((GLEW_VERSION_4_3 == GL_FALSE) && (GLEW_ARB_shader_storage_buffer_object == GL_FALSE))
+	{
+		std::cout << "Shader storage buffers are not supported, the first " << UNIFORM_LIGHT_COUNT << " lights are used" << std::endl;
+		return(false);
+	}
+
+	GLuint lightBlock = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, g_LightBlockName);
+	GLuint clusterBlock = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, g_ClusterBlockName);
+	GLuint indexBlock = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, g_IndexBlockName);
+	if ((GL_INVALID_INDEX == lightBlock) || (GL_INVALID_INDEX == clusterBlock) || (GL_INVALID_INDEX == indexBlock))
+	{
+		std::cout << "The shader program has no light cluster blocks, the first " << UNIFORM_LIGHT_COUNT << " lights are used" << std::endl;
+		return(false);
+	}
+	glShaderStorageBlockBinding(program, lightBlock, g_LightBinding);
+	glShaderStorageBlockBinding(program, clusterBlock, g_ClusterBinding);
+	glShaderStorageBlockBinding(program, indexBlock, g_IndexBinding);
+
+	if (0 == m_lightBuffer)
+	{
+		GLuint buffers[3];
+		glGenBuffers(3, buffers);
+		m_lightBuffer = buffers[0];
+		m_clusterBuffer = buffers[1];
+		m_indexBuffer = buffers[2];
+	}
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, g_LightBinding, m_lightBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, g_ClusterBinding, m_clusterBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, g_IndexBinding, m_indexBuffer);
+
+	m_clusterRanges.assign(CLUSTER_COUNT * 2, 0);
+	m_pShaderManager->setVec3Value("clusterGridSize", (float)GRID_X, (float)GRID_Y, (float)GRID_Z);
+	m_pShaderManager->setBoolValue("bUseClusteredLighting", true);
+
+	// the render thread assigns the lights of the first slices itself
+	if (m_workers.empty() == true)
+	{
+		int threadCount = (int)std::thread::hardware_concurrency();
+		threadCount = (threadCount < g_MaxThreads) ? threadCount : g_MaxThreads;
+		threadCount = (threadCount > 1) ? threadCount : 1;
+		m_outputs.resize(threadCount);
+		for (int i = 1; i < threadCount; i++)
+		{
+			m_workers.push_back(std::thread(&ClusteredLighting::WorkerLoop, this, i));
+		}
+	}
+
+	m_bClustered = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsClustered()
+ *
+ *  This method is used to check whether the lights are
+ *  assigned to clusters, or set in the uniforms.
+ ***********************************************************/
+bool ClusteredLighting::IsClustered() const
+{
+	return(m_bClustered);
+}
+
+/***********************************************************
+ *  AddLight()
+ *
+ *  This method is used to add a light to the scene, and
+ *  returns its index.
+ ***********************************************************/
+int ClusteredLighting::AddLight(const POINT_LIGHT& light)
+{
+	m_lights.push_back(light);
+	m_bLightsChanged = true;
+
+	return((int)m_lights.size() - 1);
+}
+
+/***********************************************************
+ *  SetLight()
+ *
+ *  This method is used to change a light of the scene.
+ ***********************************************************/
+void ClusteredLighting::SetLight(int index, const POINT_LIGHT& light)
+{
+	if ((index < 0) || (index >= (int)m_lights.size()))
+	{
+		return;
+	}
+
+	m_lights[index] = light;
+	m_bLightsChanged = true;
+}
+
+/***********************************************************
+ *  ClearLights()
+ *
+ *  This method is used to remove all of the lights.
+ ***********************************************************/
+void ClusteredLighting::ClearLights()
+{
+	m_lights.clear();
+	m_bLightsChanged = true;
+}
+
+/***********************************************************
+ *  GetLightCount()
+ *
+ *  This method is used to get the number of lights.
+ ***********************************************************/
+int ClusteredLighting::GetLightCount() const
+{
+	return((int)m_lights.size());
+}
+
+/***********************************************************
+ *  GetLight()
+ *
+ *  This method is used to get a light of the scene.
+ ***********************************************************/
+const ClusteredLighting::POINT_LIGHT& ClusteredLighting::GetLight(int index) const
+{
+	return(m_lights[index]);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used to assign the lights to the clusters
+ *  of the view of the frame, and to upload the lights and
+ *  the clusters.  The cluster bounds are only rebuilt when
+ *  the projection changed.
+ ***********************************************************/
+void ClusteredLighting::Update(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	float nearPlane,
+	float farPlane,
+	int viewportWidth,
+	int viewportHeight)
+{
+	if (m_bClustered == false)
+	{
+		if (m_bLightsChanged == true)
+		{
+			SetUniformLights();
+			m_bLightsChanged = false;
+		}
+		return;
+	}
+
+	if ((m_bBoundsValid == false) || (m_projection != projection) ||
+		(m_nearPlane != nearPlane) || (m_farPlane != farPlane))
+	{
+		m_projection = projection;
+		m_nearPlane = nearPlane;
+		m_farPlane = farPlane;
+		BuildClusterBounds();
+		m_bBoundsValid = true;
+
+		// a fragment finds its depth slice from the log of its depth
+		float logRange = logf(farPlane / nearPlane);
+		m_pShaderManager->setFloatValue("clusterDepthScale", (float)GRID_Z / logRange);
+		m_pShaderManager->setFloatValue("clusterDepthBias", (float)GRID_Z * logf(nearPlane) / logRange);
+	}
+
+	if ((m_viewportWidth != viewportWidth) || (m_viewportHeight != viewportHeight))
+	{
+		m_viewportWidth = viewportWidth;
+		m_viewportHeight = viewportHeight;
+		if ((viewportWidth > 0) && (viewportHeight > 0))
+		{
+			m_pShaderManager->setVec2Value("clusterScreenScale",
+				(float)GRID_X / (float)viewportWidth,
+				(float)GRID_Y / (float)viewportHeight);
+		}
+	}
+
+	if (m_bLightsChanged == true)
+	{
+		UploadLights();
+		m_bLightsChanged = false;
+	}
+
+	// move the lights into view space, in groups of four
+	size_t lightCount = m_lights.size();
+	m_lightX.resize(lightCount);
+	m_lightY.resize(lightCount);
+	m_lightZ.resize(lightCount);
+	m_lightRadius.resize(lightCount);
+	for (size_t i = 0; i < lightCount; i++)
+	{
+		glm::vec4 position = view * glm::vec4(m_lights[i].position, 1.0f);
+		m_lightX[i] = position.x;
+		m_lightY[i] = position.y;
+		m_lightZ[i] = position.z;
+		m_lightRadius[i] = (m_lights[i].radius > 0.0f) ? m_lights[i].radius : FLT_MAX;
+	}
+
+	AssignLights();
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_clusterBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, m_clusterRanges.size() * sizeof(uint32_t), m_clusterRanges.data(), GL_STREAM_DRAW);
+	// an empty buffer cannot back a storage block
+	if (m_lightIndices.empty() == true)
+	{
+		m_lightIndices.push_back(0);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_indexBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, m_lightIndices.size() * sizeof(uint32_t), m_lightIndices.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  BuildClusterBounds()
+ *
+ *  This method is used to find the view space bounds of every
+ *  cluster.  The corners of a tile are unprojected into rays,
+ *  which are cut at the near and far depth of the slice, so
+ *  this works for perspective and orthographic projections.
+ ***********************************************************/
+void ClusteredLighting::BuildClusterBounds()
+{
+	m_bounds.resize(CLUSTER_COUNT);
+	glm::mat4 inverseProjection = glm::inverse(m_projection);
+
+	for (int z = 0; z < GRID_Z; z++)
+	{
+		float depths[2];
+		depths[0] = m_nearPlane * powf(m_farPlane / m_nearPlane, (float)z / (float)GRID_Z);
+		depths[1] = m_nearPlane * powf(m_farPlane / m_nearPlane, (float)(z + 1) / (float)GRID_Z);
+
+		for (int y = 0; y < GRID_Y; y++)
+		{
+			for (int x = 0; x < GRID_X; x++)
+			{
+				CLUSTER_BOUNDS& bounds = m_bounds[x + GRID_X * (y + GRID_Y * z)];
+				bounds.minX = bounds.minY = bounds.minZ = FLT_MAX;
+				bounds.maxX = bounds.maxY = bounds.maxZ = -FLT_MAX;
+
+				for (int corner = 0; corner < 4; corner++)
+				{
+					float ndcX = -1.0f + 2.0f * (float)(x + (corner & 1)) / (float)GRID_X;
+					float ndcY = -1.0f + 2.0f * (float)(y + (corner >> 1)) / (float)GRID_Y;
+					glm::vec4 nearPoint = inverseProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+					glm::vec4 farPoint = inverseProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+					glm::vec3 rayStart = glm::vec3(nearPoint) / nearPoint.w;
+					glm::vec3 rayEnd = glm::vec3(farPoint) / farPoint.w;
+
+					for (int i = 0; i < 2; i++)
+					{
+						float t = (-depths[i] - rayStart.z) / (rayEnd.z - rayStart.z);
+						glm::vec3 point = rayStart + (rayEnd - rayStart) * t;
+						bounds.minX = std::fmin(bounds.minX, point.x);
+						bounds.minY = std::fmin(bounds.minY, point.y);
+						bounds.minZ = std::fmin(bounds.minZ, point.z);
+						bounds.maxX = std::fmax(bounds.maxX, point.x);
+						bounds.maxY = std::fmax(bounds.maxY, point.y);
+						bounds.maxZ = std::fmax(bounds.maxZ, point.z);
+					}
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  AssignLights()
+ *
+ *  This method is used to split the depth slices between the
+ *  render thread and the workers, to wait for them, and to
+ *  join their light index lists in cluster order.
+ ***********************************************************/
+void ClusteredLighting::AssignLights()
+{
+	int threadCount = (int)m_outputs.size();
+	if (m_lights.size() * CLUSTER_COUNT < g_ParallelThreshold)
+	{
+		threadCount = 1;
+	}
+
+	int slicesPerThread = (GRID_Z + threadCount - 1) / threadCount;
+	for (int i = 0; i < (int)m_outputs.size(); i++)
+	{
+		int firstSlice = (i < threadCount) ? (i * slicesPerThread) : GRID_Z;
+		m_outputs[i].firstSlice = (firstSlice < GRID_Z) ? firstSlice : GRID_Z;
+		m_outputs[i].lastSlice = (firstSlice + slicesPerThread < GRID_Z) ? (firstSlice + slicesPerThread) : GRID_Z;
+		if (i >= threadCount)
+		{
+			m_outputs[i].indices.clear();
+		}
+	}
+
+	if (threadCount > 1)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_busyWorkers = (int)m_workers.size();
+			m_generation++;
+		}
+		m_startCondition.notify_all();
+	}
+
+	AssignSlices(m_outputs[0]);
+
+	if (threadCount > 1)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_doneCondition.wait(lock, [this]() { return(m_busyWorkers == 0); });
+	}
+
+	// the ranges of every worker start at its own list, so they are
+	// moved by the length of the lists of the workers before it
+	m_lightIndices.clear();
+	for (size_t i = 0; i < m_outputs.size(); i++)
+	{
+		const WORKER_OUTPUT& output = m_outputs[i];
+		uint32_t base = (uint32_t)m_lightIndices.size();
+		for (int cluster = output.firstSlice * GRID_X * GRID_Y; cluster < output.lastSlice * GRID_X * GRID_Y; cluster++)
+		{
+			m_clusterRanges[cluster * 2] += base;
+		}
+		m_lightIndices.insert(m_lightIndices.end(), output.indices.begin(), output.indices.end());
+	}
+}
+
+/***********************************************************
+ *  AssignSlices()
+ *
+ *  This method is used to find the lights of the clusters in
+ *  a range of depth slices.  The lights that reach the depth
+ *  of a slice are gathered first, and then tested against
+ *  every tile of the slice, four at a time.  A light touches
+ *  a cluster when the distance from its center to the bounds
+ *  is within its radius.
+ ***********************************************************/
+void ClusteredLighting::AssignSlices(WORKER_OUTPUT& output)
+{
+	output.indices.clear();
+
+	for (int slice = output.firstSlice; slice < output.lastSlice; slice++)
+	{
+		const CLUSTER_BOUNDS& sliceBounds = m_bounds[slice * GRID_X * GRID_Y];
+
+		output.candidateX.clear();
+		output.candidateY.clear();
+		output.candidateZ.clear();
+		output.candidateRadius2.clear();
+		output.candidateIndex.clear();
+		for (size_t i = 0; i < m_lights.size(); i++)
+		{
+			float radius = m_lightRadius[i];
+			if ((m_lightZ[i] + radius < sliceBounds.minZ) || (m_lightZ[i] - radius > sliceBounds.maxZ))
+			{
+				continue;
+			}
+			output.candidateX.push_back(m_lightX[i]);
+			output.candidateY.push_back(m_lightY[i]);
+			output.candidateZ.push_back(m_lightZ[i]);
+			output.candidateRadius2.push_back((radius < FLT_MAX) ? (radius * radius) : FLT_MAX);
+			output.candidateIndex.push_back((uint32_t)i);
+		}
+		// pad the last group with lights that never touch a cluster
+		while ((output.candidateIndex.size() % 4) != 0)
+		{
+			output.candidateX.push_back(0.0f);
+			output.candidateY.push_back(0.0f);
+			output.candidateZ.push_back(0.0f);
+			output.candidateRadius2.push_back(-1.0f);
+			output.candidateIndex.push_back(0);
+		}
+		size_t candidateCount = output.candidateIndex.size();
+
+		for (int tile = 0; tile < GRID_X * GRID_Y; tile++)
+		{
+			int cluster = slice * GRID_X * GRID_Y + tile;
+			const CLUSTER_BOUNDS& bounds = m_bounds[cluster];
+			uint32_t offset = (uint32_t)output.indices.size();
+
+#ifdef CLUSTEREDLIGHTING_USE_SSE2
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 minX = _mm_set1_ps(bounds.minX);
+			const __m128 minY = _mm_set1_ps(bounds.minY);
+			const __m128 minZ = _mm_set1_ps(bounds.minZ);
+			const __m128 maxX = _mm_set1_ps(bounds.maxX);
+			const __m128 maxY = _mm_set1_ps(bounds.maxY);
+			const __m128 maxZ = _mm_set1_ps(bounds.maxZ);
+			for (size_t i = 0; i < candidateCount; i += 4)
+			{
+				__m128 x = _mm_loadu_ps(&output.candidateX[i]);
+				__m128 y = _mm_loadu_ps(&output.candidateY[i]);
+				__m128 z = _mm_loadu_ps(&output.candidateZ[i]);
+				__m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, x), _mm_sub_ps(x, maxX)), zero);
+				__m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, y), _mm_sub_ps(y, maxY)), zero);
+				__m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, z), _mm_sub_ps(z, maxZ)), zero);
+				__m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+				int mask = _mm_movemask_ps(_mm_cmple_ps(distance2, _mm_loadu_ps(&output.candidateRadius2[i])));
+				for (int lane = 0; (lane < 4) && (mask != 0); lane++, mask >>= 1)
+				{
+					if ((mask & 1) != 0)
+					{
+						output.indices.push_back(output.candidateIndex[i + lane]);
+					}
+				}
+			}
+#else
+			for (size_t i = 0; i < candidateCount; i++)
+			{
+				float x = output.candidateX[i];
+				float y = output.candidateY[i];
+				float z = output.candidateZ[i];
+				float dx = std::fmax(std::fmax(bounds.minX - x, x - bounds.maxX), 0.0f);
+				float dy = std::fmax(std::fmax(bounds.minY - y, y - bounds.maxY), 0.0f);
+				float dz = std::fmax(std::fmax(bounds.minZ - z, z - bounds.maxZ), 0.0f);
+				if (dx * dx + dy * dy + dz * dz <= output.candidateRadius2[i])
+				{
+					output.indices.push_back(output.candidateIndex[i]);
+				}
+			}
+#endif
+
+			m_clusterRanges[cluster * 2] = offset;
+			m_clusterRanges[cluster * 2 + 1] = (uint32_t)output.indices.size() - offset;
+		}
+	}
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is run by every worker thread.  It waits for
+ *  the next frame, assigns the lights of its slices, and
+ *  reports back, until the object is destroyed.
+ ***********************************************************/
+void ClusteredLighting::WorkerLoop(int worker)
+{
+	uint64_t generation = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_startCondition.wait(lock, [this, generation]() { return((m_bShutdown == true) || (m_generation != generation)); });
+			if (m_bShutdown == true)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		AssignSlices(m_outputs[worker]);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_busyWorkers--;
+		}
+		m_doneCondition.notify_one();
+	}
+}
+
+/***********************************************************
+ *  UploadLights()
+ *
+ *  This method is used to upload all of the lights into the
+ *  light buffer.
+ ***********************************************************/
+void ClusteredLighting::UploadLights()
+{
+	std::vector<GPU_LIGHT> gpuLights(m_lights.empty() ? 1 : m_lights.size());
+	for (size_t i = 0; i < m_lights.size(); i++)
+	{
+		const POINT_LIGHT& light = m_lights[i];
+		GPU_LIGHT& gpuLight = gpuLights[i];
+		gpuLight.positionRadius[0] = light.position.x;
+		gpuLight.positionRadius[1] = light.position.y;
+		gpuLight.positionRadius[2] = light.position.z;
+		gpuLight.positionRadius[3] = light.radius;
+		gpuLight.ambientColor[0] = light.ambientColor.x;
+		gpuLight.ambientColor[1] = light.ambientColor.y;
+		gpuLight.ambientColor[2] = light.ambientColor.z;
+		gpuLight.ambientColor[3] = light.focalStrength;
+		gpuLight.diffuseColor[0] = light.diffuseColor.x;
+		gpuLight.diffuseColor[1] = light.diffuseColor.y;
+		gpuLight.diffuseColor[2] = light.diffuseColor.z;
+		gpuLight.diffuseColor[3] = light.specularIntensity;
+		gpuLight.specularColor[0] = light.specularColor.x;
+		gpuLight.specularColor[1] = light.specularColor.y;
+		gpuLight.specularColor[2] = light.specularColor.z;
+		gpuLight.specularColor[3] = (float)light.shadowIndex;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, gpuLights.size() * sizeof(GPU_LIGHT), gpuLights.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  SetUniformLights()
+ *
+ *  This method is used to set the first lights into the
+ *  lightSources uniforms, when the lights cannot be
+ *  clustered.  The unused uniform lights are turned off.
+ ***********************************************************/
+void ClusteredLighting::SetUniformLights()
+{
+	for (int i = 0; i < UNIFORM_LIGHT_COUNT; i++)
+	{
+		POINT_LIGHT light = {};
+		light.shadowIndex = -1;
+		if (i < (int)m_lights.size())
+		{
+			light = m_lights[i];
+		}
+
+		std::string name = "lightSources[" + std::to_string(i) + "].";
+		m_pShaderManager->setVec3Value(name + "position", light.position);
+		m_pShaderManager->setFloatValue(name + "radius", light.radius);
+		m_pShaderManager->setVec3Value(name + "ambientColor", light.ambientColor);
+		m_pShaderManager->setVec3Value(name + "diffuseColor", light.diffuseColor);
+		m_pShaderManager->setVec3Value(name + "specularColor", light.specularColor);
+		m_pShaderManager->setFloatValue(name + "focalStrength", light.focalStrength);
+		m_pShaderManager->setFloatValue(name + "specularIntensity", light.specularIntensity);
+		m_pShaderManager->setIntValue(name + "shadowIndex", light.shadowIndex);
+	}
+}
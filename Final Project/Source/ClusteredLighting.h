@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////
+// clusteredlighting.h
+// ============
+// assign the point lights of the scene to the clusters of the view frustum
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+
+#include <GL/glew.h>
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+/***********************************************************
+ *  ClusteredLighting
+ *
+ *  This class contains the code for clustered forward
+ *  lighting.  The view frustum is split into a grid of
+ *  clusters, with screen space tiles and depth slices that
+ *  grow exponentially with the distance.  Every frame, the
+ *  lights are tested against the bounds of every cluster on
+ *  the CPU, four lights at a time with SSE, and the depth
+ *  slices are split between worker threads.  The lights, the
+ *  light range of every cluster and the light index lists
+ *  are uploaded in shader storage buffers, so a fragment
+ *  only lights itself with the lights of its own cluster.
+ *  Without shader storage buffers, the first lights are set
+ *  in the lightSources uniforms instead.
+ ***********************************************************/
+class ClusteredLighting
+{
+public:
+	// constructor
+	ClusteredLighting(ShaderManager* pShaderManager);
+	// destructor
+	~ClusteredLighting();
+
+	// number of lights in the uniforms when clustering is not supported
+	static const int UNIFORM_LIGHT_COUNT = 4;
+
+	struct POINT_LIGHT
+	{
+		glm::vec3 position;
+		// distance where the light fades out, or 0 to reach everywhere
+		float radius;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float focalStrength;
+		float specularIntensity;
+		// shadow map of the light, or -1 when it casts no shadows
+		int shadowIndex;
+	};
+
+	// create the storage buffers, false when they are not supported
+	bool Create(GLuint program);
+	bool IsClustered() const;
+
+	// add, change and remove the lights of the scene
+	int AddLight(const POINT_LIGHT& light);
+	void SetLight(int index, const POINT_LIGHT& light);
+	void ClearLights();
+	int GetLightCount() const;
+	const POINT_LIGHT& GetLight(int index) const;
+
+	// assign the lights to the clusters of the view and upload them
+	void Update(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		float nearPlane,
+		float farPlane,
+		int viewportWidth,
+		int viewportHeight);
+
+private:
+	// size of the cluster grid
+	static const int GRID_X = 16;
+	static const int GRID_Y = 9;
+	static const int GRID_Z = 24;
+	static const int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+	// layout of a light in the light buffer, matching std430
+	struct GPU_LIGHT
+	{
+		float positionRadius[4];
+		float ambientColor[4];
+		float diffuseColor[4];
+		float specularColor[4];
+	};
+
+	// view space bounds of a cluster
+	struct CLUSTER_BOUNDS
+	{
+		float minX, minY, minZ;
+		float maxX, maxY, maxZ;
+	};
+
+	// light indices found by a worker for its depth slices
+	struct WORKER_OUTPUT
+	{
+		int firstSlice;
+		int lastSlice;
+		std::vector<uint32_t> indices;
+		// candidate lights of a slice, four lights per SIMD group
+		std::vector<float> candidateX;
+		std::vector<float> candidateY;
+		std::vector<float> candidateZ;
+		std::vector<float> candidateRadius2;
+		std::vector<uint32_t> candidateIndex;
+	};
+
+	ShaderManager* m_pShaderManager;
+	bool m_bClustered;
+	std::vector<POINT_LIGHT> m_lights;
+	bool m_bLightsChanged;
+
+	// storage buffers of the lights, the clusters and the light indices
+	GLuint m_lightBuffer;
+	GLuint m_clusterBuffer;
+	GLuint m_indexBuffer;
+
+	// projection that the cluster bounds were built for
+	glm::mat4 m_projection;
+	float m_nearPlane;
+	float m_farPlane;
+	int m_viewportWidth;
+	int m_viewportHeight;
+	bool m_bBoundsValid;
+	std::vector<CLUSTER_BOUNDS> m_bounds;
+
+	// view space lights of the frame, padded to groups of four
+	std::vector<float> m_lightX;
+	std::vector<float> m_lightY;
+	std::vector<float> m_lightZ;
+	std::vector<float> m_lightRadius;
+	// light offset and count of every cluster, and the light indices
+	std::vector<uint32_t> m_clusterRanges;
+	std::vector<uint32_t> m_lightIndices;
+
+	// worker threads that assign the lights to the depth slices
+	std::vector<std::thread> m_workers;
+	std::vector<WORKER_OUTPUT> m_outputs;
+	std::mutex m_mutex;
+	std::condition_variable m_startCondition;
+	std::condition_variable m_doneCondition;
+	uint64_t m_generation;
+	int m_busyWorkers;
+	bool m_bShutdown;
+
+	void BuildClusterBounds();
+	void AssignLights();
+	void AssignSlices(WORKER_OUTPUT& output);
+	void WorkerLoop(int worker);
+	void UploadLights();
+	void SetUniformLights();
+};
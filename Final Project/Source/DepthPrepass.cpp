@@ -0,0 +1,353 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthprepass.cpp
+// ============
+// lay down the depth of the scene before the lit main pass
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DepthPrepass.h"
+
+#include <iostream>
+#include <fstream>
+
+// declaration of global variables
+namespace
+{
+	const char* g_ModelName = "model";
+	const char* g_ViewName = "view";
+	const char* g_ProjectionName = "projection";
+}
+
+/***********************************************************
+ *  DepthPrepass()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+DepthPrepass::DepthPrepass()
+{
+	m_pShaderManager = NULL;
+	m_modelLocation = -1;
+	m_bEnabled = true;
+	m_bMeasuring = false;
+	m_bFramePrepass = false;
+	m_frame = 0;
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		m_queries[i].query = 0;
+		m_queries[i].bPrepass = false;
+		m_queries[i].bPending = false;
+	}
+	m_nextQuery = 0;
+	m_bQueryActive = false;
+	for (int i = 0; i < 2; i++)
+	{
+		m_measuredFrames[i] = 0;
+		m_shadedFragments[i] = 0;
+	}
+}
+
+/***********************************************************
+ *  ~DepthPrepass()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+DepthPrepass::~DepthPrepass()
+{
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		if (m_queries[i].query != 0)
+		{
+			glDeleteQueries(1, &m_queries[i].query);
+			m_queries[i].query = 0;
+		}
+	}
+
+	if (NULL != m_pShaderManager)
+	{
+		delete m_pShaderManager;
+		m_pShaderManager = NULL;
+	}
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used to load the position only shaders of
+ *  the pre-pass.  The scene shaders are put back in use by
+ *  the caller.
+ ***********************************************************/
+bool DepthPrepass::Create(const char* vertexShaderPath, const char* fragmentShaderPath)
+{
+	m_pShaderManager = new ShaderManager();
+	m_pShaderManager->LoadShaders(vertexShaderPath, fragmentShaderPath);
+	if (m_pShaderManager->m_programID == 0)
+	{
+		std::cout << "Could not load the depth pre-pass shaders" << std::endl;
+		delete m_pShaderManager;
+		m_pShaderManager = NULL;
+		return(false);
+	}
+
+	m_modelLocation = glGetUniformLocation(m_pShaderManager->m_programID, g_ModelName);
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		glGenQueries(1, &m_queries[i].query);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsCreated()
+ *
+ *  This method is used to check whether the shaders of the
+ *  pre-pass were loaded.
+ ***********************************************************/
+bool DepthPrepass::IsCreated() const
+{
+	return(NULL != m_pShaderManager);
+}
+
+/***********************************************************
+ *  GetShaderManager()
+ *
+ *  This method is used to get the shaders of the pre-pass.
+ ***********************************************************/
+ShaderManager* DepthPrepass::GetShaderManager()
+{
+	return(m_pShaderManager);
+}
+
+/***********************************************************
+ *  SetEnabled()
+ *
+ *  This method is used to turn the pre-pass on or off.
+ ***********************************************************/
+void DepthPrepass::SetEnabled(bool bEnabled)
+{
+	m_bEnabled = bEnabled;
+}
+
+/***********************************************************
+ *  IsEnabled()
+ *
+ *  This method is used to check whether the pre-pass is on.
+ ***********************************************************/
+bool DepthPrepass::IsEnabled() const
+{
+	return(m_bEnabled);
+}
+
+/***********************************************************
+ *  SetMeasuring()
+ *
+ *  This method is used to turn on the measuring mode, where
+ *  every other frame is drawn without the pre-pass and the
+ *  shaded fragments of both kinds of frames are counted.
+ ***********************************************************/
+void DepthPrepass::SetMeasuring(bool bMeasuring)
+{
+	m_bMeasuring = bMeasuring;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used to decide whether the frame is drawn
+ *  with the pre-pass.
+ ***********************************************************/
+bool DepthPrepass::BeginFrame()
+{
+	if (IsCreated() == false)
+	{
+		m_bFramePrepass = false;
+	}
+	else if (m_bMeasuring == true)
+	{
+		m_bFramePrepass = ((m_frame % 2) == 1);
+	}
+	else
+	{
+		m_bFramePrepass = m_bEnabled;
+	}
+	m_frame++;
+
+	return(m_bFramePrepass);
+}
+
+/***********************************************************
+ *  BeginPrepass()
+ *
+ *  This method is used to switch to the depth only shaders
+ *  with the camera of the frame, and to turn off the color
+ *  writes.
+ ***********************************************************/
+void DepthPrepass::BeginPrepass(const glm::mat4& view, const glm::mat4& projection)
+{
+	m_pShaderManager->use();
+	m_pShaderManager->setMat4Value(g_ViewName, view);
+	m_pShaderManager->setMat4Value(g_ProjectionName, projection);
+
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
+}
+
+/***********************************************************
+ *  SetModel()
+ *
+ *  This method is used to set the model transformation of
+ *  the next draw of the pre-pass.
+ ***********************************************************/
+void DepthPrepass::SetModel(const glm::mat4& model)
+{
+	glUniformMatrix4fv(m_modelLocation, 1, GL_FALSE, &model[0][0]);
+}
+
+/***********************************************************
+ *  EndPrepass()
+ *
+ *  This method is used to switch back to the scene shaders
+ *  and set up the depth test of the main pass, which only
+ *  passes the fragments at the depth of the pre-pass and no
+ *  longer writes the depth.  The two passes use different
+ *  programs, and the invariant positions are not promised to
+ *  give the same depth across programs, so the test passes
+ *  the depths in front of the pre-pass too instead of
+ *  testing for equality.
+ ***********************************************************/
+void DepthPrepass::EndPrepass(ShaderManager* pSceneShaderManager)
+{
+	pSceneShaderManager->use();
+
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glDepthFunc(GL_LEQUAL);
+	glDepthMask(GL_FALSE);
+}
+
+/***********************************************************
+ *  BeginMainPass()
+ *
+ *  This method is used to start counting the samples that
+ *  pass the depth test of the main pass when measuring.
+ ***********************************************************/
+void DepthPrepass::BeginMainPass()
+{
+	if ((m_bMeasuring == false) || (IsCreated() == false))
+	{
+		return;
+	}
+
+	FRAGMENT_QUERY& fragmentQuery = m_queries[m_nextQuery];
+	ResolveQuery(fragmentQuery);
+
+	glBeginQuery(GL_SAMPLES_PASSED, fragmentQuery.query);
+	fragmentQuery.bPrepass = m_bFramePrepass;
+	fragmentQuery.bPending = true;
+	m_bQueryActive = true;
+}
+
+/***********************************************************
+ *  EndMainPass()
+ *
+ *  This method is used to stop counting the samples of the
+ *  main pass, and to restore the depth test of the scene
+ *  after a pre-pass.
+ ***********************************************************/
+void DepthPrepass::EndMainPass()
+{
+	if (m_bQueryActive == true)
+	{
+		glEndQuery(GL_SAMPLES_PASSED);
+		m_nextQuery = (m_nextQuery + 1) % FRAME_LATENCY;
+		m_bQueryActive = false;
+	}
+
+	if (m_bFramePrepass == true)
+	{
+		glDepthFunc(GL_LESS);
+		glDepthMask(GL_TRUE);
+	}
+}
+
+/***********************************************************
+ *  ResolveQuery()
+ *
+ *  This method is used to read back a pending query and add
+ *  its samples to the frames with or without the pre-pass.
+ ***********************************************************/
+void DepthPrepass::ResolveQuery(FRAGMENT_QUERY& fragmentQuery)
+{
+	if (fragmentQuery.bPending == false)
+	{
+		return;
+	}
+
+	GLuint64 samples = 0;
+	glGetQueryObjectui64v(fragmentQuery.query, GL_QUERY_RESULT, &samples);
+	fragmentQuery.bPending = false;
+
+	int index = (fragmentQuery.bPrepass == true) ? 1 : 0;
+	m_measuredFrames[index]++;
+	m_shadedFragments[index] += samples;
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the average number of shaded
+ *  fragments per frame with and without the pre-pass.  The
+ *  queries that are still pending are read back first.
+ ***********************************************************/
+void DepthPrepass::WriteReport(std::ostream& stream)
+{
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		ResolveQuery(m_queries[i]);
+	}
+
+	const char* names[] = { "without_prepass", "with_prepass" };
+	double average[2] = { 0.0, 0.0 };
+
+	stream << "# shaded fragments per frame of the main pass" << std::endl;
+	for (int i = 0; i < 2; i++)
+	{
+		if (m_measuredFrames[i] > 0)
+		{
+			average[i] = (double)m_shadedFragments[i] / (double)m_measuredFrames[i];
+		}
+		stream << names[i] << "_frames: " << m_measuredFrames[i] << std::endl;
+		stream << names[i] << "_fragments: " << (uint64_t)(average[i] + 0.5) << std::endl;
+	}
+	if (average[1] > 0.0)
+	{
+		stream << "overdraw_ratio: " << average[0] / average[1] << std::endl;
+	}
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the report into a file.
+ ***********************************************************/
+bool DepthPrepass::WriteReport(const char* filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create overdraw report file:" << filename << std::endl;
+		return(false);
+	}
+
+	WriteReport(file);
+	if (!file)
+	{
+		std::cout << "Could not write overdraw report file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote overdraw report file:" << filename << std::endl;
+
+	return(true);
+}
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthprepass.h
+// ============
+// lay down the depth of the scene before the lit main pass
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+
+#include <GL/glew.h>
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <ostream>
+#include <cstdint>
+
+/***********************************************************
+ *  DepthPrepass
+ *
+ *  This class contains the code for the depth pre-pass.  The
+ *  scene is first drawn with a position only shader and no
+ *  color writes, then the main pass only passes the depth
+ *  that is not behind it, so the lighting only runs once for
+ *  every pixel instead of for every object drawn over it.  In the
+ *  measuring mode, the frames alternate between drawing with
+ *  and without the pre-pass, and the samples that pass the
+ *  depth test of the main pass are counted as the fragments
+ *  that were shaded.
+ ***********************************************************/
+class DepthPrepass
+{
+public:
+	// constructor
+	DepthPrepass();
+	// destructor
+	~DepthPrepass();
+
+	// load the position only shaders
+	bool Create(const char* vertexShaderPath, const char* fragmentShaderPath);
+	bool IsCreated() const;
+	ShaderManager* GetShaderManager();
+
+	// turn the pre-pass on or off
+	void SetEnabled(bool bEnabled);
+	bool IsEnabled() const;
+	// alternate the frames with and without the pre-pass
+	void SetMeasuring(bool bMeasuring);
+
+	// decide whether the frame is drawn with the pre-pass
+	bool BeginFrame();
+
+	// switch to the depth only shaders and back
+	void BeginPrepass(const glm::mat4& view, const glm::mat4& projection);
+	void SetModel(const glm::mat4& model);
+	void EndPrepass(ShaderManager* pSceneShaderManager);
+
+	// count the fragments of the main pass and restore the depth test
+	void BeginMainPass();
+	void EndMainPass();
+
+	// write the shaded fragments per frame with and without the pre-pass
+	void WriteReport(std::ostream& stream);
+	bool WriteReport(const char* filename);
+
+private:
+	// frames that pass before the query of a frame is read back
+	static const int FRAME_LATENCY = 4;
+
+	struct FRAGMENT_QUERY
+	{
+		GLuint query;
+		bool bPrepass;
+		bool bPending;
+	};
+
+	ShaderManager* m_pShaderManager;
+	GLint m_modelLocation;
+	bool m_bEnabled;
+	bool m_bMeasuring;
+	// whether the current frame is drawn with the pre-pass
+	bool m_bFramePrepass;
+	uint64_t m_frame;
+
+	FRAGMENT_QUERY m_queries[FRAME_LATENCY];
+	int m_nextQuery;
+	bool m_bQueryActive;
+	// measured frames and fragments, without and with the pre-pass
+	uint64_t m_measuredFrames[2];
+	uint64_t m_shadedFragments[2];
+
+	// read back a query and add its fragments
+	void ResolveQuery(FRAGMENT_QUERY& fragmentQuery);
+};
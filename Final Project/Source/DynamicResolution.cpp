@@ -0,0 +1,387 @@
+///////////////////////////////////////////////////////////////////////////////
+// dynamicresolution.cpp
+// ============
+// adapt the render resolution of the scene to a target GPU frame time
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DynamicResolution.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	// limits of the resolution scale along each axis
+	const float g_MinScale = 0.25f;
+	const float g_MaxScale = 1.0f;
+	// the render size changes in steps, so small changes of the
+	// frame time do not resize the render targets every frame
+	const float g_ScaleStep = 0.05f;
+
+	// gains of the controller on the relative frame time error
+	const double g_ProportionalGain = 0.3;
+	const double g_IntegralGain = 0.05;
+
+	// GPU time that the scale is adapted to by default
+	const double g_DefaultTargetFrameTime = 16.0;
+}
+
+/***********************************************************
+ *  DynamicResolution()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+DynamicResolution::DynamicResolution()
+{
+	m_framebuffer = 0;
+	m_colorTexture = 0;
+	m_depthBuffer = 0;
+	m_targetWidth = 0;
+	m_targetHeight = 0;
+	m_windowWidth = 0;
+	m_windowHeight = 0;
+	m_renderWidth = 0;
+	m_renderHeight = 0;
+	m_pSharpenShaderManager = NULL;
+	m_emptyVertexArray = 0;
+	m_targetFrameTime = g_DefaultTargetFrameTime;
+	// the integral starts where the controller outputs full scale
+	m_integral = g_MaxScale / g_IntegralGain;
+	m_scale = g_MaxScale;
+
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		glGenQueries(1, &m_queries[i].beginQuery);
+		glGenQueries(1, &m_queries[i].endQuery);
+		m_queries[i].bPending = false;
+	}
+	m_nextQuery = 0;
+}
+
+/***********************************************************
+ *  ~DynamicResolution()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+DynamicResolution::~DynamicResolution()
+{
+	DestroyTarget();
+
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		glDeleteQueries(1, &m_queries[i].beginQuery);
+		glDeleteQueries(1, &m_queries[i].endQuery);
+	}
+
+	if (m_emptyVertexArray != 0)
+	{
+		glDeleteVertexArrays(1, &m_emptyVertexArray);
+		m_emptyVertexArray = 0;
+	}
+
+	if (NULL != m_pSharpenShaderManager)
+	{
+		delete m_pSharpenShaderManager;
+		m_pSharpenShaderManager = NULL;
+	}
+}
+
+/***********************************************************
+ *  SetTargetFrameTime()
+ *
+ *  This method is used to set the GPU time of the scene, in
+ *  milliseconds, that the resolution scale is adapted to.
+ ***********************************************************/
+void DynamicResolution::SetTargetFrameTime(double milliseconds)
+{
+	if (milliseconds > 0.0)
+	{
+		m_targetFrameTime = milliseconds;
+	}
+}
+
+/***********************************************************
+ *  CreateSharpening()
+ *
+ *  This method is used to load the shaders that upscale the
+ *  frame with sharpening.  The scene shaders are put back in
+ *  use by the caller.
+ ***********************************************************/
+bool DynamicResolution::CreateSharpening(const char* vertexShaderPath, const char* fragmentShaderPath, float sharpness)
+{
+	m_pSharpenShaderManager = new ShaderManager();
+	m_pSharpenShaderManager->LoadShaders(vertexShaderPath, fragmentShaderPath);
+	if (m_pSharpenShaderManager->m_programID == 0)
+	{
+		std::cout << "Could not load the upscale sharpening shaders" << std::endl;
+		delete m_pSharpenShaderManager;
+		m_pSharpenShaderManager = NULL;
+		return(false);
+	}
+
+	// the full screen triangle is made from the vertex index alone
+	glGenVertexArrays(1, &m_emptyVertexArray);
+
+	m_pSharpenShaderManager->use();
+	m_pSharpenShaderManager->setSampler2DValue("sourceTexture", 0);
+	m_pSharpenShaderManager->setFloatValue("sharpness", sharpness);
+
+	return(true);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used to redirect the rendering of the
+ *  frame into the part of the offscreen target that the
+ *  current scale covers, and to mark the start of its GPU
+ *  time.  The query slot is read back first when it still
+ *  holds the queries of an older frame.
+ ***********************************************************/
+void DynamicResolution::BeginFrame(int windowWidth, int windowHeight)
+{
+	m_windowWidth = std::max(1, windowWidth);
+	m_windowHeight = std::max(1, windowHeight);
+	if (((m_windowWidth != m_targetWidth) || (m_windowHeight != m_targetHeight) || (m_framebuffer == 0)) &&
+		(CreateTarget(m_windowWidth, m_windowHeight) == false))
+	{
+		m_renderWidth = m_windowWidth;
+		m_renderHeight = m_windowHeight;
+		return;
+	}
+
+	TIME_QUERY& timeQuery = m_queries[m_nextQuery];
+	ResolveQuery(timeQuery);
+
+	float scale = std::floor(m_scale / g_ScaleStep + 0.5f) * g_ScaleStep;
+	scale = std::min(std::max(scale, g_MinScale), g_MaxScale);
+	m_renderWidth = std::max(1, (int)(m_windowWidth * scale + 0.5f));
+	m_renderHeight = std::max(1, (int)(m_windowHeight * scale + 0.5f));
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, m_renderWidth, m_renderHeight);
+
+	glQueryCounter(timeQuery.beginQuery, GL_TIMESTAMP);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used to mark the end of the GPU time of
+ *  the frame and to upscale the rendered part of the target
+ *  to the whole window.
+ ***********************************************************/
+void DynamicResolution::EndFrame(ShaderManager* pSceneShaderManager)
+{
+	if (m_framebuffer == 0)
+	{
+		return;
+	}
+
+	TIME_QUERY& timeQuery = m_queries[m_nextQuery];
+	glQueryCounter(timeQuery.endQuery, GL_TIMESTAMP);
+	timeQuery.bPending = true;
+	m_nextQuery = (m_nextQuery + 1) % FRAME_LATENCY;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, m_windowWidth, m_windowHeight);
+
+	if (NULL == m_pSharpenShaderManager)
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+		glBlitFramebuffer(
+			0, 0, m_renderWidth, m_renderHeight,
+			0, 0, m_windowWidth, m_windowHeight,
+			GL_COLOR_BUFFER_BIT,
+			GL_LINEAR);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+		return;
+	}
+
+	// the sharpening shader reads the rendered part of the target
+	// through texture unit 0, which is rebound to its scene texture
+	GLint savedTexture = 0;
+	glActiveTexture(GL_TEXTURE0);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &savedTexture);
+	glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+
+	m_pSharpenShaderManager->use();
+	m_pSharpenShaderManager->setVec2Value("sourceScale", glm::vec2(
+		(float)m_renderWidth / (float)m_targetWidth,
+		(float)m_renderHeight / (float)m_targetHeight));
+	m_pSharpenShaderManager->setVec2Value("sourceTexelSize", glm::vec2(
+		1.0f / (float)m_targetWidth,
+		1.0f / (float)m_targetHeight));
+
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_BLEND);
+	glBindVertexArray(m_emptyVertexArray);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	glEnable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+
+	glBindTexture(GL_TEXTURE_2D, (GLuint)savedTexture);
+	pSceneShaderManager->use();
+}
+
+/***********************************************************
+ *  GetRenderWidth()
+ *
+ *  This method is used to get the width that the scene is
+ *  rendered at in the current frame.
+ ***********************************************************/
+int DynamicResolution::GetRenderWidth() const
+{
+	return(m_renderWidth);
+}
+
+/***********************************************************
+ *  GetRenderHeight()
+ *
+ *  This method is used to get the height that the scene is
+ *  rendered at in the current frame.
+ ***********************************************************/
+int DynamicResolution::GetRenderHeight() const
+{
+	return(m_renderHeight);
+}
+
+/***********************************************************
+ *  GetScale()
+ *
+ *  This method is used to get the resolution scale that the
+ *  controller currently asks for.
+ ***********************************************************/
+float DynamicResolution::GetScale() const
+{
+	return(m_scale);
+}
+
+/***********************************************************
+ *  CreateTarget()
+ *
+ *  This method is used to allocate the offscreen target at
+ *  the full window size.  Lower scales only render into a
+ *  part of it, so it is not reallocated when the scale
+ *  changes.
+ ***********************************************************/
+bool DynamicResolution::CreateTarget(int width, int height)
+{
+	DestroyTarget();
+
+	GLint savedTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &savedTexture);
+
+	glGenTextures(1, &m_colorTexture);
+	glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)savedTexture);
+
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Dynamic resolution framebuffer is incomplete" << std::endl;
+		DestroyTarget();
+		return(false);
+	}
+
+	m_targetWidth = width;
+	m_targetHeight = height;
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyTarget()
+ *
+ *  This method is used to free the offscreen target.
+ ***********************************************************/
+void DynamicResolution::DestroyTarget()
+{
+	if (m_framebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	if (m_colorTexture != 0)
+	{
+		glDeleteTextures(1, &m_colorTexture);
+		m_colorTexture = 0;
+	}
+	if (m_depthBuffer != 0)
+	{
+		glDeleteRenderbuffers(1, &m_depthBuffer);
+		m_depthBuffer = 0;
+	}
+	m_targetWidth = 0;
+	m_targetHeight = 0;
+}
+
+/***********************************************************
+ *  ResolveQuery()
+ *
+ *  This method is used to read back the timestamps of a
+ *  pending frame and update the scale with its GPU time.
+ ***********************************************************/
+void DynamicResolution::ResolveQuery(TIME_QUERY& timeQuery)
+{
+	if (timeQuery.bPending == false)
+	{
+		return;
+	}
+
+	GLuint64 beginTime = 0;
+	GLuint64 endTime = 0;
+	glGetQueryObjectui64v(timeQuery.beginQuery, GL_QUERY_RESULT, &beginTime);
+	glGetQueryObjectui64v(timeQuery.endQuery, GL_QUERY_RESULT, &endTime);
+	timeQuery.bPending = false;
+
+	if (endTime > beginTime)
+	{
+		UpdateScale((double)(endTime - beginTime) / 1000000.0);
+	}
+}
+
+/***********************************************************
+ *  UpdateScale()
+ *
+ *  This method is used to run the controller on a measured
+ *  GPU time.  The error is relative to the target, so the
+ *  gains work for any target, and the integral only grows
+ *  while the scale is within its limits, so it does not wind
+ *  up while the scale is held at a limit.
+ ***********************************************************/
+void DynamicResolution::UpdateScale(double gpuMilliseconds)
+{
+	double error = (m_targetFrameTime - gpuMilliseconds) / m_targetFrameTime;
+	error = std::min(std::max(error, -1.0), 1.0);
+
+	double integral = m_integral + error;
+	double output = g_ProportionalGain * error + g_IntegralGain * integral;
+	if ((output >= g_MinScale) && (output <= g_MaxScale))
+	{
+		m_integral = integral;
+	}
+
+	m_scale = (float)std::min(std::max(output, (double)g_MinScale), (double)g_MaxScale);
+}
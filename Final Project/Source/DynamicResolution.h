@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+// dynamicresolution.h
+// ============
+// adapt the render resolution of the scene to a target GPU frame time
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  DynamicResolution
+ *
+ *  This class contains the code for dynamic resolution
+ *  scaling.  The scene is rendered into an offscreen target
+ *  with a fraction of the window size, and the GPU time of
+ *  the scene is measured with timestamp queries that are
+ *  read back a few frames later.  A proportional-integral
+ *  controller turns the difference to the target frame time
+ *  into the resolution scale of the next frames, and the
+ *  result is upscaled to the window with a bilinear blit, or
+ *  with a sharpening shader that restores some of the detail
+ *  lost to the lower resolution.
+ ***********************************************************/
+class DynamicResolution
+{
+public:
+	// constructor
+	DynamicResolution();
+	// destructor
+	~DynamicResolution();
+
+	// set the GPU time of the scene that the scale is adapted to
+	void SetTargetFrameTime(double milliseconds);
+	// load the sharpening shaders, without them the blit is bilinear
+	bool CreateSharpening(const char* vertexShaderPath, const char* fragmentShaderPath, float sharpness);
+
+	// render the frame into the scaled target
+	void BeginFrame(int windowWidth, int windowHeight);
+	// upscale the frame to the window and put the scene shaders back
+	void EndFrame(ShaderManager* pSceneShaderManager);
+
+	// get the size that the scene is rendered at
+	int GetRenderWidth() const;
+	int GetRenderHeight() const;
+	float GetScale() const;
+
+private:
+	// frames that pass before the queries of a frame are read back
+	static const int FRAME_LATENCY = 4;
+
+	struct TIME_QUERY
+	{
+		GLuint beginQuery;
+		GLuint endQuery;
+		bool bPending;
+	};
+
+	// offscreen target at the full window size, rendered in part
+	GLuint m_framebuffer;
+	GLuint m_colorTexture;
+	GLuint m_depthBuffer;
+	int m_targetWidth;
+	int m_targetHeight;
+	int m_windowWidth;
+	int m_windowHeight;
+	int m_renderWidth;
+	int m_renderHeight;
+
+	// sharpening upscale
+	ShaderManager* m_pSharpenShaderManager;
+	GLuint m_emptyVertexArray;
+
+	// controller state
+	double m_targetFrameTime;
+	double m_integral;
+	float m_scale;
+
+	TIME_QUERY m_queries[FRAME_LATENCY];
+	int m_nextQuery;
+
+	// reallocate the target for a new window size
+	bool CreateTarget(int width, int height);
+	void DestroyTarget();
+	// read back a query and feed its GPU time to the controller
+	void ResolveQuery(TIME_QUERY& timeQuery);
+	void UpdateScale(double gpuMilliseconds);
+};
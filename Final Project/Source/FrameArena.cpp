@@ -0,0 +1,265 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.cpp
+// ============
+// allocate the transient data of a frame from a reused block of memory
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameArena.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstdint>
+
+// declaration of global variables
+namespace
+{
+	// the blocks grow in steps of this size, so a frame that
+	// needs a little more does not grow them every time
+	const size_t g_GrowStep = 64 * 1024;
+
+	/***********************************************************
+	 *  AlignUp()
+	 *
+	 *  Round a size or an address up to a multiple of an
+	 *  alignment, which is a power of two.
+	 ***********************************************************/
+	size_t AlignUp(size_t value, size_t alignment)
+	{
+		return((value + alignment - 1) & ~(alignment - 1));
+	}
+}
+
+/***********************************************************
+ *  FrameArena()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameArena::FrameArena(size_t frameBytes)
+{
+	for (int i = 0; i < BUFFER_COUNT; i++)
+	{
+		FRAME_BUFFER& buffer = m_buffers[i];
+		buffer.pStorage = NULL;
+		buffer.pMemory = NULL;
+		buffer.capacity = 0;
+		buffer.used = 0;
+		buffer.lastOffset = 0;
+		buffer.overflowBytes = 0;
+		GrowBuffer(buffer, frameBytes);
+	}
+	m_currentBuffer = 0;
+	m_bFrameStarted = false;
+
+	m_frameCount = 0;
+	m_peakBytes = 0;
+	m_totalBytes = 0.0;
+	m_overflowAllocations = 0;
+	m_overflowBytesTotal = 0;
+	m_growCount = 0;
+}
+
+/***********************************************************
+ *  ~FrameArena()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameArena::~FrameArena()
+{
+	for (int i = 0; i < BUFFER_COUNT; i++)
+	{
+		ReleaseOverflow(m_buffers[i]);
+		delete[] m_buffers[i].pStorage;
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used to finish the frame that was being
+ *  allocated and to start the next one in the other block.
+ *  The block was last used two frames ago, so nothing of
+ *  that frame is in use any more.  The block is grown first
+ *  when a frame needed more than it holds.
+ ***********************************************************/
+void FrameArena::BeginFrame()
+{
+	if (m_bFrameStarted == true)
+	{
+		size_t frameBytes = GetFrameBytes();
+		if (frameBytes > m_peakBytes)
+		{
+			m_peakBytes = frameBytes;
+		}
+		m_totalBytes += (double)frameBytes;
+		m_frameCount++;
+	}
+	m_bFrameStarted = true;
+
+	m_currentBuffer = (m_currentBuffer + 1) % BUFFER_COUNT;
+	FRAME_BUFFER& buffer = m_buffers[m_currentBuffer];
+	ReleaseOverflow(buffer);
+	if (buffer.capacity < m_peakBytes)
+	{
+		GrowBuffer(buffer, m_peakBytes);
+		m_growCount++;
+	}
+	buffer.used = 0;
+	buffer.lastOffset = 0;
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  This method is used to allocate memory for the current
+ *  frame by moving the top of its block up to the next cache
+ *  line.  When the block is full, the memory is taken from
+ *  the heap and freed when the block is used again.
+ ***********************************************************/
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	if (alignment < CACHE_LINE_SIZE)
+	{
+		alignment = CACHE_LINE_SIZE;
+	}
+
+	FRAME_BUFFER& buffer = m_buffers[m_currentBuffer];
+	size_t offset = AlignUp(buffer.used, alignment);
+	if ((offset <= buffer.capacity) && (size <= buffer.capacity - offset))
+	{
+		buffer.lastOffset = offset;
+		buffer.used = offset + size;
+		return(buffer.pMemory + offset);
+	}
+
+	// the block is full, so the allocation is counted with the
+	// frame and the block is grown before it is used again
+	unsigned char* pStorage = new unsigned char[size + alignment];
+	buffer.overflow.push_back(pStorage);
+	buffer.overflowBytes += size + alignment;
+	m_overflowAllocations++;
+	m_overflowBytesTotal += size + alignment;
+
+	return((unsigned char*)AlignUp((size_t)(uintptr_t)pStorage, alignment));
+}
+
+/***********************************************************
+ *  Deallocate()
+ *
+ *  This method is used to give back memory of the current
+ *  frame.  Only the last allocation of the block can be used
+ *  again, like a container that grows and frees its old
+ *  elements; the rest is reused with the whole block.
+ ***********************************************************/
+void FrameArena::Deallocate(void* pMemory, size_t size)
+{
+	FRAME_BUFFER& buffer = m_buffers[m_currentBuffer];
+	if ((pMemory == buffer.pMemory + buffer.lastOffset) &&
+		(buffer.lastOffset + size == buffer.used))
+	{
+		buffer.used = buffer.lastOffset;
+	}
+}
+
+/***********************************************************
+ *  GetFrameBytes()
+ *
+ *  This method is used to get the bytes allocated by the
+ *  current frame, including the padding to the cache lines
+ *  and the allocations that did not fit in the block.
+ ***********************************************************/
+size_t FrameArena::GetFrameBytes() const
+{
+	const FRAME_BUFFER& buffer = m_buffers[m_currentBuffer];
+	return(buffer.used + buffer.overflowBytes);
+}
+
+/***********************************************************
+ *  GetPeakBytes()
+ *
+ *  This method is used to get the most bytes allocated by a
+ *  finished frame.
+ ***********************************************************/
+size_t FrameArena::GetPeakBytes() const
+{
+	return(m_peakBytes);
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the size of the blocks, the
+ *  peak and mean bytes allocated per frame, and how often a
+ *  frame did not fit and took memory from the heap.
+ ***********************************************************/
+void FrameArena::WriteReport(std::ostream& stream)
+{
+	stream << "# frame arena allocations" << std::endl;
+	stream << "frames: " << m_frameCount << std::endl;
+	stream << "block_bytes: " << m_buffers[m_currentBuffer].capacity << std::endl;
+	stream << "peak_frame_bytes: " << m_peakBytes << std::endl;
+	stream << "mean_frame_bytes: " << ((m_frameCount > 0) ? m_totalBytes / (double)m_frameCount : 0.0) << std::endl;
+	stream << "overflow_allocations: " << m_overflowAllocations << std::endl;
+	stream << "overflow_bytes: " << m_overflowBytesTotal << std::endl;
+	stream << "grown_blocks: " << m_growCount << std::endl;
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the report into a file.
+ ***********************************************************/
+bool FrameArena::WriteReport(const char* filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create frame arena report file:" << filename << std::endl;
+		return(false);
+	}
+
+	WriteReport(file);
+	if (!file)
+	{
+		std::cout << "Could not write frame arena report file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote frame arena report file:" << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GrowBuffer()
+ *
+ *  This method is used to replace the memory of a block with
+ *  a larger one, rounded up to the grow step, with its first
+ *  byte on a cache line.
+ ***********************************************************/
+void FrameArena::GrowBuffer(FRAME_BUFFER& buffer, size_t capacity)
+{
+	capacity = AlignUp(capacity, g_GrowStep);
+	delete[] buffer.pStorage;
+
+	buffer.pStorage = new unsigned char[capacity + CACHE_LINE_SIZE];
+	buffer.pMemory = (unsigned char*)AlignUp((size_t)(uintptr_t)buffer.pStorage, CACHE_LINE_SIZE);
+	buffer.capacity = capacity;
+}
+
+/***********************************************************
+ *  ReleaseOverflow()
+ *
+ *  This method is used to free the allocations of a block
+ *  that were taken from the heap.
+ ***********************************************************/
+void FrameArena::ReleaseOverflow(FRAME_BUFFER& buffer)
+{
+	for (size_t i = 0; i < buffer.overflow.size(); i++)
+	{
+		delete[] (unsigned char*)buffer.overflow[i];
+	}
+	buffer.overflow.clear();
+	buffer.overflowBytes = 0;
+}
@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.h
+// ============
+// allocate the transient data of a frame from a reused block of memory
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <ostream>
+#include <vector>
+#include <new>
+#include <type_traits>
+#include <cstddef>
+
+/***********************************************************
+ *  FrameArena
+ *
+ *  This class contains the code for allocating the data that
+ *  only lives for a frame or two, like the draw list and its
+ *  sort keys, without going through the heap.  Two blocks of
+ *  memory are used in turn, one per frame, and every
+ *  allocation just moves the top of the block of the frame
+ *  up to the next cache line.  Nothing is freed on its own;
+ *  the whole block is reused two frames later, so the data
+ *  of the last frame stays valid while the next one is
+ *  built.  When a frame needs more than its block holds, the
+ *  rest is taken from the heap, and the blocks are grown to
+ *  the largest frame before they are used again.  The arena
+ *  is only used from the render thread.
+ ***********************************************************/
+class FrameArena
+{
+public:
+	// the allocations start on a cache line, so the data of
+	// different containers never shares one
+	static const size_t CACHE_LINE_SIZE = 64;
+
+	// constructor
+	FrameArena(size_t frameBytes);
+	// destructor
+	~FrameArena();
+
+	// reuse the block of the frame before the last one for the
+	// allocations of the next frame
+	void BeginFrame();
+
+	// allocate memory for the current frame, or give back the
+	// last allocation so it can be used again
+	void* Allocate(size_t size, size_t alignment);
+	void Deallocate(void* pMemory, size_t size);
+
+	// get the bytes allocated by the current frame, and the most
+	// allocated by a finished frame
+	size_t GetFrameBytes() const;
+	size_t GetPeakBytes() const;
+
+	// write the size of the blocks and the bytes used per frame
+	void WriteReport(std::ostream& stream);
+	bool WriteReport(const char* filename);
+
+private:
+	// the frames that the blocks are used in turn for
+	static const int BUFFER_COUNT = 2;
+
+	struct FRAME_BUFFER
+	{
+		// memory from the heap, and its first cache line
+		unsigned char* pStorage;
+		unsigned char* pMemory;
+		size_t capacity;
+		// bytes used, and where the last allocation starts
+		size_t used;
+		size_t lastOffset;
+		// allocations that did not fit, which are freed when the
+		// block is used again
+		std::vector<void*> overflow;
+		size_t overflowBytes;
+	};
+
+	FRAME_BUFFER m_buffers[BUFFER_COUNT];
+	int m_currentBuffer;
+	bool m_bFrameStarted;
+
+	// totals of the finished frames
+	size_t m_frameCount;
+	size_t m_peakBytes;
+	double m_totalBytes;
+	size_t m_overflowAllocations;
+	size_t m_overflowBytesTotal;
+	size_t m_growCount;
+
+	// replace the memory of a block with a larger one
+	void GrowBuffer(FRAME_BUFFER& buffer, size_t capacity);
+	void ReleaseOverflow(FRAME_BUFFER& buffer);
+};
+
+/***********************************************************
+ *  FrameArenaAllocator
+ *
+ *  This class template lets the standard containers allocate
+ *  their elements from a frame arena.  The container must be
+ *  let go of before the arena reuses its block, two frames
+ *  later.  An allocator without an arena uses the heap, so a
+ *  container can be declared before its arena exists.
+ ***********************************************************/
+template<class T>
+class FrameArenaAllocator
+{
+public:
+	typedef T value_type;
+	// a container that is assigned or swapped takes the arena of
+	// the other container along with its memory
+	typedef std::true_type propagate_on_container_copy_assignment;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+
+	FrameArenaAllocator()
+	{
+		m_pArena = NULL;
+	}
+
+	FrameArenaAllocator(FrameArena* pArena)
+	{
+		m_pArena = pArena;
+	}
+
+	template<class U>
+	FrameArenaAllocator(const FrameArenaAllocator<U>& other)
+	{
+		m_pArena = other.GetArena();
+	}
+
+	T* allocate(size_t count)
+	{
+		if (NULL == m_pArena)
+		{
+			return((T*)::operator new(count * sizeof(T)));
+		}
+		return((T*)m_pArena->Allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* pMemory, size_t count)
+	{
+		if (NULL == m_pArena)
+		{
+			::operator delete(pMemory);
+			return;
+		}
+		m_pArena->Deallocate(pMemory, count * sizeof(T));
+	}
+
+	FrameArena* GetArena() const
+	{
+		return(m_pArena);
+	}
+
+private:
+	FrameArena* m_pArena;
+};
+
+template<class T, class U>
+bool operator==(const FrameArenaAllocator<T>& first, const FrameArenaAllocator<U>& second)
+{
+	return(first.GetArena() == second.GetArena());
+}
+
+template<class T, class U>
+bool operator!=(const FrameArenaAllocator<T>& first, const FrameArenaAllocator<U>& second)
+{
+	return(first.GetArena() != second.GetArena());
+}
+
+// a vector whose elements are allocated from a frame arena
+template<class T>
+using FrameVector = std::vector<T, FrameArenaAllocator<T> >;
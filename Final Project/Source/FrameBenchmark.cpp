@@ -0,0 +1,638 @@
+///////////////////////////////////////////////////////////////////////////////
+// framebenchmark.cpp
+// ============
+// measure the frame times along a scripted camera path and report them
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameBenchmark.h"
+#include "FramePacer.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	struct CAMERA_KEYFRAME
+	{
+		glm::vec3 position;
+		glm::vec3 target;
+	};
+
+	// closed camera path around the objects on the desk, starting
+	// from the default view of the scene
+	const CAMERA_KEYFRAME g_CameraPath[] =
+	{
+		{ glm::vec3(0.0f, 5.0f, 23.0f), glm::vec3(0.0f, 1.0f, 4.0f) },
+		{ glm::vec3(12.0f, 6.0f, 18.0f), glm::vec3(4.0f, 1.0f, 8.0f) },
+		{ glm::vec3(16.0f, 4.0f, 6.0f), glm::vec3(6.0f, 1.0f, 8.0f) },
+		{ glm::vec3(7.0f, 3.0f, 15.0f), glm::vec3(5.0f, 1.0f, 9.0f) },
+		{ glm::vec3(-2.0f, 4.0f, 16.0f), glm::vec3(-4.0f, 1.0f, 10.0f) },
+		{ glm::vec3(-12.0f, 7.0f, 16.0f), glm::vec3(2.0f, 2.0f, 4.0f) },
+		{ glm::vec3(-6.0f, 12.0f, 22.0f), glm::vec3(0.0f, 1.0f, 4.0f) }
+	};
+	const int g_CameraKeyframeCount = sizeof(g_CameraPath) / sizeof(g_CameraPath[0]);
+
+	// number of batches that the frame times are averaged in for
+	// the significance test
+	const int g_BatchCount = 20;
+	// a regression must be significant at this level and slower by
+	// at least this fraction to be flagged
+	const double g_SignificanceLevel = 0.01;
+	const double g_MinimumRegression = 0.03;
+
+	/***********************************************************
+	 *  CatmullRom()
+	 *
+	 *  This function is used to interpolate smoothly between the
+	 *  two middle points of four consecutive path points.
+	 ***********************************************************/
+	glm::vec3 CatmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t)
+	{
+		float t2 = t * t;
+		float t3 = t2 * t;
+
+		return(0.5f * ((2.0f * p1) +
+			(p2 - p0) * t +
+			(2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+			(3.0f * p1 - p0 - 3.0f * p2 + p3) * t3));
+	}
+
+	/***********************************************************
+	 *  BetaContinuedFraction()
+	 *
+	 *  This function is used to evaluate the continued fraction
+	 *  of the incomplete beta function with Lentz's method.
+	 ***********************************************************/
+	double BetaContinuedFraction(double a, double b, double x)
+	{
+		const double tiny = 1.0e-300;
+		double c = 1.0;
+		double d = 1.0 - (a + b) * x / (a + 1.0);
+		if (std::fabs(d) < tiny)
+		{
+			d = tiny;
+		}
+		d = 1.0 / d;
+		double result = d;
+
+		for (int m = 1; m <= 300; m++)
+		{
+			int m2 = 2 * m;
+
+			// even step of the recurrence
+			double aa = m * (b - m) * x / ((a - 1.0 + m2) * (a + m2));
+			d = 1.0 + aa * d;
+			if (std::fabs(d) < tiny)
+			{
+				d = tiny;
+			}
+			c = 1.0 + aa / c;
+			if (std::fabs(c) < tiny)
+			{
+				c = tiny;
+			}
+			d = 1.0 / d;
+			result *= d * c;
+
+			// odd step of the recurrence
+			aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + 1.0 + m2));
+			d = 1.0 + aa * d;
+			if (std::fabs(d) < tiny)
+			{
+				d = tiny;
+			}
+			c = 1.0 + aa / c;
+			if (std::fabs(c) < tiny)
+			{
+				c = tiny;
+			}
+			d = 1.0 / d;
+			double delta = d * c;
+			result *= delta;
+
+			if (std::fabs(delta - 1.0) < 1.0e-12)
+			{
+				break;
+			}
+		}
+
+		return(result);
+	}
+
+	/***********************************************************
+	 *  IncompleteBeta()
+	 *
+	 *  This function is used to calculate the regularized
+	 *  incomplete beta function I_x(a, b).
+	 ***********************************************************/
+	double IncompleteBeta(double a, double b, double x)
+	{
+		if (x <= 0.0)
+		{
+			return(0.0);
+		}
+		if (x >= 1.0)
+		{
+			return(1.0);
+		}
+
+		double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+			a * std::log(x) + b * std::log(1.0 - x));
+
+		// the continued fraction converges quickly on this side
+		if (x < (a + 1.0) / (a + b + 2.0))
+		{
+			return(front * BetaContinuedFraction(a, b, x) / a);
+		}
+
+		return(1.0 - front * BetaContinuedFraction(b, a, 1.0 - x) / b);
+	}
+
+	/***********************************************************
+	 *  StudentTUpperTail()
+	 *
+	 *  This function is used to calculate the probability that
+	 *  a Student's t variable with the given degrees of freedom
+	 *  is larger than t.
+	 ***********************************************************/
+	double StudentTUpperTail(double t, double degreesOfFreedom)
+	{
+		double tail = 0.5 * IncompleteBeta(0.5 * degreesOfFreedom, 0.5, degreesOfFreedom / (degreesOfFreedom + t * t));
+
+		return((t > 0.0) ? tail : (1.0 - tail));
+	}
+
+	/***********************************************************
+	 *  Percentile()
+	 *
+	 *  This function is used to get a percentile of sorted values
+	 *  with the nearest rank method.
+	 ***********************************************************/
+	double Percentile(const std::vector<double>& sortedValues, double percent)
+	{
+		if (sortedValues.size() == 0)
+		{
+			return(0.0);
+		}
+
+		size_t rank = (size_t)std::ceil(percent / 100.0 * (double)sortedValues.size());
+		rank = std::max<size_t>(rank, 1);
+		rank = std::min<size_t>(rank, sortedValues.size());
+
+		return(sortedValues[rank - 1]);
+	}
+}
+
+/***********************************************************
+ *  FrameBenchmark()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameBenchmark::FrameBenchmark(int frameCount, int warmupFrames)
+{
+	m_frameCount = std::max(frameCount, 1);
+	m_warmupFrames = std::max(warmupFrames, 0);
+	m_frame = 0;
+	m_frameStartTime = 0.0;
+	m_bResolved = false;
+
+	// every measured frame gets its own queries, which are only
+	// read when the benchmark is done so that nothing stalls
+	m_timeQueries.resize(m_frameCount);
+	m_primitiveQueries.resize(m_frameCount);
+	glGenQueries(m_frameCount, m_timeQueries.data());
+	glGenQueries(m_frameCount, m_primitiveQueries.data());
+	m_samples.reserve(m_frameCount);
+}
+
+/***********************************************************
+ *  ~FrameBenchmark()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameBenchmark::~FrameBenchmark()
+{
+	glDeleteQueries((GLsizei)m_timeQueries.size(), m_timeQueries.data());
+	glDeleteQueries((GLsizei)m_primitiveQueries.size(), m_primitiveQueries.data());
+}
+
+/***********************************************************
+ *  IsFinished()
+ *
+ *  This method is used to check whether the warmup frames and
+ *  all of the measured frames have been rendered.
+ ***********************************************************/
+bool FrameBenchmark::IsFinished() const
+{
+	return(m_frame >= m_warmupFrames + m_frameCount);
+}
+
+/***********************************************************
+ *  GetCameraPose()
+ *
+ *  This method is used to get the camera position and view
+ *  direction of the current frame.  The camera goes around
+ *  the closed path once over the measured frames, and the
+ *  warmup frames are rendered from the start of the path.
+ ***********************************************************/
+void FrameBenchmark::GetCameraPose(glm::vec3& position, glm::vec3& front) const
+{
+	int frame = std::max(m_frame - m_warmupFrames, 0);
+	float pathTime = (float)frame / (float)m_frameCount * (float)g_CameraKeyframeCount;
+	int keyframe = (int)pathTime;
+	float t = pathTime - (float)keyframe;
+
+	const CAMERA_KEYFRAME& k0 = g_CameraPath[(keyframe + g_CameraKeyframeCount - 1) % g_CameraKeyframeCount];
+	const CAMERA_KEYFRAME& k1 = g_CameraPath[keyframe % g_CameraKeyframeCount];
+	const CAMERA_KEYFRAME& k2 = g_CameraPath[(keyframe + 1) % g_CameraKeyframeCount];
+	const CAMERA_KEYFRAME& k3 = g_CameraPath[(keyframe + 2) % g_CameraKeyframeCount];
+
+	position = CatmullRom(k0.position, k1.position, k2.position, k3.position, t);
+	glm::vec3 target = CatmullRom(k0.target, k1.target, k2.target, k3.target, t);
+	front = glm::normalize(target - position);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used to start measuring the current frame.
+ ***********************************************************/
+void FrameBenchmark::BeginFrame()
+{
+	int sample = m_frame - m_warmupFrames;
+	if ((sample >= 0) && (sample < m_frameCount))
+	{
+		glBeginQuery(GL_TIME_ELAPSED, m_timeQueries[sample]);
+		glBeginQuery(GL_PRIMITIVES_GENERATED, m_primitiveQueries[sample]);
+	}
+
+	m_frameStartTime = FramePacer::GetTime();
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used to finish measuring the current frame
+ *  and to move on to the next frame of the path.
+ ***********************************************************/
+void FrameBenchmark::EndFrame(int drawCount)
+{
+	double cpuTime = FramePacer::GetTime() - m_frameStartTime;
+
+	int sample = m_frame - m_warmupFrames;
+	if ((sample >= 0) && (sample < m_frameCount))
+	{
+		glEndQuery(GL_PRIMITIVES_GENERATED);
+		glEndQuery(GL_TIME_ELAPSED);
+
+		FRAME_SAMPLE frameSample;
+		frameSample.cpuTime = cpuTime;
+		frameSample.gpuTime = 0.0;
+		frameSample.drawCount = drawCount;
+		frameSample.triangleCount = 0;
+		m_samples.push_back(frameSample);
+	}
+
+	m_frame++;
+}
+
+/***********************************************************
+ *  ResolveQueries()
+ *
+ *  This method is used to read the GPU time and the number
+ *  of triangles of every measured frame.
+ ***********************************************************/
+void FrameBenchmark::ResolveQueries()
+{
+	if (m_bResolved == true)
+	{
+		return;
+	}
+
+	glFinish();
+	for (size_t i = 0; i < m_samples.size(); i++)
+	{
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(m_timeQueries[i], GL_QUERY_RESULT, &elapsed);
+		glGetQueryObjectui64v(m_primitiveQueries[i], GL_QUERY_RESULT, &m_samples[i].triangleCount);
+		m_samples[i].gpuTime = (double)elapsed / 1000000000.0;
+	}
+
+	m_bResolved = true;
+}
+
+/***********************************************************
+ *  GetResults()
+ *
+ *  This method is used to get the CPU and GPU times of the
+ *  measured frames in milliseconds, and their average number
+ *  of draws and triangles.
+ ***********************************************************/
+void FrameBenchmark::GetResults(std::vector<double>& cpuTimes, std::vector<double>& gpuTimes, double& drawCount, double& triangleCount)
+{
+	ResolveQueries();
+
+	for (size_t i = 0; i < m_samples.size(); i++)
+	{
+		cpuTimes.push_back(m_samples[i].cpuTime * 1000.0);
+		gpuTimes.push_back(m_samples[i].gpuTime * 1000.0);
+		drawCount += (double)m_samples[i].drawCount;
+		triangleCount += (double)m_samples[i].triangleCount;
+	}
+	if (m_samples.size() > 0)
+	{
+		drawCount /= (double)m_samples.size();
+		triangleCount /= (double)m_samples.size();
+	}
+}
+
+/***********************************************************
+ *  CalculateStatistics()
+ *
+ *  This method is used to calculate the mean, the standard
+ *  deviation and the percentiles of a series of frame times
+ *  in milliseconds.  Consecutive frames are correlated, so
+ *  the series is also split into batches whose means are
+ *  used to test the significance of a change.
+ ***********************************************************/
+FrameBenchmark::FRAME_STATISTICS FrameBenchmark::CalculateStatistics(std::vector<double> times)
+{
+	FRAME_STATISTICS statistics;
+	statistics.sampleCount = (int)times.size();
+	statistics.mean = 0.0;
+	statistics.stddev = 0.0;
+	statistics.p50 = 0.0;
+	statistics.p95 = 0.0;
+	statistics.p99 = 0.0;
+	statistics.batchCount = 0;
+	statistics.batchStddev = 0.0;
+
+	if (times.size() == 0)
+	{
+		return(statistics);
+	}
+
+	double total = 0.0;
+	for (size_t i = 0; i < times.size(); i++)
+	{
+		total += times[i];
+	}
+	statistics.mean = total / (double)times.size();
+
+	double squares = 0.0;
+	for (size_t i = 0; i < times.size(); i++)
+	{
+		squares += (times[i] - statistics.mean) * (times[i] - statistics.mean);
+	}
+	if (times.size() > 1)
+	{
+		statistics.stddev = std::sqrt(squares / (double)(times.size() - 1));
+	}
+
+	// the batches are formed in frame order, before sorting
+	int batchCount = std::min(g_BatchCount, (int)times.size() / 2);
+	if (batchCount >= 2)
+	{
+		size_t batchSize = times.size() / batchCount;
+		std::vector<double> batchMeans(batchCount, 0.0);
+		double batchTotal = 0.0;
+		for (int batch = 0; batch < batchCount; batch++)
+		{
+			for (size_t i = 0; i < batchSize; i++)
+			{
+				batchMeans[batch] += times[batch * batchSize + i];
+			}
+			batchMeans[batch] /= (double)batchSize;
+			batchTotal += batchMeans[batch];
+		}
+
+		double batchMean = batchTotal / (double)batchCount;
+		double batchSquares = 0.0;
+		for (int batch = 0; batch < batchCount; batch++)
+		{
+			batchSquares += (batchMeans[batch] - batchMean) * (batchMeans[batch] - batchMean);
+		}
+		statistics.batchCount = batchCount;
+		statistics.batchStddev = std::sqrt(batchSquares / (double)(batchCount - 1));
+	}
+
+	std::sort(times.begin(), times.end());
+	statistics.p50 = Percentile(times, 50.0);
+	statistics.p95 = Percentile(times, 95.0);
+	statistics.p99 = Percentile(times, 99.0);
+
+	return(statistics);
+}
+
+/***********************************************************
+ *  WriteStatistics()
+ *
+ *  This method is used to write the statistics of a series
+ *  as key and value lines, prefixed with the series name.
+ ***********************************************************/
+void FrameBenchmark::WriteStatistics(std::ostream& file, const char* prefix, const FRAME_STATISTICS& statistics)
+{
+	file << prefix << "_mean_ms " << statistics.mean << std::endl;
+	file << prefix << "_stddev_ms " << statistics.stddev << std::endl;
+	file << prefix << "_p50_ms " << statistics.p50 << std::endl;
+	file << prefix << "_p95_ms " << statistics.p95 << std::endl;
+	file << prefix << "_p99_ms " << statistics.p99 << std::endl;
+	file << prefix << "_batches " << statistics.batchCount << std::endl;
+	file << prefix << "_batch_stddev_ms " << statistics.batchStddev << std::endl;
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the results of the measured
+ *  frames as a report, which can also serve as the baseline
+ *  of later runs.
+ ***********************************************************/
+bool FrameBenchmark::WriteReport(const char* filename)
+{
+	std::vector<double> cpuTimes;
+	std::vector<double> gpuTimes;
+	double drawCount = 0.0;
+	double triangleCount = 0.0;
+	GetResults(cpuTimes, gpuTimes, drawCount, triangleCount);
+
+	FRAME_STATISTICS cpuStatistics = CalculateStatistics(cpuTimes);
+	FRAME_STATISTICS gpuStatistics = CalculateStatistics(gpuTimes);
+
+	std::ostringstream report;
+	report.precision(4);
+	report << std::fixed;
+	report << "# frame benchmark report" << std::endl;
+	report << "# renderer " << glGetString(GL_RENDERER) << std::endl;
+	report << "# version " << glGetString(GL_VERSION) << std::endl;
+	report << "frames " << m_samples.size() << std::endl;
+	WriteStatistics(report, "cpu", cpuStatistics);
+	WriteStatistics(report, "gpu", gpuStatistics);
+	report << "draws_per_frame " << drawCount << std::endl;
+	report << "triangles_per_frame " << triangleCount << std::endl;
+
+	std::cout << report.str();
+
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create benchmark report:" << filename << std::endl;
+		return(false);
+	}
+
+	file << report.str();
+	if (!file)
+	{
+		std::cout << "Could not write benchmark report:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote benchmark report:" << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReadReport()
+ *
+ *  This method is used to read the key and value lines of a
+ *  report.  Comment lines start with a '#'.
+ ***********************************************************/
+bool FrameBenchmark::ReadReport(const char* filename, std::map<std::string, double>& values)
+{
+	std::ifstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not open benchmark baseline:" << filename << std::endl;
+		return(false);
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if ((line.size() == 0) || (line[0] == '#'))
+		{
+			continue;
+		}
+
+		std::istringstream stream(line);
+		std::string key;
+		double value = 0.0;
+		if (stream >> key >> value)
+		{
+			values[key] = value;
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CompareSeries()
+ *
+ *  This method is used to test whether the mean frame time
+ *  of a series got slower than in the baseline.  The batch
+ *  means of both runs are compared with Welch's t-test, and
+ *  a slowdown is only flagged when it is significant and
+ *  larger than the noise that is expected between runs.
+ ***********************************************************/
+bool FrameBenchmark::CompareSeries(const char* prefix, const FRAME_STATISTICS& current, const std::map<std::string, double>& baseline)
+{
+	std::string name = prefix;
+	std::map<std::string, double>::const_iterator mean = baseline.find(name + "_mean_ms");
+	std::map<std::string, double>::const_iterator p95 = baseline.find(name + "_p95_ms");
+	std::map<std::string, double>::const_iterator batches = baseline.find(name + "_batches");
+	std::map<std::string, double>::const_iterator batchStddev = baseline.find(name + "_batch_stddev_ms");
+	if ((mean == baseline.end()) || (batches == baseline.end()) || (batchStddev == baseline.end()) ||
+		(batches->second < 2.0) || (current.batchCount < 2) || (mean->second <= 0.0))
+	{
+		std::cout << prefix << ": not enough data to compare" << std::endl;
+		return(false);
+	}
+
+	double baselineCount = batches->second;
+	double currentCount = (double)current.batchCount;
+	double baselineVariance = batchStddev->second * batchStddev->second / baselineCount;
+	double currentVariance = current.batchStddev * current.batchStddev / currentCount;
+	double standardError = std::sqrt(baselineVariance + currentVariance);
+	double change = (current.mean - mean->second) / mean->second;
+
+	// one sided p-value of the current run being slower
+	double pValue = (current.mean > mean->second) ? 0.0 : 1.0;
+	if (standardError > 0.0)
+	{
+		double t = (current.mean - mean->second) / standardError;
+		double degreesOfFreedom = (baselineVariance + currentVariance) * (baselineVariance + currentVariance) /
+			(baselineVariance * baselineVariance / (baselineCount - 1.0) +
+			currentVariance * currentVariance / (currentCount - 1.0));
+		pValue = StudentTUpperTail(t, degreesOfFreedom);
+	}
+
+	bool bRegression = (pValue < g_SignificanceLevel) && (change > g_MinimumRegression);
+
+	std::cout << prefix << ": mean " << mean->second << " -> " << current.mean << " ms ("
+		<< ((change >= 0.0) ? "+" : "") << (change * 100.0) << "%, p=" << pValue << ")";
+	if (p95 != baseline.end())
+	{
+		std::cout << ", p95 " << p95->second << " -> " << current.p95 << " ms";
+	}
+	std::cout << (bRegression ? "  REGRESSION" : "") << std::endl;
+
+	return(bRegression);
+}
+
+/***********************************************************
+ *  CompareWithBaseline()
+ *
+ *  This method is used to compare the measured frames with
+ *  the report of an earlier run.  The draw and triangle
+ *  counts are deterministic, so any change of them is shown
+ *  as a change of the workload rather than tested.
+ ***********************************************************/
+int FrameBenchmark::CompareWithBaseline(const char* filename)
+{
+	std::map<std::string, double> baseline;
+	if (ReadReport(filename, baseline) == false)
+	{
+		return(0);
+	}
+
+	std::vector<double> cpuTimes;
+	std::vector<double> gpuTimes;
+	double drawCount = 0.0;
+	double triangleCount = 0.0;
+	GetResults(cpuTimes, gpuTimes, drawCount, triangleCount);
+
+	std::cout << "Comparing with benchmark baseline:" << filename << std::endl;
+	std::cout.precision(4);
+	std::cout << std::fixed;
+
+	int regressions = 0;
+	if (CompareSeries("cpu", CalculateStatistics(cpuTimes), baseline) == true)
+	{
+		regressions++;
+	}
+	if (CompareSeries("gpu", CalculateStatistics(gpuTimes), baseline) == true)
+	{
+		regressions++;
+	}
+
+	if ((baseline.count("draws_per_frame") > 0) && (std::fabs(baseline["draws_per_frame"] - drawCount) > 0.5))
+	{
+		std::cout << "draws per frame changed: " << baseline["draws_per_frame"] << " -> " << drawCount << std::endl;
+	}
+	if ((baseline.count("triangles_per_frame") > 0) && (std::fabs(baseline["triangles_per_frame"] - triangleCount) > 0.5))
+	{
+		std::cout << "triangles per frame changed: " << baseline["triangles_per_frame"] << " -> " << triangleCount << std::endl;
+	}
+
+	std::cout << regressions << " significant regression(s) found" << std::endl;
+
+	return(regressions);
+}
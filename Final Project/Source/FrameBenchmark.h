@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+// framebenchmark.h
+// ============
+// measure the frame times along a scripted camera path and report them
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstddef>
+
+/***********************************************************
+ *  FrameBenchmark
+ *
+ *  This class contains the code for a repeatable performance
+ *  benchmark.  The camera follows a fixed path through the
+ *  scene for a fixed number of frames, and every frame is
+ *  measured for its CPU time, its GPU time with a timer query,
+ *  its number of draws and the triangles that it submitted.
+ *  The results are written as a report with the mean and the
+ *  50th, 95th and 99th percentile frame times, and can be
+ *  compared against the report of an earlier run to flag the
+ *  statistically significant regressions.
+ ***********************************************************/
+class FrameBenchmark
+{
+public:
+	// constructor
+	FrameBenchmark(int frameCount, int warmupFrames = 30);
+	// destructor
+	~FrameBenchmark();
+
+	struct FRAME_STATISTICS
+	{
+		int sampleCount;
+		double mean;
+		double stddev;
+		double p50;
+		double p95;
+		double p99;
+		// spread of the means of consecutive batches of frames,
+		// which are close to independent unlike single frames
+		int batchCount;
+		double batchStddev;
+	};
+
+	// check whether all of the frames have been rendered
+	bool IsFinished() const;
+	// get the camera pose of the current frame on the scripted path
+	void GetCameraPose(glm::vec3& position, glm::vec3& front) const;
+
+	// measure the current frame
+	void BeginFrame();
+	void EndFrame(int drawCount);
+
+	// write the results of the measured frames
+	bool WriteReport(const char* filename);
+	// compare the results against an earlier report and return
+	// the number of significant regressions
+	int CompareWithBaseline(const char* filename);
+
+private:
+	struct FRAME_SAMPLE
+	{
+		double cpuTime;
+		double gpuTime;
+		int drawCount;
+		GLuint64 triangleCount;
+	};
+
+	// number of frames that are measured and rendered beforehand
+	int m_frameCount;
+	int m_warmupFrames;
+	// number of the current frame, counting the warmup frames
+	int m_frame;
+	// CPU start time of the current frame
+	double m_frameStartTime;
+	// timer and primitive queries of every measured frame
+	std::vector<GLuint> m_timeQueries;
+	std::vector<GLuint> m_primitiveQueries;
+	// measured frames
+	std::vector<FRAME_SAMPLE> m_samples;
+	bool m_bResolved;
+
+	// read the query results of all of the measured frames
+	void ResolveQueries();
+	// get the frame times and the average counts of the measured frames
+	void GetResults(std::vector<double>& cpuTimes, std::vector<double>& gpuTimes, double& drawCount, double& triangleCount);
+	// calculate the statistics of a series of frame times
+	static FRAME_STATISTICS CalculateStatistics(std::vector<double> times);
+	// write the statistics of a series with a key prefix
+	static void WriteStatistics(std::ostream& file, const char* prefix, const FRAME_STATISTICS& statistics);
+	// read the values of a report
+	static bool ReadReport(const char* filename, std::map<std::string, double>& values);
+	// test whether a series got significantly slower than the baseline
+	static bool CompareSeries(const char* prefix, const FRAME_STATISTICS& current, const std::map<std::string, double>& baseline);
+};
@@ -0,0 +1,789 @@
+///////////////////////////////////////////////////////////////////////////////
+// framecapture.cpp
+// ============
+// capture screenshots and frame sequences of the window
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameCapture.h"
+#include "FramePacer.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	// pixel buffers in the ring, so a readback is mapped two frames
+	// after it was started
+	const int g_DefaultRingSize = 3;
+	// frame rate of the videos when none is set
+	const double g_DefaultFrameRate = 60.0;
+	// frames that can wait for the encoder on top of the ring,
+	// before the capture waits for the encoder to catch up
+	const int g_MaxQueuedFrames = 8;
+	// longest wait for a readback before the fence is checked again
+	const GLuint64 g_FenceTimeout = 1000000000;
+	// most screenshot files looked at for a free name
+	const int g_MaxScreenshots = 10000;
+
+	/***********************************************************
+	 *  HasVideoExtension()
+	 *
+	 *  Check whether a path names a Y4M video file.
+	 ***********************************************************/
+	bool HasVideoExtension(const std::string& path)
+	{
+		const char* extension = ".y4m";
+		size_t length = strlen(extension);
+		if (path.size() < length)
+		{
+			return(false);
+		}
+
+		for (size_t i = 0; i < length; i++)
+		{
+			char c = path[path.size() - length + i];
+			if ((c >= 'A') && (c <= 'Z'))
+			{
+				c = (char)(c - 'A' + 'a');
+			}
+			if (c != extension[i])
+			{
+				return(false);
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ClampByte()
+	 *
+	 *  Clamp a converted color value to a byte.
+	 ***********************************************************/
+	unsigned char ClampByte(int value)
+	{
+		return((unsigned char)((value < 0) ? 0 : ((value > 255) ? 255 : value)));
+	}
+}
+
+/***********************************************************
+ *  FrameCapture()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameCapture::FrameCapture()
+{
+	m_ringSize = g_DefaultRingSize;
+	m_currentSlot = 0;
+	m_bRecording = false;
+	m_bVideo = false;
+	m_bScreenshotRequested = false;
+	m_frameRate = g_DefaultFrameRate;
+	m_recordedFrames = 0;
+	m_videoWidth = 0;
+	m_videoHeight = 0;
+	m_bVideoHeaderWritten = false;
+	m_jobCount = 0;
+	m_bStopping = false;
+	m_capturedFrames = 0;
+	m_writtenFrames = 0;
+	m_writtenScreenshots = 0;
+	m_skippedFrames = 0;
+	m_failedFrames = 0;
+	m_captureTimeTotal = 0.0;
+	m_waitTimeTotal = 0.0;
+	m_encodeTimeTotal = 0.0;
+	m_frameTimeTotal = 0.0;
+	m_lastCaptureTime = 0.0;
+}
+
+/***********************************************************
+ *  ~FrameCapture()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameCapture::~FrameCapture()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  SetRingSize()
+ *
+ *  This method is used to set the number of pixel buffers
+ *  that the frames are read back into in turn.  It takes
+ *  effect when the pixel buffers are next created.
+ ***********************************************************/
+void FrameCapture::SetRingSize(int ringSize)
+{
+	m_ringSize = (ringSize > 1) ? ringSize : 2;
+}
+
+/***********************************************************
+ *  SetFrameRate()
+ *
+ *  This method is used to set the frame rate stored in the
+ *  header of the next Y4M video, which the video plays at.
+ ***********************************************************/
+void FrameCapture::SetFrameRate(double framesPerSecond)
+{
+	m_frameRate = (framesPerSecond > 0.0) ? framesPerSecond : g_DefaultFrameRate;
+}
+
+/***********************************************************
+ *  StartRecording()
+ *
+ *  This method is used to record every frame captured from
+ *  now on.  A path ending with .y4m is written as a raw
+ *  YUV 4:2:0 video, which is cheap to encode and can be
+ *  converted by most video tools, and any other path is an
+ *  existing directory that the frames are written into as
+ *  numbered PNG files.
+ ***********************************************************/
+bool FrameCapture::StartRecording(const char* path)
+{
+	if ((NULL == path) || (path[0] == '\0'))
+	{
+		return(false);
+	}
+
+	// the frames of an earlier recording are written first
+	Finish();
+
+	m_recordPath = path;
+	m_bVideo = HasVideoExtension(m_recordPath);
+	if (true == m_bVideo)
+	{
+		m_videoFile.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_videoFile)
+		{
+			std::cout << "Could not create capture video file:" << path << std::endl;
+			m_videoFile.close();
+			return(false);
+		}
+		m_videoWidth = 0;
+		m_videoHeight = 0;
+		m_bVideoHeaderWritten = false;
+	}
+
+	m_bRecording = true;
+	m_recordedFrames = 0;
+
+	std::cout << "Recording the frames into:" << path << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  StopRecording()
+ *
+ *  This method is used to stop recording the frames.  The
+ *  frames still being read back are written all the same.
+ ***********************************************************/
+void FrameCapture::StopRecording()
+{
+	m_bRecording = false;
+}
+
+/***********************************************************
+ *  IsRecording()
+ *
+ *  This method is used to check whether the frames are being
+ *  recorded.
+ ***********************************************************/
+bool FrameCapture::IsRecording() const
+{
+	return(m_bRecording);
+}
+
+/***********************************************************
+ *  RequestScreenshot()
+ *
+ *  This method is used to write the next captured frame as
+ *  a PNG file in the working directory, with the first free
+ *  screenshot number in its name.
+ ***********************************************************/
+void FrameCapture::RequestScreenshot()
+{
+	m_bScreenshotRequested = true;
+}
+
+/***********************************************************
+ *  CaptureFrame()
+ *
+ *  This method is used to capture the frame in the back
+ *  buffer of the window, and must be called before the
+ *  buffers are swapped.  The readbacks of the earlier frames
+ *  are passed on to the encoder in order, as soon as their
+ *  fences have passed, and the oldest one is waited for when
+ *  its pixel buffer is needed again.  The back buffer is then
+ *  copied into the free pixel buffer, which the GPU does
+ *  after the draws of the frame without stopping the CPU.
+ ***********************************************************/
+void FrameCapture::CaptureFrame(int width, int height)
+{
+	bool bCapture = (m_bRecording || m_bScreenshotRequested) && (width > 0) && (height > 0);
+	bool bPending = false;
+	for (size_t i = 0; i < m_slots.size(); i++)
+	{
+		bPending = bPending || m_slots[i].bPending;
+	}
+	if ((bCapture == false) && (bPending == false))
+	{
+		m_lastCaptureTime = 0.0;
+		return;
+	}
+
+	// the time between the frames that are captured is the frame
+	// time that the cost of the capture is measured against
+	double startTime = FramePacer::GetTime();
+	if (m_lastCaptureTime > 0.0)
+	{
+		m_frameTimeTotal += startTime - m_lastCaptureTime;
+	}
+	m_lastCaptureTime = startTime;
+
+	if (Begin() == false)
+	{
+		m_bRecording = false;
+		m_bScreenshotRequested = false;
+		return;
+	}
+
+	// the readbacks are passed on oldest first, so the frames of a
+	// video are written in order
+	int slotCount = (int)m_slots.size();
+	for (int i = 0; i < slotCount; i++)
+	{
+		READBACK_SLOT& slot = m_slots[(m_currentSlot + i) % slotCount];
+		if (slot.bPending == false)
+		{
+			continue;
+		}
+		if ((i > 0) && (glClientWaitSync(slot.fence, 0, 0) == GL_TIMEOUT_EXPIRED))
+		{
+			break;
+		}
+		CompleteSlot(slot);
+	}
+
+	if (true == bCapture)
+	{
+		READBACK_SLOT& slot = m_slots[m_currentSlot];
+
+		// the frames of a video all have the size of the first one
+		bool bRecorded = m_bRecording;
+		if ((true == bRecorded) && (true == m_bVideo))
+		{
+			if ((m_videoWidth == 0) && (m_videoHeight == 0))
+			{
+				m_videoWidth = width;
+				m_videoHeight = height;
+			}
+			else if ((m_videoWidth != width) || (m_videoHeight != height))
+			{
+				if (m_skippedFrames == 0)
+				{
+					std::cout << "Skipping the frames that do not have the video size " << m_videoWidth << "x" << m_videoHeight << std::endl;
+				}
+				m_skippedFrames++;
+				bRecorded = false;
+			}
+		}
+
+		if ((true == bRecorded) || (true == m_bScreenshotRequested))
+		{
+			GLsizeiptr imageSize = (GLsizeiptr)width * height * 4;
+			GLint readFramebuffer = 0;
+			glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+			glReadBuffer(GL_BACK);
+
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelBuffer);
+			if (slot.size < imageSize)
+			{
+				glBufferData(GL_PIXEL_PACK_BUFFER, imageSize, NULL, GL_STREAM_READ);
+				slot.size = imageSize;
+			}
+			glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+
+			slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			slot.width = width;
+			slot.height = height;
+			slot.frameIndex = m_recordedFrames;
+			slot.bScreenshot = m_bScreenshotRequested;
+			slot.bRecorded = bRecorded;
+			slot.bPending = true;
+
+			if (true == bRecorded)
+			{
+				m_recordedFrames++;
+			}
+			m_bScreenshotRequested = false;
+			m_currentSlot = (m_currentSlot + 1) % slotCount;
+			m_capturedFrames++;
+		}
+	}
+
+	m_captureTimeTotal += FramePacer::GetTime() - startTime;
+}
+
+/***********************************************************
+ *  Finish()
+ *
+ *  This method is used to pass on the frames that are still
+ *  being read back, oldest first, to wait until the encoder
+ *  has written every frame, and to close the video.
+ ***********************************************************/
+void FrameCapture::Finish()
+{
+	int slotCount = (int)m_slots.size();
+	for (int i = 0; i < slotCount; i++)
+	{
+		READBACK_SLOT& slot = m_slots[(m_currentSlot + i) % slotCount];
+		if (slot.bPending == true)
+		{
+			CompleteSlot(slot);
+		}
+	}
+
+	if (m_encoder.joinable() == true)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bStopping = true;
+		}
+		m_jobReady.notify_all();
+		m_encoder.join();
+	}
+
+	if (m_videoFile.is_open() == true)
+	{
+		m_videoFile.close();
+		if (!m_videoFile)
+		{
+			std::cout << "Could not write capture video file:" << m_recordPath << std::endl;
+		}
+	}
+	m_bRecording = false;
+	m_lastCaptureTime = 0.0;
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the number of frames that
+ *  were captured and written, and the time that capturing
+ *  them took on the render thread and on the encoder, along
+ *  with the share of the frame time spent capturing.
+ ***********************************************************/
+void FrameCapture::WriteReport(std::ostream& stream)
+{
+	stream << "# frames captured from the window" << std::endl;
+	stream << "ring_size: " << m_ringSize << std::endl;
+	stream << "captured_frames: " << m_capturedFrames << std::endl;
+	stream << "written_frames: " << m_writtenFrames << std::endl;
+	stream << "written_screenshots: " << m_writtenScreenshots << std::endl;
+	stream << "skipped_frames: " << m_skippedFrames << std::endl;
+	stream << "failed_frames: " << m_failedFrames << std::endl;
+	if (m_capturedFrames == 0)
+	{
+		return;
+	}
+
+	stream << "capture_ms: " << m_captureTimeTotal * 1000.0 / m_capturedFrames << std::endl;
+	stream << "readback_wait_ms: " << m_waitTimeTotal * 1000.0 / m_capturedFrames << std::endl;
+	int encodedFrames = m_writtenFrames + m_writtenScreenshots;
+	if (encodedFrames > 0)
+	{
+		stream << "encode_ms: " << m_encodeTimeTotal * 1000.0 / encodedFrames << std::endl;
+	}
+	if (m_frameTimeTotal > 0.0)
+	{
+		stream << "frame_time_percent: " << m_captureTimeTotal * 100.0 / m_frameTimeTotal << std::endl;
+	}
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the report into a file.
+ ***********************************************************/
+bool FrameCapture::WriteReport(const char* filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create capture report file:" << filename << std::endl;
+		return(false);
+	}
+
+	WriteReport(file);
+	if (!file)
+	{
+		std::cout << "Could not write capture report file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote capture report file:" << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used to create the pixel buffers of the
+ *  ring and to start the encoder thread, unless they are
+ *  already there.  The buffers are sized by the first frames
+ *  read back into them.
+ ***********************************************************/
+bool FrameCapture::Begin()
+{
+	if (m_slots.empty() == true)
+	{
+		READBACK_SLOT emptySlot = { 0, 0, NULL, 0, 0, 0, false, false, false };
+		m_slots.assign(m_ringSize, emptySlot);
+		for (int i = 0; i < m_ringSize; i++)
+		{
+			glGenBuffers(1, &m_slots[i].pixelBuffer);
+			if (0 == m_slots[i].pixelBuffer)
+			{
+				std::cout << "Could not create the capture pixel buffers" << std::endl;
+				Destroy();
+				return(false);
+			}
+		}
+		m_currentSlot = 0;
+	}
+
+	if (m_encoder.joinable() == false)
+	{
+		m_bStopping = false;
+		m_encoder = std::thread(&FrameCapture::EncodeFrames, this);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CompleteSlot()
+ *
+ *  This method is used to wait for the readback of a slot,
+ *  and to copy its pixels into a buffer for the encoder for
+ *  every file the frame is written into.  When all the
+ *  buffers are waiting to be written, the capture waits for
+ *  the encoder, which keeps the memory bounded when the
+ *  encoding cannot keep up with the frames.
+ ***********************************************************/
+void FrameCapture::CompleteSlot(READBACK_SLOT& slot)
+{
+	double waitStartTime = FramePacer::GetTime();
+	GLenum result = GL_TIMEOUT_EXPIRED;
+	while (result == GL_TIMEOUT_EXPIRED)
+	{
+		result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, g_FenceTimeout);
+	}
+	glDeleteSync(slot.fence);
+	slot.fence = NULL;
+	slot.bPending = false;
+
+	size_t imageSize = (size_t)slot.width * slot.height * 4;
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelBuffer);
+	const unsigned char* pPixels = (const unsigned char*)glMapBufferRange(
+		GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)imageSize, GL_MAP_READ_BIT);
+	if (NULL == pPixels)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		std::cout << "Could not map the pixels of a captured frame" << std::endl;
+		{
+			// the encoder counts its failed frames too
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_failedFrames++;
+		}
+		m_waitTimeTotal += FramePacer::GetTime() - waitStartTime;
+		return;
+	}
+	m_waitTimeTotal += FramePacer::GetTime() - waitStartTime;
+
+	JOB_TYPE types[2];
+	int typeCount = 0;
+	if (true == slot.bScreenshot)
+	{
+		types[typeCount++] = JOB_SCREENSHOT;
+	}
+	if (true == slot.bRecorded)
+	{
+		types[typeCount++] = (true == m_bVideo) ? JOB_Y4M_FRAME : JOB_PNG_FRAME;
+	}
+
+	for (int i = 0; i < typeCount; i++)
+	{
+		ENCODE_JOB* pJob = NULL;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			int maxJobs = m_ringSize + g_MaxQueuedFrames;
+			if ((m_freeJobs.empty() == true) && (m_jobCount >= maxJobs))
+			{
+				double queueStartTime = FramePacer::GetTime();
+				while ((m_freeJobs.empty() == true) && (m_jobCount >= maxJobs))
+				{
+					m_jobDone.wait(lock);
+				}
+				m_waitTimeTotal += FramePacer::GetTime() - queueStartTime;
+			}
+			if (m_freeJobs.empty() == false)
+			{
+				pJob = m_freeJobs.back();
+				m_freeJobs.pop_back();
+			}
+			else
+			{
+				pJob = new ENCODE_JOB();
+				m_jobCount++;
+			}
+		}
+
+		pJob->type = types[i];
+		pJob->frameIndex = slot.frameIndex;
+		pJob->width = slot.width;
+		pJob->height = slot.height;
+		pJob->pixels.resize(imageSize);
+		memcpy(pJob->pixels.data(), pPixels, imageSize);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back(pJob);
+		}
+		m_jobReady.notify_one();
+	}
+
+	glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+/***********************************************************
+ *  EncodeFrames()
+ *
+ *  This method is run by the encoder thread, and writes the
+ *  queued frames in order until the capture is finished and
+ *  the queue is empty.
+ ***********************************************************/
+void FrameCapture::EncodeFrames()
+{
+	ImageWriter writer;
+	std::vector<char> filename(m_recordPath.size() + 32);
+	int screenshotNumber = 0;
+
+	while (true)
+	{
+		ENCODE_JOB* pJob = NULL;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while ((m_jobs.empty() == true) && (m_bStopping == false))
+			{
+				m_jobReady.wait(lock);
+			}
+			if (m_jobs.empty() == true)
+			{
+				break;
+			}
+			pJob = m_jobs.front();
+			m_jobs.pop_front();
+		}
+
+		double startTime = FramePacer::GetTime();
+		bool bWritten = false;
+		if (pJob->type == JOB_Y4M_FRAME)
+		{
+			bWritten = WriteVideoFrame(*pJob);
+		}
+		else
+		{
+			if (pJob->type == JOB_SCREENSHOT)
+			{
+				// the screenshots of earlier sessions are kept
+				while (screenshotNumber < g_MaxScreenshots)
+				{
+					snprintf(filename.data(), filename.size(), "screenshot_%04d.png", screenshotNumber);
+					std::ifstream existing(filename.data());
+					if (!existing)
+					{
+						break;
+					}
+					screenshotNumber++;
+				}
+				screenshotNumber++;
+			}
+			else
+			{
+				snprintf(filename.data(), filename.size(), "%s/frame_%05d.png",
+					m_recordPath.c_str(), pJob->frameIndex);
+			}
+			bWritten = writer.WritePNG(filename.data(), pJob->width, pJob->height, pJob->pixels.data(), true);
+			if ((true == bWritten) && (pJob->type == JOB_SCREENSHOT))
+			{
+				std::cout << "Saved screenshot:" << filename.data() << std::endl;
+			}
+		}
+		double encodeTime = FramePacer::GetTime() - startTime;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (false == bWritten)
+			{
+				m_failedFrames++;
+			}
+			else if (pJob->type == JOB_SCREENSHOT)
+			{
+				m_writtenScreenshots++;
+			}
+			else
+			{
+				m_writtenFrames++;
+			}
+			m_encodeTimeTotal += encodeTime;
+			m_freeJobs.push_back(pJob);
+		}
+		m_jobDone.notify_one();
+	}
+}
+
+/***********************************************************
+ *  WriteVideoFrame()
+ *
+ *  This method is used to convert a frame into the planes of
+ *  a YUV 4:2:0 image, with the full range BT.601 colors that
+ *  the C420jpeg color space of Y4M stands for, and to append
+ *  it to the video.  The first frame that is written, which
+ *  is not the first one recorded when frames were skipped,
+ *  writes the header too.
+ ***********************************************************/
+bool FrameCapture::WriteVideoFrame(const ENCODE_JOB& job)
+{
+	if (m_videoFile.is_open() == false)
+	{
+		return(false);
+	}
+
+	int width = job.width;
+	int height = job.height;
+	if (false == m_bVideoHeaderWritten)
+	{
+		// the frame rate is stored as a ratio of whole numbers
+		int rateNumerator = (int)floor(m_frameRate * 1000.0 + 0.5);
+		int rateDenominator = 1000;
+		if ((rateNumerator % 1000) == 0)
+		{
+			rateNumerator /= 1000;
+			rateDenominator = 1;
+		}
+		m_videoFile << "YUV4MPEG2 W" << width << " H" << height
+			<< " F" << rateNumerator << ":" << rateDenominator
+			<< " Ip A1:1 C420jpeg\n";
+		m_bVideoHeaderWritten = true;
+	}
+
+	int chromaWidth = (width + 1) / 2;
+	int chromaHeight = (height + 1) / 2;
+	size_t lumaSize = (size_t)width * height;
+	size_t chromaSize = (size_t)chromaWidth * chromaHeight;
+	m_planes.resize(lumaSize + 2 * chromaSize);
+	unsigned char* pLuma = m_planes.data();
+	unsigned char* pBlue = pLuma + lumaSize;
+	unsigned char* pRed = pBlue + chromaSize;
+	const unsigned char* pPixels = job.pixels.data();
+
+	// the rows of the frame are read back from the bottom up
+	for (int y = 0; y < height; y++)
+	{
+		const unsigned char* pRow = pPixels + (size_t)(height - 1 - y) * width * 4;
+		unsigned char* pLumaRow = pLuma + (size_t)y * width;
+		for (int x = 0; x < width; x++)
+		{
+			const unsigned char* pPixel = pRow + x * 4;
+			pLumaRow[x] = (unsigned char)((77 * pPixel[0] + 150 * pPixel[1] + 29 * pPixel[2] + 128) >> 8);
+		}
+	}
+
+	// the chroma is taken from the average color of every 2x2 block
+	for (int y = 0; y < chromaHeight; y++)
+	{
+		int row0 = height - 1 - 2 * y;
+		int row1 = (row0 > 0) ? (row0 - 1) : row0;
+		const unsigned char* pRow0 = pPixels + (size_t)row0 * width * 4;
+		const unsigned char* pRow1 = pPixels + (size_t)row1 * width * 4;
+		for (int x = 0; x < chromaWidth; x++)
+		{
+			int x0 = 2 * x * 4;
+			int x1 = (2 * x + 1 < width) ? (x0 + 4) : x0;
+			int red = pRow0[x0] + pRow0[x1] + pRow1[x0] + pRow1[x1];
+			int green = pRow0[x0 + 1] + pRow0[x1 + 1] + pRow1[x0 + 1] + pRow1[x1 + 1];
+			int blue = pRow0[x0 + 2] + pRow0[x1 + 2] + pRow1[x0 + 2] + pRow1[x1 + 2];
+
+			// the sums of four pixels are scaled back with the shift,
+			// after the offset of 128 keeps them from being negative
+			size_t index = (size_t)y * chromaWidth + x;
+			pBlue[index] = ClampByte((-43 * red - 85 * green + 128 * blue + 131584) >> 10);
+			pRed[index] = ClampByte((128 * red - 107 * green - 21 * blue + 131584) >> 10);
+		}
+	}
+
+	m_videoFile << "FRAME\n";
+	m_videoFile.write((const char*)m_planes.data(), (std::streamsize)m_planes.size());
+
+	return(m_videoFile.good());
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used to stop the encoder thread and free
+ *  the pixel buffers.
+ ***********************************************************/
+void FrameCapture::Destroy()
+{
+	if (m_encoder.joinable() == true)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bStopping = true;
+		}
+		m_jobReady.notify_all();
+		m_encoder.join();
+	}
+	if (m_videoFile.is_open() == true)
+	{
+		m_videoFile.close();
+	}
+
+	for (size_t i = 0; i < m_slots.size(); i++)
+	{
+		READBACK_SLOT& slot = m_slots[i];
+		if (NULL != slot.fence)
+		{
+			glDeleteSync(slot.fence);
+		}
+		glDeleteBuffers(1, &slot.pixelBuffer);
+	}
+	m_slots.clear();
+
+	for (size_t i = 0; i < m_jobs.size(); i++)
+	{
+		delete m_jobs[i];
+	}
+	m_jobs.clear();
+	for (size_t i = 0; i < m_freeJobs.size(); i++)
+	{
+		delete m_freeJobs[i];
+	}
+	m_freeJobs.clear();
+	m_jobCount = 0;
+}
@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////
+// framecapture.h
+// ============
+// capture screenshots and frame sequences of the window
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ImageWriter.h"
+
+#include <GL/glew.h>
+
+#include <ostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+/***********************************************************
+ *  FrameCapture
+ *
+ *  This class contains the code for capturing the frames
+ *  shown in the window without stalling the rendering.  The
+ *  back buffer of a frame is copied into one of a ring of
+ *  pixel buffer objects, and the buffer is only mapped a few
+ *  frames later, when its fence has normally passed.  The
+ *  pixels are then handed to a background encoder thread,
+ *  which writes them as PNG files or as the frames of a raw
+ *  Y4M video, so the render thread only pays for the copy
+ *  out of the mapped buffer.
+ ***********************************************************/
+class FrameCapture
+{
+public:
+	// constructor
+	FrameCapture();
+	// destructor
+	~FrameCapture();
+
+	// set the number of pixel buffers, which is one more than the
+	// number of frames that a readback lags behind
+	void SetRingSize(int ringSize);
+	// set the frame rate stored in the header of a Y4M video
+	void SetFrameRate(double framesPerSecond);
+
+	// record every frame from now on into a Y4M video when the path
+	// ends with .y4m, or else into numbered PNG files in a directory
+	bool StartRecording(const char* path);
+	void StopRecording();
+	bool IsRecording() const;
+
+	// write the next captured frame as a PNG screenshot
+	void RequestScreenshot();
+
+	// start the readback of the back buffer of the frame when it is
+	// captured, and pass on the frames whose readback is done
+	void CaptureFrame(int width, int height);
+
+	// wait for the remaining frames to be written
+	void Finish();
+
+	// write the captured frames and the time spent capturing them
+	void WriteReport(std::ostream& stream);
+	bool WriteReport(const char* filename);
+
+private:
+	// what a frame is written as
+	enum JOB_TYPE
+	{
+		JOB_SCREENSHOT,
+		JOB_PNG_FRAME,
+		JOB_Y4M_FRAME
+	};
+
+	struct READBACK_SLOT
+	{
+		GLuint pixelBuffer;
+		GLsizeiptr size;
+		GLsync fence;
+		int width;
+		int height;
+		int frameIndex;
+		bool bScreenshot;
+		bool bRecorded;
+		bool bPending;
+	};
+
+	struct ENCODE_JOB
+	{
+		JOB_TYPE type;
+		int frameIndex;
+		int width;
+		int height;
+		std::vector<unsigned char> pixels;
+	};
+
+	// pixel buffers that the frames are read back into in turn
+	std::vector<READBACK_SLOT> m_slots;
+	int m_ringSize;
+	int m_currentSlot;
+
+	// what the next frames are captured for
+	bool m_bRecording;
+	bool m_bVideo;
+	bool m_bScreenshotRequested;
+	std::string m_recordPath;
+	double m_frameRate;
+	int m_recordedFrames;
+	int m_videoWidth;
+	int m_videoHeight;
+
+	// frames waiting for the encoder, and the buffers that are free
+	std::thread m_encoder;
+	std::mutex m_mutex;
+	std::condition_variable m_jobReady;
+	std::condition_variable m_jobDone;
+	std::deque<ENCODE_JOB*> m_jobs;
+	std::vector<ENCODE_JOB*> m_freeJobs;
+	int m_jobCount;
+	bool m_bStopping;
+
+	// video that the encoder writes into, whether its header was
+	// written, and its converted planes
+	std::ofstream m_videoFile;
+	bool m_bVideoHeaderWritten;
+	std::vector<unsigned char> m_planes;
+
+	// totals of the session
+	int m_capturedFrames;
+	int m_writtenFrames;
+	int m_writtenScreenshots;
+	int m_skippedFrames;
+	int m_failedFrames;
+	double m_captureTimeTotal;
+	double m_waitTimeTotal;
+	double m_encodeTimeTotal;
+	double m_frameTimeTotal;
+	double m_lastCaptureTime;
+
+	// create the pixel buffers and start the encoder thread
+	bool Begin();
+	// map the pixels of a slot and queue them for the encoder
+	void CompleteSlot(READBACK_SLOT& slot);
+	// write the queued frames until the capture is finished
+	void EncodeFrames();
+	bool WriteVideoFrame(const ENCODE_JOB& job);
+	// free the pixel buffers and stop the encoder thread
+	void Destroy();
+};
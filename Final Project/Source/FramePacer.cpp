@@ -0,0 +1,276 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.cpp
+// ============
+// pace the frames of the main loop and measure the frame time
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FramePacer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+// GLFW library
+#include "GLFW/glfw3.h"
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	// longer frames are clamped so that a stall does not move the camera far
+	const double g_MaxDeltaTime = 0.1;
+	// length of the short sleeps used by the frame limiter
+	const double g_SleepSlice = 0.001;
+}
+
+/***********************************************************
+ *  FramePacer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FramePacer::FramePacer()
+{
+	m_targetFPS = 0.0;
+	m_framePeriod = 0.0;
+	m_vsyncMode = VSYNC_ON;
+	m_frameStartTime = GetTime();
+	m_nextFrameTime = m_frameStartTime;
+	m_deltaTime = 0.0;
+	for (int i = 0; i < SMOOTHING_FRAMES; i++)
+	{
+		m_deltaHistory[i] = 0.0;
+	}
+	m_deltaHistoryIndex = 0;
+	m_deltaHistoryCount = 0;
+
+	// start from a pessimistic guess of the sleep overshoot
+	m_sleepMean = 0.005;
+	m_sleepM2 = 0.0;
+	m_sleepCount = 1;
+
+#ifdef _WIN32
+	// raise the resolution of the system timer so that short
+	// sleeps do not last a whole scheduler tick
+	timeBeginPeriod(1);
+#endif
+}
+
+/***********************************************************
+ *  ~FramePacer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+/***********************************************************
+ *  GetTime()
+ *
+ *  This method is used to get the seconds elapsed on a high
+ *  resolution monotonic clock, in double precision.
+ ***********************************************************/
+double FramePacer::GetTime()
+{
+	static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	return(std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+/***********************************************************
+ *  SetTargetFPS()
+ *
+ *  This method is used to set the frame rate limit.  A limit
+ *  of zero disables the limiter.
+ ***********************************************************/
+void FramePacer::SetTargetFPS(double targetFPS)
+{
+	m_targetFPS = (targetFPS > 0.0) ? targetFPS : 0.0;
+	m_framePeriod = (m_targetFPS > 0.0) ? (1.0 / m_targetFPS) : 0.0;
+	m_nextFrameTime = GetTime();
+}
+
+/***********************************************************
+ *  GetTargetFPS()
+ *
+ *  This method is used to get the frame rate limit.
+ ***********************************************************/
+double FramePacer::GetTargetFPS() const
+{
+	return(m_targetFPS);
+}
+
+/***********************************************************
+ *  SetVSyncMode()
+ *
+ *  This method is used to set the swap interval of the
+ *  current OpenGL context.  Adaptive vsync needs the swap
+ *  control tear extension, without it regular vsync is used.
+ ***********************************************************/
+void FramePacer::SetVSyncMode(VSYNC_MODE mode)
+{
+	if (mode == VSYNC_ADAPTIVE)
+	{
+		if ((glfwExtensionSupported("WGL_EXT_swap_control_tear") == GLFW_TRUE) ||
+			(glfwExtensionSupported("GLX_EXT_swap_control_tear") == GLFW_TRUE))
+		{
+			glfwSwapInterval(-1);
+		}
+		else
+		{
+			std::cout << "Adaptive vsync is not supported, using vsync" << std::endl;
+			mode = VSYNC_ON;
+			glfwSwapInterval(1);
+		}
+	}
+	else
+	{
+		glfwSwapInterval((mode == VSYNC_ON) ? 1 : 0);
+	}
+
+	m_vsyncMode = mode;
+}
+
+/***********************************************************
+ *  GetVSyncMode()
+ *
+ *  This method is used to get the vertical sync mode.
+ ***********************************************************/
+FramePacer::VSYNC_MODE FramePacer::GetVSyncMode() const
+{
+	return(m_vsyncMode);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used to measure the time since the start
+ *  of the last frame and add it to the smoothing history.
+ ***********************************************************/
+void FramePacer::BeginFrame()
+{
+	double currentTime = GetTime();
+
+	m_deltaTime = currentTime - m_frameStartTime;
+	m_frameStartTime = currentTime;
+	if (m_deltaTime > g_MaxDeltaTime)
+	{
+		m_deltaTime = g_MaxDeltaTime;
+	}
+
+	m_deltaHistory[m_deltaHistoryIndex] = m_deltaTime;
+	m_deltaHistoryIndex = (m_deltaHistoryIndex + 1) % SMOOTHING_FRAMES;
+	if (m_deltaHistoryCount < SMOOTHING_FRAMES)
+	{
+		m_deltaHistoryCount++;
+	}
+}
+
+/***********************************************************
+ *  WaitForNextFrame()
+ *
+ *  This method is used to wait until the next frame is due
+ *  when a frame rate limit is set.  A frame that runs late
+ *  starts a new schedule instead of rushing the next frames.
+ ***********************************************************/
+void FramePacer::WaitForNextFrame()
+{
+	if (m_framePeriod <= 0.0)
+	{
+		return;
+	}
+
+	m_nextFrameTime += m_framePeriod;
+
+	double currentTime = GetTime();
+	if (m_nextFrameTime < currentTime - m_framePeriod)
+	{
+		m_nextFrameTime = currentTime;
+		return;
+	}
+
+	SleepUntil(m_nextFrameTime);
+}
+
+/***********************************************************
+ *  SleepUntil()
+ *
+ *  This method is used to wait until a deadline with little
+ *  CPU use.  Short sleeps are taken while the remaining time
+ *  is longer than the estimated worst sleep, and the rest of
+ *  the time is spun away for precision.
+ ***********************************************************/
+void FramePacer::SleepUntil(double deadline)
+{
+	double currentTime = GetTime();
+
+	while (deadline - currentTime > 0.0)
+	{
+		double stddev = std::sqrt(m_sleepM2 / (double)m_sleepCount);
+		double estimate = m_sleepMean + stddev;
+		if (deadline - currentTime <= estimate)
+		{
+			break;
+		}
+
+		std::this_thread::sleep_for(std::chrono::duration<double>(g_SleepSlice));
+
+		// update the mean and variance of the sleep length
+		double sleepTime = GetTime() - currentTime;
+		currentTime += sleepTime;
+		m_sleepCount++;
+		double delta = sleepTime - m_sleepMean;
+		m_sleepMean += delta / (double)m_sleepCount;
+		m_sleepM2 += delta * (sleepTime - m_sleepMean);
+	}
+
+	// spin for the remaining fraction of a millisecond
+	while (GetTime() < deadline)
+	{
+		std::this_thread::yield();
+	}
+}
+
+/***********************************************************
+ *  GetDeltaTime()
+ *
+ *  This method is used to get the length of the last frame.
+ ***********************************************************/
+double FramePacer::GetDeltaTime() const
+{
+	return(m_deltaTime);
+}
+
+/***********************************************************
+ *  GetSmoothedDeltaTime()
+ *
+ *  This method is used to get the average length of the
+ *  last frames, which keeps the camera movement steady when
+ *  single frames vary in length.
+ ***********************************************************/
+double FramePacer::GetSmoothedDeltaTime() const
+{
+	if (m_deltaHistoryCount == 0)
+	{
+		return(0.0);
+	}
+
+	double total = 0.0;
+	for (int i = 0; i < m_deltaHistoryCount; i++)
+	{
+		total += m_deltaHistory[i];
+	}
+
+	return(total / (double)m_deltaHistoryCount);
+}
@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.h
+// ============
+// pace the frames of the main loop and measure the frame time
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/***********************************************************
+ *  FramePacer
+ *
+ *  This class contains the code for pacing the main loop.
+ *  It measures every frame with a double precision monotonic
+ *  clock, smooths the frame delta time used for the camera
+ *  movement, sets the vertical sync mode of the display, and
+ *  limits the frame rate to a target by sleeping for most of
+ *  the remaining frame time and spinning for the last part.
+ ***********************************************************/
+class FramePacer
+{
+public:
+	// constructor
+	FramePacer();
+	// destructor
+	~FramePacer();
+
+	enum VSYNC_MODE
+	{
+		VSYNC_OFF,
+		VSYNC_ON,
+		VSYNC_ADAPTIVE		// tear instead of waiting when a frame is late
+	};
+
+	// get the seconds elapsed on the monotonic clock
+	static double GetTime();
+
+	// set the frame rate limit, zero renders as fast as possible
+	void SetTargetFPS(double targetFPS);
+	double GetTargetFPS() const;
+
+	// set the vertical sync mode of the current OpenGL context
+	void SetVSyncMode(VSYNC_MODE mode);
+	VSYNC_MODE GetVSyncMode() const;
+
+	// measure the time since the last frame started
+	void BeginFrame();
+	// wait until the next frame is due
+	void WaitForNextFrame();
+
+	// get the raw and smoothed frame times in seconds
+	double GetDeltaTime() const;
+	double GetSmoothedDeltaTime() const;
+
+private:
+	// number of frames averaged for the smoothed delta time
+	static const int SMOOTHING_FRAMES = 8;
+
+	// frame rate limit and the resulting frame period
+	double m_targetFPS;
+	double m_framePeriod;
+	// vertical sync mode that is applied
+	VSYNC_MODE m_vsyncMode;
+	// start of the last frame and the time the next frame is due
+	double m_frameStartTime;
+	double m_nextFrameTime;
+	// raw frame time and the history used to smooth it
+	double m_deltaTime;
+	double m_deltaHistory[SMOOTHING_FRAMES];
+	int m_deltaHistoryIndex;
+	int m_deltaHistoryCount;
+	// running estimate of how long a short sleep really takes
+	double m_sleepMean;
+	double m_sleepM2;
+	long long m_sleepCount;
+
+	// sleep for most of the remaining time, then spin until the deadline
+	void SleepUntil(double deadline);
+};
@@ -0,0 +1,315 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.cpp
+// ============
+// measure the CPU and GPU time of nested scopes within each frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameProfiler.h"
+#include "FramePacer.h"
+
+#include <iostream>
+#include <fstream>
+
+// declaration of global variables
+namespace
+{
+	// profiler that the profiled scopes record into
+	FrameProfiler* g_pActiveProfiler = NULL;
+
+	// thread ids of the CPU and GPU timelines in the trace
+	const int g_CPUTraceThread = 1;
+	const int g_GPUTraceThread = 2;
+}
+
+/***********************************************************
+ *  FrameProfiler()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameProfiler::FrameProfiler(size_t eventCapacity)
+{
+	m_events.resize(eventCapacity);
+	m_nextEvent = 0;
+	m_frame = 0;
+	m_depth = 0;
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		m_frameQueries[i].frame = 0;
+		m_frameQueries[i].usedQueries = 0;
+		m_frameQueries[i].cpuCalibration = 0.0;
+		m_frameQueries[i].gpuCalibration = 0;
+	}
+}
+
+/***********************************************************
+ *  ~FrameProfiler()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameProfiler::~FrameProfiler()
+{
+	if (g_pActiveProfiler == this)
+	{
+		g_pActiveProfiler = NULL;
+	}
+
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		if (m_frameQueries[i].queries.size() > 0)
+		{
+			glDeleteQueries((GLsizei)m_frameQueries[i].queries.size(), m_frameQueries[i].queries.data());
+		}
+	}
+}
+
+/***********************************************************
+ *  GetActive()
+ *
+ *  This method is used to get the profiler that the
+ *  profiled scopes record into.
+ ***********************************************************/
+FrameProfiler* FrameProfiler::GetActive()
+{
+	return(g_pActiveProfiler);
+}
+
+/***********************************************************
+ *  SetActive()
+ *
+ *  This method is used to set the profiler that the
+ *  profiled scopes record into, or NULL to stop profiling.
+ ***********************************************************/
+void FrameProfiler::SetActive(FrameProfiler* pProfiler)
+{
+	g_pActiveProfiler = pProfiler;
+}
+
+/***********************************************************
+ *  GetEvent()
+ *
+ *  This method is used to get a recorded event from the ring
+ *  buffer, unless it was overwritten by a newer event.
+ ***********************************************************/
+FrameProfiler::PROFILE_EVENT* FrameProfiler::GetEvent(uint64_t sequence)
+{
+	PROFILE_EVENT& event = m_events[sequence % m_events.size()];
+	if (event.sequence != sequence)
+	{
+		return(NULL);
+	}
+
+	return(&event);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used to start a new frame.  The slot of
+ *  the frame that was recorded FRAME_LATENCY frames ago is
+ *  read back and reused.  The current CPU and GPU times are
+ *  sampled to line the two timelines up in the trace.
+ ***********************************************************/
+void FrameProfiler::BeginFrame()
+{
+	m_frame++;
+	m_depth = 0;
+
+	FRAME_QUERIES& frameQueries = m_frameQueries[m_frame % FRAME_LATENCY];
+	ResolveFrame(frameQueries, false);
+
+	frameQueries.frame = m_frame;
+	frameQueries.usedQueries = 0;
+	frameQueries.events.clear();
+	glGetInteger64v(GL_TIMESTAMP, &frameQueries.gpuCalibration);
+	frameQueries.cpuCalibration = FramePacer::GetTime();
+}
+
+/***********************************************************
+ *  BeginScope()
+ *
+ *  This method is used to record the start of a profiled
+ *  scope, and to issue its GPU start timestamp query.
+ ***********************************************************/
+uint64_t FrameProfiler::BeginScope(const char* name, bool bGPU)
+{
+	uint64_t sequence = m_nextEvent++;
+	PROFILE_EVENT& event = m_events[sequence % m_events.size()];
+	FRAME_QUERIES& frameQueries = m_frameQueries[m_frame % FRAME_LATENCY];
+
+	event.name = name;
+	event.sequence = sequence;
+	event.frame = m_frame;
+	event.depth = m_depth++;
+	event.bEnded = false;
+	event.bGPU = bGPU;
+	event.bGPUResolved = false;
+	event.queryIndex = -1;
+	event.gpuStart = 0;
+	event.gpuEnd = 0;
+	event.cpuCalibration = frameQueries.cpuCalibration;
+	event.gpuCalibration = frameQueries.gpuCalibration;
+
+	if (bGPU == true)
+	{
+		// the query pool of a frame only grows until it fits the frame
+		if (frameQueries.usedQueries + 2 > frameQueries.queries.size())
+		{
+			size_t first = frameQueries.queries.size();
+			frameQueries.queries.resize(first + 16);
+			glGenQueries(16, &frameQueries.queries[first]);
+		}
+
+		event.queryIndex = (int)frameQueries.usedQueries;
+		frameQueries.usedQueries += 2;
+		frameQueries.events.push_back(sequence);
+
+		// nested GL_TIME_ELAPSED queries are not allowed, so every
+		// scope is measured with a pair of timestamps instead
+		glQueryCounter(frameQueries.queries[event.queryIndex], GL_TIMESTAMP);
+	}
+
+	event.cpuStart = FramePacer::GetTime();
+
+	return(sequence);
+}
+
+/***********************************************************
+ *  EndScope()
+ *
+ *  This method is used to record the end of a profiled
+ *  scope, and to issue its GPU end timestamp query.
+ ***********************************************************/
+void FrameProfiler::EndScope(uint64_t sequence)
+{
+	double currentTime = FramePacer::GetTime();
+
+	m_depth--;
+
+	PROFILE_EVENT* pEvent = GetEvent(sequence);
+	if (NULL == pEvent)
+	{
+		return;
+	}
+
+	pEvent->cpuEnd = currentTime;
+	pEvent->bEnded = true;
+	if ((pEvent->bGPU == true) && (pEvent->frame == m_frame))
+	{
+		FRAME_QUERIES& frameQueries = m_frameQueries[m_frame % FRAME_LATENCY];
+		glQueryCounter(frameQueries.queries[pEvent->queryIndex + 1], GL_TIMESTAMP);
+	}
+}
+
+/***********************************************************
+ *  ResolveFrame()
+ *
+ *  This method is used to read back the GPU timestamps of the
+ *  events of a frame.  Unless waiting is requested, nothing is
+ *  read while the last query of the frame is still pending.
+ ***********************************************************/
+void FrameProfiler::ResolveFrame(FRAME_QUERIES& frameQueries, bool bWait)
+{
+	if (frameQueries.usedQueries == 0)
+	{
+		return;
+	}
+
+	// the queries finish in order, so the last one tells for all
+	if (bWait == false)
+	{
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(frameQueries.queries[frameQueries.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_FALSE)
+		{
+			frameQueries.usedQueries = 0;
+			return;
+		}
+	}
+
+	for (size_t i = 0; i < frameQueries.events.size(); i++)
+	{
+		PROFILE_EVENT* pEvent = GetEvent(frameQueries.events[i]);
+		if ((NULL == pEvent) || (pEvent->bEnded == false))
+		{
+			continue;
+		}
+
+		glGetQueryObjectui64v(frameQueries.queries[pEvent->queryIndex], GL_QUERY_RESULT, &pEvent->gpuStart);
+		glGetQueryObjectui64v(frameQueries.queries[pEvent->queryIndex + 1], GL_QUERY_RESULT, &pEvent->gpuEnd);
+		pEvent->bGPUResolved = true;
+	}
+
+	frameQueries.usedQueries = 0;
+	frameQueries.events.clear();
+}
+
+/***********************************************************
+ *  WriteChromeTrace()
+ *
+ *  This method is used to write the events in the ring buffer
+ *  as a Chrome trace.  Every scope becomes a complete event
+ *  on the CPU timeline, and on the GPU timeline when it was
+ *  measured on the GPU as well.
+ ***********************************************************/
+bool FrameProfiler::WriteChromeTrace(const char* filename)
+{
+	// the frames in flight are waited for, since the program is done
+	glFinish();
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		ResolveFrame(m_frameQueries[i], true);
+	}
+
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create trace file:" << filename << std::endl;
+		return(false);
+	}
+
+	file << "{\"traceEvents\":[" << std::endl;
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << g_CPUTraceThread << ",\"args\":{\"name\":\"CPU\"}}," << std::endl;
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << g_GPUTraceThread << ",\"args\":{\"name\":\"GPU\"}}";
+	file.precision(3);
+	file << std::fixed;
+
+	uint64_t firstEvent = (m_nextEvent > m_events.size()) ? (m_nextEvent - m_events.size()) : 0;
+	for (uint64_t sequence = firstEvent; sequence < m_nextEvent; sequence++)
+	{
+		const PROFILE_EVENT* pEvent = GetEvent(sequence);
+		if ((NULL == pEvent) || (pEvent->bEnded == false))
+		{
+			continue;
+		}
+
+		file << "," << std::endl << "{\"name\":\"" << pEvent->name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << g_CPUTraceThread
+			<< ",\"ts\":" << (pEvent->cpuStart * 1000000.0)
+			<< ",\"dur\":" << ((pEvent->cpuEnd - pEvent->cpuStart) * 1000000.0)
+			<< ",\"args\":{\"frame\":" << pEvent->frame << ",\"depth\":" << pEvent->depth << "}}";
+
+		if (pEvent->bGPUResolved == true)
+		{
+			// place the GPU times relative to the calibration of their frame
+			double gpuStart = pEvent->cpuCalibration * 1000000.0 + (double)((GLint64)pEvent->gpuStart - pEvent->gpuCalibration) / 1000.0;
+			double gpuDuration = (double)(pEvent->gpuEnd - pEvent->gpuStart) / 1000.0;
+			file << "," << std::endl << "{\"name\":\"" << pEvent->name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << g_GPUTraceThread
+				<< ",\"ts\":" << gpuStart
+				<< ",\"dur\":" << gpuDuration
+				<< ",\"args\":{\"frame\":" << pEvent->frame << "}}";
+		}
+	}
+
+	file << std::endl << "]}" << std::endl;
+
+	if (!file)
+	{
+		std::cout << "Could not write trace file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote trace file:" << filename << std::endl;
+
+	return(true);
+}
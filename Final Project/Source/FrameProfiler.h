@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.h
+// ============
+// measure the CPU and GPU time of nested scopes within each frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "AllocationTracker.h"
+
+#include <GL/glew.h>
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************
+ *  FrameProfiler
+ *
+ *  This class contains the code for a hierarchical frame
+ *  profiler.  Every profiled scope records its CPU start and
+ *  end times into a fixed size ring buffer, and brackets its
+ *  OpenGL commands with a pair of GPU timestamp queries.  The
+ *  queries are read back a few frames later, once the GPU
+ *  has finished with them, so the profiler never stalls the
+ *  pipeline.  The frames in the ring buffer can be exported
+ *  as a Chrome trace, which chrome://tracing and Perfetto
+ *  display as nested timelines for the CPU and the GPU.
+ ***********************************************************/
+class FrameProfiler
+{
+public:
+	// constructor
+	FrameProfiler(size_t eventCapacity = 16384);
+	// destructor
+	~FrameProfiler();
+
+	// get and set the profiler that the profiled scopes record into
+	static FrameProfiler* GetActive();
+	static void SetActive(FrameProfiler* pProfiler);
+
+	// start a new frame and read back the finished GPU queries
+	void BeginFrame();
+
+	// record the start and end of a profiled scope
+	uint64_t BeginScope(const char* name, bool bGPU);
+	void EndScope(uint64_t event);
+
+	// write the recorded frames as a Chrome trace JSON file
+	bool WriteChromeTrace(const char* filename);
+
+private:
+	// frames that pass before the GPU queries of a frame are read back
+	static const int FRAME_LATENCY = 4;
+
+	struct PROFILE_EVENT
+	{
+		const char* name;
+		uint64_t sequence;
+		uint64_t frame;
+		int depth;
+		double cpuStart;
+		double cpuEnd;
+		bool bEnded;
+		bool bGPU;
+		bool bGPUResolved;
+		int queryIndex;
+		GLuint64 gpuStart;
+		GLuint64 gpuEnd;
+		// matching CPU and GPU times for placing the GPU events
+		double cpuCalibration;
+		GLint64 gpuCalibration;
+	};
+
+	struct FRAME_QUERIES
+	{
+		uint64_t frame;
+		std::vector<GLuint> queries;
+		std::vector<uint64_t> events;
+		size_t usedQueries;
+		double cpuCalibration;
+		GLint64 gpuCalibration;
+	};
+
+	// ring buffer of the recorded events
+	std::vector<PROFILE_EVENT> m_events;
+	uint64_t m_nextEvent;
+	// number of the current frame and the current scope depth
+	uint64_t m_frame;
+	int m_depth;
+	// timestamp queries of the frames that are still in flight
+	FRAME_QUERIES m_frameQueries[FRAME_LATENCY];
+
+	// get a recorded event, or NULL when it was overwritten
+	PROFILE_EVENT* GetEvent(uint64_t sequence);
+	// read back the GPU times of the events of a frame
+	void ResolveFrame(FRAME_QUERIES& frameQueries, bool bWait);
+};
+
+/***********************************************************
+ *  ProfileScope
+ *
+ *  This class records a profiled scope from its construction
+ *  to the end of the enclosing block.  It does nothing when
+ *  no profiler is active, except for naming the phase that
+ *  the heap allocations of the block are attributed to.
+ ***********************************************************/
+class ProfileScope
+{
+public:
+	ProfileScope(const char* name, bool bGPU)
+	{
+		m_pPreviousPhase = AllocationTracker::EnterPhase(name);
+		m_pProfiler = FrameProfiler::GetActive();
+		m_event = 0;
+		if (NULL != m_pProfiler)
+		{
+			m_event = m_pProfiler->BeginScope(name, bGPU);
+		}
+	}
+
+	~ProfileScope()
+	{
+		if (NULL != m_pProfiler)
+		{
+			m_pProfiler->EndScope(m_event);
+		}
+		AllocationTracker::LeavePhase(m_pPreviousPhase);
+	}
+
+private:
+	FrameProfiler* m_pProfiler;
+	uint64_t m_event;
+	const char* m_pPreviousPhase;
+};
+
+// profile the rest of the enclosing block on the CPU and the GPU
+#define PROFILE_SCOPE_NAME(line) profileScope##line
+#define PROFILE_SCOPE_LINE(name, bGPU, line) ProfileScope PROFILE_SCOPE_NAME(line)(name, bGPU)
+#define PROFILE_SCOPE(name) PROFILE_SCOPE_LINE(name, true, __LINE__)
+// profile the rest of the enclosing block on the CPU only
+#define PROFILE_CPU_SCOPE(name) PROFILE_SCOPE_LINE(name, false, __LINE__)
@@ -0,0 +1,400 @@
+///////////////////////////////////////////////////////////////////////////////
+// glrenderbackend.cpp
+// ============
+// draw the scene with OpenGL
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLRenderBackend.h"
+
+#include <iostream>
+
+/***********************************************************
+ *  GLRenderBackend()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GLRenderBackend::GLRenderBackend(ShaderManager* pSceneShaderManager, ShapeMeshes* pShapeMeshes)
+{
+	m_pSceneShaderManager = pSceneShaderManager;
+	m_pShapeMeshes = pShapeMeshes;
+	m_programs.push_back(pSceneShaderManager);
+	m_currentProgram = (NULL != pSceneShaderManager) ? pSceneShaderManager->m_programID : 0;
+}
+
+/***********************************************************
+ *  ~GLRenderBackend()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+GLRenderBackend::~GLRenderBackend()
+{
+	// the first program is the scene program of the caller
+	for (size_t i = 1; i < m_programs.size(); i++)
+	{
+		if (NULL != m_programs[i])
+		{
+			delete m_programs[i];
+			m_programs[i] = NULL;
+		}
+	}
+	m_programs.clear();
+	m_pSceneShaderManager = NULL;
+	m_pShapeMeshes = NULL;
+}
+
+/***********************************************************
+ *  GetSceneProgram()
+ *
+ *  This method is used to get the handle of the scene shader
+ *  program that the backend was created with.
+ ***********************************************************/
+uint32_t GLRenderBackend::GetSceneProgram() const
+{
+	return(1);
+}
+
+/***********************************************************
+ *  GetName()
+ *
+ *  This method is used to get the name of the backend.
+ ***********************************************************/
+const char* GLRenderBackend::GetName() const
+{
+	return("opengl");
+}
+
+/***********************************************************
+ *  SupportsOpenGLPasses()
+ *
+ *  This method is used to check whether the passes with
+ *  their own OpenGL framebuffers can run, which they always
+ *  can with this backend.
+ ***********************************************************/
+bool GLRenderBackend::SupportsOpenGLPasses() const
+{
+	return(true);
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used to create a buffer with its initial
+ *  data.  The buffers are created through the copy target,
+ *  so the bindings of the scene are not changed.
+ ***********************************************************/
+uint32_t GLRenderBackend::CreateBuffer(BUFFER_TYPE type, const void* pData, size_t size)
+{
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)size, pData,
+		(type == BUFFER_UNIFORM) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	return(buffer);
+}
+
+/***********************************************************
+ *  UpdateBuffer()
+ *
+ *  This method is used to replace a range of a buffer.
+ ***********************************************************/
+void GLRenderBackend::UpdateBuffer(uint32_t buffer, size_t offset, const void* pData, size_t size)
+{
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)offset, (GLsizeiptr)size, pData);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  DestroyBuffer()
+ *
+ *  This method is used to free a buffer.
+ ***********************************************************/
+void GLRenderBackend::DestroyBuffer(uint32_t buffer)
+{
+	GLuint name = buffer;
+	glDeleteBuffers(1, &name);
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used to create a repeating RGBA texture
+ *  with the filtering of the scene textures.  The texture
+ *  bound to the active unit is restored afterwards.
+ ***********************************************************/
+uint32_t GLRenderBackend::CreateTexture(int width, int height, const unsigned char* pPixels, bool bGenerateMips)
+{
+	GLint savedTexture = 0;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &savedTexture);
+
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, bGenerateMips ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pPixels);
+	if (true == bGenerateMips)
+	{
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+	glBindTexture(GL_TEXTURE_2D, (GLuint)savedTexture);
+
+	return(texture);
+}
+
+/***********************************************************
+ *  DestroyTexture()
+ *
+ *  This method is used to free a texture.
+ ***********************************************************/
+void GLRenderBackend::DestroyTexture(uint32_t texture)
+{
+	GLuint name = texture;
+	glDeleteTextures(1, &name);
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used to bind a texture to a texture unit.
+ ***********************************************************/
+void GLRenderBackend::BindTexture(int unit, uint32_t texture)
+{
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+/***********************************************************
+ *  CreateProgram()
+ *
+ *  This method is used to load a shader program.  The
+ *  program in use does not change.
+ ***********************************************************/
+uint32_t GLRenderBackend::CreateProgram(const char* vertexShaderPath, const char* fragmentShaderPath)
+{
+	GLint savedProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &savedProgram);
+
+	ShaderManager* pShaderManager = new ShaderManager();
+	pShaderManager->LoadShaders(vertexShaderPath, fragmentShaderPath);
+	glUseProgram((GLuint)savedProgram);
+	if (pShaderManager->m_programID == 0)
+	{
+		std::cout << "Could not load the shader program:" << vertexShaderPath << std::endl;
+		delete pShaderManager;
+		return(0);
+	}
+
+	m_programs.push_back(pShaderManager);
+
+	return((uint32_t)m_programs.size());
+}
+
+/***********************************************************
+ *  DestroyProgram()
+ *
+ *  This method is used to free a loaded shader program.
+ ***********************************************************/
+void GLRenderBackend::DestroyProgram(uint32_t program)
+{
+	if ((program <= 1) || (program > m_programs.size()) || (NULL == m_programs[program - 1]))
+	{
+		return;
+	}
+
+	if (m_currentProgram == m_programs[program - 1]->m_programID)
+	{
+		m_currentProgram = 0;
+	}
+	delete m_programs[program - 1];
+	m_programs[program - 1] = NULL;
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used to select the program of the next
+ *  draws and uniforms.
+ ***********************************************************/
+void GLRenderBackend::UseProgram(uint32_t program)
+{
+	if ((program == 0) || (program > m_programs.size()) || (NULL == m_programs[program - 1]))
+	{
+		return;
+	}
+
+	m_programs[program - 1]->use();
+	m_currentProgram = m_programs[program - 1]->m_programID;
+}
+
+/***********************************************************
+ *  SetIntValue()
+ *
+ *  This method is used to set an integer, boolean or sampler
+ *  uniform of the program in use.
+ ***********************************************************/
+void GLRenderBackend::SetIntValue(const char* name, int value)
+{
+	glUniform1i(glGetUniformLocation(m_currentProgram, name), value);
+}
+
+/***********************************************************
+ *  SetFloatValue()
+ *
+ *  This method is used to set a float uniform of the
+ *  program in use.
+ ***********************************************************/
+void GLRenderBackend::SetFloatValue(const char* name, float value)
+{
+	glUniform1f(glGetUniformLocation(m_currentProgram, name), value);
+}
+
+/***********************************************************
+ *  SetVec2Value()
+ *
+ *  This method is used to set a vec2 uniform of the program
+ *  in use.
+ ***********************************************************/
+void GLRenderBackend::SetVec2Value(const char* name, const glm::vec2& value)
+{
+	glUniform2fv(glGetUniformLocation(m_currentProgram, name), 1, &value[0]);
+}
+
+/***********************************************************
+ *  SetVec3Value()
+ *
+ *  This method is used to set a vec3 uniform of the program
+ *  in use.
+ ***********************************************************/
+void GLRenderBackend::SetVec3Value(const char* name, const glm::vec3& value)
+{
+	glUniform3fv(glGetUniformLocation(m_currentProgram, name), 1, &value[0]);
+}
+
+/***********************************************************
+ *  SetVec4Value()
+ *
+ *  This method is used to set a vec4 uniform of the program
+ *  in use.
+ ***********************************************************/
+void GLRenderBackend::SetVec4Value(const char* name, const glm::vec4& value)
+{
+	glUniform4fv(glGetUniformLocation(m_currentProgram, name), 1, &value[0]);
+}
+
+/***********************************************************
+ *  SetMat4Value()
+ *
+ *  This method is used to set a mat4 uniform of the program
+ *  in use.
+ ***********************************************************/
+void GLRenderBackend::SetMat4Value(const char* name, const glm::mat4& value)
+{
+	glUniformMatrix4fv(glGetUniformLocation(m_currentProgram, name), 1, GL_FALSE, &value[0][0]);
+}
+
+/***********************************************************
+ *  SetState()
+ *
+ *  This method is used to turn a render state on or off.
+ ***********************************************************/
+void GLRenderBackend::SetState(RENDER_STATE state, bool bEnabled)
+{
+	switch (state)
+	{
+	case STATE_DEPTH_TEST:
+		if (true == bEnabled)
+			glEnable(GL_DEPTH_TEST);
+		else
+			glDisable(GL_DEPTH_TEST);
+		break;
+	case STATE_DEPTH_WRITE:
+		glDepthMask(bEnabled ? GL_TRUE : GL_FALSE);
+		break;
+	case STATE_COLOR_WRITE:
+		glColorMask(bEnabled, bEnabled, bEnabled, bEnabled);
+		break;
+	case STATE_BLEND:
+		if (true == bEnabled)
+			glEnable(GL_BLEND);
+		else
+			glDisable(GL_BLEND);
+		break;
+	}
+}
+
+/***********************************************************
+ *  SetDepthFunction()
+ *
+ *  This method is used to set the comparison of the depth
+ *  test.
+ ***********************************************************/
+void GLRenderBackend::SetDepthFunction(DEPTH_FUNCTION function)
+{
+	switch (function)
+	{
+	case DEPTH_LESS:
+		glDepthFunc(GL_LESS);
+		break;
+	case DEPTH_LESS_EQUAL:
+		glDepthFunc(GL_LEQUAL);
+		break;
+	case DEPTH_EQUAL:
+		glDepthFunc(GL_EQUAL);
+		break;
+	}
+}
+
+/***********************************************************
+ *  DrawShape()
+ *
+ *  This method is used to draw a basic shape mesh.
+ ***********************************************************/
+void GLRenderBackend::DrawShape(SHAPE_MESH shape)
+{
+	switch (shape)
+	{
+	case SHAPE_BOX:
+		m_pShapeMeshes->DrawBoxMesh();
+		break;
+	case SHAPE_CONE:
+		m_pShapeMeshes->DrawConeMesh();
+		break;
+	case SHAPE_CYLINDER:
+		m_pShapeMeshes->DrawCylinderMesh();
+		break;
+	case SHAPE_PLANE:
+		m_pShapeMeshes->DrawPlaneMesh();
+		break;
+	case SHAPE_PRISM:
+		m_pShapeMeshes->DrawPrismMesh();
+		break;
+	case SHAPE_SPHERE:
+		m_pShapeMeshes->DrawSphereMesh();
+		break;
+	case SHAPE_TAPERED_CYLINDER:
+		m_pShapeMeshes->DrawTaperedCylinderMesh();
+		break;
+	case SHAPE_TORUS:
+		m_pShapeMeshes->DrawTorusMesh();
+		break;
+	default:
+		break;
+	}
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used to mark the end of a frame, which
+ *  needs nothing with OpenGL.
+ ***********************************************************/
+void GLRenderBackend::EndFrame()
+{
+}
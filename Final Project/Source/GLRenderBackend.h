@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// glrenderbackend.h
+// ============
+// draw the scene with OpenGL
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+#include "ShaderManager.h"
+#include "ShapeMeshes.h"
+
+#include <GL/glew.h>
+
+#include <vector>
+
+/***********************************************************
+ *  GLRenderBackend
+ *
+ *  This class contains the OpenGL implementation of the
+ *  render backend.  The buffer and texture handles are the
+ *  OpenGL names, the shape meshes are drawn by the basic
+ *  shapes of the scene, and the scene shader program is the
+ *  first program, so the other passes keep working with the
+ *  same program.  The uniforms are set through their
+ *  locations, without converting the names into strings.
+ ***********************************************************/
+class GLRenderBackend : public RenderBackend
+{
+public:
+	// constructor
+	GLRenderBackend(ShaderManager* pSceneShaderManager, ShapeMeshes* pShapeMeshes);
+	// destructor
+	virtual ~GLRenderBackend();
+
+	// get the handle of the scene shader program
+	uint32_t GetSceneProgram() const;
+
+	virtual const char* GetName() const;
+	virtual bool SupportsOpenGLPasses() const;
+
+	virtual uint32_t CreateBuffer(BUFFER_TYPE type, const void* pData, size_t size);
+	virtual void UpdateBuffer(uint32_t buffer, size_t offset, const void* pData, size_t size);
+	virtual void DestroyBuffer(uint32_t buffer);
+
+	virtual uint32_t CreateTexture(int width, int height, const unsigned char* pPixels, bool bGenerateMips);
+	virtual void DestroyTexture(uint32_t texture);
+	virtual void BindTexture(int unit, uint32_t texture);
+
+	virtual uint32_t CreateProgram(const char* vertexShaderPath, const char* fragmentShaderPath);
+	virtual void DestroyProgram(uint32_t program);
+	virtual void UseProgram(uint32_t program);
+
+	virtual void SetIntValue(const char* name, int value);
+	virtual void SetFloatValue(const char* name, float value);
+	virtual void SetVec2Value(const char* name, const glm::vec2& value);
+	virtual void SetVec3Value(const char* name, const glm::vec3& value);
+	virtual void SetVec4Value(const char* name, const glm::vec4& value);
+	virtual void SetMat4Value(const char* name, const glm::mat4& value);
+
+	virtual void SetState(RENDER_STATE state, bool bEnabled);
+	virtual void SetDepthFunction(DEPTH_FUNCTION function);
+
+	virtual void DrawShape(SHAPE_MESH shape);
+
+	virtual void EndFrame();
+
+private:
+	// loaded programs, the handle is the index plus one
+	std::vector<ShaderManager*> m_programs;
+	// the scene program is not owned by the backend
+	ShaderManager* m_pSceneShaderManager;
+	ShapeMeshes* m_pShapeMeshes;
+	// OpenGL name of the program that the uniforms are set on
+	GLuint m_currentProgram;
+};
@@ -0,0 +1,382 @@
+///////////////////////////////////////////////////////////////////////////////
+// glstatecache.cpp
+// ============
+// track the OpenGL state to skip the calls that would not change it
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLStateCache.h"
+
+// declaration of global variables
+namespace
+{
+	// capabilities whose enabled state is tracked, the others are
+	// always passed through
+	const GLenum g_TrackedCaps[] =
+	{
+		GL_DEPTH_TEST,
+		GL_BLEND,
+		GL_CULL_FACE,
+		GL_SCISSOR_TEST,
+		GL_STENCIL_TEST,
+		GL_POLYGON_OFFSET_FILL,
+		GL_MULTISAMPLE,
+		GL_FRAMEBUFFER_SRGB
+	};
+	const int g_TrackedCapCount = sizeof(g_TrackedCaps) / sizeof(g_TrackedCaps[0]);
+
+	// texture targets whose bindings are tracked on every unit
+	const GLenum g_TrackedTargets[] =
+	{
+		GL_TEXTURE_2D,
+		GL_TEXTURE_2D_ARRAY,
+		GL_TEXTURE_3D,
+		GL_TEXTURE_CUBE_MAP
+	};
+	const int g_TrackedTargetCount = sizeof(g_TrackedTargets) / sizeof(g_TrackedTargets[0]);
+	// number of texture units whose bindings are tracked
+	const int g_TrackedUnitCount = 32;
+
+	// a tracked value and whether it is known
+	template <typename T>
+	struct CACHED_VALUE
+	{
+		T value;
+		bool bKnown;
+	};
+
+	bool g_bActive = true;
+	CACHED_VALUE<bool> g_Caps[g_TrackedCapCount];
+	CACHED_VALUE<GLuint> g_Program;
+	CACHED_VALUE<GLuint> g_VertexArray;
+	CACHED_VALUE<GLenum> g_ActiveTexture;
+	CACHED_VALUE<GLuint> g_Textures[g_TrackedUnitCount][g_TrackedTargetCount];
+	CACHED_VALUE<GLenum> g_BlendFunc[2];
+	CACHED_VALUE<GLenum> g_DepthFunc;
+	CACHED_VALUE<GLboolean> g_DepthMask;
+	CACHED_VALUE<GLint> g_Viewport[4];
+	CACHED_VALUE<GLfloat> g_ClearColor[4];
+
+	/***********************************************************
+	 *  UpdateValue()
+	 *
+	 *  This function is used to store a requested value, and
+	 *  returns whether it differs from the known value.
+	 ***********************************************************/
+	template <typename T>
+	bool UpdateValue(CACHED_VALUE<T>& cached, T value)
+	{
+		if ((g_bActive == true) && (cached.bKnown == true) && (cached.value == value))
+		{
+			return(false);
+		}
+
+		cached.value = value;
+		cached.bKnown = true;
+		return(true);
+	}
+
+	/***********************************************************
+	 *  UpdateValues()
+	 *
+	 *  This function is used to store a group of values that
+	 *  are set by a single call, and returns whether any of them
+	 *  differs from the known values.
+	 ***********************************************************/
+	template <typename T>
+	bool UpdateValues(CACHED_VALUE<T>* cached, const T* values, int count)
+	{
+		bool bChanged = false;
+		for (int i = 0; i < count; i++)
+		{
+			if (UpdateValue(cached[i], values[i]) == true)
+			{
+				bChanged = true;
+			}
+		}
+
+		return(bChanged);
+	}
+
+	/***********************************************************
+	 *  FindCap()
+	 *
+	 *  This function is used to find the index of a tracked
+	 *  capability, or -1.
+	 ***********************************************************/
+	int FindCap(GLenum cap)
+	{
+		for (int i = 0; i < g_TrackedCapCount; i++)
+		{
+			if (g_TrackedCaps[i] == cap)
+			{
+				return(i);
+			}
+		}
+
+		return(-1);
+	}
+
+	/***********************************************************
+	 *  FindTarget()
+	 *
+	 *  This function is used to find the index of a tracked
+	 *  texture target, or -1.
+	 ***********************************************************/
+	int FindTarget(GLenum target)
+	{
+		for (int i = 0; i < g_TrackedTargetCount; i++)
+		{
+			if (g_TrackedTargets[i] == target)
+			{
+				return(i);
+			}
+		}
+
+		return(-1);
+	}
+}
+
+/***********************************************************
+ *  SetActive()
+ *
+ *  This method is used to turn the cache on or off.  While
+ *  it is off, every call is let through but the state is
+ *  still tracked, so it can be turned back on at any time.
+ ***********************************************************/
+void GLStateCache::SetActive(bool bActive)
+{
+	g_bActive = bActive;
+}
+
+/***********************************************************
+ *  IsActive()
+ *
+ *  This method is used to check whether redundant calls are
+ *  skipped.
+ ***********************************************************/
+bool GLStateCache::IsActive()
+{
+	return(g_bActive);
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used to mark all of the tracked state as
+ *  unknown, which is needed after code that does not go
+ *  through the cache changed it, or for a new context.
+ ***********************************************************/
+void GLStateCache::Invalidate()
+{
+	for (int i = 0; i < g_TrackedCapCount; i++)
+	{
+		g_Caps[i].bKnown = false;
+	}
+	g_Program.bKnown = false;
+	g_VertexArray.bKnown = false;
+	g_ActiveTexture.bKnown = false;
+	for (int unit = 0; unit < g_TrackedUnitCount; unit++)
+	{
+		for (int target = 0; target < g_TrackedTargetCount; target++)
+		{
+			g_Textures[unit][target].bKnown = false;
+		}
+	}
+	g_BlendFunc[0].bKnown = false;
+	g_BlendFunc[1].bKnown = false;
+	g_DepthFunc.bKnown = false;
+	g_DepthMask.bKnown = false;
+	for (int i = 0; i < 4; i++)
+	{
+		g_Viewport[i].bKnown = false;
+		g_ClearColor[i].bKnown = false;
+	}
+}
+
+/***********************************************************
+ *  SetCapability()
+ *
+ *  This method is used to record the enabling or disabling
+ *  of a capability.
+ ***********************************************************/
+bool GLStateCache::SetCapability(GLenum cap, bool bEnabled)
+{
+	int index = FindCap(cap);
+	if (index < 0)
+	{
+		return(true);
+	}
+
+	return(UpdateValue(g_Caps[index], bEnabled));
+}
+
+/***********************************************************
+ *  SetProgram()
+ *
+ *  This method is used to record the binding of a program.
+ ***********************************************************/
+bool GLStateCache::SetProgram(GLuint program)
+{
+	return(UpdateValue(g_Program, program));
+}
+
+/***********************************************************
+ *  SetVertexArray()
+ *
+ *  This method is used to record the binding of a vertex
+ *  array object.
+ ***********************************************************/
+bool GLStateCache::SetVertexArray(GLuint vertexArray)
+{
+	return(UpdateValue(g_VertexArray, vertexArray));
+}
+
+/***********************************************************
+ *  SetActiveTexture()
+ *
+ *  This method is used to record the selection of the active
+ *  texture unit.
+ ***********************************************************/
+bool GLStateCache::SetActiveTexture(GLenum unit)
+{
+	return(UpdateValue(g_ActiveTexture, unit));
+}
+
+/***********************************************************
+ *  SetTexture()
+ *
+ *  This method is used to record the binding of a texture to
+ *  the active texture unit.  Nothing is skipped while the
+ *  active unit is unknown.
+ ***********************************************************/
+bool GLStateCache::SetTexture(GLenum target, GLuint texture)
+{
+	int targetIndex = FindTarget(target);
+	int unit = (int)g_ActiveTexture.value - (int)GL_TEXTURE0;
+	if ((targetIndex < 0) || (g_ActiveTexture.bKnown == false) ||
+		(unit < 0) || (unit >= g_TrackedUnitCount))
+	{
+		return(true);
+	}
+
+	return(UpdateValue(g_Textures[unit][targetIndex], texture));
+}
+
+/***********************************************************
+ *  SetBlendFunc()
+ *
+ *  This method is used to record the blend factors.
+ ***********************************************************/
+bool GLStateCache::SetBlendFunc(GLenum sourceFactor, GLenum destinationFactor)
+{
+	GLenum factors[2] = { sourceFactor, destinationFactor };
+
+	return(UpdateValues(g_BlendFunc, factors, 2));
+}
+
+/***********************************************************
+ *  SetDepthFunc()
+ *
+ *  This method is used to record the depth comparison.
+ ***********************************************************/
+bool GLStateCache::SetDepthFunc(GLenum func)
+{
+	return(UpdateValue(g_DepthFunc, func));
+}
+
+/***********************************************************
+ *  SetDepthMask()
+ *
+ *  This method is used to record whether depth is written.
+ ***********************************************************/
+bool GLStateCache::SetDepthMask(GLboolean flag)
+{
+	return(UpdateValue(g_DepthMask, flag));
+}
+
+/***********************************************************
+ *  SetViewport()
+ *
+ *  This method is used to record the viewport rectangle.
+ ***********************************************************/
+bool GLStateCache::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	GLint viewport[4] = { x, y, (GLint)width, (GLint)height };
+
+	return(UpdateValues(g_Viewport, viewport, 4));
+}
+
+/***********************************************************
+ *  SetClearColor()
+ *
+ *  This method is used to record the clear color.
+ ***********************************************************/
+bool GLStateCache::SetClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+	GLfloat color[4] = { red, green, blue, alpha };
+
+	return(UpdateValues(g_ClearColor, color, 4));
+}
+
+/***********************************************************
+ *  DeleteTextures()
+ *
+ *  This method is used to reset the bindings of deleted
+ *  textures to zero on every unit, like OpenGL does.
+ ***********************************************************/
+void GLStateCache::DeleteTextures(GLsizei count, const GLuint* textures)
+{
+	for (GLsizei i = 0; i < count; i++)
+	{
+		if (textures[i] == 0)
+		{
+			continue;
+		}
+
+		for (int unit = 0; unit < g_TrackedUnitCount; unit++)
+		{
+			for (int target = 0; target < g_TrackedTargetCount; target++)
+			{
+				if (g_Textures[unit][target].value == textures[i])
+				{
+					g_Textures[unit][target].value = 0;
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  DeleteVertexArrays()
+ *
+ *  This method is used to reset the vertex array binding to
+ *  zero when the bound vertex array is deleted.
+ ***********************************************************/
+void GLStateCache::DeleteVertexArrays(GLsizei count, const GLuint* vertexArrays)
+{
+	for (GLsizei i = 0; i < count; i++)
+	{
+		if ((vertexArrays[i] != 0) && (g_VertexArray.value == vertexArrays[i]))
+		{
+			g_VertexArray.value = 0;
+		}
+	}
+}
+
+/***********************************************************
+ *  DeleteProgram()
+ *
+ *  This method is used to forget the program in use when it
+ *  is deleted.  OpenGL keeps using it until another program
+ *  is used, and its name can be given to a new program
+ *  afterwards, so the next use always reaches the driver.
+ ***********************************************************/
+void GLStateCache::DeleteProgram(GLuint program)
+{
+	if ((program != 0) && (g_Program.value == program))
+	{
+		g_Program.bKnown = false;
+	}
+}
@@ -0,0 +1,53 @@
+///////////////////////////////////////////////////////////////////////////////
+// glstatecache.h
+// ============
+// track the OpenGL state to skip the calls that would not change it
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  GLStateCache
+ *
+ *  This class contains a shadow copy of the OpenGL state that
+ *  the project changes most often: the enabled capabilities,
+ *  the bound program and vertex array, the active texture
+ *  unit and the textures bound to every unit, the blend and
+ *  depth functions, the depth mask, the viewport and the
+ *  clear color.  The OpenGL call wrappers ask the cache
+ *  before every state call, and the call is skipped when the
+ *  state already has the requested value.  Every value starts
+ *  out unknown, so the first call always reaches the driver.
+ ***********************************************************/
+class GLStateCache
+{
+public:
+	// turn the cache off to let every call through, for comparisons
+	static void SetActive(bool bActive);
+	static bool IsActive();
+	// forget all of the tracked state after it was changed elsewhere
+	static void Invalidate();
+
+	// the methods below record the requested state and return
+	// whether the call has to be made to change it
+
+	static bool SetCapability(GLenum cap, bool bEnabled);
+	static bool SetProgram(GLuint program);
+	static bool SetVertexArray(GLuint vertexArray);
+	static bool SetActiveTexture(GLenum unit);
+	static bool SetTexture(GLenum target, GLuint texture);
+	static bool SetBlendFunc(GLenum sourceFactor, GLenum destinationFactor);
+	static bool SetDepthFunc(GLenum func);
+	static bool SetDepthMask(GLboolean flag);
+	static bool SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+	static bool SetClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+	// drop the bindings of deleted objects, which revert to zero
+	static void DeleteTextures(GLsizei count, const GLuint* textures);
+	static void DeleteVertexArrays(GLsizei count, const GLuint* vertexArrays);
+	static void DeleteProgram(GLuint program);
+};
@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////
+// glstats.cpp
+// ============
+// count the OpenGL calls and state changes of every frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLStats.h"
+
+#include <fstream>
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	// counters of the frame that is being rendered
+	GLStats::FRAME_STATS g_CurrentFrame = {};
+	// counters of the last finished frame, their peaks and their sums
+	GLStats::FRAME_STATS g_LastFrame = {};
+	GLStats::FRAME_STATS g_PeakFrame = {};
+	GLStats::FRAME_STATS g_Total = {};
+	// number of finished frames
+	uint64_t g_FrameCount = 0;
+
+	struct COUNTER_INFO
+	{
+		const char* name;
+		uint64_t GLStats::FRAME_STATS::* counter;
+	};
+
+	// names of the counters in the written summary
+	const COUNTER_INFO g_Counters[] =
+	{
+		{ "draws", &GLStats::FRAME_STATS::draws },
+		{ "triangles", &GLStats::FRAME_STATS::triangles },
+		{ "uniform writes", &GLStats::FRAME_STATS::uniformWrites },
+		{ "texture binds", &GLStats::FRAME_STATS::textureBinds },
+		{ "program binds", &GLStats::FRAME_STATS::programBinds },
+		{ "vertex array binds", &GLStats::FRAME_STATS::vertexArrayBinds },
+		{ "buffer binds", &GLStats::FRAME_STATS::bufferBinds },
+		{ "buffer uploads", &GLStats::FRAME_STATS::bufferUploads },
+		{ "texture uploads", &GLStats::FRAME_STATS::textureUploads },
+		{ "bytes uploaded", &GLStats::FRAME_STATS::uploadBytes },
+		{ "state changes", &GLStats::FRAME_STATS::stateChanges },
+		{ "skipped redundant calls", &GLStats::FRAME_STATS::skippedCalls }
+	};
+	const int g_CounterCount = sizeof(g_Counters) / sizeof(g_Counters[0]);
+}
+
+/***********************************************************
+ *  GetCurrentFrame()
+ *
+ *  This method is used to get the counters of the frame that
+ *  is being rendered, which the OpenGL call wrappers add to.
+ ***********************************************************/
+GLStats::FRAME_STATS& GLStats::GetCurrentFrame()
+{
+	return(g_CurrentFrame);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used to finish the counters of the current
+ *  frame, to add them to the peaks and the totals, and to
+ *  reset them for the next frame.
+ ***********************************************************/
+void GLStats::EndFrame()
+{
+	for (int i = 0; i < g_CounterCount; i++)
+	{
+		uint64_t FRAME_STATS::* counter = g_Counters[i].counter;
+		g_PeakFrame.*counter = std::max(g_PeakFrame.*counter, g_CurrentFrame.*counter);
+		g_Total.*counter += g_CurrentFrame.*counter;
+	}
+
+	g_LastFrame = g_CurrentFrame;
+	g_CurrentFrame = FRAME_STATS();
+	g_FrameCount++;
+}
+
+/***********************************************************
+ *  GetLastFrame()
+ *
+ *  This method is used to get the counters of the last
+ *  finished frame.
+ ***********************************************************/
+const GLStats::FRAME_STATS& GLStats::GetLastFrame()
+{
+	return(g_LastFrame);
+}
+
+/***********************************************************
+ *  GetPeakFrame()
+ *
+ *  This method is used to get the highest value that every
+ *  counter reached in a single frame.
+ ***********************************************************/
+const GLStats::FRAME_STATS& GLStats::GetPeakFrame()
+{
+	return(g_PeakFrame);
+}
+
+/***********************************************************
+ *  GetTotal()
+ *
+ *  This method is used to get the sum of the counters of all
+ *  of the finished frames.
+ ***********************************************************/
+const GLStats::FRAME_STATS& GLStats::GetTotal()
+{
+	return(g_Total);
+}
+
+/***********************************************************
+ *  GetFrameCount()
+ *
+ *  This method is used to get the number of finished frames.
+ ***********************************************************/
+uint64_t GLStats::GetFrameCount()
+{
+	return(g_FrameCount);
+}
+
+/***********************************************************
+ *  WriteSummary()
+ *
+ *  This method is used to write the total, the average per
+ *  frame and the peak of every counter.  The calls made
+ *  before the first frame, like the texture loading, are
+ *  part of the totals of the first frame.
+ ***********************************************************/
+void GLStats::WriteSummary(std::ostream& stream)
+{
+	stream << "OpenGL call statistics over " << g_FrameCount << " frames" << std::endl;
+	stream << "counter total per_frame peak" << std::endl;
+	for (int i = 0; i < g_CounterCount; i++)
+	{
+		uint64_t FRAME_STATS::* counter = g_Counters[i].counter;
+		double average = (g_FrameCount > 0) ? ((double)(g_Total.*counter) / (double)g_FrameCount) : 0.0;
+		stream << g_Counters[i].name << ": " << g_Total.*counter << " " << average << " " << g_PeakFrame.*counter << std::endl;
+	}
+}
+
+/***********************************************************
+ *  WriteSummary()
+ *
+ *  This method is used to write the summary into a file.
+ ***********************************************************/
+bool GLStats::WriteSummary(const char* filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create GL statistics file:" << filename << std::endl;
+		return(false);
+	}
+
+	WriteSummary(file);
+	if (!file)
+	{
+		std::cout << "Could not write GL statistics file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote GL statistics file:" << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetTriangleCount()
+ *
+ *  This method is used to get the number of triangles that
+ *  a draw of the given primitive mode submits.
+ ***********************************************************/
+uint64_t GLStats::GetTriangleCount(GLenum mode, GLsizei count, GLsizei instanceCount)
+{
+	uint64_t triangles = 0;
+
+	switch (mode)
+	{
+	case GL_TRIANGLES:
+		triangles = (uint64_t)(count / 3);
+		break;
+	case GL_TRIANGLE_STRIP:
+	case GL_TRIANGLE_FAN:
+		triangles = (count > 2) ? (uint64_t)(count - 2) : 0;
+		break;
+	default:
+		break;
+	}
+
+	return(triangles * (uint64_t)std::max(instanceCount, 0));
+}
+
+/***********************************************************
+ *  GetImageBytes()
+ *
+ *  This method is used to get the size of the client pixels
+ *  of an uploaded image, from its pixel format and type.
+ ***********************************************************/
+uint64_t GLStats::GetImageBytes(GLsizei width, GLsizei height, GLenum format, GLenum type)
+{
+	uint64_t components = 4;
+	switch (format)
+	{
+	case GL_RED:
+	case GL_RED_INTEGER:
+	case GL_DEPTH_COMPONENT:
+		components = 1;
+		break;
+	case GL_RG:
+	case GL_RG_INTEGER:
+		components = 2;
+		break;
+	case GL_RGB:
+	case GL_BGR:
+	case GL_RGB_INTEGER:
+		components = 3;
+		break;
+	default:
+		break;
+	}
+
+	uint64_t pixelBytes = components;
+	switch (type)
+	{
+	case GL_SHORT:
+	case GL_UNSIGNED_SHORT:
+	case GL_HALF_FLOAT:
+		pixelBytes = components * 2;
+		break;
+	case GL_INT:
+	case GL_UNSIGNED_INT:
+	case GL_FLOAT:
+		pixelBytes = components * 4;
+		break;
+	case GL_UNSIGNED_INT_8_8_8_8:
+	case GL_UNSIGNED_INT_8_8_8_8_REV:
+	case GL_UNSIGNED_INT_2_10_10_10_REV:
+		pixelBytes = 4;
+		break;
+	default:
+		break;
+	}
+
+	return((uint64_t)std::max(width, 0) * (uint64_t)std::max(height, 0) * pixelBytes);
+}
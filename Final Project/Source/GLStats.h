@@ -0,0 +1,465 @@
+///////////////////////////////////////////////////////////////////////////////
+// glstats.h
+// ============
+// count the OpenGL calls and state changes of every frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include "GLStateCache.h"
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************
+ *  GLStats
+ *
+ *  This class contains the counters of the OpenGL work that
+ *  every frame generates.  This header is force included
+ *  into every source file of the project, including the
+ *  shader manager and the shape meshes, and routes the draw,
+ *  uniform, bind, upload and state calls through small inline
+ *  wrappers that count them before calling OpenGL.  The
+ *  counters of the finished frames are kept as the last
+ *  frame, the peak of every counter and the running total.
+ *  The state calls are checked against the state cache first,
+ *  and the calls that would not change anything are skipped
+ *  and counted as such.
+ ***********************************************************/
+class GLStats
+{
+public:
+	struct FRAME_STATS
+	{
+		uint64_t draws;
+		uint64_t triangles;
+		uint64_t uniformWrites;
+		uint64_t textureBinds;
+		uint64_t programBinds;
+		uint64_t vertexArrayBinds;
+		uint64_t bufferBinds;
+		uint64_t bufferUploads;
+		uint64_t textureUploads;
+		uint64_t uploadBytes;
+		uint64_t stateChanges;
+		uint64_t skippedCalls;
+	};
+
+	// get the counters of the frame that is being rendered
+	static FRAME_STATS& GetCurrentFrame();
+
+	// finish the counters of the current frame and start a new frame
+	static void EndFrame();
+
+	// get the counters of the last finished frame
+	static const FRAME_STATS& GetLastFrame();
+	// get the highest value of every counter in a single frame
+	static const FRAME_STATS& GetPeakFrame();
+	// get the sum of the counters of all finished frames
+	static const FRAME_STATS& GetTotal();
+	static uint64_t GetFrameCount();
+
+	// write the totals and the per frame averages and peaks
+	static void WriteSummary(std::ostream& stream);
+	static bool WriteSummary(const char* filename);
+
+	// get the number of triangles of a draw
+	static uint64_t GetTriangleCount(GLenum mode, GLsizei count, GLsizei instanceCount);
+	// get the size of the pixels of an uploaded image
+	static uint64_t GetImageBytes(GLsizei width, GLsizei height, GLenum format, GLenum type);
+};
+
+// the wrappers call the OpenGL functions as they are defined at this
+// point, before the names are redirected to the wrappers below, and
+// the state calls return early when the state cache has the value
+
+inline void GLStatsDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	GLStats::FRAME_STATS& stats = GLStats::GetCurrentFrame();
+	stats.draws++;
+	stats.triangles += GLStats::GetTriangleCount(mode, count, 1);
+	glDrawArrays(mode, first, count);
+}
+
+inline void GLStatsDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+	GLStats::FRAME_STATS& stats = GLStats::GetCurrentFrame();
+	stats.draws++;
+	stats.triangles += GLStats::GetTriangleCount(mode, count, 1);
+	glDrawElements(mode, count, type, indices);
+}
+
+inline void GLStatsDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+{
+	GLStats::FRAME_STATS& stats = GLStats::GetCurrentFrame();
+	stats.draws++;
+	stats.triangles += GLStats::GetTriangleCount(mode, count, instanceCount);
+	glDrawArraysInstanced(mode, first, count, instanceCount);
+}
+
+inline void GLStatsDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount)
+{
+	GLStats::FRAME_STATS& stats = GLStats::GetCurrentFrame();
+	stats.draws++;
+	stats.triangles += GLStats::GetTriangleCount(mode, count, instanceCount);
+	glDrawElementsInstanced(mode, count, type, indices, instanceCount);
+}
+
+inline void GLStatsUniform1i(GLint location, GLint v0)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniform1i(location, v0);
+}
+
+inline void GLStatsUniform1f(GLint location, GLfloat v0)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniform1f(location, v0);
+}
+
+inline void GLStatsUniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniform2f(location, v0, v1);
+}
+
+inline void GLStatsUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniform3f(location, v0, v1, v2);
+}
+
+inline void GLStatsUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniform4f(location, v0, v1, v2, v3);
+}
+
+inline void GLStatsUniform1iv(GLint location, GLsizei count, const GLint* value)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniform1iv(location, count, value);
+}
+
+inline void GLStatsUniform1fv(GLint location, GLsizei count, const GLfloat* value)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniform1fv(location, count, value);
+}
+
+inline void GLStatsUniform2fv(GLint location, GLsizei count, const GLfloat* value)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniform2fv(location, count, value);
+}
+
+inline void GLStatsUniform3fv(GLint location, GLsizei count, const GLfloat* value)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniform3fv(location, count, value);
+}
+
+inline void GLStatsUniform4fv(GLint location, GLsizei count, const GLfloat* value)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniform4fv(location, count, value);
+}
+
+inline void GLStatsUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniformMatrix3fv(location, count, transpose, value);
+}
+
+inline void GLStatsUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+	GLStats::GetCurrentFrame().uniformWrites++;
+	glUniformMatrix4fv(location, count, transpose, value);
+}
+
+inline void GLStatsBindTexture(GLenum target, GLuint texture)
+{
+	if (GLStateCache::SetTexture(target, texture) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().textureBinds++;
+	glBindTexture(target, texture);
+}
+
+inline void GLStatsUseProgram(GLuint program)
+{
+	if (GLStateCache::SetProgram(program) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().programBinds++;
+	glUseProgram(program);
+}
+
+inline void GLStatsBindVertexArray(GLuint vertexArray)
+{
+	if (GLStateCache::SetVertexArray(vertexArray) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().vertexArrayBinds++;
+	glBindVertexArray(vertexArray);
+}
+
+inline void GLStatsBindBuffer(GLenum target, GLuint buffer)
+{
+	GLStats::GetCurrentFrame().bufferBinds++;
+	glBindBuffer(target, buffer);
+}
+
+inline void GLStatsBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	GLStats::FRAME_STATS& stats = GLStats::GetCurrentFrame();
+	stats.bufferUploads++;
+	stats.uploadBytes += (NULL != data) ? (uint64_t)size : 0;
+	glBufferData(target, size, data, usage);
+}
+
+inline void GLStatsBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	GLStats::FRAME_STATS& stats = GLStats::GetCurrentFrame();
+	stats.bufferUploads++;
+	stats.uploadBytes += (uint64_t)size;
+	glBufferSubData(target, offset, size, data);
+}
+
+inline void GLStatsTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	// allocations without pixels do not upload anything
+	if (NULL != pixels)
+	{
+		GLStats::FRAME_STATS& stats = GLStats::GetCurrentFrame();
+		stats.textureUploads++;
+		stats.uploadBytes += GLStats::GetImageBytes(width, height, format, type);
+	}
+	glTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+}
+
+inline void GLStatsTexSubImage2D(GLenum target, GLint level, GLint xOffset, GLint yOffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+	GLStats::FRAME_STATS& stats = GLStats::GetCurrentFrame();
+	stats.textureUploads++;
+	stats.uploadBytes += GLStats::GetImageBytes(width, height, format, type);
+	glTexSubImage2D(target, level, xOffset, yOffset, width, height, format, type, pixels);
+}
+
+inline void GLStatsCompressedTexImage2D(GLenum target, GLint level, GLenum internalFormat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data)
+{
+	GLStats::FRAME_STATS& stats = GLStats::GetCurrentFrame();
+	stats.textureUploads++;
+	stats.uploadBytes += (uint64_t)imageSize;
+	glCompressedTexImage2D(target, level, internalFormat, width, height, border, imageSize, data);
+}
+
+inline void GLStatsCompressedTexSubImage2D(GLenum target, GLint level, GLint xOffset, GLint yOffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void* data)
+{
+	GLStats::FRAME_STATS& stats = GLStats::GetCurrentFrame();
+	stats.textureUploads++;
+	stats.uploadBytes += (uint64_t)imageSize;
+	glCompressedTexSubImage2D(target, level, xOffset, yOffset, width, height, format, imageSize, data);
+}
+
+inline void GLStatsEnable(GLenum cap)
+{
+	if (GLStateCache::SetCapability(cap, true) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().stateChanges++;
+	glEnable(cap);
+}
+
+inline void GLStatsDisable(GLenum cap)
+{
+	if (GLStateCache::SetCapability(cap, false) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().stateChanges++;
+	glDisable(cap);
+}
+
+inline void GLStatsBlendFunc(GLenum sourceFactor, GLenum destinationFactor)
+{
+	if (GLStateCache::SetBlendFunc(sourceFactor, destinationFactor) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().stateChanges++;
+	glBlendFunc(sourceFactor, destinationFactor);
+}
+
+inline void GLStatsDepthFunc(GLenum func)
+{
+	if (GLStateCache::SetDepthFunc(func) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().stateChanges++;
+	glDepthFunc(func);
+}
+
+inline void GLStatsDepthMask(GLboolean flag)
+{
+	if (GLStateCache::SetDepthMask(flag) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().stateChanges++;
+	glDepthMask(flag);
+}
+
+inline void GLStatsActiveTexture(GLenum texture)
+{
+	if (GLStateCache::SetActiveTexture(texture) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().stateChanges++;
+	glActiveTexture(texture);
+}
+
+inline void GLStatsViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	if (GLStateCache::SetViewport(x, y, width, height) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().stateChanges++;
+	glViewport(x, y, width, height);
+}
+
+inline void GLStatsClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+	if (GLStateCache::SetClearColor(red, green, blue, alpha) == false)
+	{
+		GLStats::GetCurrentFrame().skippedCalls++;
+		return;
+	}
+	GLStats::GetCurrentFrame().stateChanges++;
+	glClearColor(red, green, blue, alpha);
+}
+
+inline void GLStatsDeleteTextures(GLsizei count, const GLuint* textures)
+{
+	GLStateCache::DeleteTextures(count, textures);
+	glDeleteTextures(count, textures);
+}
+
+inline void GLStatsDeleteVertexArrays(GLsizei count, const GLuint* vertexArrays)
+{
+	GLStateCache::DeleteVertexArrays(count, vertexArrays);
+	glDeleteVertexArrays(count, vertexArrays);
+}
+
+inline void GLStatsDeleteProgram(GLuint program)
+{
+	GLStateCache::DeleteProgram(program);
+	glDeleteProgram(program);
+}
+
+inline void GLStatsBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	GLStats::GetCurrentFrame().stateChanges++;
+	glBindFramebuffer(target, framebuffer);
+}
+
+// redirect the OpenGL calls of the project to the counting wrappers,
+// GLEW defines most of these names as macros of its function pointers
+#undef glDrawArrays
+#define glDrawArrays GLStatsDrawArrays
+#undef glDrawElements
+#define glDrawElements GLStatsDrawElements
+#undef glDrawArraysInstanced
+#define glDrawArraysInstanced GLStatsDrawArraysInstanced
+#undef glDrawElementsInstanced
+#define glDrawElementsInstanced GLStatsDrawElementsInstanced
+#undef glUniform1i
+#define glUniform1i GLStatsUniform1i
+#undef glUniform1f
+#define glUniform1f GLStatsUniform1f
+#undef glUniform2f
+#define glUniform2f GLStatsUniform2f
+#undef glUniform3f
+#define glUniform3f GLStatsUniform3f
+#undef glUniform4f
+#define glUniform4f GLStatsUniform4f
+#undef glUniform1iv
+#define glUniform1iv GLStatsUniform1iv
+#undef glUniform1fv
+#define glUniform1fv GLStatsUniform1fv
+#undef glUniform2fv
+#define glUniform2fv GLStatsUniform2fv
+#undef glUniform3fv
+#define glUniform3fv GLStatsUniform3fv
+#undef glUniform4fv
+#define glUniform4fv GLStatsUniform4fv
+#undef glUniformMatrix3fv
+#define glUniformMatrix3fv GLStatsUniformMatrix3fv
+#undef glUniformMatrix4fv
+#define glUniformMatrix4fv GLStatsUniformMatrix4fv
+#undef glBindTexture
+#define glBindTexture GLStatsBindTexture
+#undef glUseProgram
+#define glUseProgram GLStatsUseProgram
+#undef glBindVertexArray
+#define glBindVertexArray GLStatsBindVertexArray
+#undef glBindBuffer
+#define glBindBuffer GLStatsBindBuffer
+#undef glBufferData
+#define glBufferData GLStatsBufferData
+#undef glBufferSubData
+#define glBufferSubData GLStatsBufferSubData
+#undef glTexImage2D
+#define glTexImage2D GLStatsTexImage2D
+#undef glTexSubImage2D
+#define glTexSubImage2D GLStatsTexSubImage2D
+#undef glCompressedTexImage2D
+#define glCompressedTexImage2D GLStatsCompressedTexImage2D
+#undef glCompressedTexSubImage2D
+#define glCompressedTexSubImage2D GLStatsCompressedTexSubImage2D
+#undef glEnable
+#define glEnable GLStatsEnable
+#undef glDisable
+#define glDisable GLStatsDisable
+#undef glBlendFunc
+#define glBlendFunc GLStatsBlendFunc
+#undef glDepthFunc
+#define glDepthFunc GLStatsDepthFunc
+#undef glDepthMask
+#define glDepthMask GLStatsDepthMask
+#undef glActiveTexture
+#define glActiveTexture GLStatsActiveTexture
+#undef glViewport
+#define glViewport GLStatsViewport
+#undef glClearColor
+#define glClearColor GLStatsClearColor
+#undef glBindFramebuffer
+#define glBindFramebuffer GLStatsBindFramebuffer
+#undef glDeleteTextures
+#define glDeleteTextures GLStatsDeleteTextures
+#undef glDeleteVertexArrays
+#define glDeleteVertexArrays GLStatsDeleteVertexArrays
+#undef glDeleteProgram
+#define glDeleteProgram GLStatsDeleteProgram
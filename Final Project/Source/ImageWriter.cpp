@@ -0,0 +1,420 @@
+///////////////////////////////////////////////////////////////////////////////
+// imagewriter.cpp
+// ============
+// encode the rendered frames into image files
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ImageWriter.h"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// the matches are found through a hash of the next four bytes
+	const int g_HashBits = 15;
+	const int g_MinMatch = 4;
+	const int g_MaxMatch = 258;
+	const int g_WindowSize = 32768;
+
+	// base values and extra bits of the deflate length and distance codes
+	const int g_LengthBase[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	const int g_LengthExtra[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	const int g_DistanceBase[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	const int g_DistanceExtra[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	const unsigned char g_PngSignature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+	/***********************************************************
+	 *  ReverseBits()
+	 *
+	 *  Huffman codes are stored from their most significant bit,
+	 *  while the stream is filled from the least significant bit.
+	 ***********************************************************/
+	uint32_t ReverseBits(uint32_t code, int length)
+	{
+		uint32_t reversed = 0;
+		for (int i = 0; i < length; i++)
+		{
+			reversed = (reversed << 1) | ((code >> i) & 1);
+		}
+		return(reversed);
+	}
+
+	// lookup tables of the encoder, built once for all the writers
+	struct ENCODER_TABLES
+	{
+		uint16_t literalCodes[288];
+		uint8_t literalLengths[288];
+		uint8_t lengthSymbols[g_MaxMatch + 1];
+		uint8_t distanceSymbols[512];
+		uint8_t distanceCodes[30];
+		uint32_t crc[256];
+
+		ENCODER_TABLES()
+		{
+			// fixed Huffman codes of the literal and length alphabet
+			for (int symbol = 0; symbol < 288; symbol++)
+			{
+				uint32_t code = 0;
+				int length = 0;
+				if (symbol < 144)
+				{
+					code = 0x30 + symbol;
+					length = 8;
+				}
+				else if (symbol < 256)
+				{
+					code = 0x190 + (symbol - 144);
+					length = 9;
+				}
+				else if (symbol < 280)
+				{
+					code = symbol - 256;
+					length = 7;
+				}
+				else
+				{
+					code = 0xC0 + (symbol - 280);
+					length = 8;
+				}
+				literalCodes[symbol] = (uint16_t)ReverseBits(code, length);
+				literalLengths[symbol] = (uint8_t)length;
+			}
+
+			memset(lengthSymbols, 0, sizeof(lengthSymbols));
+			for (int code = 0; code < 29; code++)
+			{
+				int count = (code == 28) ? 1 : (1 << g_LengthExtra[code]);
+				for (int i = 0; i < count; i++)
+				{
+					lengthSymbols[g_LengthBase[code] + i] = (uint8_t)code;
+				}
+			}
+
+			// the distances up to 256 are looked up directly, and the
+			// longer ones by their distance divided by 128
+			for (int code = 0; code < 30; code++)
+			{
+				for (int i = 0; i < (1 << g_DistanceExtra[code]); i++)
+				{
+					int distance = g_DistanceBase[code] + i - 1;
+					int index = (distance < 256) ? distance : 256 + (distance >> 7);
+					distanceSymbols[index] = (uint8_t)code;
+				}
+				distanceCodes[code] = (uint8_t)ReverseBits(code, 5);
+			}
+
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t value = i;
+				for (int bit = 0; bit < 8; bit++)
+				{
+					value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+				}
+				crc[i] = value;
+			}
+		}
+	};
+
+	const ENCODER_TABLES& GetEncoderTables()
+	{
+		static const ENCODER_TABLES tables;
+		return(tables);
+	}
+
+	/***********************************************************
+	 *  UpdateCrc()
+	 *
+	 *  Add bytes to the CRC of a PNG chunk.
+	 ***********************************************************/
+	uint32_t UpdateCrc(uint32_t crc, const unsigned char* pData, size_t size)
+	{
+		const uint32_t* pTable = GetEncoderTables().crc;
+		for (size_t i = 0; i < size; i++)
+		{
+			crc = pTable[(crc ^ pData[i]) & 0xFF] ^ (crc >> 8);
+		}
+		return(crc);
+	}
+
+	void PutBigEndian(unsigned char* pData, uint32_t value)
+	{
+		pData[0] = (unsigned char)(value >> 24);
+		pData[1] = (unsigned char)(value >> 16);
+		pData[2] = (unsigned char)(value >> 8);
+		pData[3] = (unsigned char)value;
+	}
+
+	/***********************************************************
+	 *  WriteChunk()
+	 *
+	 *  Write a PNG chunk with its length and CRC.
+	 ***********************************************************/
+	void WriteChunk(std::ofstream& file, const char* type, const unsigned char* pData, size_t size)
+	{
+		unsigned char header[8];
+		PutBigEndian(header, (uint32_t)size);
+		memcpy(header + 4, type, 4);
+
+		uint32_t crc = UpdateCrc(0xFFFFFFFFu, header + 4, 4);
+		crc = UpdateCrc(crc, pData, size);
+		unsigned char footer[4];
+		PutBigEndian(footer, crc ^ 0xFFFFFFFFu);
+
+		file.write((const char*)header, 8);
+		file.write((const char*)pData, size);
+		file.write((const char*)footer, 4);
+	}
+
+	uint32_t ReadSequence(const unsigned char* pData)
+	{
+		uint32_t value = 0;
+		memcpy(&value, pData, 4);
+		return(value);
+	}
+}
+
+/***********************************************************
+ *  ImageWriter()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ImageWriter::ImageWriter()
+{
+	m_bitBuffer = 0;
+	m_bitCount = 0;
+	m_hashTable.resize((size_t)1 << g_HashBits);
+}
+
+/***********************************************************
+ *  WritePNG()
+ *
+ *  This method is used to write RGBA pixels as an RGB PNG
+ *  file.  The alpha of a framebuffer is not part of the
+ *  image, so it is dropped.
+ ***********************************************************/
+bool ImageWriter::WritePNG(const char* filename, int width, int height, const unsigned char* pPixels, bool bBottomUp)
+{
+	if ((NULL == filename) || (NULL == pPixels) || (width <= 0) || (height <= 0))
+	{
+		return(false);
+	}
+
+	FilterRows(width, height, pPixels, bBottomUp);
+	Deflate();
+
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not create image file:" << filename << std::endl;
+		return(false);
+	}
+
+	// 8 bits per channel, RGB, default compression and filtering, no interlace
+	unsigned char header[13];
+	PutBigEndian(header, (uint32_t)width);
+	PutBigEndian(header + 4, (uint32_t)height);
+	header[8] = 8;
+	header[9] = 2;
+	header[10] = 0;
+	header[11] = 0;
+	header[12] = 0;
+
+	file.write((const char*)g_PngSignature, sizeof(g_PngSignature));
+	WriteChunk(file, "IHDR", header, sizeof(header));
+	WriteChunk(file, "IDAT", m_compressed.data(), m_compressed.size());
+	WriteChunk(file, "IEND", NULL, 0);
+	if (!file)
+	{
+		std::cout << "Could not write image file:" << filename << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  FilterRows()
+ *
+ *  This method is used to convert the pixels into RGB rows,
+ *  from the top down, with the sub filter of PNG.  Storing
+ *  the difference to the pixel on the left turns the smooth
+ *  gradients of a rendered image into runs of small values
+ *  that compress well.
+ ***********************************************************/
+void ImageWriter::FilterRows(int width, int height, const unsigned char* pPixels, bool bBottomUp)
+{
+	size_t rowSize = 1 + (size_t)width * 3;
+	m_scanlines.resize(rowSize * height);
+
+	for (int y = 0; y < height; y++)
+	{
+		int sourceRow = (bBottomUp == true) ? (height - 1 - y) : y;
+		const unsigned char* pSource = pPixels + (size_t)sourceRow * width * 4;
+		unsigned char* pRow = &m_scanlines[rowSize * y];
+
+		pRow[0] = 1;
+		pRow[1] = pSource[0];
+		pRow[2] = pSource[1];
+		pRow[3] = pSource[2];
+		for (int x = 1; x < width; x++)
+		{
+			const unsigned char* pPixel = pSource + x * 4;
+			unsigned char* pFiltered = pRow + 1 + x * 3;
+			pFiltered[0] = (unsigned char)(pPixel[0] - pPixel[-4]);
+			pFiltered[1] = (unsigned char)(pPixel[1] - pPixel[-3]);
+			pFiltered[2] = (unsigned char)(pPixel[2] - pPixel[-2]);
+		}
+	}
+}
+
+/***********************************************************
+ *  Deflate()
+ *
+ *  This method is used to compress the filtered rows into a
+ *  zlib stream with a single block of fixed Huffman codes.
+ *  Every position only looks up the last position with the
+ *  same next four bytes, which finds the long runs of equal
+ *  pixels of a rendered image at a small cost.
+ ***********************************************************/
+void ImageWriter::Deflate()
+{
+	const unsigned char* pData = m_scanlines.data();
+	int size = (int)m_scanlines.size();
+
+	m_compressed.clear();
+	m_compressed.push_back(0x78);
+	m_compressed.push_back(0x01);
+
+	m_bitBuffer = 0;
+	m_bitCount = 0;
+	// last block, fixed Huffman codes
+	PutBits(1, 1);
+	PutBits(1, 2);
+
+	std::fill(m_hashTable.begin(), m_hashTable.end(), -1);
+
+	int position = 0;
+	while (position < size)
+	{
+		if (position + g_MinMatch <= size)
+		{
+			uint32_t sequence = ReadSequence(pData + position);
+			uint32_t hash = (sequence * 2654435761u) >> (32 - g_HashBits);
+			int candidate = m_hashTable[hash];
+			m_hashTable[hash] = position;
+
+			if ((candidate >= 0) &&
+				(position - candidate <= g_WindowSize) &&
+				(ReadSequence(pData + candidate) == sequence))
+			{
+				int maxLength = std::min(g_MaxMatch, size - position);
+				int length = g_MinMatch;
+				while ((length < maxLength) && (pData[candidate + length] == pData[position + length]))
+				{
+					length++;
+				}
+
+				PutMatch(length, position - candidate);
+				position += length;
+				continue;
+			}
+		}
+
+		PutLiteral(pData[position]);
+		position++;
+	}
+
+	// end of block, and the stream ends on a whole byte
+	PutLiteral(256);
+	if (m_bitCount > 0)
+	{
+		m_compressed.push_back((unsigned char)m_bitBuffer);
+		m_bitBuffer = 0;
+		m_bitCount = 0;
+	}
+
+	// checksum of the uncompressed data, with the modulo deferred
+	// for as many bytes as the sums can hold
+	uint32_t a = 1;
+	uint32_t b = 0;
+	int index = 0;
+	while (index < size)
+	{
+		int end = std::min(size, index + 5552);
+		for (; index < end; index++)
+		{
+			a += pData[index];
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+	}
+	unsigned char checksum[4];
+	PutBigEndian(checksum, (b << 16) | a);
+	m_compressed.insert(m_compressed.end(), checksum, checksum + 4);
+}
+
+/***********************************************************
+ *  PutBits()
+ *
+ *  This method is used to append bits to the compressed
+ *  stream, starting from the least significant bit.
+ ***********************************************************/
+void ImageWriter::PutBits(uint32_t bits, int count)
+{
+	m_bitBuffer |= bits << m_bitCount;
+	m_bitCount += count;
+	while (m_bitCount >= 8)
+	{
+		m_compressed.push_back((unsigned char)m_bitBuffer);
+		m_bitBuffer >>= 8;
+		m_bitCount -= 8;
+	}
+}
+
+/***********************************************************
+ *  PutLiteral()
+ *
+ *  This method is used to append a symbol of the literal and
+ *  length alphabet.
+ ***********************************************************/
+void ImageWriter::PutLiteral(int symbol)
+{
+	const ENCODER_TABLES& tables = GetEncoderTables();
+	PutBits(tables.literalCodes[symbol], tables.literalLengths[symbol]);
+}
+
+/***********************************************************
+ *  PutMatch()
+ *
+ *  This method is used to append a copy of earlier bytes as
+ *  its length and distance codes.
+ ***********************************************************/
+void ImageWriter::PutMatch(int length, int distance)
+{
+	const ENCODER_TABLES& tables = GetEncoderTables();
+
+	int lengthCode = tables.lengthSymbols[length];
+	PutLiteral(257 + lengthCode);
+	PutBits(length - g_LengthBase[lengthCode], g_LengthExtra[lengthCode]);
+
+	int index = (distance <= 256) ? (distance - 1) : (256 + ((distance - 1) >> 7));
+	int distanceCode = tables.distanceSymbols[index];
+	PutBits(tables.distanceCodes[distanceCode], 5);
+	PutBits(distance - g_DistanceBase[distanceCode], g_DistanceExtra[distanceCode]);
+}
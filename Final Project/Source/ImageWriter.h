@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////////////
+// imagewriter.h
+// ============
+// encode the rendered frames into image files
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+/***********************************************************
+ *  ImageWriter
+ *
+ *  This class contains the code for writing RGBA pixels that
+ *  were read back from a framebuffer as PNG files.  The rows
+ *  are filtered and compressed with a single pass LZ77 match
+ *  finder and the fixed Huffman codes of deflate, which
+ *  trades some file size for a much faster encode than a full
+ *  compressor.  A writer keeps its buffers between images, so
+ *  every encoder thread should own one.
+ ***********************************************************/
+class ImageWriter
+{
+public:
+	// constructor
+	ImageWriter();
+
+	// write RGBA pixels as an RGB PNG file, with the rows stored
+	// from the bottom up like the framebuffer reads them back
+	bool WritePNG(const char* filename, int width, int height, const unsigned char* pPixels, bool bBottomUp);
+
+private:
+	// filtered rows and compressed stream of the current image
+	std::vector<unsigned char> m_scanlines;
+	std::vector<unsigned char> m_compressed;
+	// most recent position of every hashed sequence of bytes
+	std::vector<int> m_hashTable;
+	// bits of the compressed stream not yet written as bytes
+	uint32_t m_bitBuffer;
+	int m_bitCount;
+
+	// convert the pixels into filtered RGB rows
+	void FilterRows(int width, int height, const unsigned char* pPixels, bool bBottomUp);
+	// compress the filtered rows into a zlib stream
+	void Deflate();
+	void PutBits(uint32_t bits, int count);
+	void PutLiteral(int symbol);
+	void PutMatch(int length, int distance);
+};
@@ -0,0 +1,224 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputqueue.cpp
+// ============
+// collect the input events between frames and coalesce them per frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InputQueue.h"
+#include "FramePacer.h"
+
+// GLFW library
+#include "GLFW/glfw3.h"
+
+/***********************************************************
+ *  InputQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InputQueue::InputQueue()
+{
+	m_bFirstMouse = true;
+	m_lastX = 0.0;
+	m_lastY = 0.0;
+	m_pendingOffsetX = 0.0;
+	m_pendingOffsetY = 0.0;
+	m_frameOffsetX = 0.0;
+	m_frameOffsetY = 0.0;
+	m_pendingInputTime = -1.0;
+	m_frameInputTime = -1.0;
+}
+
+/***********************************************************
+ *  StampEvent()
+ *
+ *  This method is used to note the arrival time of the first
+ *  event since the last frame, which the latency of the frame
+ *  is measured from.
+ ***********************************************************/
+void InputQueue::StampEvent()
+{
+	if (m_pendingInputTime < 0.0)
+	{
+		m_pendingInputTime = FramePacer::GetTime();
+	}
+}
+
+/***********************************************************
+ *  PushKey()
+ *
+ *  This method is used to add a key event.  A press sets the
+ *  key as held and as pressed for the next frame, even when
+ *  it is released again before that frame starts.
+ ***********************************************************/
+void InputQueue::PushKey(int key, int action)
+{
+	if ((key < 0) || (key >= KEY_COUNT))
+	{
+		return;
+	}
+
+	StampEvent();
+	if (action == GLFW_PRESS)
+	{
+		m_keysDown.set(key);
+		m_keysPressed.set(key);
+	}
+	else if (action == GLFW_RELEASE)
+	{
+		m_keysDown.reset(key);
+	}
+}
+
+/***********************************************************
+ *  PushMousePosition()
+ *
+ *  This method is used to add a mouse move.  The offset from
+ *  the last position is added to the offset of the frame.
+ ***********************************************************/
+void InputQueue::PushMousePosition(double xMousePos, double yMousePos)
+{
+	// the first position has no previous position to move from
+	if (m_bFirstMouse == true)
+	{
+		m_lastX = xMousePos;
+		m_lastY = yMousePos;
+		m_bFirstMouse = false;
+	}
+
+	StampEvent();
+	m_pendingOffsetX += xMousePos - m_lastX;
+	// reversed since y-coordinates go from bottom to top
+	m_pendingOffsetY += m_lastY - yMousePos;
+	m_lastX = xMousePos;
+	m_lastY = yMousePos;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used to take the input that was collected
+ *  since the last frame as the input of the new frame.
+ ***********************************************************/
+void InputQueue::BeginFrame()
+{
+	m_frameKeysDown = m_keysDown;
+	m_frameKeysPressed = m_keysPressed;
+	m_keysPressed.reset();
+
+	m_frameOffsetX = m_pendingOffsetX;
+	m_frameOffsetY = m_pendingOffsetY;
+	m_pendingOffsetX = 0.0;
+	m_pendingOffsetY = 0.0;
+
+	m_frameInputTime = m_pendingInputTime;
+	m_pendingInputTime = -1.0;
+}
+
+/***********************************************************
+ *  IsKeyDown()
+ *
+ *  This method is used to check whether a key was held at the
+ *  start of the frame, or pressed during the last frame.
+ ***********************************************************/
+bool InputQueue::IsKeyDown(int key) const
+{
+	if ((key < 0) || (key >= KEY_COUNT))
+	{
+		return(false);
+	}
+
+	return(m_frameKeysDown.test(key) || m_frameKeysPressed.test(key));
+}
+
+/***********************************************************
+ *  WasKeyPressed()
+ *
+ *  This method is used to check whether a key was pressed
+ *  since the last frame.
+ ***********************************************************/
+bool InputQueue::WasKeyPressed(int key) const
+{
+	if ((key < 0) || (key >= KEY_COUNT))
+	{
+		return(false);
+	}
+
+	return(m_frameKeysPressed.test(key));
+}
+
+/***********************************************************
+ *  HasMouseMovement()
+ *
+ *  This method is used to check whether the mouse moved
+ *  since the last frame.
+ ***********************************************************/
+bool InputQueue::HasMouseMovement() const
+{
+	return((m_frameOffsetX != 0.0) || (m_frameOffsetY != 0.0));
+}
+
+/***********************************************************
+ *  GetMouseOffsetX()
+ *
+ *  This method is used to get the horizontal mouse offset of
+ *  the frame.
+ ***********************************************************/
+double InputQueue::GetMouseOffsetX() const
+{
+	return(m_frameOffsetX);
+}
+
+/***********************************************************
+ *  GetMouseOffsetY()
+ *
+ *  This method is used to get the vertical mouse offset of
+ *  the frame, positive when the mouse moved up.
+ ***********************************************************/
+double InputQueue::GetMouseOffsetY() const
+{
+	return(m_frameOffsetY);
+}
+
+/***********************************************************
+ *  TakeLateMouseOffset()
+ *
+ *  This method is used to take the mouse offset that was
+ *  collected after the start of the frame, so it can still be
+ *  applied to the frame right before its draws are submitted.
+ *  Returns false when the mouse did not move.
+ ***********************************************************/
+bool InputQueue::TakeLateMouseOffset(double& xOffset, double& yOffset)
+{
+	if ((m_pendingOffsetX == 0.0) && (m_pendingOffsetY == 0.0))
+	{
+		return(false);
+	}
+
+	xOffset = m_pendingOffsetX;
+	yOffset = m_pendingOffsetY;
+	m_pendingOffsetX = 0.0;
+	m_pendingOffsetY = 0.0;
+
+	// the frame now also shows the late events
+	if (m_frameInputTime < 0.0)
+	{
+		m_frameInputTime = m_pendingInputTime;
+		m_pendingInputTime = -1.0;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetFrameInputTime()
+ *
+ *  This method is used to get the arrival time of the oldest
+ *  input event that the frame shows, or -1 when the frame
+ *  has no new input.
+ ***********************************************************/
+double InputQueue::GetFrameInputTime() const
+{
+	return(m_frameInputTime);
+}
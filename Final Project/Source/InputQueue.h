@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputqueue.h
+// ============
+// collect the input events between frames and coalesce them per frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <bitset>
+
+/***********************************************************
+ *  InputQueue
+ *
+ *  This class contains the code for collecting the keyboard
+ *  and mouse events that GLFW delivers between two frames.
+ *  The keys are kept as bitsets of the held keys and of the
+ *  keys pressed since the last frame, and the mouse moves
+ *  are summed into a single offset, so the frame reads its
+ *  input once no matter how many events arrived.
+ ***********************************************************/
+class InputQueue
+{
+public:
+	// constructor
+	InputQueue();
+
+	// add the events as they arrive
+	void PushKey(int key, int action);
+	void PushMousePosition(double xMousePos, double yMousePos);
+
+	// take the input collected since the last frame
+	void BeginFrame();
+
+	// check the keys as of the start of the frame
+	bool IsKeyDown(int key) const;
+	bool WasKeyPressed(int key) const;
+	// get the mouse offset of the frame, with y pointing up
+	bool HasMouseMovement() const;
+	double GetMouseOffsetX() const;
+	double GetMouseOffsetY() const;
+	// take the mouse moves that arrived after the start of the frame
+	bool TakeLateMouseOffset(double& xOffset, double& yOffset);
+	// get the time of the oldest event shown by the frame, or -1
+	double GetFrameInputTime() const;
+
+private:
+	// number of key codes that are tracked
+	static const int KEY_COUNT = 512;
+
+	// keys held now, and pressed since the last frame
+	std::bitset<KEY_COUNT> m_keysDown;
+	std::bitset<KEY_COUNT> m_keysPressed;
+	// keys as they were at the start of the frame
+	std::bitset<KEY_COUNT> m_frameKeysDown;
+	std::bitset<KEY_COUNT> m_frameKeysPressed;
+	// last cursor position and the offsets summed since the last frame
+	bool m_bFirstMouse;
+	double m_lastX;
+	double m_lastY;
+	double m_pendingOffsetX;
+	double m_pendingOffsetY;
+	// mouse offset of the frame
+	double m_frameOffsetX;
+	double m_frameOffsetY;
+	// arrival time of the oldest event since the last frame, and of
+	// the oldest event taken by the frame, negative when there is none
+	double m_pendingInputTime;
+	double m_frameInputTime;
+
+	// note the arrival time of an event
+	void StampEvent();
+};
@@ -0,0 +1,432 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputrecorder.cpp
+// ============
+// record the keyboard and mouse input and replay it deterministically
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InputRecorder.h"
+#include "FramePacer.h"
+
+// GLFW library
+#include "GLFW/glfw3.h"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	// identifies the input recording files and their layout version
+	const char g_RecordingMagic[4] = { 'I', 'N', 'R', 'C' };
+	const uint32_t g_RecordingVersion = 1;
+
+	/***********************************************************
+	 *  WriteValue()
+	 *
+	 *  This function is used to write an unsigned value of the
+	 *  given size in little endian byte order.
+	 ***********************************************************/
+	void WriteValue(std::ostream& file, uint32_t value, int size)
+	{
+		for (int i = 0; i < size; i++)
+		{
+			file.put((char)((value >> (8 * i)) & 0xFF));
+		}
+	}
+
+	/***********************************************************
+	 *  ReadValue()
+	 *
+	 *  This function is used to read an unsigned value of the
+	 *  given size in little endian byte order.
+	 ***********************************************************/
+	bool ReadValue(std::istream& file, uint32_t& value, int size)
+	{
+		unsigned char bytes[4];
+		if (!file.read((char*)bytes, size))
+		{
+			return(false);
+		}
+
+		value = 0;
+		for (int i = 0; i < size; i++)
+		{
+			value |= (uint32_t)bytes[i] << (8 * i);
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  WriteFloat()
+	 *
+	 *  This function is used to write the bits of a float.
+	 ***********************************************************/
+	void WriteFloat(std::ostream& file, float value)
+	{
+		uint32_t bits = 0;
+		memcpy(&bits, &value, sizeof(bits));
+		WriteValue(file, bits, 4);
+	}
+
+	/***********************************************************
+	 *  ReadFloat()
+	 *
+	 *  This function is used to read the bits of a float.
+	 ***********************************************************/
+	bool ReadFloat(std::istream& file, float& value)
+	{
+		uint32_t bits = 0;
+		if (ReadValue(file, bits, 4) == false)
+		{
+			return(false);
+		}
+
+		memcpy(&value, &bits, sizeof(value));
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  InputRecorder()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InputRecorder::InputRecorder()
+{
+	m_bRecording = false;
+	m_recordStartTime = 0.0;
+	m_bReplaying = false;
+	m_replayTimeStep = 0;
+	m_replayTime = 0;
+	m_nextEvent = 0;
+	m_duration = 0;
+	m_maxStepEvents = 0;
+}
+
+/***********************************************************
+ *  ~InputRecorder()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+InputRecorder::~InputRecorder()
+{
+	// a recording that is still running is saved
+	if (m_bRecording == true)
+	{
+		StopRecording();
+	}
+}
+
+/***********************************************************
+ *  StartRecording()
+ *
+ *  This method is used to start recording the input events.
+ *  They are kept in memory and written when the recording
+ *  is stopped.
+ ***********************************************************/
+bool InputRecorder::StartRecording(const char* filename)
+{
+	if (m_bReplaying == true)
+	{
+		std::cout << "Cannot record the input while it is replayed" << std::endl;
+		return(false);
+	}
+
+	m_events.clear();
+	m_recordFilename = filename;
+	m_recordStartTime = FramePacer::GetTime();
+	m_bRecording = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  StopRecording()
+ *
+ *  This method is used to stop recording and to write the
+ *  recorded events into the recording file.  The file has a
+ *  small header, followed by every event as its time, its
+ *  type and a key or cursor position payload.
+ ***********************************************************/
+bool InputRecorder::StopRecording()
+{
+	if (m_bRecording == false)
+	{
+		return(false);
+	}
+
+	m_bRecording = false;
+	m_duration = GetRecordTime();
+
+	std::ofstream file(m_recordFilename.c_str(), std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not create input recording:" << m_recordFilename << std::endl;
+		return(false);
+	}
+
+	file.write(g_RecordingMagic, sizeof(g_RecordingMagic));
+	WriteValue(file, g_RecordingVersion, 4);
+	WriteValue(file, (uint32_t)m_events.size(), 4);
+	WriteValue(file, m_duration, 4);
+
+	for (size_t i = 0; i < m_events.size(); i++)
+	{
+		const INPUT_EVENT& event = m_events[i];
+		WriteValue(file, event.time, 4);
+		WriteValue(file, (uint32_t)event.type, 1);
+		if (event.type == EVENT_KEY)
+		{
+			WriteValue(file, (uint32_t)event.key, 2);
+			WriteValue(file, (uint32_t)event.action, 1);
+		}
+		else
+		{
+			WriteFloat(file, event.x);
+			WriteFloat(file, event.y);
+		}
+	}
+
+	if (!file)
+	{
+		std::cout << "Could not write input recording:" << m_recordFilename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote input recording:" << m_recordFilename
+		<< " (" << m_events.size() << " events)" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsRecording()
+ *
+ *  This method is used to check whether the input is being
+ *  recorded.
+ ***********************************************************/
+bool InputRecorder::IsRecording() const
+{
+	return(m_bRecording);
+}
+
+/***********************************************************
+ *  GetRecordTime()
+ *
+ *  This method is used to get the time since the recording
+ *  started in microseconds.
+ ***********************************************************/
+uint32_t InputRecorder::GetRecordTime() const
+{
+	return((uint32_t)((FramePacer::GetTime() - m_recordStartTime) * 1000000.0));
+}
+
+/***********************************************************
+ *  RecordKey()
+ *
+ *  This method is used to record a key press or release.
+ *  Key repeats do not change the key state and are skipped.
+ ***********************************************************/
+void InputRecorder::RecordKey(int key, int action)
+{
+	if ((m_bRecording == false) || (key < 0) || (key >= MAX_KEYS) || (action == GLFW_REPEAT))
+	{
+		return;
+	}
+
+	INPUT_EVENT event;
+	event.time = GetRecordTime();
+	event.type = EVENT_KEY;
+	event.key = key;
+	event.action = action;
+	event.x = 0.0f;
+	event.y = 0.0f;
+	m_events.push_back(event);
+}
+
+/***********************************************************
+ *  RecordMouseMove()
+ *
+ *  This method is used to record a move of the cursor.
+ ***********************************************************/
+void InputRecorder::RecordMouseMove(double x, double y)
+{
+	if (m_bRecording == false)
+	{
+		return;
+	}
+
+	INPUT_EVENT event;
+	event.time = GetRecordTime();
+	event.type = EVENT_MOUSE_MOVE;
+	event.key = 0;
+	event.action = 0;
+	event.x = (float)x;
+	event.y = (float)y;
+	m_events.push_back(event);
+}
+
+/***********************************************************
+ *  StartReplay()
+ *
+ *  This method is used to load a recording and to start
+ *  replaying it from the beginning.
+ ***********************************************************/
+bool InputRecorder::StartReplay(const char* filename, double timeStep)
+{
+	if (m_bRecording == true)
+	{
+		std::cout << "Cannot replay the input while it is recorded" << std::endl;
+		return(false);
+	}
+
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not open input recording:" << filename << std::endl;
+		return(false);
+	}
+
+	char magic[4];
+	uint32_t version = 0;
+	uint32_t eventCount = 0;
+	uint32_t duration = 0;
+	if (!file.read(magic, sizeof(magic)) ||
+		(memcmp(magic, g_RecordingMagic, sizeof(magic)) != 0) ||
+		(ReadValue(file, version, 4) == false) ||
+		(version != g_RecordingVersion) ||
+		(ReadValue(file, eventCount, 4) == false) ||
+		(ReadValue(file, duration, 4) == false))
+	{
+		std::cout << "Not a valid input recording:" << filename << std::endl;
+		return(false);
+	}
+
+	std::vector<INPUT_EVENT> events;
+	for (uint32_t i = 0; i < eventCount; i++)
+	{
+		INPUT_EVENT event;
+		uint32_t type = 0;
+		if ((ReadValue(file, event.time, 4) == false) ||
+			(ReadValue(file, type, 1) == false))
+		{
+			std::cout << "Input recording is truncated:" << filename << std::endl;
+			return(false);
+		}
+
+		event.type = (EVENT_TYPE)type;
+		event.key = 0;
+		event.action = 0;
+		event.x = 0.0f;
+		event.y = 0.0f;
+
+		bool bSuccess = false;
+		if (event.type == EVENT_KEY)
+		{
+			uint32_t key = 0;
+			uint32_t action = 0;
+			bSuccess = (ReadValue(file, key, 2) == true) && (ReadValue(file, action, 1) == true);
+			event.key = (int)key;
+			event.action = (int)action;
+		}
+		else if (event.type == EVENT_MOUSE_MOVE)
+		{
+			bSuccess = (ReadFloat(file, event.x) == true) && (ReadFloat(file, event.y) == true);
+		}
+
+		if (bSuccess == false)
+		{
+			std::cout << "Input recording is corrupt:" << filename << std::endl;
+			return(false);
+		}
+		events.push_back(event);
+	}
+
+	m_events.swap(events);
+	m_duration = duration;
+	m_replayTimeStep = (uint32_t)std::max(std::floor(timeStep * 1000000.0 + 0.5), 1.0);
+	m_replayTime = 0;
+	m_nextEvent = 0;
+
+	// count the events of the busiest step, so that the list of
+	// the events of a step is only sized once
+	m_maxStepEvents = 0;
+	size_t stepEvents = 0;
+	uint64_t lastStep = 0;
+	for (size_t i = 0; i < m_events.size(); i++)
+	{
+		uint64_t step = std::max<uint64_t>(((uint64_t)m_events[i].time + m_replayTimeStep - 1) / m_replayTimeStep, 1);
+		stepEvents = (step == lastStep) ? stepEvents + 1 : 1;
+		lastStep = step;
+		m_maxStepEvents = std::max(m_maxStepEvents, stepEvents);
+	}
+	m_bReplaying = true;
+
+	std::cout << "Replaying input recording:" << filename
+		<< " (" << m_events.size() << " events)" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsReplaying()
+ *
+ *  This method is used to check whether the input is being
+ *  replayed.
+ ***********************************************************/
+bool InputRecorder::IsReplaying() const
+{
+	return(m_bReplaying);
+}
+
+/***********************************************************
+ *  IsReplayFinished()
+ *
+ *  This method is used to check whether the replay reached
+ *  the end of the recorded session.
+ ***********************************************************/
+bool InputRecorder::IsReplayFinished() const
+{
+	return((m_bReplaying == true) && (m_nextEvent >= m_events.size()) && (m_replayTime >= m_duration));
+}
+
+/***********************************************************
+ *  AdvanceReplay()
+ *
+ *  This method is used to advance the replay time by one
+ *  fixed step, and to get the events that happened up to
+ *  the new time.  The list is sized for the busiest step, so
+ *  a list that is kept between the steps never grows again.
+ ***********************************************************/
+void InputRecorder::AdvanceReplay(std::vector<INPUT_EVENT>& events)
+{
+	events.clear();
+	if (m_bReplaying == false)
+	{
+		return;
+	}
+	events.reserve(m_maxStepEvents);
+
+	m_replayTime += m_replayTimeStep;
+	while ((m_nextEvent < m_events.size()) && (m_events[m_nextEvent].time <= m_replayTime))
+	{
+		events.push_back(m_events[m_nextEvent++]);
+	}
+}
+
+/***********************************************************
+ *  GetReplayTimeStep()
+ *
+ *  This method is used to get the fixed time step of the
+ *  replay in seconds.
+ ***********************************************************/
+double InputRecorder::GetReplayTimeStep() const
+{
+	return((double)m_replayTimeStep / 1000000.0);
+}
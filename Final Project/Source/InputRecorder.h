@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputrecorder.h
+// ============
+// record the keyboard and mouse input and replay it deterministically
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************
+ *  InputRecorder
+ *
+ *  This class contains the code for recording the keyboard
+ *  and mouse input of a session into a compact binary file,
+ *  and for replaying it.  While recording, every key press,
+ *  key release and mouse move is stored with the time since
+ *  the recording started.  While replaying, the time advances
+ *  by a fixed step every frame no matter how long the frame
+ *  took, and the events up to that time are fed back in, so
+ *  a recorded camera flight produces the same view matrices
+ *  on every run.
+ ***********************************************************/
+class InputRecorder
+{
+public:
+	// constructor
+	InputRecorder();
+	// destructor
+	~InputRecorder();
+
+	enum EVENT_TYPE
+	{
+		EVENT_KEY = 1,
+		EVENT_MOUSE_MOVE = 2
+	};
+
+	struct INPUT_EVENT
+	{
+		// microseconds since the recording started
+		uint32_t time;
+		EVENT_TYPE type;
+		// key and action of the key events
+		int key;
+		int action;
+		// cursor position of the mouse move events
+		float x;
+		float y;
+	};
+
+	// start recording the input, which is written to the file when stopped
+	bool StartRecording(const char* filename);
+	bool StopRecording();
+	bool IsRecording() const;
+	// record the input events as they arrive
+	void RecordKey(int key, int action);
+	void RecordMouseMove(double x, double y);
+
+	// load a recording for replay with a fixed time step in seconds
+	bool StartReplay(const char* filename, double timeStep);
+	bool IsReplaying() const;
+	bool IsReplayFinished() const;
+	// advance the replay by one time step and get the events of that step
+	void AdvanceReplay(std::vector<INPUT_EVENT>& events);
+	double GetReplayTimeStep() const;
+
+private:
+	// highest key code that is recorded
+	static const int MAX_KEYS = 512;
+
+	// recorded or loaded events, in time order
+	std::vector<INPUT_EVENT> m_events;
+	// file that the recording is written to
+	std::string m_recordFilename;
+	bool m_bRecording;
+	double m_recordStartTime;
+	// replay state, timed in whole microseconds so that it never drifts
+	bool m_bReplaying;
+	uint32_t m_replayTimeStep;
+	uint64_t m_replayTime;
+	size_t m_nextEvent;
+	uint32_t m_duration;
+	// most events that one step of the replay gets
+	size_t m_maxStepEvents;
+
+	// get the time since the recording started in microseconds
+	uint32_t GetRecordTime() const;
+};
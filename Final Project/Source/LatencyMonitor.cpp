@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+// latencymonitor.cpp
+// ============
+// measure the time from the user input to the present of the frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LatencyMonitor.h"
+#include "FramePacer.h"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+/***********************************************************
+ *  LatencyMonitor()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LatencyMonitor::LatencyMonitor()
+{
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		glGenQueries(1, &m_queries[i].query);
+		m_queries[i].inputTime = 0.0;
+		m_queries[i].bPending = false;
+	}
+	m_nextQuery = 0;
+
+	m_latencies.reserve(MAX_SAMPLES);
+	m_nextSample = 0;
+	m_sampleCount = 0;
+	m_latencySum = 0.0;
+	m_maxLatency = 0.0;
+}
+
+/***********************************************************
+ *  ~LatencyMonitor()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LatencyMonitor::~LatencyMonitor()
+{
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		glDeleteQueries(1, &m_queries[i].query);
+	}
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used to issue the present query of a frame
+ *  that was just swapped.  The query slot is read back first
+ *  if it still holds the query of an older frame.
+ ***********************************************************/
+void LatencyMonitor::EndFrame(double inputTime)
+{
+	PRESENT_QUERY& presentQuery = m_queries[m_nextQuery];
+	ResolveQuery(presentQuery);
+
+	if (inputTime < 0.0)
+	{
+		return;
+	}
+
+	glQueryCounter(presentQuery.query, GL_TIMESTAMP);
+	presentQuery.inputTime = inputTime;
+	presentQuery.bPending = true;
+	m_nextQuery = (m_nextQuery + 1) % FRAME_LATENCY;
+}
+
+/***********************************************************
+ *  ResolveQuery()
+ *
+ *  This method is used to read back a pending query.  The
+ *  GPU time is placed on the CPU clock by sampling both
+ *  clocks now and going back by the GPU time that passed
+ *  since the query.
+ ***********************************************************/
+void LatencyMonitor::ResolveQuery(PRESENT_QUERY& presentQuery)
+{
+	if (presentQuery.bPending == false)
+	{
+		return;
+	}
+
+	GLuint64 presentTime = 0;
+	glGetQueryObjectui64v(presentQuery.query, GL_QUERY_RESULT, &presentTime);
+	presentQuery.bPending = false;
+
+	GLint64 gpuNow = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+	double cpuNow = FramePacer::GetTime();
+
+	double cpuPresentTime = cpuNow - (double)(gpuNow - (GLint64)presentTime) / 1000000000.0;
+	double latency = (cpuPresentTime - presentQuery.inputTime) * 1000.0;
+	if (latency < 0.0)
+	{
+		return;
+	}
+
+	// the oldest latency is replaced once the ring buffer is full
+	if (m_latencies.size() < MAX_SAMPLES)
+	{
+		m_latencies.push_back(latency);
+	}
+	else
+	{
+		m_latencies[m_nextSample] = latency;
+		m_nextSample = (m_nextSample + 1) % MAX_SAMPLES;
+	}
+
+	m_sampleCount++;
+	m_latencySum += latency;
+	m_maxLatency = std::max(m_maxLatency, latency);
+}
+
+/***********************************************************
+ *  GetSampleCount()
+ *
+ *  This method is used to get the number of frames whose
+ *  latency was measured.
+ ***********************************************************/
+size_t LatencyMonitor::GetSampleCount() const
+{
+	return(m_sampleCount);
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the mean and the maximum of
+ *  the measured latencies, and the percentiles of the most
+ *  recent ones.  The queries that are still pending are
+ *  read back first.
+ ***********************************************************/
+void LatencyMonitor::WriteReport(std::ostream& stream)
+{
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		ResolveQuery(m_queries[i]);
+	}
+
+	stream << "# input to present latency in milliseconds" << std::endl;
+	stream << "frames: " << m_sampleCount << std::endl;
+	if (m_sampleCount == 0)
+	{
+		return;
+	}
+
+	std::vector<double> sorted = m_latencies;
+	std::sort(sorted.begin(), sorted.end());
+
+	const double percentiles[] = { 50.0, 95.0, 99.0 };
+	const char* names[] = { "p50_ms", "p95_ms", "p99_ms" };
+
+	stream << "mean_ms: " << m_latencySum / (double)m_sampleCount << std::endl;
+	stream << "percentile_frames: " << sorted.size() << std::endl;
+	for (int i = 0; i < 3; i++)
+	{
+		size_t index = (size_t)(percentiles[i] / 100.0 * (double)(sorted.size() - 1) + 0.5);
+		stream << names[i] << ": " << sorted[index] << std::endl;
+	}
+	stream << "max_ms: " << m_maxLatency << std::endl;
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the report into a file.
+ ***********************************************************/
+bool LatencyMonitor::WriteReport(const char* filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create latency report file:" << filename << std::endl;
+		return(false);
+	}
+
+	WriteReport(file);
+	if (!file)
+	{
+		std::cout << "Could not write latency report file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote latency report file:" << filename << std::endl;
+
+	return(true);
+}
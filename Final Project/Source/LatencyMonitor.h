@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// latencymonitor.h
+// ============
+// measure the time from the user input to the present of the frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <vector>
+#include <ostream>
+
+/***********************************************************
+ *  LatencyMonitor
+ *
+ *  This class contains the code for measuring the input to
+ *  present latency.  After the buffers of a frame are swapped,
+ *  a GPU timestamp query marks the point where the frame is
+ *  finished and handed to the display.  The query is read
+ *  back a few frames later, converted to the CPU clock, and
+ *  compared with the time of the oldest input event that the
+ *  frame shows.  Frames without new input are not measured.
+ *  The latencies of the most recent frames are kept in a
+ *  fixed size ring buffer for the percentiles, and the mean
+ *  and the maximum are kept for all of the frames.
+ ***********************************************************/
+class LatencyMonitor
+{
+public:
+	// constructor
+	LatencyMonitor();
+	// destructor
+	~LatencyMonitor();
+
+	// mark the present of a frame that shows the input of a time,
+	// which is negative when the frame has no new input
+	void EndFrame(double inputTime);
+
+	// get the number of measured frames
+	size_t GetSampleCount() const;
+
+	// write the latency statistics of the measured frames
+	void WriteReport(std::ostream& stream);
+	bool WriteReport(const char* filename);
+
+private:
+	// frames that pass before the query of a frame is read back
+	static const int FRAME_LATENCY = 4;
+	// most recent latencies that the percentiles are taken from
+	static const size_t MAX_SAMPLES = 8192;
+
+	struct PRESENT_QUERY
+	{
+		GLuint query;
+		double inputTime;
+		bool bPending;
+	};
+
+	PRESENT_QUERY m_queries[FRAME_LATENCY];
+	int m_nextQuery;
+	// most recent measured latencies in milliseconds, and the
+	// slot that the next one is written into once it is full
+	std::vector<double> m_latencies;
+	size_t m_nextSample;
+	// totals of all of the measured frames
+	size_t m_sampleCount;
+	double m_latencySum;
+	double m_maxLatency;
+
+	// read back a query and add its latency
+	void ResolveQuery(PRESENT_QUERY& presentQuery);
+};
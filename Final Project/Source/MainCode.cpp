@@ -1,177 +1,1061 @@
-#include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
-
-#include <GL/glew.h>        // GLEW library
-#include "GLFW/glfw3.h"     // GLFW library
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "SceneManager.h"
-#include "ViewManager.h"
-#include "ShapeMeshes.h"
-#include "ShaderManager.h"
-
-// Namespace for declaring global variables
-namespace
-{
-	// Macro for window title
-	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
-
-	// Main GLFW window
-	GLFWwindow* g_Window = nullptr;
-
-	// scene manager object for managing the 3D scene prepare and render
-	SceneManager* g_SceneManager = nullptr;
-	// shader manager object for dynamic interaction with the shader code
-	ShaderManager* g_ShaderManager = nullptr;
-	// view manager object for managing the 3D view setup and projection to 2D
-	ViewManager* g_ViewManager = nullptr;
-}
-
-// Function declarations - all functions that are called manually
-// need to be pre-declared at the beginning of the source code.
-bool InitializeGLFW();
-bool InitializeGLEW();
-
-
-/***********************************************************
- *  main(int, char*)
- *
- *  This function gets called after the application has been
- *  launched.
- ***********************************************************/
-int main(int argc, char* argv[])
-{
-	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// try to create a new shader manager object
-	g_ShaderManager = new ShaderManager();
-	// try to create a new view manager object
-	g_ViewManager = new ViewManager(
-		g_ShaderManager);
-
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
-
-	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
-
-	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
-
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
-	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
-
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
-
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
-
-
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
-
-		// query the latest GLFW events
-		glfwPollEvents();
-	}
-
-	// clear the allocated manager objects from memory
-	if (NULL != g_SceneManager)
-	{
-		delete g_SceneManager;
-		g_SceneManager = NULL;
-	}
-	if (NULL != g_ViewManager)
-	{
-		delete g_ViewManager;
-		g_ViewManager = NULL;
-	}
-	if (NULL != g_ShaderManager)
-	{
-		delete g_ShaderManager;
-		g_ShaderManager = NULL;
-	}
-
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
-}
-
-/***********************************************************
- *	InitializeGLFW()
- * 
- *  This function is used to initialize the GLFW library.   
- ***********************************************************/
-bool InitializeGLFW()
-{
-	// GLFW: initialize and configure library
-	// --------------------------------------
-	glfwInit();
-
-#ifdef __APPLE__
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#else
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
-	// GLFW: end -------------------------------
-
-	return(true);
-}
-
-/***********************************************************
- *	InitializeGLEW()
- *
- *  This function is used to initialize the GLEW library.
- ***********************************************************/
-bool InitializeGLEW()
-{
-	// GLEW: initialize
-	// -----------------------------------------
-	GLenum GLEWInitResult = GLEW_OK;
-
-	// try to initialize the GLEW library
-	GLEWInitResult = glewInit();
-	if (GLEW_OK != GLEWInitResult)
-	{
-		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
-		return false;
-	}
-	// GLEW: end -------------------------------
-
-	// Displays a successful OpenGL initialization message
-	std::cout << "INFO: OpenGL Successfully Initialized\n";
-	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
-
-	return(true);
+#include <iostream>         // error handling and output
+#include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // strcmp
+#include <cstdio>           // sscanf
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ShapeMeshes.h"
+#include "ShaderManager.h"
+#include "TextureCooker.h"
+#include "VirtualTextureSystem.h"
+#include "FramePacer.h"
+#include "FrameProfiler.h"
+#include "FrameBenchmark.h"
+#include "InputRecorder.h"
+#include "LatencyMonitor.h"
+#include "DepthPrepass.h"
+#include "DynamicResolution.h"
+#include "BatchRenderer.h"
+#include "FrameCapture.h"
+#include "AllocationTracker.h"
+#include "NullRenderBackend.h"
+#include "SoftwareRenderBackend.h"
+#include "VulkanRenderBackend.h"
+#include "GLStats.h"
+
+// Namespace for declaring global variables
+namespace
+{
+	// Macro for window title
+	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
+
+	// Main GLFW window
+	GLFWwindow* g_Window = nullptr;
+
+	// frames that load and stream their data before the heap
+	// allocations of the frames are checked
+	const int g_AllocationWarmupFrames = 120;
+
+	// scene manager object for managing the 3D scene prepare and render
+	SceneManager* g_SceneManager = nullptr;
+	// shader manager object for dynamic interaction with the shader code
+	ShaderManager* g_ShaderManager = nullptr;
+	// view manager object for managing the 3D view setup and projection to 2D
+	ViewManager* g_ViewManager = nullptr;
+	// frame pacer object for limiting the frame rate and timing the frames
+	FramePacer* g_FramePacer = nullptr;
+	// frame profiler object for measuring the CPU and GPU time of the frames
+	FrameProfiler* g_FrameProfiler = nullptr;
+	// input recorder object for recording and replaying the user input
+	InputRecorder* g_InputRecorder = nullptr;
+	// latency monitor object for measuring the input to present latency
+	LatencyMonitor* g_LatencyMonitor = nullptr;
+	// depth pre-pass object for shading only the visible fragments
+	DepthPrepass* g_DepthPrepass = nullptr;
+	// dynamic resolution object for holding the GPU time of the frames
+	DynamicResolution* g_DynamicResolution = nullptr;
+	// frame capture object for writing screenshots and frame sequences
+	FrameCapture* g_FrameCapture = nullptr;
+	// null render backend object for measuring the CPU cost of the scene
+	NullRenderBackend* g_NullBackend = nullptr;
+	// software render backend object for drawing the scene on the CPU
+	SoftwareRenderBackend* g_SoftwareBackend = nullptr;
+#ifdef VULKANRENDERBACKEND_AVAILABLE
+	// Vulkan render backend object for recording the scene on many threads
+	VulkanRenderBackend* g_VulkanBackend = nullptr;
+#endif
+}
+
+// Function declarations - all functions that are called manually
+// need to be pre-declared at the beginning of the source code.
+bool InitializeGLFW(bool bHeadless, bool bUseEGL);
+bool InitializeGLEW(bool bHeadless);
+void RenderFrame();
+void DrawSceneView(int renderWidth, int renderHeight);
+int RunBenchmark(int argc, char* argv[]);
+int RunBatch(int argc, char* argv[]);
+int CookSceneTextures(int argc, char* argv[]);
+bool FindCommandLineOption(int argc, char* argv[], const char* option);
+const char* FindCommandLineValue(int argc, char* argv[], const char* option);
+
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the application has been
+ *  launched.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	// the texture cooker runs offline and does not need a window
+	if ((argc > 1) && (strcmp(argv[1], "--cook-textures") == 0))
+	{
+		return(CookSceneTextures(argc, argv));
+	}
+
+	// the benchmark and the batch rendering of camera poses render
+	// offscreen, without a visible window
+	bool bBenchmark = FindCommandLineOption(argc, argv, "--benchmark");
+	bool bBatch = (NULL != FindCommandLineValue(argc, argv, "--batch"));
+	bool bHeadless = (bBenchmark || bBatch);
+
+	// count the heap allocations of every frame from the start, and
+	// fail when the frames after the warmup allocate, which is best
+	// run with the benchmark (--alloc-check [--alloc-warmup <frames>]
+	// [--alloc-report <file>])
+	bool bAllocationCheck = FindCommandLineOption(argc, argv, "--alloc-check");
+	const char* allocationFilename = FindCommandLineValue(argc, argv, "--alloc-report");
+	if ((true == bAllocationCheck) || (NULL != allocationFilename))
+	{
+		const char* warmupFrames = FindCommandLineValue(argc, argv, "--alloc-warmup");
+		AllocationTracker::Enable((NULL != warmupFrames) ? atoi(warmupFrames) : g_AllocationWarmupFrames);
+	}
+
+	// if GLFW fails initialization, then terminate the application
+	if (InitializeGLFW(bHeadless, false) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// try to create a new shader manager object
+	g_ShaderManager = new ShaderManager();
+	// try to create a new view manager object
+	g_ViewManager = new ViewManager(
+		g_ShaderManager);
+
+	// try to create the main display window
+	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+
+	// without OSMesa, the headless modes try an EGL context instead
+	if ((NULL == g_Window) && (true == bHeadless) && (InitializeGLFW(true, true) == true))
+	{
+		g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+	}
+	if (NULL == g_Window)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// if GLEW fails initialization, then terminate the application
+	if (InitializeGLEW(bHeadless) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+	// nothing of the state of the new context is known yet
+	GLStateCache::Invalidate();
+
+	// pace the frames with an optional frame rate limit (--fps <rate>)
+	// and vertical sync mode (--vsync off|on|adaptive)
+	g_FramePacer = new FramePacer();
+	const char* targetFPS = FindCommandLineValue(argc, argv, "--fps");
+	if (NULL != targetFPS)
+	{
+		g_FramePacer->SetTargetFPS(atof(targetFPS));
+	}
+	FramePacer::VSYNC_MODE vsyncMode = FramePacer::VSYNC_ADAPTIVE;
+	const char* vsync = FindCommandLineValue(argc, argv, "--vsync");
+	if (NULL != vsync)
+	{
+		if (strcmp(vsync, "off") == 0)
+			vsyncMode = FramePacer::VSYNC_OFF;
+		else if (strcmp(vsync, "on") == 0)
+			vsyncMode = FramePacer::VSYNC_ON;
+	}
+	g_FramePacer->SetVSyncMode(vsyncMode);
+	g_ViewManager->SetFramePacer(g_FramePacer);
+
+	// record the input of the session (--record-input <file>), or
+	// replay a recorded session at a fixed rate for reproducible
+	// runs (--replay-input <file> [--replay-rate <steps per second>])
+	const char* recordFilename = FindCommandLineValue(argc, argv, "--record-input");
+	const char* replayFilename = FindCommandLineValue(argc, argv, "--replay-input");
+	if ((NULL != recordFilename) || (NULL != replayFilename))
+	{
+		g_InputRecorder = new InputRecorder();
+		if (NULL != replayFilename)
+		{
+			double replayRate = 60.0;
+			const char* rate = FindCommandLineValue(argc, argv, "--replay-rate");
+			if ((NULL != rate) && (atof(rate) > 0.0))
+			{
+				replayRate = atof(rate);
+			}
+			if (g_InputRecorder->StartReplay(replayFilename, 1.0 / replayRate) == false)
+			{
+				return(EXIT_FAILURE);
+			}
+		}
+		else
+		{
+			g_InputRecorder->StartRecording(recordFilename);
+		}
+		g_ViewManager->SetInputRecorder(g_InputRecorder);
+	}
+
+	// redundant OpenGL state calls are skipped by the state cache,
+	// which can be turned off for comparisons (--no-gl-state-cache)
+	if (FindCommandLineOption(argc, argv, "--no-gl-state-cache") == true)
+	{
+		GLStateCache::SetActive(false);
+	}
+
+	// profile the frames and write them as a Chrome trace when the
+	// application is closed (--profile <trace.json>)
+	const char* traceFilename = FindCommandLineValue(argc, argv, "--profile");
+	if (NULL != traceFilename)
+	{
+		g_FrameProfiler = new FrameProfiler();
+		FrameProfiler::SetActive(g_FrameProfiler);
+	}
+
+	// load the shader code from the external GLSL files
+	g_ShaderManager->LoadShaders(
+		"Shaders/vertexShader.glsl",
+		"Shaders/fragmentShader.glsl");
+	g_ShaderManager->use();
+
+	// the camera is written into a persistently mapped buffer right
+	// before the draws, after sampling the mouse once more, unless the
+	// late sampling is turned off for comparisons (--no-late-latch)
+	g_ViewManager->CreateCameraBuffer();
+	if (FindCommandLineOption(argc, argv, "--no-late-latch") == true)
+	{
+		g_ViewManager->SetLateLatch(false);
+	}
+
+	// measure the input to present latency and report it when the
+	// application is closed (--latency-report <file>)
+	const char* latencyFilename = FindCommandLineValue(argc, argv, "--latency-report");
+	if (NULL != latencyFilename)
+	{
+		g_LatencyMonitor = new LatencyMonitor();
+	}
+
+	// capture the frames of the window in the background, so F12
+	// saves a screenshot, and record every frame into a Y4M video or
+	// a directory of PNG files, like a replayed flythrough, and
+	// report the cost of the capture when the application is closed
+	// (--capture <file.y4m|directory> [--capture-fps <rate>]
+	// [--capture-report <file>])
+	g_FrameCapture = new FrameCapture();
+	const char* capturePath = FindCommandLineValue(argc, argv, "--capture");
+	const char* captureReportFilename = FindCommandLineValue(argc, argv, "--capture-report");
+	if (NULL != capturePath)
+	{
+		const char* captureFPS = FindCommandLineValue(argc, argv, "--capture-fps");
+		if (NULL != captureFPS)
+		{
+			g_FrameCapture->SetFrameRate(atof(captureFPS));
+		}
+		g_FrameCapture->StartRecording(capturePath);
+	}
+
+	// try to create a new scene manager object and prepare the 3D scene
+	g_SceneManager = new SceneManager(g_ShaderManager);
+
+	// the GPU memory budget for the textures can be set in megabytes
+	const char* textureBudget = FindCommandLineValue(argc, argv, "--texture-budget");
+	if (NULL != textureBudget)
+	{
+		g_SceneManager->SetTextureBudget((size_t)atoi(textureBudget) * 1024 * 1024);
+	}
+
+	g_SceneManager->PrepareScene();
+
+	// add point lights over the desk to measure the cost of many
+	// lights with the clustered lighting (--point-lights <count>)
+	const char* pointLights = FindCommandLineValue(argc, argv, "--point-lights");
+	if (NULL != pointLights)
+	{
+		g_SceneManager->AddScatteredLights(atoi(pointLights));
+	}
+
+	// the scene is drawn with its flat colors and textures unless
+	// the custom lighting is turned on (--lighting), which casts the
+	// shadows of the scene lights from cached shadow maps that can
+	// be rendered every frame for comparisons (--no-shadow-cache)
+	if (FindCommandLineOption(argc, argv, "--lighting") == true)
+	{
+		g_SceneManager->SetLightingEnabled(true);
+	}
+	if (FindCommandLineOption(argc, argv, "--no-shadow-cache") == true)
+	{
+		g_SceneManager->SetShadowCaching(false);
+	}
+
+	// draw the depth of the scene before the lit main pass
+	// (--depth-prepass), or alternate the frames with and without
+	// it and report the fragments that the main pass shaded when
+	// the application is closed (--overdraw-report <file>)
+	const char* overdrawFilename = FindCommandLineValue(argc, argv, "--overdraw-report");
+	if ((FindCommandLineOption(argc, argv, "--depth-prepass") == true) ||
+		(NULL != overdrawFilename))
+	{
+		g_DepthPrepass = new DepthPrepass();
+		if (g_DepthPrepass->Create(
+			"Shaders/depthVertexShader.glsl",
+			"Shaders/depthFragmentShader.glsl") == true)
+		{
+			g_ViewManager->BindCameraBlock(g_DepthPrepass->GetShaderManager());
+			g_DepthPrepass->SetMeasuring(NULL != overdrawFilename);
+			g_SceneManager->SetDepthPrepass(g_DepthPrepass);
+		}
+		g_ShaderManager->use();
+	}
+
+	// render the scene at the resolution that holds the GPU time
+	// of the frames at a target in milliseconds, and upscale it to
+	// the window (--dynamic-resolution <ms>), with a sharpening
+	// filter instead of the bilinear blit (--upscale-sharpness <0-1>)
+	const char* targetFrameTime = FindCommandLineValue(argc, argv, "--dynamic-resolution");
+	if (NULL != targetFrameTime)
+	{
+		g_DynamicResolution = new DynamicResolution();
+		g_DynamicResolution->SetTargetFrameTime(atof(targetFrameTime));
+
+		const char* sharpness = FindCommandLineValue(argc, argv, "--upscale-sharpness");
+		if ((NULL != sharpness) && (atof(sharpness) > 0.0))
+		{
+			g_DynamicResolution->CreateSharpening(
+				"Shaders/upscaleVertexShader.glsl",
+				"Shaders/upscaleFragmentShader.glsl",
+				(float)atof(sharpness));
+			g_ShaderManager->use();
+		}
+	}
+
+	// submit the frames of the scene to the null backend, which
+	// records the commands without drawing them, so the frame times
+	// measure the CPU cost of the scene alone, and report the
+	// commands per frame when the application is closed
+	// (--null-backend <file>)
+	const char* nullBackendFilename = FindCommandLineValue(argc, argv, "--null-backend");
+	if (NULL != nullBackendFilename)
+	{
+		g_NullBackend = new NullRenderBackend();
+		g_SceneManager->SetRenderBackend(g_NullBackend);
+	}
+
+	// draw the frames of the scene on the CPU instead, with the
+	// tiles split between a pool of threads, and copy them into
+	// the window, and report the rasterization time per frame when
+	// the application is closed
+	// (--software-backend <file> [--software-threads <count>])
+	const char* softwareBackendFilename = FindCommandLineValue(argc, argv, "--software-backend");
+	if ((NULL != softwareBackendFilename) && (NULL == g_NullBackend))
+	{
+		g_SoftwareBackend = new SoftwareRenderBackend();
+		const char* threads = FindCommandLineValue(argc, argv, "--software-threads");
+		if (NULL != threads)
+		{
+			g_SoftwareBackend->SetThreadCount(atoi(threads));
+		}
+		g_SceneManager->SetRenderBackend(g_SoftwareBackend);
+	}
+
+	// draw the frames of the scene with Vulkan instead, with the
+	// draws recorded into secondary command buffers on a pool of
+	// threads and a frame in flight while the next is recorded, and
+	// copy them into the window, and report the recording time per
+	// frame when the application is closed.  The batch waits for
+	// every frame, so the images it writes are the frames it drew.
+	// (--vulkan-backend <file> [--vulkan-threads <count>])
+	const char* vulkanBackendFilename = FindCommandLineValue(argc, argv, "--vulkan-backend");
+	if ((NULL != vulkanBackendFilename) && (NULL == g_NullBackend) && (NULL == g_SoftwareBackend))
+	{
+#ifdef VULKANRENDERBACKEND_AVAILABLE
+		g_VulkanBackend = new VulkanRenderBackend();
+		const char* threads = FindCommandLineValue(argc, argv, "--vulkan-threads");
+		if (NULL != threads)
+		{
+			g_VulkanBackend->SetThreadCount(atoi(threads));
+		}
+		if (true == bBatch)
+		{
+			g_VulkanBackend->SetPresentLatency(0);
+		}
+
+		if (g_VulkanBackend->Initialize(
+			"Shaders/vulkanVertexShader.spv",
+			"Shaders/vulkanFragmentShader.spv") == true)
+		{
+			g_SceneManager->SetRenderBackend(g_VulkanBackend);
+		}
+		else
+		{
+			std::cout << "Drawing the scene with OpenGL instead" << std::endl;
+			delete g_VulkanBackend;
+			g_VulkanBackend = NULL;
+		}
+#else
+		std::cout << "The Vulkan backend is not available in this build" << std::endl;
+#endif
+	}
+
+	// the benchmark and the batch close the window when they are
+	// done, so the interactive loop does not run afterwards
+	int exitCode = EXIT_SUCCESS;
+	if (true == bBenchmark)
+	{
+		exitCode = RunBenchmark(argc, argv);
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+	else if (true == bBatch)
+	{
+		exitCode = RunBatch(argc, argv);
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+
+	// loop will keep running until the application is closed 
+	// or until an error has occurred
+	while (!glfwWindowShouldClose(g_Window))
+	{
+		// measure the time since the last frame
+		g_FramePacer->BeginFrame();
+		if (NULL != g_FrameProfiler)
+		{
+			g_FrameProfiler->BeginFrame();
+		}
+		AllocationTracker::BeginFrame();
+		PROFILE_SCOPE("Frame");
+
+		// render the scene and show it
+		RenderFrame();
+
+		// wait for the next frame before the events are read, so
+		// the next frame starts from the most recent input
+		{
+			PROFILE_CPU_SCOPE("WaitForNextFrame");
+			g_FramePacer->WaitForNextFrame();
+		}
+
+		// query the latest GLFW events
+		{
+			PROFILE_CPU_SCOPE("PollEvents");
+			glfwPollEvents();
+		}
+	}
+
+	// finish the last frame before the reports allocate, and fail
+	// the allocation check when the steady state frames allocated
+	AllocationTracker::Finish();
+	if ((true == bAllocationCheck) || (NULL != allocationFilename))
+	{
+		AllocationTracker::WriteReport(std::cout);
+		if (NULL != allocationFilename)
+		{
+			AllocationTracker::WriteReport(allocationFilename);
+		}
+		if ((true == bAllocationCheck) && (AllocationTracker::GetAllocatingFrameCount() > 0))
+		{
+			std::cout << "Frames allocated from the heap after the warmup:" << AllocationTracker::GetAllocatingFrameCount() << std::endl;
+			exitCode = EXIT_FAILURE;
+		}
+	}
+
+	// write the OpenGL call statistics of the session (--gl-stats <file>)
+	const char* statsFilename = FindCommandLineValue(argc, argv, "--gl-stats");
+	if (NULL != statsFilename)
+	{
+		GLStats::WriteSummary(std::cout);
+		GLStats::WriteSummary(statsFilename);
+	}
+
+	// write the bytes of transient frame data that the scene
+	// allocated from its arena per frame (--arena-report <file>)
+	const char* arenaFilename = FindCommandLineValue(argc, argv, "--arena-report");
+	if (NULL != arenaFilename)
+	{
+		g_SceneManager->GetFrameArena()->WriteReport(std::cout);
+		g_SceneManager->GetFrameArena()->WriteReport(arenaFilename);
+	}
+
+	if (NULL != g_LatencyMonitor)
+	{
+		g_LatencyMonitor->WriteReport(std::cout);
+		g_LatencyMonitor->WriteReport(latencyFilename);
+		delete g_LatencyMonitor;
+		g_LatencyMonitor = NULL;
+	}
+
+	if (NULL != g_DepthPrepass)
+	{
+		if (NULL != overdrawFilename)
+		{
+			g_DepthPrepass->WriteReport(std::cout);
+			g_DepthPrepass->WriteReport(overdrawFilename);
+		}
+		g_SceneManager->SetDepthPrepass(NULL);
+		delete g_DepthPrepass;
+		g_DepthPrepass = NULL;
+	}
+
+	if (NULL != g_DynamicResolution)
+	{
+		delete g_DynamicResolution;
+		g_DynamicResolution = NULL;
+	}
+
+	if (NULL != g_FrameCapture)
+	{
+		g_FrameCapture->Finish();
+		if ((NULL != capturePath) || (NULL != captureReportFilename))
+		{
+			g_FrameCapture->WriteReport(std::cout);
+		}
+		if (NULL != captureReportFilename)
+		{
+			g_FrameCapture->WriteReport(captureReportFilename);
+		}
+		delete g_FrameCapture;
+		g_FrameCapture = NULL;
+	}
+
+	if (NULL != g_NullBackend)
+	{
+		g_NullBackend->WriteReport(std::cout);
+		g_NullBackend->WriteReport(nullBackendFilename);
+		g_SceneManager->SetRenderBackend(NULL);
+		delete g_NullBackend;
+		g_NullBackend = NULL;
+	}
+
+	if (NULL != g_SoftwareBackend)
+	{
+		g_SoftwareBackend->WriteReport(std::cout);
+		g_SoftwareBackend->WriteReport(softwareBackendFilename);
+		g_SceneManager->SetRenderBackend(NULL);
+		delete g_SoftwareBackend;
+		g_SoftwareBackend = NULL;
+	}
+
+#ifdef VULKANRENDERBACKEND_AVAILABLE
+	if (NULL != g_VulkanBackend)
+	{
+		g_VulkanBackend->WriteReport(std::cout);
+		g_VulkanBackend->WriteReport(vulkanBackendFilename);
+		g_SceneManager->SetRenderBackend(NULL);
+		delete g_VulkanBackend;
+		g_VulkanBackend = NULL;
+	}
+#endif
+
+	if (NULL != g_FrameProfiler)
+	{
+		g_FrameProfiler->WriteChromeTrace(traceFilename);
+		FrameProfiler::SetActive(NULL);
+		delete g_FrameProfiler;
+		g_FrameProfiler = NULL;
+	}
+
+	// clear the allocated manager objects from memory
+	if (NULL != g_SceneManager)
+	{
+		delete g_SceneManager;
+		g_SceneManager = NULL;
+	}
+	if (NULL != g_ViewManager)
+	{
+		delete g_ViewManager;
+		g_ViewManager = NULL;
+	}
+	if (NULL != g_ShaderManager)
+	{
+		delete g_ShaderManager;
+		g_ShaderManager = NULL;
+	}
+	if (NULL != g_FramePacer)
+	{
+		delete g_FramePacer;
+		g_FramePacer = NULL;
+	}
+	// a running recording is written when the recorder is deleted
+	if (NULL != g_InputRecorder)
+	{
+		delete g_InputRecorder;
+		g_InputRecorder = NULL;
+	}
+
+	// Terminates the program successfully
+	exit(exitCode); 
+}
+
+/***********************************************************
+ *	InitializeGLFW()
+ * 
+ *  This function is used to initialize the GLFW library.   
+ *  A headless context is created without a display, with
+ *  OSMesa or with EGL, and its window is never shown.
+ ***********************************************************/
+bool InitializeGLFW(bool bHeadless, bool bUseEGL)
+{
+	// GLFW: initialize and configure library
+	// --------------------------------------
+#ifdef GLFW_PLATFORM_NULL
+	if (true == bHeadless)
+	{
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+	}
+#endif
+	if (glfwInit() == GLFW_FALSE)
+	{
+		std::cout << "Failed to initialize GLFW" << std::endl;
+		return(false);
+	}
+
+	if (true == bHeadless)
+	{
+		// Mesa provides a core profile 3.3 context or newer in software
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, bUseEGL ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		return(true);
+	}
+
+#ifdef __APPLE__
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#else
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
+	// GLFW: end -------------------------------
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLEW()
+ *
+ *  This function is used to initialize the GLEW library.
+ ***********************************************************/
+bool InitializeGLEW(bool bHeadless)
+{
+	// GLEW: initialize
+	// -----------------------------------------
+	GLenum GLEWInitResult = GLEW_OK;
+
+	// try to initialize the GLEW library
+	GLEWInitResult = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	// a GLX build of GLEW loads the OpenGL functions of headless
+	// contexts, but fails to find a GLX display afterwards
+	if ((true == bHeadless) && (GLEW_ERROR_NO_GLX_DISPLAY == GLEWInitResult))
+	{
+		GLEWInitResult = GLEW_OK;
+	}
+#else
+	// the other builds of GLEW do not fail on headless contexts
+	(void)bHeadless;
+#endif
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return false;
+	}
+	// GLEW: end -------------------------------
+
+	// Displays a successful OpenGL initialization message
+	std::cout << "INFO: OpenGL Successfully Initialized\n";
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *	RenderFrame()
+ *
+ *  This function is used to render the 3D scene into the
+ *  back buffer and to show it.
+ ***********************************************************/
+void RenderFrame()
+{
+	// Enable z-depth
+	glEnable(GL_DEPTH_TEST);
+
+	// convert from 3D object space to 2D view
+	{
+		PROFILE_SCOPE("PrepareSceneView");
+		g_ViewManager->PrepareSceneView();
+	}
+
+	// render into the scaled offscreen target when the resolution
+	// is dynamic, which replaces the viewport of the window
+	int renderWidth = g_ViewManager->GetFramebufferWidth();
+	int renderHeight = g_ViewManager->GetFramebufferHeight();
+	if (NULL != g_DynamicResolution)
+	{
+		g_DynamicResolution->BeginFrame(renderWidth, renderHeight);
+		renderWidth = g_DynamicResolution->GetRenderWidth();
+		renderHeight = g_DynamicResolution->GetRenderHeight();
+	}
+
+	// Clear the frame and z buffers
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// draw the scene into the bound framebuffer
+	DrawSceneView(renderWidth, renderHeight);
+
+	// upscale the frame to the window
+	if (NULL != g_DynamicResolution)
+	{
+		PROFILE_SCOPE("Upscale");
+		g_DynamicResolution->EndFrame(g_ShaderManager);
+	}
+
+	// read the finished frame back in the background when it is
+	// recorded or a screenshot was asked for
+	if (g_ViewManager->WasKeyPressed(GLFW_KEY_F12) == true)
+	{
+		g_FrameCapture->RequestScreenshot();
+	}
+	{
+		PROFILE_SCOPE("CaptureFrame");
+		g_FrameCapture->CaptureFrame(
+			g_ViewManager->GetFramebufferWidth(),
+			g_ViewManager->GetFramebufferHeight());
+	}
+
+	// Flips the the back buffer with the front buffer every frame.
+	{
+		PROFILE_CPU_SCOPE("SwapBuffers");
+		glfwSwapBuffers(g_Window);
+	}
+
+	// the present of the frame ends the latency of its input
+	if (NULL != g_LatencyMonitor)
+	{
+		g_LatencyMonitor->EndFrame(g_ViewManager->GetFrameInputTime());
+	}
+
+	// the OpenGL calls counted so far belong to this frame
+	GLStats::EndFrame();
+}
+
+/***********************************************************
+ *	DrawSceneView()
+ *
+ *  This function is used to draw the scene from the current
+ *  camera into the bound framebuffer, which was cleared with
+ *  a viewport of the given size.
+ ***********************************************************/
+void DrawSceneView(int renderWidth, int renderHeight)
+{
+	// the software backend draws into buffers of the same size
+	if (NULL != g_SoftwareBackend)
+	{
+		g_SoftwareBackend->SetFramebufferSize(renderWidth, renderHeight);
+	}
+#ifdef VULKANRENDERBACKEND_AVAILABLE
+	if (NULL != g_VulkanBackend)
+	{
+		g_VulkanBackend->SetFramebufferSize(renderWidth, renderHeight);
+	}
+#endif
+
+	// stream the textures that the frame needs
+	{
+		PROFILE_SCOPE("UpdateScene");
+		g_SceneManager->UpdateScene();
+	}
+
+	// pass the camera with the latest mouse input to the shaders
+	{
+		PROFILE_CPU_SCOPE("LatchSceneView");
+		g_ViewManager->LatchSceneView();
+	}
+
+	// draw the passes of the scene with the latched camera, and
+	// assign the lights to its clusters
+	g_SceneManager->SetViewCamera(
+		g_ViewManager->GetViewMatrix(),
+		g_ViewManager->GetProjectionMatrix());
+	g_SceneManager->UpdateLighting(
+		g_ViewManager->GetViewMatrix(),
+		g_ViewManager->GetProjectionMatrix(),
+		g_ViewManager->GetNearPlane(),
+		g_ViewManager->GetFarPlane(),
+		renderWidth,
+		renderHeight);
+
+	// refresh the 3D scene
+	{
+		PROFILE_SCOPE("RenderScene");
+		g_SceneManager->RenderScene();
+	}
+
+	// copy the frame drawn on the CPU into the bound framebuffer
+	if (NULL != g_SoftwareBackend)
+	{
+		PROFILE_SCOPE("SoftwarePresent");
+		g_SoftwareBackend->Present(renderWidth, renderHeight);
+	}
+#ifdef VULKANRENDERBACKEND_AVAILABLE
+	if (NULL != g_VulkanBackend)
+	{
+		PROFILE_SCOPE("VulkanPresent");
+		g_VulkanBackend->Present(renderWidth, renderHeight);
+	}
+#endif
+}
+
+/***********************************************************
+ *	RunBenchmark()
+ *
+ *  This function is used to render a fixed number of frames
+ *  along a scripted camera path as fast as possible, and to
+ *  write the measured frame times as a report.  When a
+ *  baseline report is given, the run fails when it is
+ *  significantly slower than the baseline.
+ *  Usage: --benchmark [--benchmark-frames <count>]
+ *         [--benchmark-report <file>] [--benchmark-baseline <file>]
+ ***********************************************************/
+int RunBenchmark(int argc, char* argv[])
+{
+	int frameCount = 600;
+	const char* frames = FindCommandLineValue(argc, argv, "--benchmark-frames");
+	if (NULL != frames)
+	{
+		frameCount = atoi(frames);
+	}
+	const char* reportFilename = FindCommandLineValue(argc, argv, "--benchmark-report");
+	if (NULL == reportFilename)
+	{
+		reportFilename = "benchmark_report.txt";
+	}
+	const char* baselineFilename = FindCommandLineValue(argc, argv, "--benchmark-baseline");
+
+	// the frames are neither limited nor synchronized to a display
+	g_FramePacer->SetTargetFPS(0.0);
+	g_FramePacer->SetVSyncMode(FramePacer::VSYNC_OFF);
+
+	FrameBenchmark benchmark(frameCount);
+	while ((benchmark.IsFinished() == false) && !glfwWindowShouldClose(g_Window))
+	{
+		g_FramePacer->BeginFrame();
+		if (NULL != g_FrameProfiler)
+		{
+			g_FrameProfiler->BeginFrame();
+		}
+		AllocationTracker::BeginFrame();
+		PROFILE_SCOPE("Frame");
+
+		benchmark.BeginFrame();
+
+		glm::vec3 position;
+		glm::vec3 front;
+		benchmark.GetCameraPose(position, front);
+		g_ViewManager->SetCameraPose(position, front);
+		RenderFrame();
+
+		benchmark.EndFrame((int)GLStats::GetLastFrame().draws);
+
+		glfwPollEvents();
+	}
+	AllocationTracker::Finish();
+
+	if (benchmark.WriteReport(reportFilename) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+	if ((NULL != baselineFilename) && (benchmark.CompareWithBaseline(baselineFilename) > 0))
+	{
+		return(EXIT_FAILURE);
+	}
+
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	RunBatch()
+ *
+ *  This function is used to render an image of the scene for
+ *  every camera pose of a list, as fast as possible, and to
+ *  write them as numbered PNG files.  The rendering, the
+ *  readback and the encoding of the images overlap, and the
+ *  images per second are written when the batch is done.
+ *  Usage: --batch <poses> [--batch-output <directory>]
+ *         [--batch-size <width>x<height>] [--batch-pool <count>]
+ *         [--batch-threads <count>]
+ ***********************************************************/
+int RunBatch(int argc, char* argv[])
+{
+	BatchRenderer batch;
+	if (batch.LoadPoses(FindCommandLineValue(argc, argv, "--batch")) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	int width = g_ViewManager->GetFramebufferWidth();
+	int height = g_ViewManager->GetFramebufferHeight();
+	const char* size = FindCommandLineValue(argc, argv, "--batch-size");
+	if ((NULL != size) && (sscanf(size, "%dx%d", &width, &height) != 2))
+	{
+		std::cout << "Invalid batch image size:" << size << std::endl;
+		return(EXIT_FAILURE);
+	}
+	const char* poolSize = FindCommandLineValue(argc, argv, "--batch-pool");
+	if (NULL != poolSize)
+	{
+		batch.SetPoolSize(atoi(poolSize));
+	}
+	const char* threads = FindCommandLineValue(argc, argv, "--batch-threads");
+	if (NULL != threads)
+	{
+		batch.SetEncoderThreadCount(atoi(threads));
+	}
+
+	if (batch.Begin(width, height, FindCommandLineValue(argc, argv, "--batch-output")) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// the images are neither limited nor synchronized to a display,
+	// and the projection of the camera follows the size of the images
+	g_FramePacer->SetTargetFPS(0.0);
+	g_FramePacer->SetVSyncMode(FramePacer::VSYNC_OFF);
+	ViewManager::Framebuffer_Size_Callback(g_Window, width, height);
+
+	for (int i = 0; (i < batch.GetPoseCount()) && !glfwWindowShouldClose(g_Window); i++)
+	{
+		g_FramePacer->BeginFrame();
+		if (NULL != g_FrameProfiler)
+		{
+			g_FrameProfiler->BeginFrame();
+		}
+		AllocationTracker::BeginFrame();
+		PROFILE_SCOPE("Frame");
+
+		glm::vec3 position;
+		glm::vec3 front;
+		batch.BeginImage(i, position, front);
+		g_ViewManager->SetCameraPose(position, front);
+
+		glEnable(GL_DEPTH_TEST);
+		{
+			PROFILE_SCOPE("PrepareSceneView");
+			g_ViewManager->PrepareSceneView();
+		}
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		DrawSceneView(width, height);
+
+		batch.EndImage();
+		GLStats::EndFrame();
+
+		glfwPollEvents();
+	}
+	AllocationTracker::Finish();
+
+	bool bSuccess = batch.Finish();
+	batch.WriteReport(std::cout);
+
+	return(bSuccess ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/***********************************************************
+ *	CookSceneTextures()
+ *
+ *  This function is used to convert every scene texture into
+ *  a block-compressed container with a precomputed mip chain,
+ *  which is loaded instead of the image file when present.
+ *  The page files of the virtual textures are built as well.
+ *  Usage: --cook-textures [bc1|bc3|bc7] [threads]
+ ***********************************************************/
+int CookSceneTextures(int argc, char* argv[])
+{
+	TextureCooker cooker;
+	TextureCooker::COOK_FORMAT format = TextureCooker::COOK_FORMAT_AUTO;
+	bool bSuccess = true;
+
+	if (argc > 2)
+	{
+		if (strcmp(argv[2], "bc1") == 0)
+			format = TextureCooker::COOK_FORMAT_BC1;
+		else if (strcmp(argv[2], "bc3") == 0)
+			format = TextureCooker::COOK_FORMAT_BC3;
+		else if (strcmp(argv[2], "bc7") == 0)
+			format = TextureCooker::COOK_FORMAT_BC7;
+	}
+	if (argc > 3)
+	{
+		cooker.SetThreadCount(atoi(argv[3]));
+	}
+
+	for (int i = 0; i < SceneManager::GetSceneTextureCount(); i++)
+	{
+		const SceneManager::SCENE_TEXTURE& texture = SceneManager::GetSceneTexture(i);
+		std::string cookedFilename = TextureCooker::GetCookedFilename(texture.filename);
+		if (cooker.CookTexture(texture.filename, cookedFilename.c_str(), format) == false)
+		{
+			bSuccess = false;
+		}
+
+		// very large textures also get the page file that they are
+		// streamed from as virtual textures
+		if (texture.bVirtual == true)
+		{
+			std::string pageFilename = VirtualTextureSystem::GetPageFilename(texture.filename);
+			if (VirtualTextureSystem::BuildPageFile(texture.filename, pageFilename.c_str()) == false)
+			{
+				bSuccess = false;
+			}
+		}
+	}
+
+	return(bSuccess ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/***********************************************************
+ *	FindCommandLineOption()
+ *
+ *  This function is used to check whether a command line
+ *  option is present.
+ ***********************************************************/
+bool FindCommandLineOption(int argc, char* argv[], const char* option)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], option) == 0)
+		{
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *	FindCommandLineValue()
+ *
+ *  This function is used to find the value that follows a
+ *  command line option, or NULL when the option is missing.
+ ***********************************************************/
+const char* FindCommandLineValue(int argc, char* argv[], const char* option)
+{
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], option) == 0)
+		{
+			return(argv[i + 1]);
+		}
+	}
+
+	return(NULL);
 }
\ No newline at end of file
@@ -0,0 +1,408 @@
+///////////////////////////////////////////////////////////////////////////////
+// nullrenderbackend.cpp
+// ============
+// record the commands of the scene without drawing them
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "NullRenderBackend.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	const char* g_CommandNames[NullRenderBackend::COMMAND_TYPE_COUNT] =
+	{
+		"create_buffer",
+		"update_buffer",
+		"destroy_buffer",
+		"create_texture",
+		"destroy_texture",
+		"bind_texture",
+		"create_program",
+		"destroy_program",
+		"use_program",
+		"set_uniform",
+		"set_state",
+		"set_depth_function",
+		"draw_shape"
+	};
+}
+
+/***********************************************************
+ *  NullRenderBackend()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+NullRenderBackend::NullRenderBackend()
+{
+	m_nextHandle = 1;
+	m_frameCount = 0;
+	for (int i = 0; i < COMMAND_TYPE_COUNT; i++)
+	{
+		m_commandTotals[i] = 0;
+	}
+	m_peakFrameCommands = 0;
+}
+
+/***********************************************************
+ *  ~NullRenderBackend()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+NullRenderBackend::~NullRenderBackend()
+{
+}
+
+/***********************************************************
+ *  GetCommandCount()
+ *
+ *  This method is used to get the number of commands of the
+ *  last finished frame.
+ ***********************************************************/
+int NullRenderBackend::GetCommandCount() const
+{
+	return((int)m_lastFrameCommands.size());
+}
+
+/***********************************************************
+ *  GetCommand()
+ *
+ *  This method is used to get a command of the last
+ *  finished frame.
+ ***********************************************************/
+const NullRenderBackend::COMMAND& NullRenderBackend::GetCommand(int index) const
+{
+	return(m_lastFrameCommands[index]);
+}
+
+/***********************************************************
+ *  GetFrameCount()
+ *
+ *  This method is used to get the number of frames that
+ *  were finished.
+ ***********************************************************/
+uint64_t NullRenderBackend::GetFrameCount() const
+{
+	return(m_frameCount);
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the average number of every
+ *  kind of command per frame.
+ ***********************************************************/
+void NullRenderBackend::WriteReport(std::ostream& stream)
+{
+	stream << "# commands per frame recorded by the null backend" << std::endl;
+	stream << "frames: " << m_frameCount << std::endl;
+	if (m_frameCount == 0)
+	{
+		return;
+	}
+
+	uint64_t total = 0;
+	for (int i = 0; i < COMMAND_TYPE_COUNT; i++)
+	{
+		stream << g_CommandNames[i] << ": " << (double)m_commandTotals[i] / (double)m_frameCount << std::endl;
+		total += m_commandTotals[i];
+	}
+	stream << "commands: " << (double)total / (double)m_frameCount << std::endl;
+	stream << "peak_commands: " << m_peakFrameCommands << std::endl;
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the report into a file.
+ ***********************************************************/
+bool NullRenderBackend::WriteReport(const char* filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create null backend report file:" << filename << std::endl;
+		return(false);
+	}
+
+	WriteReport(file);
+	if (!file)
+	{
+		std::cout << "Could not write null backend report file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote null backend report file:" << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetName()
+ *
+ *  This method is used to get the name of the backend.
+ ***********************************************************/
+const char* NullRenderBackend::GetName() const
+{
+	return("null");
+}
+
+/***********************************************************
+ *  SupportsOpenGLPasses()
+ *
+ *  This method is used to check whether the passes with
+ *  their own OpenGL framebuffers can run, which they cannot
+ *  without drawing.
+ ***********************************************************/
+bool NullRenderBackend::SupportsOpenGLPasses() const
+{
+	return(false);
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used to record the creation of a buffer.
+ ***********************************************************/
+uint32_t NullRenderBackend::CreateBuffer(BUFFER_TYPE type, const void* pData, size_t size)
+{
+	uint32_t buffer = m_nextHandle++;
+	Record(COMMAND_CREATE_BUFFER, buffer, (int)size);
+	return(buffer);
+}
+
+/***********************************************************
+ *  UpdateBuffer()
+ *
+ *  This method is used to record an update of a buffer.
+ ***********************************************************/
+void NullRenderBackend::UpdateBuffer(uint32_t buffer, size_t offset, const void* pData, size_t size)
+{
+	Record(COMMAND_UPDATE_BUFFER, buffer, (int)size);
+}
+
+/***********************************************************
+ *  DestroyBuffer()
+ *
+ *  This method is used to record the release of a buffer.
+ ***********************************************************/
+void NullRenderBackend::DestroyBuffer(uint32_t buffer)
+{
+	Record(COMMAND_DESTROY_BUFFER, buffer, 0);
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used to record the creation of a texture.
+ ***********************************************************/
+uint32_t NullRenderBackend::CreateTexture(int width, int height, const unsigned char* pPixels, bool bGenerateMips)
+{
+	uint32_t texture = m_nextHandle++;
+	Record(COMMAND_CREATE_TEXTURE, texture, width * height * 4);
+	return(texture);
+}
+
+/***********************************************************
+ *  DestroyTexture()
+ *
+ *  This method is used to record the release of a texture.
+ ***********************************************************/
+void NullRenderBackend::DestroyTexture(uint32_t texture)
+{
+	Record(COMMAND_DESTROY_TEXTURE, texture, 0);
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used to record the binding of a texture
+ *  to a texture unit.
+ ***********************************************************/
+void NullRenderBackend::BindTexture(int unit, uint32_t texture)
+{
+	Record(COMMAND_BIND_TEXTURE, texture, unit);
+}
+
+/***********************************************************
+ *  CreateProgram()
+ *
+ *  This method is used to record the loading of a shader
+ *  program, without reading its files.
+ ***********************************************************/
+uint32_t NullRenderBackend::CreateProgram(const char* vertexShaderPath, const char* fragmentShaderPath)
+{
+	uint32_t program = m_nextHandle++;
+	Record(COMMAND_CREATE_PROGRAM, program, 0);
+	return(program);
+}
+
+/***********************************************************
+ *  DestroyProgram()
+ *
+ *  This method is used to record the release of a program.
+ ***********************************************************/
+void NullRenderBackend::DestroyProgram(uint32_t program)
+{
+	Record(COMMAND_DESTROY_PROGRAM, program, 0);
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used to record the selection of a program.
+ ***********************************************************/
+void NullRenderBackend::UseProgram(uint32_t program)
+{
+	Record(COMMAND_USE_PROGRAM, program, 0);
+}
+
+/***********************************************************
+ *  SetIntValue()
+ *
+ *  This method is used to record an integer uniform.
+ ***********************************************************/
+void NullRenderBackend::SetIntValue(const char* name, int value)
+{
+	COMMAND& command = Record(COMMAND_SET_UNIFORM, 0, value);
+	command.name = name;
+}
+
+/***********************************************************
+ *  SetFloatValue()
+ *
+ *  This method is used to record a float uniform.
+ ***********************************************************/
+void NullRenderBackend::SetFloatValue(const char* name, float value)
+{
+	RecordUniform(name, &value, 1);
+}
+
+/***********************************************************
+ *  SetVec2Value()
+ *
+ *  This method is used to record a vec2 uniform.
+ ***********************************************************/
+void NullRenderBackend::SetVec2Value(const char* name, const glm::vec2& value)
+{
+	RecordUniform(name, &value[0], 2);
+}
+
+/***********************************************************
+ *  SetVec3Value()
+ *
+ *  This method is used to record a vec3 uniform.
+ ***********************************************************/
+void NullRenderBackend::SetVec3Value(const char* name, const glm::vec3& value)
+{
+	RecordUniform(name, &value[0], 3);
+}
+
+/***********************************************************
+ *  SetVec4Value()
+ *
+ *  This method is used to record a vec4 uniform.
+ ***********************************************************/
+void NullRenderBackend::SetVec4Value(const char* name, const glm::vec4& value)
+{
+	RecordUniform(name, &value[0], 4);
+}
+
+/***********************************************************
+ *  SetMat4Value()
+ *
+ *  This method is used to record a mat4 uniform.
+ ***********************************************************/
+void NullRenderBackend::SetMat4Value(const char* name, const glm::mat4& value)
+{
+	RecordUniform(name, &value[0][0], 16);
+}
+
+/***********************************************************
+ *  SetState()
+ *
+ *  This method is used to record a change of a render state.
+ ***********************************************************/
+void NullRenderBackend::SetState(RENDER_STATE state, bool bEnabled)
+{
+	Record(COMMAND_SET_STATE, (uint32_t)state, bEnabled);
+}
+
+/***********************************************************
+ *  SetDepthFunction()
+ *
+ *  This method is used to record a change of the depth test.
+ ***********************************************************/
+void NullRenderBackend::SetDepthFunction(DEPTH_FUNCTION function)
+{
+	Record(COMMAND_SET_DEPTH_FUNCTION, (uint32_t)function, 0);
+}
+
+/***********************************************************
+ *  DrawShape()
+ *
+ *  This method is used to record the draw of a shape mesh.
+ ***********************************************************/
+void NullRenderBackend::DrawShape(SHAPE_MESH shape)
+{
+	Record(COMMAND_DRAW_SHAPE, (uint32_t)shape, 0);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used to add the commands of the frame to
+ *  the totals, and to keep them as the last frame.
+ ***********************************************************/
+void NullRenderBackend::EndFrame()
+{
+	for (size_t i = 0; i < m_commands.size(); i++)
+	{
+		m_commandTotals[m_commands[i].type]++;
+	}
+	if (m_commands.size() > m_peakFrameCommands)
+	{
+		m_peakFrameCommands = m_commands.size();
+	}
+	m_frameCount++;
+
+	m_lastFrameCommands.swap(m_commands);
+	m_commands.clear();
+}
+
+/***********************************************************
+ *  Record()
+ *
+ *  This method is used to append a command to the frame.
+ ***********************************************************/
+NullRenderBackend::COMMAND& NullRenderBackend::Record(COMMAND_TYPE type, uint32_t handle, int value)
+{
+	m_commands.push_back(COMMAND());
+	COMMAND& command = m_commands.back();
+	command.type = type;
+	command.name = NULL;
+	command.handle = handle;
+	command.value = value;
+	command.valueCount = 0;
+
+	return(command);
+}
+
+/***********************************************************
+ *  RecordUniform()
+ *
+ *  This method is used to append a uniform and its values to
+ *  the frame.
+ ***********************************************************/
+void NullRenderBackend::RecordUniform(const char* name, const float* pValues, int valueCount)
+{
+	COMMAND& command = Record(COMMAND_SET_UNIFORM, 0, 0);
+	command.name = name;
+	command.valueCount = valueCount;
+	memcpy(command.values, pValues, valueCount * sizeof(float));
+}
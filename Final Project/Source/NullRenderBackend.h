@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+// nullrenderbackend.h
+// ============
+// record the commands of the scene without drawing them
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+
+#include <ostream>
+#include <vector>
+
+/***********************************************************
+ *  NullRenderBackend
+ *
+ *  This class contains a render backend that records the
+ *  commands of every frame instead of executing them, and
+ *  needs no OpenGL context.  Drawing the scene through it
+ *  measures the CPU cost of the scene alone, and the
+ *  commands of the last frame can be inspected to check
+ *  what the scene submitted.
+ ***********************************************************/
+class NullRenderBackend : public RenderBackend
+{
+public:
+	// constructor
+	NullRenderBackend();
+	// destructor
+	virtual ~NullRenderBackend();
+
+	// kinds of recorded commands
+	enum COMMAND_TYPE
+	{
+		COMMAND_CREATE_BUFFER,
+		COMMAND_UPDATE_BUFFER,
+		COMMAND_DESTROY_BUFFER,
+		COMMAND_CREATE_TEXTURE,
+		COMMAND_DESTROY_TEXTURE,
+		COMMAND_BIND_TEXTURE,
+		COMMAND_CREATE_PROGRAM,
+		COMMAND_DESTROY_PROGRAM,
+		COMMAND_USE_PROGRAM,
+		COMMAND_SET_UNIFORM,
+		COMMAND_SET_STATE,
+		COMMAND_SET_DEPTH_FUNCTION,
+		COMMAND_DRAW_SHAPE,
+		COMMAND_TYPE_COUNT
+	};
+
+	// a recorded command and its arguments
+	struct COMMAND
+	{
+		COMMAND_TYPE type;
+		// uniform name, or NULL
+		const char* name;
+		// buffer, texture or program handle, texture unit, state,
+		// depth function or shape of the command
+		uint32_t handle;
+		int value;
+		// number of the values of a uniform, and the values
+		int valueCount;
+		float values[16];
+	};
+
+	// get the commands of the last finished frame
+	int GetCommandCount() const;
+	const COMMAND& GetCommand(int index) const;
+	// get the number of finished frames
+	uint64_t GetFrameCount() const;
+
+	// write the average commands per frame
+	void WriteReport(std::ostream& stream);
+	bool WriteReport(const char* filename);
+
+	virtual const char* GetName() const;
+	virtual bool SupportsOpenGLPasses() const;
+
+	virtual uint32_t CreateBuffer(BUFFER_TYPE type, const void* pData, size_t size);
+	virtual void UpdateBuffer(uint32_t buffer, size_t offset, const void* pData, size_t size);
+	virtual void DestroyBuffer(uint32_t buffer);
+
+	virtual uint32_t CreateTexture(int width, int height, const unsigned char* pPixels, bool bGenerateMips);
+	virtual void DestroyTexture(uint32_t texture);
+	virtual void BindTexture(int unit, uint32_t texture);
+
+	virtual uint32_t CreateProgram(const char* vertexShaderPath, const char* fragmentShaderPath);
+	virtual void DestroyProgram(uint32_t program);
+	virtual void UseProgram(uint32_t program);
+
+	virtual void SetIntValue(const char* name, int value);
+	virtual void SetFloatValue(const char* name, float value);
+	virtual void SetVec2Value(const char* name, const glm::vec2& value);
+	virtual void SetVec3Value(const char* name, const glm::vec3& value);
+	virtual void SetVec4Value(const char* name, const glm::vec4& value);
+	virtual void SetMat4Value(const char* name, const glm::mat4& value);
+
+	virtual void SetState(RENDER_STATE state, bool bEnabled);
+	virtual void SetDepthFunction(DEPTH_FUNCTION function);
+
+	virtual void DrawShape(SHAPE_MESH shape);
+
+	virtual void EndFrame();
+
+private:
+	// commands of the current and of the last finished frame,
+	// which keep their memory from frame to frame
+	std::vector<COMMAND> m_commands;
+	std::vector<COMMAND> m_lastFrameCommands;
+	// handle of the next created resource
+	uint32_t m_nextHandle;
+
+	// totals of the finished frames
+	uint64_t m_frameCount;
+	uint64_t m_commandTotals[COMMAND_TYPE_COUNT];
+	size_t m_peakFrameCommands;
+
+	// record a command without values
+	COMMAND& Record(COMMAND_TYPE type, uint32_t handle, int value);
+	// record a uniform with its values
+	void RecordUniform(const char* name, const float* pValues, int valueCount);
+};
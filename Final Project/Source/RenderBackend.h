@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderbackend.h
+// ============
+// interface between the scene and the API that draws it
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************
+ *  RenderBackend
+ *
+ *  This class is the interface that the scene submits its
+ *  frames through.  It covers the buffers, textures, shader
+ *  programs, uniforms, draws and render state that the scene
+ *  uses, so the scene can be drawn with OpenGL, or recorded
+ *  by the null backend to measure the CPU cost of the scene
+ *  without the cost of a driver.  Handles of 0 are invalid,
+ *  and uniform names are expected to be string constants
+ *  that outlive the frame.
+ ***********************************************************/
+class RenderBackend
+{
+public:
+	// destructor
+	virtual ~RenderBackend() {}
+
+	// kinds of buffers that can be created
+	enum BUFFER_TYPE
+	{
+		BUFFER_VERTEX,
+		BUFFER_INDEX,
+		BUFFER_UNIFORM
+	};
+
+	// render states that can be turned on or off
+	enum RENDER_STATE
+	{
+		STATE_DEPTH_TEST,
+		STATE_DEPTH_WRITE,
+		STATE_COLOR_WRITE,
+		STATE_BLEND
+	};
+
+	// comparisons of the depth test
+	enum DEPTH_FUNCTION
+	{
+		DEPTH_LESS,
+		DEPTH_LESS_EQUAL,
+		DEPTH_EQUAL
+	};
+
+	// basic shape meshes that the scene is built from
+	enum SHAPE_MESH
+	{
+		SHAPE_BOX,
+		SHAPE_CONE,
+		SHAPE_CYLINDER,
+		SHAPE_PLANE,
+		SHAPE_PRISM,
+		SHAPE_SPHERE,
+		SHAPE_TAPERED_CYLINDER,
+		SHAPE_TORUS,
+		SHAPE_COUNT
+	};
+
+	// get the name of the backend for the reports
+	virtual const char* GetName() const = 0;
+	// check whether the passes that render with their own OpenGL
+	// framebuffers and programs can run with this backend
+	virtual bool SupportsOpenGLPasses() const = 0;
+
+	// create, update and free a buffer
+	virtual uint32_t CreateBuffer(BUFFER_TYPE type, const void* pData, size_t size) = 0;
+	virtual void UpdateBuffer(uint32_t buffer, size_t offset, const void* pData, size_t size) = 0;
+	virtual void DestroyBuffer(uint32_t buffer) = 0;
+
+	// create and free an RGBA texture, and bind it to a texture unit
+	virtual uint32_t CreateTexture(int width, int height, const unsigned char* pPixels, bool bGenerateMips) = 0;
+	virtual void DestroyTexture(uint32_t texture) = 0;
+	virtual void BindTexture(int unit, uint32_t texture) = 0;
+
+	// load a shader program, and select it for the next draws
+	virtual uint32_t CreateProgram(const char* vertexShaderPath, const char* fragmentShaderPath) = 0;
+	virtual void DestroyProgram(uint32_t program) = 0;
+	virtual void UseProgram(uint32_t program) = 0;
+
+	// set a uniform of the program in use
+	virtual void SetIntValue(const char* name, int value) = 0;
+	virtual void SetFloatValue(const char* name, float value) = 0;
+	virtual void SetVec2Value(const char* name, const glm::vec2& value) = 0;
+	virtual void SetVec3Value(const char* name, const glm::vec3& value) = 0;
+	virtual void SetVec4Value(const char* name, const glm::vec4& value) = 0;
+	virtual void SetMat4Value(const char* name, const glm::mat4& value) = 0;
+
+	// change the render state
+	virtual void SetState(RENDER_STATE state, bool bEnabled) = 0;
+	virtual void SetDepthFunction(DEPTH_FUNCTION function) = 0;
+
+	// draw a shape mesh with the current program and state
+	virtual void DrawShape(SHAPE_MESH shape) = 0;
+
+	// mark the end of the commands of a frame
+	virtual void EndFrame() = 0;
+};
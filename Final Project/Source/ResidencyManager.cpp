@@ -0,0 +1,296 @@
+///////////////////////////////////////////////////////////////////////////////
+// residencymanager.cpp
+// ============
+// track the GPU memory used by scene resources against a budget
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ResidencyManager.h"
+
+#include <algorithm>
+
+/***********************************************************
+ *  ResidencyManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ResidencyManager::ResidencyManager(size_t budgetBytes)
+{
+	m_budgetBytes = budgetBytes;
+	m_residentBytes = 0;
+	m_frame = 0;
+	m_maxEvictions = 0;
+}
+
+/***********************************************************
+ *  ~ResidencyManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ResidencyManager::~ResidencyManager()
+{
+	m_resources.clear();
+}
+
+/***********************************************************
+ *  SetBudget()
+ *
+ *  This method is used to set the memory budget in bytes.
+ ***********************************************************/
+void ResidencyManager::SetBudget(size_t budgetBytes)
+{
+	m_budgetBytes = budgetBytes;
+}
+
+/***********************************************************
+ *  GetBudget()
+ *
+ *  This method is used to get the memory budget in bytes.
+ ***********************************************************/
+size_t ResidencyManager::GetBudget() const
+{
+	return(m_budgetBytes);
+}
+
+/***********************************************************
+ *  GetResidentBytes()
+ *
+ *  This method is used to get the memory that is currently
+ *  used by all of the resident resources.
+ ***********************************************************/
+size_t ResidencyManager::GetResidentBytes() const
+{
+	return(m_residentBytes);
+}
+
+/***********************************************************
+ *  Register()
+ *
+ *  This method is used to add a resource to the accounting
+ *  at its full size.  Resources that cannot be recreated
+ *  from their source are registered as not evictable.
+ ***********************************************************/
+int ResidencyManager::Register(
+	std::string tag,
+	size_t fullBytes,
+	int maxDroppedMips,
+	bool bEvictable)
+{
+	RESIDENT_RESOURCE resource;
+	resource.tag = tag;
+	resource.fullBytes = fullBytes;
+	resource.residentBytes = fullBytes;
+	resource.droppedMips = 0;
+	resource.maxDroppedMips = maxDroppedMips;
+	resource.bResident = true;
+	resource.bEvictable = bEvictable;
+	resource.lastUsedFrame = m_frame;
+
+	m_resources.push_back(resource);
+	m_residentBytes += fullBytes;
+
+	// a resource is either shrunk by each of its mip levels or
+	// unloaded once, so the lists of the evictions are sized here
+	m_maxEvictions += (size_t)std::max(maxDroppedMips, 1);
+	m_candidates.reserve(m_resources.size());
+
+	return((int)m_resources.size() - 1);
+}
+
+/***********************************************************
+ *  Unregister()
+ *
+ *  This method is used to remove a freed resource from the
+ *  accounting.  The handle stays reserved.
+ ***********************************************************/
+void ResidencyManager::Unregister(int handle)
+{
+	if ((handle < 0) || (handle >= (int)m_resources.size()))
+	{
+		return;
+	}
+
+	RESIDENT_RESOURCE& resource = m_resources[handle];
+	if (resource.bResident == true)
+	{
+		m_residentBytes -= resource.residentBytes;
+	}
+	resource.residentBytes = 0;
+	resource.bResident = false;
+	resource.bEvictable = false;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used to advance the frame counter that
+ *  the last-used frames are recorded against.
+ ***********************************************************/
+void ResidencyManager::BeginFrame()
+{
+	m_frame++;
+}
+
+/***********************************************************
+ *  GetFrame()
+ *
+ *  This method is used to get the current frame number.
+ ***********************************************************/
+uint64_t ResidencyManager::GetFrame() const
+{
+	return(m_frame);
+}
+
+/***********************************************************
+ *  Touch()
+ *
+ *  This method is used to mark a resource as used in the
+ *  current frame.
+ ***********************************************************/
+void ResidencyManager::Touch(int handle)
+{
+	if ((handle >= 0) && (handle < (int)m_resources.size()))
+	{
+		m_resources[handle].lastUsedFrame = m_frame;
+	}
+}
+
+/***********************************************************
+ *  UpdateResource()
+ *
+ *  This method is used to report the new size and state of
+ *  a resource after it was shrunk, unloaded or restored.
+ ***********************************************************/
+void ResidencyManager::UpdateResource(int handle, size_t residentBytes, int droppedMips, bool bResident)
+{
+	if ((handle < 0) || (handle >= (int)m_resources.size()))
+	{
+		return;
+	}
+
+	RESIDENT_RESOURCE& resource = m_resources[handle];
+	if (resource.bResident == true)
+	{
+		m_residentBytes -= resource.residentBytes;
+	}
+
+	resource.residentBytes = (bResident == true) ? residentBytes : 0;
+	resource.droppedMips = droppedMips;
+	resource.bResident = bResident;
+
+	if (resource.bResident == true)
+	{
+		m_residentBytes += resource.residentBytes;
+	}
+}
+
+/***********************************************************
+ *  CanRestore()
+ *
+ *  This method is used to check whether a resource that was
+ *  shrunk or unloaded can be brought back at its full size
+ *  without exceeding the budget.
+ ***********************************************************/
+bool ResidencyManager::CanRestore(int handle) const
+{
+	if ((handle < 0) || (handle >= (int)m_resources.size()))
+	{
+		return(false);
+	}
+
+	const RESIDENT_RESOURCE& resource = m_resources[handle];
+	size_t currentBytes = (resource.bResident == true) ? resource.residentBytes : 0;
+
+	return(m_residentBytes - currentBytes + resource.fullBytes <= m_budgetBytes);
+}
+
+/***********************************************************
+ *  CollectEvictions()
+ *
+ *  This method is used to pick the evictions that bring the
+ *  memory usage back within the budget.  The least recently
+ *  used resources are shrunk one mip level at a time first,
+ *  and unloaded once they cannot be shrunk any further.
+ *  Resources used in the current frame are never evicted.
+ *  The list is sized for every registered resource, so it
+ *  only grows after new resources were registered.
+ ***********************************************************/
+void ResidencyManager::CollectEvictions(std::vector<EVICTION>& evictions)
+{
+	evictions.clear();
+	evictions.reserve(m_maxEvictions);
+	if (m_residentBytes <= m_budgetBytes)
+	{
+		return;
+	}
+
+	// order the evictable resources from least to most recently
+	// used, and by handle when they were used in the same frame,
+	// which keeps the order of a stable sort without its buffer
+	std::vector<int>& candidates = m_candidates;
+	candidates.clear();
+	for (size_t i = 0; i < m_resources.size(); i++)
+	{
+		const RESIDENT_RESOURCE& resource = m_resources[i];
+		if ((resource.bResident == true) &&
+			(resource.bEvictable == true) &&
+			(resource.lastUsedFrame < m_frame))
+		{
+			candidates.push_back((int)i);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(),
+		[this](int a, int b)
+		{
+			uint64_t frameA = m_resources[a].lastUsedFrame;
+			uint64_t frameB = m_resources[b].lastUsedFrame;
+			return((frameA != frameB) ? (frameA < frameB) : (a < b));
+		});
+
+	// dropping a mip level releases about three quarters of the memory
+	size_t projectedBytes = m_residentBytes;
+	for (size_t i = 0; (i < candidates.size()) && (projectedBytes > m_budgetBytes); i++)
+	{
+		const RESIDENT_RESOURCE& resource = m_resources[candidates[i]];
+		size_t firstEviction = evictions.size();
+		size_t startBytes = projectedBytes;
+		size_t bytes = resource.residentBytes;
+		int droppedMips = resource.droppedMips;
+
+		while ((droppedMips < resource.maxDroppedMips) && (projectedBytes > m_budgetBytes))
+		{
+			EVICTION eviction;
+			eviction.handle = candidates[i];
+			eviction.action = EVICT_DROP_MIP;
+			evictions.push_back(eviction);
+
+			projectedBytes -= bytes - (bytes / 4);
+			bytes = bytes / 4;
+			droppedMips++;
+		}
+
+		// when shrinking is not enough, unload the resource instead
+		if (projectedBytes > m_budgetBytes)
+		{
+			evictions.resize(firstEviction);
+
+			EVICTION eviction;
+			eviction.handle = candidates[i];
+			eviction.action = EVICT_UNLOAD;
+			evictions.push_back(eviction);
+
+			projectedBytes = startBytes - resource.residentBytes;
+		}
+	}
+}
+
+/***********************************************************
+ *  GetResource()
+ *
+ *  This method is used to get the accounting of a resource.
+ ***********************************************************/
+const ResidencyManager::RESIDENT_RESOURCE& ResidencyManager::GetResource(int handle) const
+{
+	return(m_resources[handle]);
+}
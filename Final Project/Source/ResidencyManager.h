@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////////////////////
+// residencymanager.h
+// ============
+// track the GPU memory used by scene resources against a budget
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************
+ *  ResidencyManager
+ *
+ *  This class contains the bookkeeping for keeping the GPU
+ *  resources of a scene within a fixed memory budget.  It
+ *  accounts the size of every registered resource, records
+ *  the frame each one was last used, and picks the least
+ *  recently used resources to shrink or unload whenever the
+ *  budget is exceeded.  The owner of the resources performs
+ *  the actual OpenGL work and reports the new sizes back.
+ ***********************************************************/
+class ResidencyManager
+{
+public:
+	// constructor
+	ResidencyManager(size_t budgetBytes);
+	// destructor
+	~ResidencyManager();
+
+	enum EVICTION_ACTION
+	{
+		EVICT_DROP_MIP,		// release the most detailed mip level
+		EVICT_UNLOAD		// release the whole resource
+	};
+
+	struct RESIDENT_RESOURCE
+	{
+		std::string tag;
+		size_t fullBytes;
+		size_t residentBytes;
+		int droppedMips;
+		int maxDroppedMips;
+		bool bResident;
+		bool bEvictable;
+		uint64_t lastUsedFrame;
+	};
+
+	struct EVICTION
+	{
+		int handle;
+		EVICTION_ACTION action;
+	};
+
+	// set and get the memory budget in bytes
+	void SetBudget(size_t budgetBytes);
+	size_t GetBudget() const;
+	// get the memory currently used by the resident resources
+	size_t GetResidentBytes() const;
+
+	// register a resource at its full size and get its handle
+	int Register(
+		std::string tag,
+		size_t fullBytes,
+		int maxDroppedMips,
+		bool bEvictable);
+	// remove a resource from the accounting
+	void Unregister(int handle);
+
+	// advance the frame counter used for the LRU tracking
+	void BeginFrame();
+	uint64_t GetFrame() const;
+
+	// mark a resource as used in the current frame
+	void Touch(int handle);
+
+	// report the new state of a resource after it changed
+	void UpdateResource(int handle, size_t residentBytes, int droppedMips, bool bResident);
+
+	// check whether a shrunk or unloaded resource fits back in full
+	bool CanRestore(int handle) const;
+
+	// pick the evictions that bring the usage within the budget
+	void CollectEvictions(std::vector<EVICTION>& evictions);
+
+	// get the accounting of a registered resource
+	const RESIDENT_RESOURCE& GetResource(int handle) const;
+
+private:
+	// memory budget in bytes
+	size_t m_budgetBytes;
+	// memory used by the resident resources in bytes
+	size_t m_residentBytes;
+	// number of the current frame
+	uint64_t m_frame;
+	// registered resources, indexed by handle
+	std::vector<RESIDENT_RESOURCE> m_resources;
+	// most evictions that the registered resources can need
+	size_t m_maxEvictions;
+	// resources that can be evicted, kept to reuse their memory
+	std::vector<int> m_candidates;
+};
@@ -1,1078 +1,2741 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.cpp
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables
-namespace
-{
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager *pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
-	for (int i = 0; i < 16; i++)
-	{
-		m_textureIDs[i].tag = "/0";
-		m_textureIDs[i].ID = -1;
-	}
-	m_loadedTextures = 0;
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	// free the allocated objects
-	m_pShaderManager = NULL;
-	if (NULL != m_basicMeshes)
-	{
-		delete m_basicMeshes;
-		m_basicMeshes = NULL;
-	}
-
-	// free the allocated OpenGL textures
-	DestroyGLTextures();
-}
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
-}
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationX * rotationY * rotationZ * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
-}
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
-}
-
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
-/***********************************************************
- *  LoadSceneTextures()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
- ***********************************************************/
-void SceneManager::LoadSceneTextures()
-{
-	bool bReturn = false;
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/bluefur.jpg",
-		"fur");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/blackplastic.jpg",
-		"black");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/glass.jpg",
-		"glass");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/drywall.jpg",
-		"wall");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/keyboard.jpg",
-		"keyboard");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/screen.jpg",
-		"screen");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/book.jpg",
-		"book");
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/pages.jpg",
-		"pages");
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/headphones.jpg",
-		"headphones");
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/room.jpg",
-		"floor");
-	// after the texture image data is loaded into memory, the
-	// loaded textures need to be bound to texture slots - there
-	// are a total of 16 available slots for scene textures
-	BindGLTextures();
-}
-/***********************************************************
- *  DefineObjectMaterials()
- *
- *  This method is used for configuring the various material
- *  settings for all of the objects within the 3D scene.
- ***********************************************************/
-void SceneManager::DefineObjectMaterials()
-
-{
-	OBJECT_MATERIAL furmaterial;
-	furmaterial.ambientColor = glm::vec3(.1f, .1f, .1f);
-	furmaterial.ambientStrength = 0.3f;
-	furmaterial.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	furmaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	furmaterial.shininess = 0.2;
-	furmaterial.tag = "fur";
-
-	m_objectMaterials.push_back(furmaterial);
-
-	OBJECT_MATERIAL wallmaterial;
-	wallmaterial.ambientColor = glm::vec3(.01f, .01f, .01f);
-	wallmaterial.ambientStrength = 0.1f;
-	wallmaterial.diffuseColor = glm::vec3(0.0f, 0.0f, 0.0f);
-	wallmaterial.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
-	wallmaterial.shininess = 0.1;
-	wallmaterial.tag = "wall";
-
-	m_objectMaterials.push_back(furmaterial);
-}
-/***********************************************************
- *  SetupSceneLights()
- *
- *  This method is called to add and configure the light
- *  sources for the 3D scene.  There are up to 4 light sources.
- ***********************************************************/
-void SceneManager::SetupSceneLights()
-{
-	// this line of code is NEEDED for telling the shaders to render 
-	// the 3D scene with custom lighting - to use the default rendered 
-	// lighting then comment out the following line
-
-	m_pShaderManager->setVec3Value("lightSources[0].position", 0.0f, 3.0f, 20.0f);
-	m_pShaderManager->setVec3Value("lightSources[0].ambientColor", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setVec3Value("lightSources[0].diffuseColor", 0.2f, 0.2f, 0.2f);
-	m_pShaderManager->setVec3Value("lightSources[0].specularColor", 0.0f, 0.0f, 0.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].focalStrength", 12.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].specularIntensity", 0.2f);
-
-	m_pShaderManager->setVec3Value("lightSources[1].position", -3.0f, 4.0f, 6.0f);
-	m_pShaderManager->setVec3Value("lightSources[1].ambientColor", 0.01f, 0.01f, 0.01f);
-	m_pShaderManager->setVec3Value("lightSources[1].diffuseColor", 0.5f, 0.5f, 0.5f);
-	m_pShaderManager->setVec3Value("lightSources[1].specularColor", 0.2f, 0.2f, 0.2f);
-	m_pShaderManager->setFloatValue("lightSources[1].focalStrength", 32.0f);
-	m_pShaderManager->setFloatValue("lightSources[1].specularIntensity", 0.2f);
-}
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-	LoadSceneTextures();
-	DefineObjectMaterials();
-	SetupSceneLights();
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadBoxMesh();
-	m_basicMeshes->LoadPrismMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadTaperedCylinderMesh();
-	m_basicMeshes->LoadConeMesh();
-	m_basicMeshes->LoadSphereMesh();
-	m_basicMeshes->LoadTorusMesh();
-}
-
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-void SceneManager::RenderScene()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(15.0f, .5f, 15.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, -2.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("glass");
-	SetShaderMaterial("wall");
-	SetTextureUVScale(1, 1);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-		/****************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(50.0f, 1.0f, 50.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 15.0f, -20.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("wall");
-	SetShaderMaterial("wall");
-	SetTextureUVScale(1, 1);
-	m_basicMeshes->DrawPlaneMesh();
-	/****************************************************************/
-	//This is for the floor
-// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(50.0f, 1.0f, 50.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, -27.5f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("floor");
-	SetTextureUVScale(1, 1);
-	SetShaderMaterial("wall");
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	RenderDolphin();
-	RenderLaptop();
-	RenderBook();
-	RenderHeadPhones();
-	/****************************************************************/
-		/****************************************************************/
-}
-void SceneManager::RenderDolphin() 
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	// This cyclinder is going to be the main body of the dolphin.
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.0f, 5.0f, 2.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 45.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(7.0f, 1.0f, 7.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// set the texture values 
-	SetShaderTexture("fur");
-	SetTextureUVScale(1, 1);
-	SetShaderMaterial("fur");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-
-	/****************************************************************/
-	// This tapered cyclinder is going to be the end of the dolphin
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.0f, 4.0f, 2.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 45.0f;
-	ZrotationDegrees = 270.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(7.0f, 1.0f, 7.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// set the texture values 
-	SetShaderTexture("fur");
-	SetTextureUVScale(1, 1);
-	SetShaderMaterial("fur");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTaperedCylinderMesh();
-
-	/****************************************************************/
-	// This Sphere is for the head of the dolphin
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.0f, 2.0f, 2.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(3.0f, 1.0f, 11.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// set the texture values 
-	SetShaderTexture("fur");
-	SetTextureUVScale(1, 1);
-	SetShaderMaterial("fur");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-
-	/****************************************************************/
-	// This Cone is going to be the snout of the dolphin
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.0f, 2.0f, 1.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 45.0f;
-	ZrotationDegrees = 100.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.f, 0.5f, 12.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// set the texture values 
-	SetShaderTexture("fur");
-	SetTextureUVScale(1, 1);
-	SetShaderMaterial("fur");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawConeMesh();
-
-	/****************************************************************/
-	// This Sphere is going to round out the tail area of the dolphin
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.9f, 0.9f, 0.9f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(9.95f, 1.05f, 4.25f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// set the texture values 
-	SetShaderTexture("fur");
-	SetTextureUVScale(1, 1);
-	SetShaderMaterial("fur");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-
-	/****************************************************************/
-	// This Prism is going to be the top fin of the dolphin
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.0f, .25f, 1.5f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = -90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 45.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(5.0f, 3.5f, 9.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// set the texture values 
-	SetShaderTexture("fur");
-	SetTextureUVScale(1, 1);
-	SetShaderMaterial("fur");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-
-	/****************************************************************/
-	// This Prism is going to be the left fin of the dolphin
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.0f, 0.5f, 2.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 15.0f;
-	YrotationDegrees = 25.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(6.0f, 0.0f, 11.5f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// set the texture values 
-	SetShaderTexture("fur");
-	SetTextureUVScale(1, 1);
-	SetShaderMaterial("fur");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-
-	/****************************************************************/
-	// This Prism is going to be the tail fins of the dolphin
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.0f, .5f, 2.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 10.0f;
-	YrotationDegrees = -45.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(10.8f, 1.0f, 4.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// set the texture values 
-	SetShaderTexture("fur");
-	SetShaderMaterial("fur");
-	SetTextureUVScale(1, 1);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-
-	/****************************************************************/
-	// This Sphere is going to be the left eye of the dolphin
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(.25f, .45f, .25f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(3.25f, 1.60f, 13.15f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// set the texture values 
-	SetShaderTexture("black");
-	SetShaderMaterial("fur");
-	SetTextureUVScale(1, 1);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-	/****************************************************************/
-	// This Sphere is going to be the left eye of the dolphin
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(.25f, .45f, .25f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(1.25f, 1.60f, 11.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// set the texture values 
-	SetShaderTexture("black");
-	SetShaderMaterial("fur");
-	SetTextureUVScale(1, 1);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-}
-
-void SceneManager::RenderLaptop() 
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/****************************************************************/
-	// This Cube is going to be the bottom part of the laptop
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(10.25f, .2f, 8.25f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 5.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-.5f, 0.0f, 4.0f);
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture("keyboard");
-	SetTextureUVScale(1, 1);
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-	// This box is for the screen
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(10.25f, .2f, 8.25f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-.5f, 3.0f, -.5f);
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture("screen");
-	SetTextureUVScale(1, 1);
-	m_basicMeshes->DrawBoxMesh();
-}	
-
-void SceneManager::RenderBook()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/****************************************************************/
-	// This box is for the book
-	scaleXYZ = glm::vec3(7.0f, 1.5f, 5.0f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = -20.0f;
-	ZrotationDegrees = 0.0f;
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-5.5f, 0.0f, 9.75f);
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture("book");
-	SetTextureUVScale(1, 1);
-	m_basicMeshes->DrawBoxMesh();
-	/****************************************************************/
-	// This box is for the pages
-	scaleXYZ = glm::vec3(6.8f, 1.3f, 4.8f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = -20.0f;
-	ZrotationDegrees = 0.0f;
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-5.375f, 0.0f, 9.75f);
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture("pages");
-	SetTextureUVScale(1, 1);
-	m_basicMeshes->DrawBoxMesh();
-}
-
-void SceneManager::RenderHeadPhones() 
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-	/****************************************************************/
-	// This torus is for the top part of the headphones
-	scaleXYZ = glm::vec3(2.5f, 2.5f, 1.5f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-5.375f, 1.0f, 9.75f);
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture("black");
-	SetTextureUVScale(1, 1);
-	m_basicMeshes->DrawTorusMesh();
-	/****************************************************************/
-	// This tapered cylinder is for the right part of the headphones
-	scaleXYZ = glm::vec3(1.65f, .75f, 1.65f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-3.75f, .8f, 11.5f);
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture("headphones");
-	SetTextureUVScale(1, 1);
-	m_basicMeshes->DrawTaperedCylinderMesh();
-	/****************************************************************/
-	// This tapered cylinder is for the left part of the headphones
-	scaleXYZ = glm::vec3(1.65f, .75f, 1.65f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-3.0f, .8f, 9.75f);
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderTexture("headphones");
-	SetTextureUVScale(1, 1);
-	m_basicMeshes->DrawTaperedCylinderMesh();
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.cpp
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneManager.h"
+#include "TextureCooker.h"
+#include "ResidencyManager.h"
+#include "FrameProfiler.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	const char* g_ModelName = "model";
+	const char* g_ColorValueName = "objectColor";
+	const char* g_TextureValueName = "objectTexture";
+	const char* g_UseTextureName = "bUseTexture";
+	const char* g_UseLightingName = "bUseLighting";
+	const char* g_UVScaleName = "UVscale";
+	const char* g_UVOffsetName = "UVoffset";
+	const char* g_UseVirtualTextureName = "bUseVirtualTexture";
+	const char* g_VirtualFeedbackName = "bVirtualFeedback";
+	const char* g_VirtualLodBiasName = "vtLodBias";
+
+	// the last two texture units are reserved for virtual texturing
+	const int g_VirtualPageTableUnit = 14;
+	const int g_VirtualPageCacheUnit = 15;
+	// the two units before them hold the shadow maps
+	const int g_ShadowMapFirstUnit = 12;
+
+	// the image files used by the 3D scene and their tags
+	const SceneManager::SCENE_TEXTURE g_SceneTextures[] =
+	{
+		{ "../../Utilities/textures/bluefur.jpg", "fur", false },
+		{ "../../Utilities/textures/blackplastic.jpg", "black", false },
+		{ "../../Utilities/textures/glass.jpg", "glass", false },
+		{ "../../Utilities/textures/drywall.jpg", "wall", true },
+		{ "../../Utilities/textures/keyboard.jpg", "keyboard", false },
+		{ "../../Utilities/textures/screen.jpg", "screen", false },
+		{ "../../Utilities/textures/book.jpg", "book", false },
+		{ "../../Utilities/textures/pages.jpg", "pages", false },
+		{ "../../Utilities/textures/headphones.jpg", "headphones", false },
+		{ "../../Utilities/textures/room.jpg", "floor", true }
+	};
+
+	// the backends without virtual texturing sample a copy of the
+	// whole image, which is shrunk to at most this size
+	const int g_BackendVirtualTextureSize = 2048;
+
+	// names of the members of the lightSources uniforms, which the
+	// backends need as string constants
+	const char* g_LightUniformNames[ClusteredLighting::UNIFORM_LIGHT_COUNT][7] =
+	{
+		{ "lightSources[0].position", "lightSources[0].radius", "lightSources[0].ambientColor", "lightSources[0].diffuseColor",
+		  "lightSources[0].specularColor", "lightSources[0].focalStrength", "lightSources[0].specularIntensity" },
+		{ "lightSources[1].position", "lightSources[1].radius", "lightSources[1].ambientColor", "lightSources[1].diffuseColor",
+		  "lightSources[1].specularColor", "lightSources[1].focalStrength", "lightSources[1].specularIntensity" },
+		{ "lightSources[2].position", "lightSources[2].radius", "lightSources[2].ambientColor", "lightSources[2].diffuseColor",
+		  "lightSources[2].specularColor", "lightSources[2].focalStrength", "lightSources[2].specularIntensity" },
+		{ "lightSources[3].position", "lightSources[3].radius", "lightSources[3].ambientColor", "lightSources[3].diffuseColor",
+		  "lightSources[3].specularColor", "lightSources[3].focalStrength", "lightSources[3].specularIntensity" }
+	};
+
+	// default GPU memory budget for the scene textures
+	const size_t g_DefaultTextureBudget = 256 * 1024 * 1024;
+	// textures are never shrunk below this size by the budget
+	const int g_MinResidentTextureSize = 64;
+	// textures decoded and uploaded again per frame when they
+	// are used after being shrunk or unloaded
+	const int g_MaxTextureRestoresPerFrame = 1;
+	// starting size of the blocks that the transient data of a
+	// frame is allocated from, which grow to the largest frame
+	const size_t g_FrameArenaBytes = 256 * 1024;
+
+	// a recorded draw in the order that it is drawn in
+	struct DRAW_SORT_KEY
+	{
+		bool bTransparent;
+		// distance in front of the camera, negated for the
+		// transparent draws so that all of the keys sort up
+		float depth;
+		// index of the draw in the order it was recorded
+		uint32_t index;
+	};
+
+	/***********************************************************
+	 *  HasTranslucentPixels()
+	 *
+	 *  Check whether an image has pixels that are not fully
+	 *  opaque, which need blending when they are drawn.
+	 ***********************************************************/
+	bool HasTranslucentPixels(const unsigned char* pixels, int width, int height, int colorChannels)
+	{
+		if (colorChannels != 4)
+		{
+			return(false);
+		}
+
+		size_t pixelCount = (size_t)width * height;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			if (pixels[i * 4 + 3] < 255)
+			{
+				return(true);
+			}
+		}
+
+		return(false);
+	}
+
+	/***********************************************************
+	 *  CompareDrawOrder()
+	 *
+	 *  Order the opaque draws front to back, so that the depth
+	 *  test rejects the hidden fragments early, followed by the
+	 *  transparent draws back to front, so that they blend over
+	 *  what is behind them.  The draws at the same distance keep
+	 *  the order they were recorded in.
+	 ***********************************************************/
+	bool CompareDrawOrder(const DRAW_SORT_KEY& first, const DRAW_SORT_KEY& second)
+	{
+		if (first.bTransparent != second.bTransparent)
+		{
+			return(second.bTransparent);
+		}
+		if (first.depth != second.depth)
+		{
+			return(first.depth < second.depth);
+		}
+
+		return(first.index < second.index);
+	}
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(ShaderManager *pShaderManager)
+{
+	m_pShaderManager = pShaderManager;
+	m_basicMeshes = new ShapeMeshes();
+	m_pGLBackend = new GLRenderBackend(pShaderManager, m_basicMeshes);
+	m_pBackend = m_pGLBackend;
+	m_backendVirtualFirstSlot = -1;
+	for (int i = 0; i < 16; i++)
+	{
+		m_textureIDs[i].tag = "/0";
+		m_textureIDs[i].ID = -1;
+		m_textureIDs[i].residencyHandle = -1;
+		m_textureIDs[i].bTranslucent = false;
+		m_textureIDs[i].bRestoreQueued = false;
+	}
+	m_loadedTextures = 0;
+	m_restoreCount = 0;
+	m_pResidencyManager = new ResidencyManager(g_DefaultTextureBudget);
+	m_pVirtualTextures = new VirtualTextureSystem(g_VirtualPageTableUnit, g_VirtualPageCacheUnit);
+	m_pTextureAtlas = new TextureAtlas();
+	m_pLighting = new ClusteredLighting(pShaderManager);
+	m_pShadowMaps = new ShadowMaps(pShaderManager, g_ShadowMapFirstUnit);
+	m_pFrameArena = new FrameArena(g_FrameArenaBytes);
+	m_bUseLighting = false;
+	m_pDepthPrepass = NULL;
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
+	m_atlasFirstSlot = -1;
+	m_pCurrentTile = NULL;
+	m_textureUVScale = glm::vec2(1.0f, 1.0f);
+
+	m_currentDraw.mesh = MESH_BOX;
+	m_currentDraw.model = glm::mat4(1.0f);
+	m_currentDraw.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+	m_currentDraw.bUseTexture = false;
+	m_currentDraw.textureSlot = 0;
+	m_currentDraw.virtualTexture = -1;
+	m_currentDraw.uvScale = glm::vec2(1.0f, 1.0f);
+	m_currentDraw.uvOffset = glm::vec2(0.0f, 0.0f);
+	m_currentDraw.material = -1;
+	m_currentDraw.bDynamic = false;
+	m_currentDraw.bTransparent = false;
+	m_currentDraw.viewDepth = 0.0f;
+	m_bCurrentTextureTranslucent = false;
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	// free the allocated objects
+	m_pShaderManager = NULL;
+	m_pBackend = NULL;
+	if (NULL != m_pGLBackend)
+	{
+		delete m_pGLBackend;
+		m_pGLBackend = NULL;
+	}
+	if (NULL != m_basicMeshes)
+	{
+		delete m_basicMeshes;
+		m_basicMeshes = NULL;
+	}
+	m_pCurrentTile = NULL;
+	m_pDepthPrepass = NULL;
+	if (NULL != m_pTextureAtlas)
+	{
+		delete m_pTextureAtlas;
+		m_pTextureAtlas = NULL;
+	}
+
+	if (NULL != m_pVirtualTextures)
+	{
+		delete m_pVirtualTextures;
+		m_pVirtualTextures = NULL;
+	}
+
+	if (NULL != m_pLighting)
+	{
+		delete m_pLighting;
+		m_pLighting = NULL;
+	}
+
+	if (NULL != m_pShadowMaps)
+	{
+		delete m_pShadowMaps;
+		m_pShadowMaps = NULL;
+	}
+
+	// free the allocated OpenGL textures
+	DestroyGLTextures();
+
+	if (NULL != m_pResidencyManager)
+	{
+		delete m_pResidencyManager;
+		m_pResidencyManager = NULL;
+	}
+
+	// let go of the draw list before the arena that holds it
+	if (NULL != m_pFrameArena)
+	{
+		FrameVector<DRAW_ITEM>().swap(m_drawList);
+		delete m_pFrameArena;
+		m_pFrameArena = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateGLTexture()
+ *
+ *  This method is used for loading textures from image files,
+ *  configuring the texture mapping parameters in OpenGL,
+ *  generating the mipmaps, and loading the read texture into
+ *  the next available texture slot in memory.
+ ***********************************************************/
+bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+	GLuint textureID = 0;
+
+	// small images are packed into a shared atlas page instead of
+	// getting a texture object and a slot of their own; the pages
+	// are uncompressed, so the cooked version of a small image is
+	// not used, and a tile of the largest size takes 1MB instead
+	// of the 128KB of BC1, for a texture slot and binds saved
+	if ((NULL != m_pTextureAtlas) &&
+		(stbi_info(filename, &width, &height, &colorChannels) == 1) &&
+		(m_pTextureAtlas->IsCandidate(width, height) == true))
+	{
+		if (AddTextureToAtlas(filename, tag) == true)
+		{
+			return true;
+		}
+	}
+
+	bool bTranslucent = false;
+	if (LoadGLTexture(filename, textureID, bTranslucent) == false)
+	{
+		return false;
+	}
+
+	// register the loaded texture and associate it with the special tag string
+	m_textureIDs[m_loadedTextures].ID = textureID;
+	m_textureIDs[m_loadedTextures].bTranslucent = bTranslucent;
+	m_textureIDs[m_loadedTextures].tag = tag;
+	m_textureIDs[m_loadedTextures].filename = filename;
+	RegisterTextureResidency(m_loadedTextures, true);
+	m_loadedTextures++;
+
+	return true;
+}
+
+/***********************************************************
+ *  LoadGLTexture()
+ *
+ *  This method is used for loading a texture image file into
+ *  a new OpenGL texture, configuring the texture mapping
+ *  parameters and generating the mipmaps.  The offline cooked
+ *  version of the image is used when it exists.  It also
+ *  finds whether the image has translucent pixels.
+ ***********************************************************/
+bool SceneManager::LoadGLTexture(const char* filename, GLuint& textureID, bool& bTranslucent)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+
+	// prefer the offline cooked, block-compressed version of the
+	// image when it exists, since it needs no decoding at all
+	if (LoadCookedGLTexture(filename, textureID, bTranslucent) == true)
+	{
+		return true;
+	}
+
+	// indicate to always flip images vertically when loaded
+	stbi_set_flip_vertically_on_load(true);
+
+	// try to parse the image data from the specified image file
+	unsigned char* image = stbi_load(
+		filename,
+		&width,
+		&height,
+		&colorChannels,
+		0);
+
+	// if the image was successfully read from the image file
+	if (image)
+	{
+		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
+
+		// only RGB and RGBA images are supported
+		if ((colorChannels != 3) && (colorChannels != 4))
+		{
+			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
+			stbi_image_free(image);
+			return false;
+		}
+
+		bTranslucent = HasTranslucentPixels(image, width, height, colorChannels);
+
+		glGenTextures(1, &textureID);
+		glBindTexture(GL_TEXTURE_2D, textureID);
+
+		// set the texture wrapping parameters
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		// set texture filtering parameters, sampling the mipmaps
+		// that are generated below
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		// if the loaded image is in RGB format
+		if (colorChannels == 3)
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
+		// if the loaded image is in RGBA format - it supports transparency
+		else
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
+
+		// generate the texture mipmaps for mapping textures to lower resolutions
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		// free the image data from local memory
+		stbi_image_free(image);
+		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+
+		return true;
+	}
+
+	std::cout << "Could not load image:" << filename << std::endl;
+
+	// Error loading the image
+	return false;
+}
+
+/***********************************************************
+ *  CreateVirtualTexture()
+ *
+ *  This method is used for opening the page file that was
+ *  built offline for an image file as a virtual texture.
+ *  Only the pages that are visible get loaded into memory.
+ ***********************************************************/
+bool SceneManager::CreateVirtualTexture(const char* filename, std::string tag)
+{
+	if (NULL == m_pVirtualTextures)
+	{
+		return false;
+	}
+
+	std::string pageFilename = VirtualTextureSystem::GetPageFilename(filename);
+
+	return(m_pVirtualTextures->AddVirtualTexture(pageFilename.c_str(), tag) >= 0);
+}
+
+/***********************************************************
+ *  SetupVirtualTextures()
+ *
+ *  This method is used for setting the shader parameters of
+ *  the page cache, which all virtual textures share.
+ ***********************************************************/
+void SceneManager::SetupVirtualTextures()
+{
+	if ((NULL == m_pVirtualTextures) ||
+		(m_pVirtualTextures->GetVirtualTextureCount() == 0))
+	{
+		return;
+	}
+
+	m_pShaderManager->setIntValue("vtPageTable", g_VirtualPageTableUnit);
+	m_pShaderManager->setSampler2DValue("vtPageCache", g_VirtualPageCacheUnit);
+	m_pShaderManager->setFloatValue("vtPageSize", (float)m_pVirtualTextures->GetPageSize());
+	m_pShaderManager->setFloatValue("vtPageBorder", (float)m_pVirtualTextures->GetPageBorder());
+	m_pShaderManager->setVec2Value("vtCacheSize", m_pVirtualTextures->GetPageCacheSize());
+
+	// the page cache has a fixed size and is never evicted
+	m_pResidencyManager->Register(
+		"virtual texture page cache",
+		m_pVirtualTextures->GetPageCacheBytes(),
+		0,
+		false);
+}
+
+/***********************************************************
+ *  AddTextureToAtlas()
+ *
+ *  This method is used for loading a small texture image and
+ *  packing it into the texture atlas.  The atlas pages are
+ *  uploaded once all of the scene textures have been loaded.
+ ***********************************************************/
+bool SceneManager::AddTextureToAtlas(const char* filename, std::string tag)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+
+	// indicate to always flip images vertically when loaded
+	stbi_set_flip_vertically_on_load(true);
+
+	unsigned char* image = stbi_load(
+		filename,
+		&width,
+		&height,
+		&colorChannels,
+		0);
+	if (NULL == image)
+	{
+		return false;
+	}
+
+	bool bReturn = m_pTextureAtlas->AddImage(image, width, height, colorChannels, tag);
+	stbi_image_free(image);
+
+	if (bReturn == true)
+	{
+		std::cout << "Successfully packed image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
+	}
+
+	return(bReturn);
+}
+
+/***********************************************************
+ *  LoadCookedGLTexture()
+ *
+ *  This method is used for loading the cooked container that
+ *  was generated offline for an image file, and uploading its
+ *  precomputed block-compressed mip chain directly into a
+ *  new OpenGL texture.  The blocks are not decoded, so images
+ *  with an alpha channel are taken as translucent.  A cooked
+ *  file that is truncated or does not match its header is
+ *  rejected by the loader, and the image file is loaded.
+ ***********************************************************/
+bool SceneManager::LoadCookedGLTexture(const char* filename, GLuint& textureID, bool& bTranslucent)
+{
+	TextureCooker::COOKED_TEXTURE cookedTexture;
+
+	std::string cookedFilename = TextureCooker::GetCookedFilename(filename);
+	if (TextureCooker::LoadCookedTexture(cookedFilename.c_str(), cookedTexture) == false)
+	{
+		return false;
+	}
+
+	// the compressed format must be supported by the OpenGL driver
+	bool bSupported = false;
+	if (cookedTexture.internalFormat == GL_COMPRESSED_RGBA_BPTC_UNORM)
+		bSupported = (GLEW_ARB_texture_compression_bptc == GL_TRUE);
+	else
+		bSupported = (GLEW_EXT_texture_compression_s3tc == GL_TRUE);
+	if ((bSupported == false) || (cookedTexture.mips.size() == 0))
+	{
+		std::cout << "Cooked texture format not supported:" << cookedFilename << std::endl;
+		return false;
+	}
+
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters, sampling the mipmaps
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)cookedTexture.mips.size() - 1);
+
+	// upload the precomputed mipmaps instead of generating them
+	for (size_t level = 0; level < cookedTexture.mips.size(); level++)
+	{
+		const TextureCooker::COOKED_MIP& mip = cookedTexture.mips[level];
+		glCompressedTexImage2D(
+			GL_TEXTURE_2D,
+			(GLint)level,
+			cookedTexture.internalFormat,
+			mip.width,
+			mip.height,
+			0,
+			(GLsizei)mip.data.size(),
+			mip.data.data());
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+	bTranslucent = ((stbi_info(filename, &width, &height, &colorChannels) == 1) && (colorChannels == 4));
+
+	std::cout << "Successfully loaded cooked image:" << cookedFilename << ", width:" << cookedTexture.width << ", height:" << cookedTexture.height << ", mips:" << cookedTexture.mips.size() << std::endl;
+
+	return true;
+}
+
+/***********************************************************
+ *  GetSceneTextureCount()
+ *
+ *  This method is used for getting the number of image files
+ *  that are loaded for the 3D scene.
+ ***********************************************************/
+int SceneManager::GetSceneTextureCount()
+{
+	return(sizeof(g_SceneTextures) / sizeof(g_SceneTextures[0]));
+}
+
+/***********************************************************
+ *  GetSceneTexture()
+ *
+ *  This method is used for getting the image file and tag
+ *  of one of the textures loaded for the 3D scene.
+ ***********************************************************/
+const SceneManager::SCENE_TEXTURE& SceneManager::GetSceneTexture(int index)
+{
+	return(g_SceneTextures[index]);
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for binding the loaded textures to
+ *  OpenGL texture memory slots.  There are up to 16 slots.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		// bind textures on corresponding texture units
+		glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
+	}
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory in all the
+ *  used texture memory slots.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		if (m_textureIDs[i].ID != 0)
+		{
+			glDeleteTextures(1, &m_textureIDs[i].ID);
+			m_textureIDs[i].ID = 0;
+		}
+		if (NULL != m_pResidencyManager)
+		{
+			m_pResidencyManager->Unregister(m_textureIDs[i].residencyHandle);
+		}
+		m_textureIDs[i].residencyHandle = -1;
+		m_textureIDs[i].bRestoreQueued = false;
+	}
+	m_loadedTextures = 0;
+	m_restoreCount = 0;
+}
+
+/***********************************************************
+ *  GetGLTextureBytes()
+ *
+ *  This method is used for getting the GPU memory used by
+ *  all of the mip levels of a loaded texture.  The texture
+ *  that was bound to the active unit is bound again after.
+ ***********************************************************/
+size_t SceneManager::GetGLTextureBytes(GLuint textureID)
+{
+	size_t totalBytes = 0;
+	GLint maxLevel = 0;
+	GLint boundTexture = 0;
+
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+
+	for (GLint level = 0; level <= maxLevel; level++)
+	{
+		GLint width = 0;
+		GLint height = 0;
+		GLint compressed = GL_FALSE;
+
+		// undefined mip levels report a width of zero
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &height);
+		if ((width == 0) || (height == 0))
+		{
+			break;
+		}
+
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &compressed);
+		if (compressed == GL_TRUE)
+		{
+			GLint imageSize = 0;
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &imageSize);
+			totalBytes += (size_t)imageSize;
+		}
+		else
+		{
+			// drivers store RGB8 textures with four bytes per texel
+			totalBytes += (size_t)width * height * 4;
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, (GLuint)boundTexture);
+
+	return(totalBytes);
+}
+
+/***********************************************************
+ *  RegisterTextureResidency()
+ *
+ *  This method is used for adding a loaded texture to the
+ *  GPU memory accounting.  Textures that cannot be reloaded
+ *  from an image file are never evicted.
+ ***********************************************************/
+void SceneManager::RegisterTextureResidency(int slot, bool bEvictable)
+{
+	GLint width = 0;
+	GLint height = 0;
+	int maxDroppedMips = 0;
+	GLint boundTexture = 0;
+
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+	glBindTexture(GL_TEXTURE_2D, m_textureIDs[slot].ID);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)boundTexture);
+
+	// mip levels can only be dropped when the copy is supported
+	if (GLEW_VERSION_4_3 == GL_TRUE)
+	{
+		while (((width >> (maxDroppedMips + 1)) >= g_MinResidentTextureSize) &&
+			((height >> (maxDroppedMips + 1)) >= g_MinResidentTextureSize))
+		{
+			maxDroppedMips++;
+		}
+	}
+
+	m_textureIDs[slot].residencyHandle = m_pResidencyManager->Register(
+		m_textureIDs[slot].tag,
+		GetGLTextureBytes(m_textureIDs[slot].ID),
+		maxDroppedMips,
+		bEvictable);
+}
+
+/***********************************************************
+ *  RebindGLTexture()
+ *
+ *  This method is used for binding the current texture of a
+ *  slot to its texture unit after the texture was replaced.
+ ***********************************************************/
+void SceneManager::RebindGLTexture(int slot)
+{
+	glActiveTexture(GL_TEXTURE0 + slot);
+	glBindTexture(GL_TEXTURE_2D, m_textureIDs[slot].ID);
+}
+
+/***********************************************************
+ *  DropTextureMip()
+ *
+ *  This method is used for releasing the most detailed mip
+ *  level of a texture.  The remaining levels are copied into
+ *  a new, smaller texture on the GPU and the old texture is
+ *  deleted.
+ ***********************************************************/
+bool SceneManager::DropTextureMip(int slot)
+{
+	GLuint oldTextureID = m_textureIDs[slot].ID;
+	GLuint newTextureID = 0;
+	GLint internalFormat = 0;
+	GLint maxLevel = 0;
+	GLint parameters[4];
+	GLint levelWidths[32];
+	GLint levelHeights[32];
+	int levelCount = 0;
+	GLint boundTexture = 0;
+
+	// the queries use the active unit, whose texture is bound
+	// again afterwards
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+	glBindTexture(GL_TEXTURE_2D, oldTextureID);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &parameters[0]);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &parameters[1]);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &parameters[2]);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &parameters[3]);
+
+	// gather the sizes of the levels below the most detailed one
+	for (GLint level = 1; (level <= maxLevel) && (levelCount < 32); level++)
+	{
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &levelWidths[levelCount]);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &levelHeights[levelCount]);
+		if ((levelWidths[levelCount] == 0) || (levelHeights[levelCount] == 0))
+		{
+			break;
+		}
+		levelCount++;
+	}
+	if (levelCount == 0)
+	{
+		glBindTexture(GL_TEXTURE_2D, (GLuint)boundTexture);
+		return false;
+	}
+
+	glGenTextures(1, &newTextureID);
+	glBindTexture(GL_TEXTURE_2D, newTextureID);
+	glTexStorage2D(GL_TEXTURE_2D, levelCount, internalFormat, levelWidths[0], levelHeights[0]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, parameters[0]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, parameters[1]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, parameters[2]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, parameters[3]);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)boundTexture);
+
+	// copy the remaining levels without a round trip through the CPU
+	for (int level = 0; level < levelCount; level++)
+	{
+		glCopyImageSubData(
+			oldTextureID, GL_TEXTURE_2D, level + 1, 0, 0, 0,
+			newTextureID, GL_TEXTURE_2D, level, 0, 0, 0,
+			levelWidths[level], levelHeights[level], 1);
+	}
+
+	// the size is measured before the new texture is bound to
+	// the unit of the slot
+	size_t textureBytes = GetGLTextureBytes(newTextureID);
+	glDeleteTextures(1, &oldTextureID);
+	m_textureIDs[slot].ID = newTextureID;
+	RebindGLTexture(slot);
+
+	const ResidencyManager::RESIDENT_RESOURCE& resource = m_pResidencyManager->GetResource(m_textureIDs[slot].residencyHandle);
+	m_pResidencyManager->UpdateResource(
+		m_textureIDs[slot].residencyHandle,
+		textureBytes,
+		resource.droppedMips + 1,
+		true);
+
+	return true;
+}
+
+/***********************************************************
+ *  UnloadTexture()
+ *
+ *  This method is used for releasing all of the GPU memory
+ *  of a texture.  It is reloaded from its image file the
+ *  next time that it is used.
+ ***********************************************************/
+void SceneManager::UnloadTexture(int slot)
+{
+	if (m_textureIDs[slot].ID != 0)
+	{
+		glDeleteTextures(1, &m_textureIDs[slot].ID);
+		m_textureIDs[slot].ID = 0;
+		RebindGLTexture(slot);
+	}
+
+	m_pResidencyManager->UpdateResource(m_textureIDs[slot].residencyHandle, 0, 0, false);
+}
+
+/***********************************************************
+ *  RestoreTexture()
+ *
+ *  This method is used for reloading a texture that was
+ *  shrunk or unloaded back at its full resolution.
+ ***********************************************************/
+bool SceneManager::RestoreTexture(int slot)
+{
+	GLuint textureID = 0;
+	GLint boundTexture = 0;
+
+	// loading unbinds the texture of the active unit, which can
+	// belong to another slot
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+	bool bLoaded = LoadGLTexture(m_textureIDs[slot].filename.c_str(), textureID, m_textureIDs[slot].bTranslucent);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)boundTexture);
+	if (bLoaded == false)
+	{
+		return false;
+	}
+
+	size_t textureBytes = GetGLTextureBytes(textureID);
+	if (m_textureIDs[slot].ID != 0)
+	{
+		glDeleteTextures(1, &m_textureIDs[slot].ID);
+	}
+	m_textureIDs[slot].ID = textureID;
+	RebindGLTexture(slot);
+
+	m_pResidencyManager->UpdateResource(
+		m_textureIDs[slot].residencyHandle,
+		textureBytes,
+		0,
+		true);
+
+	return true;
+}
+
+/***********************************************************
+ *  TouchTexture()
+ *
+ *  This method is used for marking a texture as used by the
+ *  current frame.  The draws are being recorded, so a texture
+ *  that was unloaded, or that was shrunk and fits within the
+ *  budget again, is only queued to be reloaded at the start
+ *  of a later frame.
+ ***********************************************************/
+void SceneManager::TouchTexture(int slot)
+{
+	if ((slot < 0) || (slot >= m_loadedTextures))
+	{
+		return;
+	}
+
+	int handle = m_textureIDs[slot].residencyHandle;
+	if (handle < 0)
+	{
+		return;
+	}
+
+	m_pResidencyManager->Touch(handle);
+
+	const ResidencyManager::RESIDENT_RESOURCE& resource = m_pResidencyManager->GetResource(handle);
+	if ((m_textureIDs[slot].bRestoreQueued == false) &&
+		((resource.bResident == false) ||
+		((resource.droppedMips > 0) && (m_pResidencyManager->CanRestore(handle) == true))))
+	{
+		m_textureIDs[slot].bRestoreQueued = true;
+		m_restoreQueue[m_restoreCount] = slot;
+		m_restoreCount++;
+	}
+}
+
+/***********************************************************
+ *  RestoreQueuedTextures()
+ *
+ *  This method is used for reloading the textures that were
+ *  queued by the last frames, before the draws of the frame
+ *  are recorded.  Only a few textures are decoded per frame,
+ *  the rest wait for the next frames.
+ ***********************************************************/
+void SceneManager::RestoreQueuedTextures()
+{
+	int restored = 0;
+	while ((m_restoreCount > 0) && (restored < g_MaxTextureRestoresPerFrame))
+	{
+		int slot = m_restoreQueue[0];
+		m_restoreCount--;
+		for (int i = 0; i < m_restoreCount; i++)
+		{
+			m_restoreQueue[i] = m_restoreQueue[i + 1];
+		}
+		m_textureIDs[slot].bRestoreQueued = false;
+
+		// a shrunk texture can stop fitting while it waits
+		int handle = m_textureIDs[slot].residencyHandle;
+		const ResidencyManager::RESIDENT_RESOURCE& resource = m_pResidencyManager->GetResource(handle);
+		if ((resource.bResident == true) &&
+			((resource.droppedMips == 0) || (m_pResidencyManager->CanRestore(handle) == false)))
+		{
+			continue;
+		}
+
+		if (RestoreTexture(slot) == true)
+		{
+			m_pResidencyManager->Touch(handle);
+		}
+		restored++;
+	}
+}
+
+/***********************************************************
+ *  EnforceTextureBudget()
+ *
+ *  This method is used for shrinking or unloading the least
+ *  recently used textures until the loaded textures fit
+ *  within the GPU memory budget.
+ ***********************************************************/
+void SceneManager::EnforceTextureBudget()
+{
+	std::vector<ResidencyManager::EVICTION>& evictions = m_evictions;
+
+	m_pResidencyManager->CollectEvictions(evictions);
+	for (size_t i = 0; i < evictions.size(); i++)
+	{
+		// find the texture slot that owns the evicted resource
+		int slot = 0;
+		while ((slot < m_loadedTextures) &&
+			(m_textureIDs[slot].residencyHandle != evictions[i].handle))
+		{
+			slot++;
+		}
+		if (slot == m_loadedTextures)
+		{
+			continue;
+		}
+
+		if (evictions[i].action == ResidencyManager::EVICT_DROP_MIP)
+		{
+			if (DropTextureMip(slot) == false)
+			{
+				UnloadTexture(slot);
+			}
+		}
+		else
+		{
+			UnloadTexture(slot);
+		}
+	}
+}
+
+/***********************************************************
+ *  SetViewCamera()
+ *
+ *  This method is used for setting the camera matrices that
+ *  the passes of the frame are drawn with, once the camera
+ *  has been latched.
+ ***********************************************************/
+void SceneManager::SetViewCamera(const glm::mat4& view, const glm::mat4& projection)
+{
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+}
+
+/***********************************************************
+ *  SetDepthPrepass()
+ *
+ *  This method is used for setting the depth pre-pass that
+ *  is drawn before the main pass, or NULL to draw without.
+ ***********************************************************/
+void SceneManager::SetDepthPrepass(DepthPrepass* pDepthPrepass)
+{
+	m_pDepthPrepass = pDepthPrepass;
+}
+
+/***********************************************************
+ *  SetRenderBackend()
+ *
+ *  This method is used to submit the frames through another
+ *  render backend, which is not owned by the scene.  The
+ *  scene is still loaded with OpenGL, and the passes with
+ *  their own framebuffers are skipped when the backend does
+ *  not draw with OpenGL.  Such a backend gets a copy of the
+ *  loaded textures.
+ ***********************************************************/
+void SceneManager::SetRenderBackend(RenderBackend* pBackend)
+{
+	m_pBackend = (NULL != pBackend) ? pBackend : m_pGLBackend;
+	m_backendVirtualFirstSlot = -1;
+
+	if (m_pBackend->SupportsOpenGLPasses() == false)
+	{
+		UploadBackendTextures();
+	}
+}
+
+/***********************************************************
+ *  UploadBackendTextures()
+ *
+ *  This method is used to copy the loaded textures into the
+ *  backend and to bind them to the same texture slots.  The
+ *  virtual textures are loaded again from their images and
+ *  bound to the slots after the loaded textures.
+ ***********************************************************/
+void SceneManager::UploadBackendTextures()
+{
+	std::vector<unsigned char> pixels;
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		// the textures are read back from OpenGL, which decodes the
+		// compressed ones, at the size that they are resident with
+		GLint width = 0;
+		GLint height = 0;
+		glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+		if ((width <= 0) || (height <= 0))
+		{
+			continue;
+		}
+
+		pixels.resize((size_t)width * height * 4);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		m_pBackend->BindTexture(i, m_pBackend->CreateTexture(width, height, pixels.data(), true));
+	}
+
+	if ((NULL == m_pVirtualTextures) || (m_pVirtualTextures->GetVirtualTextureCount() == 0))
+	{
+		return;
+	}
+
+	m_backendVirtualFirstSlot = m_loadedTextures;
+	stbi_set_flip_vertically_on_load(true);
+	for (int i = 0; i < GetSceneTextureCount(); i++)
+	{
+		int index = m_pVirtualTextures->FindVirtualTexture(g_SceneTextures[i].tag);
+		if ((g_SceneTextures[i].bVirtual == false) || (index < 0))
+		{
+			continue;
+		}
+
+		int width = 0;
+		int height = 0;
+		int colorChannels = 0;
+		unsigned char* image = stbi_load(g_SceneTextures[i].filename, &width, &height, &colorChannels, 4);
+		if (NULL == image)
+		{
+			std::cout << "Could not load virtual texture image:" << g_SceneTextures[i].filename << std::endl;
+			continue;
+		}
+
+		// the image is halved until it fits the size of the copy
+		pixels.assign(image, image + (size_t)width * height * 4);
+		stbi_image_free(image);
+		while ((width > g_BackendVirtualTextureSize) || (height > g_BackendVirtualTextureSize))
+		{
+			int halfWidth = (width > 1) ? (width / 2) : 1;
+			int halfHeight = (height > 1) ? (height / 2) : 1;
+			for (int y = 0; y < halfHeight; y++)
+			{
+				int y0 = std::min(y * 2, height - 1);
+				int y1 = std::min(y * 2 + 1, height - 1);
+				for (int x = 0; x < halfWidth; x++)
+				{
+					int x0 = std::min(x * 2, width - 1);
+					int x1 = std::min(x * 2 + 1, width - 1);
+					for (int channel = 0; channel < 4; channel++)
+					{
+						int sum =
+							pixels[((size_t)y0 * width + x0) * 4 + channel] +
+							pixels[((size_t)y0 * width + x1) * 4 + channel] +
+							pixels[((size_t)y1 * width + x0) * 4 + channel] +
+							pixels[((size_t)y1 * width + x1) * 4 + channel];
+						pixels[((size_t)y * halfWidth + x) * 4 + channel] = (unsigned char)((sum + 2) / 4);
+					}
+				}
+			}
+			width = halfWidth;
+			height = halfHeight;
+		}
+
+		m_pBackend->BindTexture(m_backendVirtualFirstSlot + index, m_pBackend->CreateTexture(width, height, pixels.data(), true));
+	}
+}
+
+/***********************************************************
+ *  SubmitBackendView()
+ *
+ *  This method is used to pass the camera and the first
+ *  lights of the scene to a backend that does not draw with
+ *  OpenGL, like they are set into the shader uniforms.
+ ***********************************************************/
+void SceneManager::SubmitBackendView()
+{
+	m_pBackend->SetMat4Value("view", m_viewMatrix);
+	m_pBackend->SetMat4Value("projection", m_projectionMatrix);
+	m_pBackend->SetVec3Value("viewPosition", glm::vec3(glm::inverse(m_viewMatrix)[3]));
+	m_pBackend->SetIntValue(g_UseLightingName, m_bUseLighting);
+
+	for (int i = 0; i < ClusteredLighting::UNIFORM_LIGHT_COUNT; i++)
+	{
+		ClusteredLighting::POINT_LIGHT light = {};
+		if (i < m_pLighting->GetLightCount())
+		{
+			light = m_pLighting->GetLight(i);
+		}
+
+		const char* const* names = g_LightUniformNames[i];
+		m_pBackend->SetVec3Value(names[0], light.position);
+		m_pBackend->SetFloatValue(names[1], light.radius);
+		m_pBackend->SetVec3Value(names[2], light.ambientColor);
+		m_pBackend->SetVec3Value(names[3], light.diffuseColor);
+		m_pBackend->SetVec3Value(names[4], light.specularColor);
+		m_pBackend->SetFloatValue(names[5], light.focalStrength);
+		m_pBackend->SetFloatValue(names[6], light.specularIntensity);
+	}
+}
+
+/***********************************************************
+ *  SetTextureBudget()
+ *
+ *  This method is used for setting the GPU memory budget
+ *  that the loaded scene textures must fit within.
+ ***********************************************************/
+void SceneManager::SetTextureBudget(size_t budgetBytes)
+{
+	m_pResidencyManager->SetBudget(budgetBytes);
+}
+
+/***********************************************************
+ *  GetResidentTextureBytes()
+ *
+ *  This method is used for getting the GPU memory used by
+ *  the currently loaded scene textures.
+ ***********************************************************/
+size_t SceneManager::GetResidentTextureBytes()
+{
+	return(m_pResidencyManager->GetResidentBytes());
+}
+
+/***********************************************************
+ *  GetFrameArena()
+ *
+ *  This method is used for getting the arena that the draw
+ *  list and the other transient data of the frames are
+ *  allocated from, to report how much of it they use.
+ ***********************************************************/
+FrameArena* SceneManager::GetFrameArena()
+{
+	return(m_pFrameArena);
+}
+
+/***********************************************************
+ *  FindTextureID()
+ *
+ *  This method is used for getting an ID for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureID(std::string tag)
+{
+	int textureID = -1;
+	int index = 0;
+	bool bFound = false;
+
+	while ((index < m_loadedTextures) && (bFound == false))
+	{
+		if (m_textureIDs[index].tag.compare(tag) == 0)
+		{
+			textureID = m_textureIDs[index].ID;
+			bFound = true;
+		}
+		else
+			index++;
+	}
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting a slot index for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(std::string tag)
+{
+	return(FindTextureSlot(tag.c_str()));
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting a slot index for the previously
+ *  loaded texture bitmap associated with the passed in tag,
+ *  without copying the tag into a string.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(const char* tag)
+{
+	int textureSlot = -1;
+	int index = 0;
+	bool bFound = false;
+
+	while ((index < m_loadedTextures) && (bFound == false))
+	{
+		if (m_textureIDs[index].tag.compare(tag) == 0)
+		{
+			textureSlot = index;
+			bFound = true;
+		}
+		else
+			index++;
+	}
+
+	return(textureSlot);
+}
+
+/***********************************************************
+ *  FindMaterial()
+ *
+ *  This method is used for getting a material from the previously
+ *  defined materials list that is associated with the passed in tag.
+ ***********************************************************/
+bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
+{
+	return(FindMaterial(tag.c_str(), material));
+}
+
+/***********************************************************
+ *  FindMaterial()
+ *
+ *  This method is used for getting a material from the previously
+ *  defined materials list that is associated with the passed in tag,
+ *  without copying the tag into a string.
+ ***********************************************************/
+bool SceneManager::FindMaterial(const char* tag, OBJECT_MATERIAL& material)
+{
+	if (m_objectMaterials.size() == 0)
+	{
+		return(false);
+	}
+
+	int index = 0;
+	bool bFound = false;
+	while ((index < m_objectMaterials.size()) && (bFound == false))
+	{
+		if (m_objectMaterials[index].tag.compare(tag) == 0)
+		{
+			bFound = true;
+			material.ambientColor = m_objectMaterials[index].ambientColor;
+			material.ambientStrength = m_objectMaterials[index].ambientStrength;
+			material.diffuseColor = m_objectMaterials[index].diffuseColor;
+			material.specularColor = m_objectMaterials[index].specularColor;
+			material.shininess = m_objectMaterials[index].shininess;
+		}
+		else
+		{
+			index++;
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the index of a defined
+ *  material from its tag, or -1 when it is not defined.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(const char* tag)
+{
+	for (size_t index = 0; index < m_objectMaterials.size(); index++)
+	{
+		if (m_objectMaterials[index].tag.compare(tag) == 0)
+		{
+			return((int)index);
+		}
+	}
+
+	return(-1);
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using the passed in transformation values.  It is used
+ *  by the next recorded meshes.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	// variables for this method
+	glm::mat4 modelView;
+	glm::mat4 scale;
+	glm::mat4 rotationX;
+	glm::mat4 rotationY;
+	glm::mat4 rotationZ;
+	glm::mat4 translation;
+
+	// set the scale value in the transform buffer
+	scale = glm::scale(scaleXYZ);
+	// set the rotation values in the transform buffer
+	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
+	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
+	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
+	// set the translation value in the transform buffer
+	translation = glm::translate(positionXYZ);
+
+	modelView = translation * rotationX * rotationY * rotationZ * scale;
+
+	m_currentDraw.model = modelView;
+}
+
+/***********************************************************
+ *  SetShaderColor()
+ *
+ *  This method is used for setting the passed in color
+ *  into the shader for the next draw command
+ ***********************************************************/
+void SceneManager::SetShaderColor(
+	float redColorValue,
+	float greenColorValue,
+	float blueColorValue,
+	float alphaValue)
+{
+	// variables for this method
+	glm::vec4 currentColor;
+
+	currentColor.r = redColorValue;
+	currentColor.g = greenColorValue;
+	currentColor.b = blueColorValue;
+	currentColor.a = alphaValue;
+
+	m_currentDraw.bUseTexture = false;
+	m_currentDraw.color = currentColor;
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in ID into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	std::string textureTag)
+{
+	SetShaderTexture(textureTag.c_str());
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in tag into the shader,
+ *  without copying the tag into a string.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	const char* textureTag)
+{
+	m_currentDraw.bUseTexture = true;
+
+	// virtual textures are sampled through their page table
+	int virtualIndex = -1;
+	if (NULL != m_pVirtualTextures)
+	{
+		virtualIndex = m_pVirtualTextures->FindVirtualTexture(textureTag);
+	}
+	m_currentDraw.virtualTexture = virtualIndex;
+	m_pCurrentTile = NULL;
+	// the virtual textures are streamed from opaque images
+	m_bCurrentTextureTranslucent = false;
+	if (virtualIndex >= 0)
+	{
+		return;
+	}
+
+	int textureID = -1;
+	textureID = FindTextureSlot(textureTag);
+
+	// textures packed into the atlas sample their tile of the
+	// atlas page through the UV scale and offset
+	if ((textureID < 0) && (NULL != m_pTextureAtlas))
+	{
+		m_pCurrentTile = m_pTextureAtlas->FindTile(textureTag);
+		if (NULL != m_pCurrentTile)
+		{
+			textureID = m_atlasFirstSlot + m_pCurrentTile->page;
+			m_bCurrentTextureTranslucent = m_pCurrentTile->bTranslucent;
+		}
+	}
+	else if (textureID >= 0)
+	{
+		m_bCurrentTextureTranslucent = m_textureIDs[textureID].bTranslucent;
+	}
+
+	TouchTexture(textureID);
+	m_currentDraw.textureSlot = textureID;
+
+	// an unloaded texture is drawn with the color of the draw
+	// until it is reloaded, and a shrunk one with the mip levels
+	// that it still has
+	if ((textureID >= 0) && (m_textureIDs[textureID].ID == 0))
+	{
+		m_currentDraw.bUseTexture = false;
+	}
+}
+
+/***********************************************************
+ *  SetTextureUVScale()
+ *
+ *  This method is used for setting the texture UV scale
+ *  values for the next recorded meshes.
+ ***********************************************************/
+void SceneManager::SetTextureUVScale(float u, float v)
+{
+	m_textureUVScale = glm::vec2(u, v);
+}
+
+/***********************************************************
+ *  SetShaderVirtualTexture()
+ *
+ *  This method is used for binding the page table of a
+ *  virtual texture and setting its size into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderVirtualTexture(int index)
+{
+	const VirtualTextureSystem::VIRTUAL_TEXTURE& texture = m_pVirtualTextures->GetVirtualTexture(index);
+
+	if (m_pBackend->SupportsOpenGLPasses() == true)
+	{
+		m_pVirtualTextures->BindPageTable(index);
+	}
+	m_pBackend->SetVec2Value("vtVirtualSize", glm::vec2((float)texture.width, (float)texture.height));
+	m_pBackend->SetIntValue("vtMipCount", texture.mipCount);
+	m_pBackend->SetIntValue("vtIndex", index);
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for selecting the material that the
+ *  next recorded meshes pass into the shader.  An undefined
+ *  material keeps the last one.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	std::string materialTag)
+{
+	SetShaderMaterial(materialTag.c_str());
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for selecting the material of the
+ *  next recorded meshes by its tag, without copying the tag
+ *  into a string.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	const char* materialTag)
+{
+	int index = FindMaterialIndex(materialTag);
+	if (index >= 0)
+	{
+		m_currentDraw.material = index;
+	}
+}
+
+/***********************************************************
+ *  SetObjectDynamic()
+ *
+ *  This method is used for marking the next recorded meshes
+ *  as moving objects.  They are left out of the cached
+ *  static shadow maps and drawn into the shadows every frame.
+ ***********************************************************/
+void SceneManager::SetObjectDynamic(bool bDynamic)
+{
+	m_currentDraw.bDynamic = bDynamic;
+}
+
+/***********************************************************
+ *  SubmitMesh()
+ *
+ *  This method is used for recording a mesh with the current
+ *  shader settings into the draw list of the frame.  For a
+ *  texture in the atlas, the UV scale and offset map the
+ *  texture coordinates into its tile.  The mesh needs
+ *  blending when the alpha of its texture or color does.
+ ***********************************************************/
+void SceneManager::SubmitMesh(MESH_TYPE mesh)
+{
+	m_currentDraw.mesh = mesh;
+	if (m_currentDraw.bUseTexture == true)
+	{
+		m_currentDraw.bTransparent = m_bCurrentTextureTranslucent;
+	}
+	else
+	{
+		m_currentDraw.bTransparent = (m_currentDraw.color.a < 1.0f);
+	}
+	if (NULL != m_pCurrentTile)
+	{
+		m_currentDraw.uvScale = m_textureUVScale * m_pCurrentTile->scale;
+		m_currentDraw.uvOffset = m_pCurrentTile->offset;
+	}
+	else
+	{
+		m_currentDraw.uvScale = m_textureUVScale;
+		m_currentDraw.uvOffset = glm::vec2(0.0f, 0.0f);
+	}
+
+	m_drawList.push_back(m_currentDraw);
+}
+
+/***********************************************************
+ *  SortDrawList()
+ *
+ *  This method is used for sorting the recorded meshes by
+ *  the distance of their origin in front of the camera, the
+ *  opaque ones first.  Small keys are sorted instead of the
+ *  draws, and the draws are then copied in their order, so
+ *  the sort works in the frame arena and does not need the
+ *  buffer that a stable sort takes from the heap.
+ ***********************************************************/
+void SceneManager::SortDrawList()
+{
+	PROFILE_CPU_SCOPE("SortDrawList");
+
+	FrameVector<DRAW_SORT_KEY> keys((FrameArenaAllocator<DRAW_SORT_KEY>(m_pFrameArena)));
+	keys.resize(m_drawList.size());
+	for (size_t i = 0; i < m_drawList.size(); i++)
+	{
+		DRAW_ITEM& item = m_drawList[i];
+		item.viewDepth = -(m_viewMatrix * item.model[3]).z;
+
+		keys[i].bTransparent = item.bTransparent;
+		keys[i].depth = (item.bTransparent == true) ? -item.viewDepth : item.viewDepth;
+		keys[i].index = (uint32_t)i;
+	}
+
+	std::sort(keys.begin(), keys.end(), CompareDrawOrder);
+
+	FrameVector<DRAW_ITEM> sortedDraws((FrameArenaAllocator<DRAW_ITEM>(m_pFrameArena)));
+	sortedDraws.reserve(m_drawList.size());
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		sortedDraws.push_back(m_drawList[keys[i].index]);
+	}
+	m_drawList.swap(sortedDraws);
+}
+
+/***********************************************************
+ *  DrawSceneObjects()
+ *
+ *  This method is used for drawing the recorded meshes that
+ *  pass the filter.  The depth only passes just need the
+ *  model transformation, the others set the shader settings
+ *  that changed since the last draw.  The callers profile
+ *  the draws under the scope of their pass.
+ ***********************************************************/
+void SceneManager::DrawSceneObjects(DRAW_FILTER filter, bool bDepthOnly)
+{
+	const DRAW_ITEM* pLastItem = NULL;
+	for (size_t i = 0; i < m_drawList.size(); i++)
+	{
+		const DRAW_ITEM& item = m_drawList[i];
+		if (((filter == DRAW_STATIC) && (item.bDynamic == true)) ||
+			((filter == DRAW_DYNAMIC) && (item.bDynamic == false)) ||
+			((filter == DRAW_OPAQUE) && (item.bTransparent == true)) ||
+			((filter == DRAW_TRANSPARENT) && (item.bTransparent == false)))
+		{
+			continue;
+		}
+
+		m_pBackend->SetMat4Value(g_ModelName, item.model);
+		if (bDepthOnly == false)
+		{
+			ApplyDrawSettings(item, pLastItem);
+			pLastItem = &item;
+		}
+
+		DrawMesh(item.mesh);
+	}
+}
+
+/***********************************************************
+ *  ApplyDrawSettings()
+ *
+ *  This method is used for passing the shader settings of a
+ *  recorded mesh into the shader, skipping the ones that are
+ *  the same as for the last drawn mesh.
+ ***********************************************************/
+void SceneManager::ApplyDrawSettings(const DRAW_ITEM& item, const DRAW_ITEM* pLastItem)
+{
+	bool bFirst = (NULL == pLastItem);
+
+	if ((bFirst == true) || (item.bUseTexture != pLastItem->bUseTexture))
+	{
+		m_pBackend->SetIntValue(g_UseTextureName, item.bUseTexture);
+	}
+	if ((bFirst == true) || (item.color != pLastItem->color))
+	{
+		m_pBackend->SetVec4Value(g_ColorValueName, item.color);
+	}
+
+	if ((bFirst == true) || ((item.virtualTexture >= 0) != (pLastItem->virtualTexture >= 0)))
+	{
+		m_pBackend->SetIntValue(g_UseVirtualTextureName, (item.virtualTexture >= 0));
+	}
+	if ((item.virtualTexture >= 0) &&
+		((bFirst == true) || (item.virtualTexture != pLastItem->virtualTexture)))
+	{
+		SetShaderVirtualTexture(item.virtualTexture);
+	}
+	int textureSlot = GetBackendTextureSlot(item);
+	if ((bFirst == true) || (textureSlot != GetBackendTextureSlot(*pLastItem)))
+	{
+		m_pBackend->SetIntValue(g_TextureValueName, textureSlot);
+	}
+
+	if ((bFirst == true) || (item.uvScale != pLastItem->uvScale))
+	{
+		m_pBackend->SetVec2Value(g_UVScaleName, item.uvScale);
+	}
+	if ((bFirst == true) || (item.uvOffset != pLastItem->uvOffset))
+	{
+		m_pBackend->SetVec2Value(g_UVOffsetName, item.uvOffset);
+	}
+
+	if ((item.material >= 0) &&
+		((bFirst == true) || (item.material != pLastItem->material)))
+	{
+		const OBJECT_MATERIAL& material = m_objectMaterials[item.material];
+		m_pBackend->SetVec3Value("material.ambientColor", material.ambientColor);
+		m_pBackend->SetFloatValue("material.ambientStrength", material.ambientStrength);
+		m_pBackend->SetVec3Value("material.diffuseColor", material.diffuseColor);
+		m_pBackend->SetVec3Value("material.specularColor", material.specularColor);
+		m_pBackend->SetFloatValue("material.shininess", material.shininess);
+	}
+}
+
+/***********************************************************
+ *  GetBackendTextureSlot()
+ *
+ *  This method is used to get the texture slot of a draw,
+ *  which is the copy of its virtual texture for a backend
+ *  that has no virtual texturing.
+ ***********************************************************/
+int SceneManager::GetBackendTextureSlot(const DRAW_ITEM& item) const
+{
+	if ((item.virtualTexture >= 0) && (m_backendVirtualFirstSlot >= 0))
+	{
+		return(m_backendVirtualFirstSlot + item.virtualTexture);
+	}
+
+	return(item.textureSlot);
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing one of the basic meshes
+ *  through the render backend.
+ ***********************************************************/
+void SceneManager::DrawMesh(MESH_TYPE mesh)
+{
+	m_pBackend->DrawShape((RenderBackend::SHAPE_MESH)mesh);
+}
+
+/***********************************************************
+ *  DrawDepthPrepass()
+ *
+ *  This method is used for drawing the depth of the opaque
+ *  recorded meshes with the position only shaders, so that
+ *  the main pass only shades the visible fragments.  The
+ *  transparent meshes do not hide what is behind them.
+ ***********************************************************/
+void SceneManager::DrawDepthPrepass()
+{
+	PROFILE_SCOPE("DepthPrepass");
+
+	m_pDepthPrepass->BeginPrepass(m_viewMatrix, m_projectionMatrix);
+	for (size_t i = 0; (i < m_drawList.size()) && (m_drawList[i].bTransparent == false); i++)
+	{
+		m_pDepthPrepass->SetModel(m_drawList[i].model);
+		DrawMesh(m_drawList[i].mesh);
+	}
+	m_pDepthPrepass->EndPrepass(m_pShaderManager);
+}
+
+/***********************************************************
+ *  HashStaticDraws()
+ *
+ *  This method is used for getting a hash of the meshes and
+ *  transformations of the static draws, which changes
+ *  whenever a static object is added, removed or moved.  The
+ *  FNV-1a hashes of the draws are summed, so the order that
+ *  the draws are sorted in does not change it.
+ ***********************************************************/
+uint64_t SceneManager::HashStaticDraws() const
+{
+	uint64_t hash = 0;
+	for (size_t i = 0; i < m_drawList.size(); i++)
+	{
+		const DRAW_ITEM& item = m_drawList[i];
+		if (item.bDynamic == true)
+		{
+			continue;
+		}
+
+		uint64_t itemHash = 14695981039346656037ull;
+		const unsigned char* bytes = (const unsigned char*)&item.model;
+		for (size_t j = 0; j < sizeof(item.model); j++)
+		{
+			itemHash = (itemHash ^ bytes[j]) * 1099511628211ull;
+		}
+		itemHash = (itemHash ^ (uint64_t)item.mesh) * 1099511628211ull;
+		hash += itemHash;
+	}
+
+	return(hash);
+}
+
+/***********************************************************
+ *  RenderShadowMaps()
+ *
+ *  This method is used for bringing the shadow maps of the
+ *  lights up to date.  The static objects are only drawn
+ *  when a light moved or the static scene changed, and the
+ *  dynamic objects are drawn over a copy every frame.
+ ***********************************************************/
+void SceneManager::RenderShadowMaps()
+{
+	PROFILE_SCOPE("RenderShadowMaps");
+
+	for (int i = 0; i < m_pLighting->GetLightCount(); i++)
+	{
+		const ClusteredLighting::POINT_LIGHT& light = m_pLighting->GetLight(i);
+		if (light.shadowIndex >= 0)
+		{
+			m_pShadowMaps->SetLightPosition(light.shadowIndex, light.position);
+		}
+	}
+
+	uint64_t staticSceneHash = HashStaticDraws();
+	bool bDynamic = false;
+	for (size_t i = 0; (i < m_drawList.size()) && (bDynamic == false); i++)
+	{
+		bDynamic = m_drawList[i].bDynamic;
+	}
+
+	bool bPassesStarted = false;
+	for (int index = 0; index < m_pShadowMaps->GetLightCount(); index++)
+	{
+		bool bStatic = (m_pShadowMaps->IsStaticMapValid(index, staticSceneHash) == false);
+		if ((bStatic == false) && (bDynamic == false))
+		{
+			continue;
+		}
+
+		if (bPassesStarted == false)
+		{
+			m_pShadowMaps->BeginPasses();
+			bPassesStarted = true;
+		}
+
+		if (bStatic == true)
+		{
+			for (int face = 0; face < 6; face++)
+			{
+				m_pShadowMaps->BeginStaticFace(index, face);
+				DrawSceneObjects(DRAW_STATIC, true);
+			}
+			m_pShadowMaps->EndStaticMap(index, staticSceneHash);
+		}
+
+		if (bDynamic == true)
+		{
+			for (int face = 0; face < 6; face++)
+			{
+				m_pShadowMaps->BeginDynamicFace(index, face);
+				DrawSceneObjects(DRAW_DYNAMIC, true);
+			}
+		}
+	}
+
+	if (bPassesStarted == true)
+	{
+		m_pShadowMaps->EndPasses(bDynamic);
+	}
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+/***********************************************************
+ *  LoadSceneTextures()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering
+ ***********************************************************/
+void SceneManager::LoadSceneTextures()
+{
+	bool bReturn = false;
+
+	for (int i = 0; i < GetSceneTextureCount(); i++)
+	{
+		// very large textures are streamed when their page file
+		// was built, otherwise they are loaded like the others
+		if ((g_SceneTextures[i].bVirtual == true) &&
+			(CreateVirtualTexture(g_SceneTextures[i].filename, g_SceneTextures[i].tag) == true))
+		{
+			continue;
+		}
+
+		bReturn = CreateGLTexture(
+			g_SceneTextures[i].filename,
+			g_SceneTextures[i].tag);
+		if (bReturn == false)
+		{
+			std::cout << "Could not load scene texture:" << g_SceneTextures[i].tag << std::endl;
+		}
+	}
+
+	// upload the packed atlas pages and register them like any
+	// other loaded texture so they get bound to texture slots
+	if (NULL != m_pTextureAtlas)
+	{
+		int pageCount = m_pTextureAtlas->BuildPages();
+		m_atlasFirstSlot = m_loadedTextures;
+		for (int i = 0; i < pageCount; i++)
+		{
+			m_textureIDs[m_loadedTextures].ID = m_pTextureAtlas->GetPageTexture(i);
+			m_textureIDs[m_loadedTextures].tag = "atlas" + std::to_string(i);
+			// the tiles of the page know whether they are translucent
+			m_textureIDs[m_loadedTextures].bTranslucent = false;
+			// the atlas pages are built in memory and cannot be reloaded
+			RegisterTextureResidency(m_loadedTextures, false);
+			m_loadedTextures++;
+		}
+	}
+
+	// after the texture image data is loaded into memory, the
+	// loaded textures need to be bound to texture slots - there
+	// are a total of 16 available slots for scene textures
+	BindGLTextures();
+	SetupVirtualTextures();
+}
+/***********************************************************
+ *  DefineObjectMaterials()
+ *
+ *  This method is used for configuring the various material
+ *  settings for all of the objects within the 3D scene.
+ ***********************************************************/
+void SceneManager::DefineObjectMaterials()
+
+{
+	OBJECT_MATERIAL furmaterial;
+	furmaterial.ambientColor = glm::vec3(.1f, .1f, .1f);
+	furmaterial.ambientStrength = 0.3f;
+	furmaterial.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	furmaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	furmaterial.shininess = 0.2;
+	furmaterial.tag = "fur";
+
+	m_objectMaterials.push_back(furmaterial);
+
+	OBJECT_MATERIAL wallmaterial;
+	wallmaterial.ambientColor = glm::vec3(.01f, .01f, .01f);
+	wallmaterial.ambientStrength = 0.1f;
+	wallmaterial.diffuseColor = glm::vec3(0.0f, 0.0f, 0.0f);
+	wallmaterial.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
+	wallmaterial.shininess = 0.1;
+	wallmaterial.tag = "wall";
+
+	m_objectMaterials.push_back(furmaterial);
+}
+/***********************************************************
+ *  SetupSceneLights()
+ *
+ *  This method is called to add and configure the light
+ *  sources for the 3D scene.  The lights are assigned to the
+ *  clusters of the view, so there can be many of them, and
+ *  only the first 4 are used when clustering is unsupported.
+ ***********************************************************/
+void SceneManager::SetupSceneLights()
+{
+	// this line of code is NEEDED for telling the shaders to render 
+	// the 3D scene with custom lighting - to use the default rendered 
+	// lighting then comment out the following line
+	m_pLighting->Create(m_pShaderManager->m_programID);
+	m_pLighting->ClearLights();
+	m_pShadowMaps->ClearLights();
+
+	// the two scene lights have no radius and reach everywhere,
+	// and they cast the shadows of the scene
+	ClusteredLighting::POINT_LIGHT light;
+	light.position = glm::vec3(0.0f, 3.0f, 20.0f);
+	light.radius = 0.0f;
+	light.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	light.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
+	light.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
+	light.focalStrength = 12.0f;
+	light.specularIntensity = 0.2f;
+	light.shadowIndex = m_pShadowMaps->AddLight(light.position);
+	m_pLighting->AddLight(light);
+
+	light.position = glm::vec3(-3.0f, 4.0f, 6.0f);
+	light.radius = 0.0f;
+	light.ambientColor = glm::vec3(0.01f, 0.01f, 0.01f);
+	light.diffuseColor = glm::vec3(0.5f, 0.5f, 0.5f);
+	light.specularColor = glm::vec3(0.2f, 0.2f, 0.2f);
+	light.focalStrength = 32.0f;
+	light.specularIntensity = 0.2f;
+	light.shadowIndex = m_pShadowMaps->AddLight(light.position);
+	m_pLighting->AddLight(light);
+}
+
+/***********************************************************
+ *  SetLightingEnabled()
+ *
+ *  This method is used for turning the custom lighting of
+ *  the scene, and the shadows of its lights, on or off.
+ ***********************************************************/
+void SceneManager::SetLightingEnabled(bool bEnabled)
+{
+	m_bUseLighting = bEnabled;
+	m_pShaderManager->setIntValue(g_UseLightingName, bEnabled);
+	m_pShadowMaps->SetEnabled(bEnabled);
+}
+
+/***********************************************************
+ *  SetShadowCaching()
+ *
+ *  This method is used for turning the caching of the static
+ *  shadow maps on or off, to measure what it saves.
+ ***********************************************************/
+void SceneManager::SetShadowCaching(bool bCaching)
+{
+	m_pShadowMaps->SetCaching(bCaching);
+}
+
+/***********************************************************
+ *  AddScatteredLights()
+ *
+ *  This method is used to add small colored point lights
+ *  over the desk, at positions that are the same on every
+ *  run, to measure the cost of many lights.
+ ***********************************************************/
+void SceneManager::AddScatteredLights(int count)
+{
+	// a fixed seed keeps the lights the same between runs
+	uint32_t seed = 12345;
+	auto random = [&seed]()
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return((float)(seed >> 8) / 16777216.0f);
+	};
+
+	for (int i = 0; i < count; i++)
+	{
+		ClusteredLighting::POINT_LIGHT light;
+		light.position = glm::vec3(
+			-14.0f + 28.0f * random(),
+			-1.5f + 7.5f * random(),
+			-14.0f + 28.0f * random());
+		light.radius = 3.0f + 4.0f * random();
+		glm::vec3 color = glm::vec3(0.3f + 0.7f * random(), 0.3f + 0.7f * random(), 0.3f + 0.7f * random());
+		light.ambientColor = glm::vec3(0.0f, 0.0f, 0.0f);
+		light.diffuseColor = color * 3.0f;
+		light.specularColor = color;
+		light.focalStrength = 16.0f;
+		light.specularIntensity = 0.5f;
+		light.shadowIndex = -1;
+		m_pLighting->AddLight(light);
+	}
+}
+
+/***********************************************************
+ *  UpdateLighting()
+ *
+ *  This method is used to assign the lights of the scene to
+ *  the clusters of the camera of the frame, once it has been
+ *  latched, and before the scene is drawn.
+ ***********************************************************/
+void SceneManager::UpdateLighting(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	float nearPlane,
+	float farPlane,
+	int viewportWidth,
+	int viewportHeight)
+{
+	PROFILE_CPU_SCOPE("UpdateLighting");
+
+	m_pLighting->Update(view, projection, nearPlane, farPlane, viewportWidth, viewportHeight);
+}
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void SceneManager::PrepareScene()
+{
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene
+	LoadSceneTextures();
+	DefineObjectMaterials();
+	SetupSceneLights();
+	m_basicMeshes->LoadPlaneMesh();
+	m_basicMeshes->LoadBoxMesh();
+	m_basicMeshes->LoadPrismMesh();
+	m_basicMeshes->LoadCylinderMesh();
+	m_basicMeshes->LoadTaperedCylinderMesh();
+	m_basicMeshes->LoadConeMesh();
+	m_basicMeshes->LoadSphereMesh();
+	m_basicMeshes->LoadTorusMesh();
+}
+
+/***********************************************************
+ *  UpdateScene()
+ *
+ *  This method is used for the work of a frame that does not
+ *  depend on the camera, like streaming in texture pages, so
+ *  it can be done before the camera is latched for the draws
+ ***********************************************************/
+void SceneManager::UpdateScene()
+{
+	// advance the frame that texture usage is recorded against
+	m_pResidencyManager->BeginFrame();
+
+	// reload the textures that the last frames used while they
+	// were shrunk or unloaded, before the draws are recorded
+	if (m_restoreCount > 0)
+	{
+		PROFILE_SCOPE("RestoreTextures");
+		RestoreQueuedTextures();
+	}
+
+	// stream in the virtual pages requested by the last feedback
+	if (NULL != m_pVirtualTextures)
+	{
+		PROFILE_SCOPE("VirtualTextureUpdate");
+		m_pVirtualTextures->Update();
+	}
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by 
+ *  transforming and drawing the basic 3D shapes
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	// the transient data of the frame is allocated from the other
+	// block of the arena, while the last frame's is kept
+	m_pFrameArena->BeginFrame();
+
+	// record the meshes of the frame once, for all of the passes,
+	// with room for as many draws as the last frame had
+	FrameVector<DRAW_ITEM> drawList((FrameArenaAllocator<DRAW_ITEM>(m_pFrameArena)));
+	drawList.reserve(m_drawList.size());
+	m_drawList.swap(drawList);
+	RenderSceneObjects();
+	SortDrawList();
+
+	// the shadow maps, the virtual texture feedback and the depth
+	// pre-pass render with their own OpenGL framebuffers and programs
+	bool bOpenGLPasses = m_pBackend->SupportsOpenGLPasses();
+
+	// the other backends do not read the camera and the lights
+	// from the OpenGL uniforms
+	if (bOpenGLPasses == false)
+	{
+		SubmitBackendView();
+	}
+
+	// the shadow maps are only used by the custom lighting
+	if ((bOpenGLPasses == true) && (m_bUseLighting == true) && (m_pShadowMaps->IsEnabled() == true))
+	{
+		RenderShadowMaps();
+	}
+
+	if ((bOpenGLPasses == true) && (NULL != m_pVirtualTextures))
+	{
+		// every few frames, the scene is first rendered into a small
+		// buffer that records the virtual pages that are visible
+		if (m_pVirtualTextures->BeginFeedbackPass() == true)
+		{
+			PROFILE_SCOPE("VirtualTextureFeedback");
+			m_pBackend->SetIntValue(g_VirtualFeedbackName, true);
+			m_pBackend->SetFloatValue(g_VirtualLodBiasName, m_pVirtualTextures->GetFeedbackLodBias());
+			DrawSceneObjects(DRAW_ALL, false);
+			m_pBackend->SetIntValue(g_VirtualFeedbackName, false);
+			m_pBackend->SetFloatValue(g_VirtualLodBiasName, 0.0f);
+			m_pVirtualTextures->EndFeedbackPass();
+		}
+	}
+
+	// the main pass only shades the fragments left visible by
+	// the depth pre-pass, when the frame draws one
+	DepthPrepass* pDepthPrepass = (bOpenGLPasses == true) ? m_pDepthPrepass : NULL;
+	if (NULL != pDepthPrepass)
+	{
+		if (pDepthPrepass->BeginFrame() == true)
+		{
+			DrawDepthPrepass();
+		}
+		pDepthPrepass->BeginMainPass();
+	}
+
+	// the opaque meshes are drawn without blending
+	{
+		PROFILE_SCOPE("OpaquePass");
+		m_pBackend->SetState(RenderBackend::STATE_BLEND, false);
+		DrawSceneObjects(DRAW_OPAQUE, false);
+	}
+
+	if (NULL != pDepthPrepass)
+	{
+		pDepthPrepass->EndMainPass();
+	}
+
+	// the transparent meshes are blended over them, and they are
+	// tested against the depth without hiding each other
+	{
+		PROFILE_SCOPE("TransparentPass");
+		m_pBackend->SetState(RenderBackend::STATE_BLEND, true);
+		m_pBackend->SetState(RenderBackend::STATE_DEPTH_WRITE, false);
+		DrawSceneObjects(DRAW_TRANSPARENT, false);
+		m_pBackend->SetState(RenderBackend::STATE_DEPTH_WRITE, true);
+	}
+
+	// shrink or unload the least recently used textures when
+	// the loaded textures exceed the GPU memory budget
+	{
+		PROFILE_SCOPE("EnforceTextureBudget");
+		EnforceTextureBudget();
+	}
+
+	m_pBackend->EndFrame();
+}
+
+/***********************************************************
+ *  RenderSceneObjects()
+ *
+ *  This method is used for transforming and recording all of
+ *  the basic 3D shapes of the scene into the draw list
+ ***********************************************************/
+void SceneManager::RenderSceneObjects()
+{
+	PROFILE_CPU_SCOPE("RenderSceneObjects");
+
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+	/*** Set needed transformations before drawing the basic mesh.  ***/
+	/*** This same ordering of code should be used for transforming ***/
+	/*** and drawing all the basic 3D shapes.						***/
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(15.0f, .5f, 15.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.0f, -2.0f, 0.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	SetShaderTexture("glass");
+	SetShaderMaterial("wall");
+	SetTextureUVScale(1, 1);
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_CYLINDER);
+	/****************************************************************/
+		/****************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(50.0f, 1.0f, 50.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.0f, 15.0f, -20.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	SetShaderTexture("wall");
+	SetShaderMaterial("wall");
+	SetTextureUVScale(1, 1);
+	SubmitMesh(MESH_PLANE);
+	/****************************************************************/
+	//This is for the floor
+// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(50.0f, 1.0f, 50.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.0f, -27.5f, 0.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	SetShaderTexture("floor");
+	SetTextureUVScale(1, 1);
+	SetShaderMaterial("wall");
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_PLANE);
+	RenderDolphin();
+	RenderLaptop();
+	RenderBook();
+	RenderHeadPhones();
+	/****************************************************************/
+		/****************************************************************/
+}
+void SceneManager::RenderDolphin() 
+{
+	PROFILE_CPU_SCOPE("RenderDolphin");
+
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+	// This cyclinder is going to be the main body of the dolphin.
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.0f, 5.0f, 2.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 45.0f;
+	ZrotationDegrees = 90.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(7.0f, 1.0f, 7.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// set the texture values 
+	SetShaderTexture("fur");
+	SetTextureUVScale(1, 1);
+	SetShaderMaterial("fur");
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_CYLINDER);
+
+	/****************************************************************/
+	// This tapered cyclinder is going to be the end of the dolphin
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.0f, 4.0f, 2.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 45.0f;
+	ZrotationDegrees = 270.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(7.0f, 1.0f, 7.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// set the texture values 
+	SetShaderTexture("fur");
+	SetTextureUVScale(1, 1);
+	SetShaderMaterial("fur");
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_TAPERED_CYLINDER);
+
+	/****************************************************************/
+	// This Sphere is for the head of the dolphin
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.0f, 2.0f, 2.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(3.0f, 1.0f, 11.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// set the texture values 
+	SetShaderTexture("fur");
+	SetTextureUVScale(1, 1);
+	SetShaderMaterial("fur");
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_SPHERE);
+
+	/****************************************************************/
+	// This Cone is going to be the snout of the dolphin
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.0f, 2.0f, 1.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 45.0f;
+	ZrotationDegrees = 100.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(2.f, 0.5f, 12.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// set the texture values 
+	SetShaderTexture("fur");
+	SetTextureUVScale(1, 1);
+	SetShaderMaterial("fur");
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_CONE);
+
+	/****************************************************************/
+	// This Sphere is going to round out the tail area of the dolphin
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.9f, 0.9f, 0.9f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(9.95f, 1.05f, 4.25f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// set the texture values 
+	SetShaderTexture("fur");
+	SetTextureUVScale(1, 1);
+	SetShaderMaterial("fur");
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_SPHERE);
+
+	/****************************************************************/
+	// This Prism is going to be the top fin of the dolphin
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.0f, .25f, 1.5f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = -90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 45.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(5.0f, 3.5f, 9.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// set the texture values 
+	SetShaderTexture("fur");
+	SetTextureUVScale(1, 1);
+	SetShaderMaterial("fur");
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_PRISM);
+
+	/****************************************************************/
+	// This Prism is going to be the left fin of the dolphin
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.0f, 0.5f, 2.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 15.0f;
+	YrotationDegrees = 25.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(6.0f, 0.0f, 11.5f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// set the texture values 
+	SetShaderTexture("fur");
+	SetTextureUVScale(1, 1);
+	SetShaderMaterial("fur");
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_PRISM);
+
+	/****************************************************************/
+	// This Prism is going to be the tail fins of the dolphin
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.0f, .5f, 2.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 10.0f;
+	YrotationDegrees = -45.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(10.8f, 1.0f, 4.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// set the texture values 
+	SetShaderTexture("fur");
+	SetShaderMaterial("fur");
+	SetTextureUVScale(1, 1);
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_PRISM);
+
+	/****************************************************************/
+	// This Sphere is going to be the left eye of the dolphin
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(.25f, .45f, .25f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(3.25f, 1.60f, 13.15f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// set the texture values 
+	SetShaderTexture("black");
+	SetShaderMaterial("fur");
+	SetTextureUVScale(1, 1);
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_SPHERE);
+	/****************************************************************/
+	// This Sphere is going to be the left eye of the dolphin
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(.25f, .45f, .25f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(1.25f, 1.60f, 11.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// set the texture values 
+	SetShaderTexture("black");
+	SetShaderMaterial("fur");
+	SetTextureUVScale(1, 1);
+
+	// draw the mesh with transformation values
+	SubmitMesh(MESH_SPHERE);
+}
+
+void SceneManager::RenderLaptop() 
+{
+	PROFILE_CPU_SCOPE("RenderLaptop");
+
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+	/****************************************************************/
+	// This Cube is going to be the bottom part of the laptop
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(10.25f, .2f, 8.25f);
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 5.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-.5f, 0.0f, 4.0f);
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	SetShaderTexture("keyboard");
+	SetTextureUVScale(1, 1);
+	SubmitMesh(MESH_BOX);
+	/****************************************************************/
+	// This box is for the screen
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(10.25f, .2f, 8.25f);
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-.5f, 3.0f, -.5f);
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	SetShaderTexture("screen");
+	SetTextureUVScale(1, 1);
+	SubmitMesh(MESH_BOX);
+}	
+
+void SceneManager::RenderBook()
+{
+	PROFILE_CPU_SCOPE("RenderBook");
+
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+	/****************************************************************/
+	// This box is for the book
+	scaleXYZ = glm::vec3(7.0f, 1.5f, 5.0f);
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = -20.0f;
+	ZrotationDegrees = 0.0f;
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-5.5f, 0.0f, 9.75f);
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	SetShaderTexture("book");
+	SetTextureUVScale(1, 1);
+	SubmitMesh(MESH_BOX);
+	/****************************************************************/
+	// This box is for the pages
+	scaleXYZ = glm::vec3(6.8f, 1.3f, 4.8f);
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = -20.0f;
+	ZrotationDegrees = 0.0f;
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-5.375f, 0.0f, 9.75f);
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	SetShaderTexture("pages");
+	SetTextureUVScale(1, 1);
+	SubmitMesh(MESH_BOX);
+}
+
+void SceneManager::RenderHeadPhones() 
+{
+	PROFILE_CPU_SCOPE("RenderHeadPhones");
+
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+	/****************************************************************/
+	// This torus is for the top part of the headphones
+	scaleXYZ = glm::vec3(2.5f, 2.5f, 1.5f);
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-5.375f, 1.0f, 9.75f);
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	SetShaderTexture("black");
+	SetTextureUVScale(1, 1);
+	SubmitMesh(MESH_TORUS);
+	/****************************************************************/
+	// This tapered cylinder is for the right part of the headphones
+	scaleXYZ = glm::vec3(1.65f, .75f, 1.65f);
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-3.75f, .8f, 11.5f);
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	SetShaderTexture("headphones");
+	SetTextureUVScale(1, 1);
+	SubmitMesh(MESH_TAPERED_CYLINDER);
+	/****************************************************************/
+	// This tapered cylinder is for the left part of the headphones
+	scaleXYZ = glm::vec3(1.65f, .75f, 1.65f);
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-3.0f, .8f, 9.75f);
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+	SetShaderTexture("headphones");
+	SetTextureUVScale(1, 1);
+	SubmitMesh(MESH_TAPERED_CYLINDER);
 }
\ No newline at end of file
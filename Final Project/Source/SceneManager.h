@@ -1,121 +1,338 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.h
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager *pShaderManager);
-	// destructor
-	~SceneManager();
-
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	struct OBJECT_MATERIAL
-	{
-		float ambientStrength;
-		glm::vec3 ambientColor;
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
-	void BindGLTextures();
-	// free the loaded OpenGL textures
-	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	// set the UV scale for the texture mapping
-	void SetTextureUVScale(
-		float u, float v);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-public:
-
-	void LoadSceneTextures();
-
-	void DefineObjectMaterials();
-
-	void SetupSceneLights();
-
-	// The following methods are for the students to 
-	// customize for their own 3D scene
-	void PrepareScene();
-	void RenderScene();
-
-	void RenderDolphin();
-
-	void RenderLaptop();
-
-	void RenderBook();
-
-	void RenderHeadPhones();
-
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.h
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "ShapeMeshes.h"
+#include "TextureAtlas.h"
+#include "ResidencyManager.h"
+#include "VirtualTextureSystem.h"
+#include "ClusteredLighting.h"
+#include "ShadowMaps.h"
+#include "DepthPrepass.h"
+#include "GLRenderBackend.h"
+#include "FrameArena.h"
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor
+	SceneManager(ShaderManager *pShaderManager);
+	// destructor
+	~SceneManager();
+
+	struct TEXTURE_INFO
+	{
+		std::string tag;
+		uint32_t ID;
+		std::string filename;
+		int residencyHandle;
+		// whether the image has pixels that are not fully opaque
+		bool bTranslucent;
+		// whether the texture waits to be reloaded at full size
+		bool bRestoreQueued;
+	};
+
+	struct OBJECT_MATERIAL
+	{
+		float ambientStrength;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		std::string tag;
+	};
+
+	struct SCENE_TEXTURE
+	{
+		const char* filename;
+		const char* tag;
+		// very large textures are streamed as virtual textures
+		bool bVirtual;
+	};
+
+	// basic meshes that the scene objects are drawn with
+	enum MESH_TYPE
+	{
+		MESH_BOX = RenderBackend::SHAPE_BOX,
+		MESH_CONE = RenderBackend::SHAPE_CONE,
+		MESH_CYLINDER = RenderBackend::SHAPE_CYLINDER,
+		MESH_PLANE = RenderBackend::SHAPE_PLANE,
+		MESH_PRISM = RenderBackend::SHAPE_PRISM,
+		MESH_SPHERE = RenderBackend::SHAPE_SPHERE,
+		MESH_TAPERED_CYLINDER = RenderBackend::SHAPE_TAPERED_CYLINDER,
+		MESH_TORUS = RenderBackend::SHAPE_TORUS
+	};
+
+	// a mesh recorded with the shader settings it is drawn with
+	struct DRAW_ITEM
+	{
+		MESH_TYPE mesh;
+		glm::mat4 model;
+		glm::vec4 color;
+		bool bUseTexture;
+		// texture slot, and virtual texture index or -1
+		int textureSlot;
+		int virtualTexture;
+		glm::vec2 uvScale;
+		glm::vec2 uvOffset;
+		// defined material index, or -1 to keep the last material
+		int material;
+		// moving objects are drawn into the shadow maps every frame
+		bool bDynamic;
+		// blended objects are drawn after the opaque ones
+		bool bTransparent;
+		// distance in front of the camera that the draws are sorted by
+		float viewDepth;
+	};
+
+	// the recorded draws that a pass draws
+	enum DRAW_FILTER
+	{
+		DRAW_ALL,
+		DRAW_STATIC,
+		DRAW_DYNAMIC,
+		DRAW_OPAQUE,
+		DRAW_TRANSPARENT
+	};
+
+	// get the image files that are loaded for the 3D scene
+	static int GetSceneTextureCount();
+	static const SCENE_TEXTURE& GetSceneTexture(int index);
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to basic shapes object
+	ShapeMeshes* m_basicMeshes;
+	// backend that the frames are submitted through, which is the
+	// OpenGL backend unless another one was set
+	GLRenderBackend* m_pGLBackend;
+	RenderBackend* m_pBackend;
+	// texture slot of the copy of the first virtual texture for the
+	// backends without virtual texturing, or -1
+	int m_backendVirtualFirstSlot;
+	// total number of loaded textures
+	int m_loadedTextures;
+	// loaded textures info
+	TEXTURE_INFO m_textureIDs[16];
+	// slots of the textures that are reloaded in the next frames,
+	// in the order that they were used
+	int m_restoreQueue[16];
+	int m_restoreCount;
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// atlas that small textures are packed into
+	TextureAtlas* m_pTextureAtlas;
+	// texture slot of the first atlas page
+	int m_atlasFirstSlot;
+	// atlas tile of the current shader texture, if any
+	const TextureAtlas::ATLAS_TILE* m_pCurrentTile;
+	// current UV scale requested for the texture mapping
+	glm::vec2 m_textureUVScale;
+	// GPU memory accounting and eviction for the loaded textures
+	ResidencyManager* m_pResidencyManager;
+	// evictions picked for the frame, kept to reuse their memory
+	std::vector<ResidencyManager::EVICTION> m_evictions;
+	// streaming of the pages of the very large textures
+	VirtualTextureSystem* m_pVirtualTextures;
+	// point lights of the scene and their assignment to clusters
+	ClusteredLighting* m_pLighting;
+	// cached shadow maps of the scene lights
+	ShadowMaps* m_pShadowMaps;
+	// whether the scene is rendered with the custom lighting
+	bool m_bUseLighting;
+	// blocks of memory that the transient data of a frame, like
+	// the draw list and its sort keys, is allocated from
+	FrameArena* m_pFrameArena;
+	// meshes recorded for the current frame, and the shader
+	// settings that the next recorded mesh is drawn with
+	FrameVector<DRAW_ITEM> m_drawList;
+	DRAW_ITEM m_currentDraw;
+	// whether the current shader texture has translucent pixels
+	bool m_bCurrentTextureTranslucent;
+	// optional depth pre-pass before the main pass
+	DepthPrepass* m_pDepthPrepass;
+	// camera matrices of the frame
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+
+	// load texture images and convert to OpenGL texture data
+	bool CreateGLTexture(const char* filename, std::string tag);
+	// load an image file into a new OpenGL texture
+	bool LoadGLTexture(const char* filename, GLuint& textureID, bool& bTranslucent);
+	// load an offline cooked, block-compressed texture
+	bool LoadCookedGLTexture(const char* filename, GLuint& textureID, bool& bTranslucent);
+	// open the page file of an image as a virtual texture
+	bool CreateVirtualTexture(const char* filename, std::string tag);
+	// set the shader parameters shared by all virtual textures
+	void SetupVirtualTextures();
+	// pack a small texture into the texture atlas
+	bool AddTextureToAtlas(const char* filename, std::string tag);
+	// bind loaded OpenGL textures to slots in memory
+	void BindGLTextures();
+	// free the loaded OpenGL textures
+	void DestroyGLTextures();
+	// get the GPU memory used by a loaded texture
+	size_t GetGLTextureBytes(GLuint textureID);
+	// add a loaded texture to the GPU memory accounting
+	void RegisterTextureResidency(int slot, bool bEvictable);
+	// bind the texture of a slot after it was replaced
+	void RebindGLTexture(int slot);
+	// release the most detailed mip level of a texture
+	bool DropTextureMip(int slot);
+	// release all of the memory of a texture
+	void UnloadTexture(int slot);
+	// reload a shrunk or unloaded texture at full resolution
+	bool RestoreTexture(int slot);
+	// mark a texture as used by the current frame
+	void TouchTexture(int slot);
+	// reload the textures that the last frames used while shrunk
+	void RestoreQueuedTextures();
+	// evict textures until the budget is met
+	void EnforceTextureBudget();
+	// find a loaded texture by tag
+	int FindTextureID(std::string tag);
+	// the overloads for the tags of the draws do not copy them
+	// into strings, which could allocate every frame
+	int FindTextureSlot(std::string tag);
+	int FindTextureSlot(const char* tag);
+	// find a defined material by tag
+	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+	bool FindMaterial(const char* tag, OBJECT_MATERIAL& material);
+	int FindMaterialIndex(const char* tag);
+
+	// set the transformation values 
+	// into the transform buffer
+	void SetTransformations(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set the color values into the shader
+	void SetShaderColor(
+		float redColorValue,
+		float greenColorValue,
+		float blueColorValue,
+		float alphaValue);
+
+	// set the texture data into the shader
+	void SetShaderTexture(
+		std::string textureTag);
+	void SetShaderTexture(
+		const char* textureTag);
+
+	// set the UV scale for the texture mapping
+	void SetTextureUVScale(
+		float u, float v);
+
+	// set a virtual texture into the shader
+	void SetShaderVirtualTexture(int index);
+
+	// set the object material into the shader
+	void SetShaderMaterial(
+		std::string materialTag);
+	void SetShaderMaterial(
+		const char* materialTag);
+
+	// mark the next recorded meshes as moving objects
+	void SetObjectDynamic(bool bDynamic);
+
+	// record a mesh with the current shader settings
+	void SubmitMesh(MESH_TYPE mesh);
+	// sort the opaque draws front to back and the transparent
+	// draws back to front after them
+	void SortDrawList();
+	// draw the recorded meshes of a pass
+	void DrawSceneObjects(DRAW_FILTER filter, bool bDepthOnly);
+	// set the shader settings that differ from the last draw
+	void ApplyDrawSettings(const DRAW_ITEM& item, const DRAW_ITEM* pLastItem);
+	void DrawMesh(MESH_TYPE mesh);
+	// get the texture slot that the backend samples for a draw
+	int GetBackendTextureSlot(const DRAW_ITEM& item) const;
+	// copy the loaded textures into a backend that does not draw
+	// with OpenGL
+	void UploadBackendTextures();
+	// pass the camera and the lights to a backend that does not
+	// read them from the OpenGL uniforms
+	void SubmitBackendView();
+	// get a hash of the static draws to detect their changes
+	uint64_t HashStaticDraws() const;
+	// bring the shadow maps up to date with the scene
+	void RenderShadowMaps();
+	// draw the depth of the recorded meshes before the main pass
+	void DrawDepthPrepass();
+
+public:
+
+	void LoadSceneTextures();
+
+	void DefineObjectMaterials();
+
+	void SetupSceneLights();
+	// render the scene with the custom lighting and shadows
+	void SetLightingEnabled(bool bEnabled);
+	// render the static shadow maps again every frame
+	void SetShadowCaching(bool bCaching);
+	// add small colored lights around the desk to stress the lighting
+	void AddScatteredLights(int count);
+	// assign the lights to the clusters of the latched camera
+	void UpdateLighting(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		float nearPlane,
+		float farPlane,
+		int viewportWidth,
+		int viewportHeight);
+
+	// set the camera matrices that the frame is drawn with
+	void SetViewCamera(const glm::mat4& view, const glm::mat4& projection);
+	// set the depth pre-pass that the main pass is drawn after
+	void SetDepthPrepass(DepthPrepass* pDepthPrepass);
+	// submit the frames through another backend, or through the
+	// OpenGL backend again when NULL
+	void SetRenderBackend(RenderBackend* pBackend);
+
+	// set the GPU memory budget for the scene textures
+	void SetTextureBudget(size_t budgetBytes);
+	// get the GPU memory used by the loaded scene textures
+	size_t GetResidentTextureBytes();
+	// get the arena that the transient data of the frames is
+	// allocated from
+	FrameArena* GetFrameArena();
+
+	// The following methods are for the students to 
+	// customize for their own 3D scene
+	void PrepareScene();
+	// stream the textures of the frame before the camera is latched
+	void UpdateScene();
+	void RenderScene();
+	void RenderSceneObjects();
+
+	void RenderDolphin();
+
+	void RenderLaptop();
+
+	void RenderBook();
+
+	void RenderHeadPhones();
+
 };
\ No newline at end of file
@@ -0,0 +1,416 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.cpp
+// ============
+// cache the shadow maps of the point lights for the static scene
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShadowMaps.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	const char* g_ShadowPassName = "bShadowPass";
+	const char* g_UseShadowsName = "bUseShadows";
+	const char* g_ShadowViewProjectionName = "shadowViewProjection";
+	const char* g_ShadowNearPlaneName = "shadowNearPlane";
+	const char* g_ShadowFarPlaneName = "shadowFarPlane";
+	const char* g_ShadowMapNames[] = { "shadowMap0", "shadowMap1" };
+
+	// depth range of the shadow maps
+	const float g_ShadowNearPlane = 0.1f;
+	const float g_ShadowFarPlane = 100.0f;
+
+	// view direction and up vector of every face of a cube map
+	const glm::vec3 g_FaceDirections[6] =
+	{
+		glm::vec3(1.0f, 0.0f, 0.0f),
+		glm::vec3(-1.0f, 0.0f, 0.0f),
+		glm::vec3(0.0f, 1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, 0.0f, 1.0f),
+		glm::vec3(0.0f, 0.0f, -1.0f)
+	};
+	const glm::vec3 g_FaceUps[6] =
+	{
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, 0.0f, 1.0f),
+		glm::vec3(0.0f, 0.0f, -1.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f)
+	};
+}
+
+/***********************************************************
+ *  ShadowMaps()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShadowMaps::ShadowMaps(ShaderManager* pShaderManager, int firstTextureUnit)
+{
+	m_pShaderManager = pShaderManager;
+	m_firstTextureUnit = firstTextureUnit;
+	for (int i = 0; i < MAX_LIGHTS; i++)
+	{
+		m_lights[i].position = glm::vec3(0.0f);
+		m_lights[i].staticMap = 0;
+		m_lights[i].dynamicMap = 0;
+		m_lights[i].bStaticValid = false;
+		m_lights[i].staticPosition = glm::vec3(0.0f);
+		m_lights[i].staticSceneHash = 0;
+	}
+	m_lightCount = 0;
+	m_bCaching = true;
+	m_bEnabled = false;
+	m_bFramebufferComplete = true;
+	m_staticRenderCount = 0;
+	m_drawFramebuffer = 0;
+	m_readFramebuffer = 0;
+	m_savedFramebuffer = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		m_savedViewport[i] = 0;
+	}
+}
+
+/***********************************************************
+ *  ~ShadowMaps()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShadowMaps::~ShadowMaps()
+{
+	ClearLights();
+
+	if (m_drawFramebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_drawFramebuffer);
+		glDeleteFramebuffers(1, &m_readFramebuffer);
+		m_drawFramebuffer = 0;
+		m_readFramebuffer = 0;
+	}
+	m_pShaderManager = NULL;
+}
+
+/***********************************************************
+ *  AddLight()
+ *
+ *  This method is used to add a shadow casting light and
+ *  create its maps.  The shader samplers of all the maps are
+ *  pointed at their own texture units, even when unused, so
+ *  no two sampler types ever share a unit.
+ ***********************************************************/
+int ShadowMaps::AddLight(const glm::vec3& position)
+{
+	if (m_lightCount >= MAX_LIGHTS)
+	{
+		return(-1);
+	}
+
+	if (m_drawFramebuffer == 0)
+	{
+		// the shadow framebuffers have no color attachments
+		GLint savedFramebuffer = 0;
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &savedFramebuffer);
+		glGenFramebuffers(1, &m_drawFramebuffer);
+		glGenFramebuffers(1, &m_readFramebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_drawFramebuffer);
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_readFramebuffer);
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+		glBindFramebuffer(GL_FRAMEBUFFER, savedFramebuffer);
+
+		for (int i = 0; i < MAX_LIGHTS; i++)
+		{
+			m_pShaderManager->setSampler2DValue(g_ShadowMapNames[i], m_firstTextureUnit + i);
+		}
+		m_pShaderManager->setFloatValue(g_ShadowNearPlaneName, g_ShadowNearPlane);
+		m_pShaderManager->setFloatValue(g_ShadowFarPlaneName, g_ShadowFarPlane);
+	}
+
+	SHADOW_LIGHT& light = m_lights[m_lightCount];
+	light.position = position;
+	light.staticMap = CreateMap();
+	light.dynamicMap = CreateMap();
+	light.bStaticValid = false;
+	light.staticSceneHash = 0;
+
+	// the framebuffer is checked once instead of for every face
+	// that is drawn, and the shadows stay off when it cannot be
+	// drawn into
+	if (m_lightCount == 0)
+	{
+		GLint savedFramebuffer = 0;
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &savedFramebuffer);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_drawFramebuffer);
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X, light.staticMap, 0);
+		m_bFramebufferComplete = (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, savedFramebuffer);
+		if (m_bFramebufferComplete == false)
+		{
+			std::cout << "Shadow map framebuffer is incomplete, the shadows are turned off" << std::endl;
+			SetEnabled(false);
+		}
+	}
+
+	return(m_lightCount++);
+}
+
+/***********************************************************
+ *  SetLightPosition()
+ *
+ *  This method is used to move a shadow casting light.  Its
+ *  static map is rendered again once it has moved.
+ ***********************************************************/
+void ShadowMaps::SetLightPosition(int index, const glm::vec3& position)
+{
+	if ((index < 0) || (index >= m_lightCount))
+	{
+		return;
+	}
+
+	m_lights[index].position = position;
+}
+
+/***********************************************************
+ *  ClearLights()
+ *
+ *  This method is used to remove the shadow casting lights
+ *  and free their maps.
+ ***********************************************************/
+void ShadowMaps::ClearLights()
+{
+	for (int i = 0; i < m_lightCount; i++)
+	{
+		glDeleteTextures(1, &m_lights[i].staticMap);
+		glDeleteTextures(1, &m_lights[i].dynamicMap);
+		m_lights[i].staticMap = 0;
+		m_lights[i].dynamicMap = 0;
+		m_lights[i].bStaticValid = false;
+	}
+	m_lightCount = 0;
+}
+
+/***********************************************************
+ *  GetLightCount()
+ *
+ *  This method is used to get the number of shadow casting
+ *  lights.
+ ***********************************************************/
+int ShadowMaps::GetLightCount() const
+{
+	return(m_lightCount);
+}
+
+/***********************************************************
+ *  SetCaching()
+ *
+ *  This method is used to turn the caching of the static
+ *  maps on or off.  Without it, every map is rendered again
+ *  every frame, which shows what the caching saves.
+ ***********************************************************/
+void ShadowMaps::SetCaching(bool bCaching)
+{
+	m_bCaching = bCaching;
+}
+
+/***********************************************************
+ *  SetEnabled()
+ *
+ *  This method is used to turn the shadows in the lighting
+ *  of the shader on or off.  They cannot be turned on when
+ *  the maps cannot be drawn into.
+ ***********************************************************/
+void ShadowMaps::SetEnabled(bool bEnabled)
+{
+	m_bEnabled = (bEnabled == true) && (m_bFramebufferComplete == true);
+	m_pShaderManager->setIntValue(g_UseShadowsName, m_bEnabled);
+}
+
+/***********************************************************
+ *  IsEnabled()
+ *
+ *  This method is used to check whether the shadows are on.
+ ***********************************************************/
+bool ShadowMaps::IsEnabled() const
+{
+	return(m_bEnabled);
+}
+
+/***********************************************************
+ *  IsStaticMapValid()
+ *
+ *  This method is used to check whether the static map of a
+ *  light was rendered for its current position and for the
+ *  current static scene.
+ ***********************************************************/
+bool ShadowMaps::IsStaticMapValid(int index, uint64_t staticSceneHash) const
+{
+	const SHADOW_LIGHT& light = m_lights[index];
+
+	return((m_bCaching == true) &&
+		(light.bStaticValid == true) &&
+		(light.staticPosition == light.position) &&
+		(light.staticSceneHash == staticSceneHash));
+}
+
+/***********************************************************
+ *  BeginPasses()
+ *
+ *  This method is used to save the framebuffer and viewport
+ *  of the scene and switch the shader to the shadow pass,
+ *  which only writes the depth seen from the light.
+ ***********************************************************/
+void ShadowMaps::BeginPasses()
+{
+	glGetIntegerv(GL_VIEWPORT, m_savedViewport);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_savedFramebuffer);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_drawFramebuffer);
+	glViewport(0, 0, MAP_SIZE, MAP_SIZE);
+	m_pShaderManager->setIntValue(g_ShadowPassName, true);
+}
+
+/***********************************************************
+ *  EndPasses()
+ *
+ *  This method is used to restore the framebuffer and the
+ *  viewport of the scene and bind the maps for its lighting.
+ *  Without dynamic objects, the static maps are sampled.
+ ***********************************************************/
+void ShadowMaps::EndPasses(bool bDynamic)
+{
+	m_pShaderManager->setIntValue(g_ShadowPassName, false);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_savedFramebuffer);
+	glViewport(m_savedViewport[0], m_savedViewport[1], m_savedViewport[2], m_savedViewport[3]);
+
+	BindMaps(bDynamic);
+}
+
+/***********************************************************
+ *  BeginStaticFace()
+ *
+ *  This method is used to clear a face of the static map of
+ *  a light before the static objects are drawn into it.
+ ***********************************************************/
+void ShadowMaps::BeginStaticFace(int index, int face)
+{
+	BeginFace(m_lights[index].staticMap, index, face);
+
+	const GLfloat clearDepth = 1.0f;
+	glClearBufferfv(GL_DEPTH, 0, &clearDepth);
+}
+
+/***********************************************************
+ *  EndStaticMap()
+ *
+ *  This method is used to remember the light position and
+ *  the static scene that the static map was rendered for.
+ ***********************************************************/
+void ShadowMaps::EndStaticMap(int index, uint64_t staticSceneHash)
+{
+	SHADOW_LIGHT& light = m_lights[index];
+	light.bStaticValid = true;
+	light.staticPosition = light.position;
+	light.staticSceneHash = staticSceneHash;
+	m_staticRenderCount++;
+}
+
+/***********************************************************
+ *  BeginDynamicFace()
+ *
+ *  This method is used to copy a face of the static map of a
+ *  light into its dynamic map, before the dynamic objects
+ *  are drawn on top of it.
+ ***********************************************************/
+void ShadowMaps::BeginDynamicFace(int index, int face)
+{
+	const SHADOW_LIGHT& light = m_lights[index];
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_readFramebuffer);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, light.staticMap, 0);
+	BeginFace(light.dynamicMap, index, face);
+	glBlitFramebuffer(0, 0, MAP_SIZE, MAP_SIZE, 0, 0, MAP_SIZE, MAP_SIZE, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
+
+/***********************************************************
+ *  GetStaticRenderCount()
+ *
+ *  This method is used to get the number of times that a
+ *  static map was rendered.
+ ***********************************************************/
+int ShadowMaps::GetStaticRenderCount() const
+{
+	return(m_staticRenderCount);
+}
+
+/***********************************************************
+ *  CreateMap()
+ *
+ *  This method is used to create a depth cube map.  The
+ *  shader compares against it with the depth of the fragment
+ *  in the face, so the lookups are filtered by the hardware.
+ ***********************************************************/
+GLuint ShadowMaps::CreateMap()
+{
+	GLuint map = 0;
+	glGenTextures(1, &map);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, map);
+	for (int face = 0; face < 6; face++)
+	{
+		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_DEPTH_COMPONENT24, MAP_SIZE, MAP_SIZE, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	}
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+	return(map);
+}
+
+/***********************************************************
+ *  BeginFace()
+ *
+ *  This method is used to attach a face of a map to the
+ *  draw framebuffer, and to set the matrix that looks from
+ *  the light through the face.
+ ***********************************************************/
+void ShadowMaps::BeginFace(GLuint map, int index, int face)
+{
+	const glm::vec3& position = m_lights[index].position;
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_drawFramebuffer);
+	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, map, 0);
+
+	glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, g_ShadowNearPlane, g_ShadowFarPlane);
+	glm::mat4 view = glm::lookAt(position, position + g_FaceDirections[face], g_FaceUps[face]);
+
+	m_pShaderManager->setMat4Value(g_ShadowViewProjectionName, projection * view);
+}
+
+/***********************************************************
+ *  BindMaps()
+ *
+ *  This method is used to bind the maps of the lights to
+ *  the texture units that the shader samples them from.
+ ***********************************************************/
+void ShadowMaps::BindMaps(bool bDynamic)
+{
+	for (int i = 0; i < m_lightCount; i++)
+	{
+		glActiveTexture(GL_TEXTURE0 + m_firstTextureUnit + i);
+		glBindTexture(GL_TEXTURE_CUBE_MAP, (bDynamic == true) ? m_lights[i].dynamicMap : m_lights[i].staticMap);
+	}
+}
@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.h
+// ============
+// cache the shadow maps of the point lights for the static scene
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+
+#include <GL/glew.h>
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+/***********************************************************
+ *  ShadowMaps
+ *
+ *  This class contains the depth cube maps that the point
+ *  lights cast their shadows with.  Every light has a static
+ *  map that holds the distance to the static scene, and it
+ *  is only rendered again when the light moves or the static
+ *  objects change, which is detected with a hash of their
+ *  draws.  When the scene has dynamic objects, the static
+ *  map is copied into a second map every frame and only the
+ *  dynamic objects are drawn on top of the copy.
+ ***********************************************************/
+class ShadowMaps
+{
+public:
+	// constructor
+	ShadowMaps(ShaderManager* pShaderManager, int firstTextureUnit);
+	// destructor
+	~ShadowMaps();
+
+	// number of lights that can cast shadows
+	static const int MAX_LIGHTS = 2;
+
+	// add a shadow casting light, or -1 when there is no map left
+	int AddLight(const glm::vec3& position);
+	void SetLightPosition(int index, const glm::vec3& position);
+	void ClearLights();
+	int GetLightCount() const;
+
+	// render the static maps every frame, to measure the savings
+	void SetCaching(bool bCaching);
+	// turn the shadows in the lighting on or off
+	void SetEnabled(bool bEnabled);
+	bool IsEnabled() const;
+
+	// check whether the static map of a light is still current
+	bool IsStaticMapValid(int index, uint64_t staticSceneHash) const;
+
+	// switch the shader to the shadow pass and back
+	void BeginPasses();
+	void EndPasses(bool bDynamic);
+
+	// select a face of a map for the draws of the shadow pass
+	void BeginStaticFace(int index, int face);
+	void EndStaticMap(int index, uint64_t staticSceneHash);
+	void BeginDynamicFace(int index, int face);
+
+	// get the number of static maps that were rendered
+	int GetStaticRenderCount() const;
+
+private:
+	// size of a face of the cube maps
+	static const int MAP_SIZE = 1024;
+
+	struct SHADOW_LIGHT
+	{
+		glm::vec3 position;
+		// depth of the static scene, and of the whole scene
+		GLuint staticMap;
+		GLuint dynamicMap;
+		// position and scene that the static map was rendered for
+		bool bStaticValid;
+		glm::vec3 staticPosition;
+		uint64_t staticSceneHash;
+	};
+
+	ShaderManager* m_pShaderManager;
+	int m_firstTextureUnit;
+	SHADOW_LIGHT m_lights[MAX_LIGHTS];
+	int m_lightCount;
+	bool m_bCaching;
+	bool m_bEnabled;
+	// whether a face of a map can be drawn into, which is checked
+	// once for the first map, since all of them are alike
+	bool m_bFramebufferComplete;
+	int m_staticRenderCount;
+
+	// framebuffers that the faces are drawn into and copied from
+	GLuint m_drawFramebuffer;
+	GLuint m_readFramebuffer;
+	// framebuffer and viewport restored after the passes
+	GLint m_savedFramebuffer;
+	GLint m_savedViewport[4];
+
+	// create a depth cube map
+	GLuint CreateMap();
+	// attach a face of a map and set the matrices of the face
+	void BeginFace(GLuint map, int index, int face);
+	// bind the maps that the lighting samples
+	void BindMaps(bool bDynamic);
+};
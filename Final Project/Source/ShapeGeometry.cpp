@@ -0,0 +1,342 @@
+///////////////////////////////////////////////////////////////////////////////
+// shapegeometry.cpp
+// ============
+// build the vertices of the basic shape meshes in memory
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShapeGeometry.h"
+
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	const float g_Pi = 3.14159265358979f;
+
+	// radii of the tapered cylinder, and of the tube of the torus
+	const float g_TaperedTopRadius = 0.5f;
+	const float g_TorusThickness = 0.2f;
+
+	// fewest segments around the round shapes
+	const int g_MinSegments = 4;
+}
+
+/***********************************************************
+ *  ShapeGeometry()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShapeGeometry::ShapeGeometry()
+{
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used to build the triangles of a shape,
+ *  replacing the ones of the last built shape.
+ ***********************************************************/
+void ShapeGeometry::Build(RenderBackend::SHAPE_MESH shape, int segments)
+{
+	m_vertices.clear();
+	m_indices.clear();
+
+	segments = (segments > g_MinSegments) ? segments : g_MinSegments;
+
+	switch (shape)
+	{
+	case RenderBackend::SHAPE_BOX:
+		BuildBox();
+		break;
+	case RenderBackend::SHAPE_CONE:
+		BuildRound(1.0f, 0.0f, segments);
+		break;
+	case RenderBackend::SHAPE_CYLINDER:
+		BuildRound(1.0f, 1.0f, segments);
+		break;
+	case RenderBackend::SHAPE_PLANE:
+		BuildPlane();
+		break;
+	case RenderBackend::SHAPE_PRISM:
+		BuildPrism();
+		break;
+	case RenderBackend::SHAPE_SPHERE:
+		BuildSphere(segments);
+		break;
+	case RenderBackend::SHAPE_TAPERED_CYLINDER:
+		BuildRound(1.0f, g_TaperedTopRadius, segments);
+		break;
+	case RenderBackend::SHAPE_TORUS:
+		BuildTorus(segments);
+		break;
+	default:
+		break;
+	}
+}
+
+/***********************************************************
+ *  GetVertices()
+ *
+ *  This method is used to get the vertices of the last
+ *  built shape.
+ ***********************************************************/
+const std::vector<ShapeGeometry::VERTEX>& ShapeGeometry::GetVertices() const
+{
+	return(m_vertices);
+}
+
+/***********************************************************
+ *  GetIndices()
+ *
+ *  This method is used to get the vertex indices of the
+ *  triangles of the last built shape.
+ ***********************************************************/
+const std::vector<uint32_t>& ShapeGeometry::GetIndices() const
+{
+	return(m_indices);
+}
+
+/***********************************************************
+ *  AddVertex()
+ *
+ *  This method is used to add a vertex to the shape, and
+ *  returns its index.
+ ***********************************************************/
+uint32_t ShapeGeometry::AddVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& textureCoordinate)
+{
+	VERTEX vertex;
+	vertex.position = position;
+	vertex.normal = normal;
+	vertex.textureCoordinate = textureCoordinate;
+	m_vertices.push_back(vertex);
+
+	return((uint32_t)(m_vertices.size() - 1));
+}
+
+/***********************************************************
+ *  AddQuad()
+ *
+ *  This method is used to add a flat quad as two triangles,
+ *  with the whole texture stretched over it.  The corners
+ *  are in counter clockwise order seen from the front.
+ ***********************************************************/
+void ShapeGeometry::AddQuad(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3)
+{
+	glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p3 - p0));
+
+	uint32_t i0 = AddVertex(p0, normal, glm::vec2(0.0f, 0.0f));
+	uint32_t i1 = AddVertex(p1, normal, glm::vec2(1.0f, 0.0f));
+	uint32_t i2 = AddVertex(p2, normal, glm::vec2(1.0f, 1.0f));
+	uint32_t i3 = AddVertex(p3, normal, glm::vec2(0.0f, 1.0f));
+
+	m_indices.push_back(i0);
+	m_indices.push_back(i1);
+	m_indices.push_back(i2);
+	m_indices.push_back(i0);
+	m_indices.push_back(i2);
+	m_indices.push_back(i3);
+}
+
+/***********************************************************
+ *  BuildBox()
+ *
+ *  This method is used to build the six faces of the box.
+ ***********************************************************/
+void ShapeGeometry::BuildBox()
+{
+	// front and back
+	AddQuad(glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(-0.5f, 0.5f, 0.5f));
+	AddQuad(glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, 0.5f, -0.5f), glm::vec3(0.5f, 0.5f, -0.5f));
+	// right and left
+	AddQuad(glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(0.5f, 0.5f, -0.5f), glm::vec3(0.5f, 0.5f, 0.5f));
+	AddQuad(glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(-0.5f, 0.5f, 0.5f), glm::vec3(-0.5f, 0.5f, -0.5f));
+	// top and bottom
+	AddQuad(glm::vec3(-0.5f, 0.5f, 0.5f), glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(0.5f, 0.5f, -0.5f), glm::vec3(-0.5f, 0.5f, -0.5f));
+	AddQuad(glm::vec3(-0.5f, -0.5f, -0.5f), glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(0.5f, -0.5f, 0.5f), glm::vec3(-0.5f, -0.5f, 0.5f));
+}
+
+/***********************************************************
+ *  BuildPlane()
+ *
+ *  This method is used to build the plane, which faces up.
+ ***********************************************************/
+void ShapeGeometry::BuildPlane()
+{
+	AddQuad(glm::vec3(-1.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, -1.0f), glm::vec3(-1.0f, 0.0f, -1.0f));
+}
+
+/***********************************************************
+ *  BuildPrism()
+ *
+ *  This method is used to build the prism, a triangle that
+ *  points up and is stretched along the Z axis.
+ ***********************************************************/
+void ShapeGeometry::BuildPrism()
+{
+	glm::vec3 frontLeft(-0.5f, -0.5f, 0.5f);
+	glm::vec3 frontRight(0.5f, -0.5f, 0.5f);
+	glm::vec3 frontTop(0.0f, 0.5f, 0.5f);
+	glm::vec3 backLeft(-0.5f, -0.5f, -0.5f);
+	glm::vec3 backRight(0.5f, -0.5f, -0.5f);
+	glm::vec3 backTop(0.0f, 0.5f, -0.5f);
+
+	// the triangles at both ends
+	glm::vec3 normal(0.0f, 0.0f, 1.0f);
+	m_indices.push_back(AddVertex(frontLeft, normal, glm::vec2(0.0f, 0.0f)));
+	m_indices.push_back(AddVertex(frontRight, normal, glm::vec2(1.0f, 0.0f)));
+	m_indices.push_back(AddVertex(frontTop, normal, glm::vec2(0.5f, 1.0f)));
+	normal = glm::vec3(0.0f, 0.0f, -1.0f);
+	m_indices.push_back(AddVertex(backRight, normal, glm::vec2(0.0f, 0.0f)));
+	m_indices.push_back(AddVertex(backLeft, normal, glm::vec2(1.0f, 0.0f)));
+	m_indices.push_back(AddVertex(backTop, normal, glm::vec2(0.5f, 1.0f)));
+
+	// the bottom and the two slanted sides
+	AddQuad(backLeft, backRight, frontRight, frontLeft);
+	AddQuad(frontRight, backRight, backTop, frontTop);
+	AddQuad(frontTop, backTop, backLeft, frontLeft);
+}
+
+/***********************************************************
+ *  BuildSphere()
+ *
+ *  This method is used to build the sphere from rings that
+ *  go from the bottom pole to the top pole.
+ ***********************************************************/
+void ShapeGeometry::BuildSphere(int segments)
+{
+	int rings = segments / 2;
+
+	for (int ring = 0; ring <= rings; ring++)
+	{
+		float latitude = g_Pi * (float)ring / (float)rings - 0.5f * g_Pi;
+		float y = sinf(latitude);
+		float radius = cosf(latitude);
+		for (int i = 0; i <= segments; i++)
+		{
+			float angle = 2.0f * g_Pi * (float)i / (float)segments;
+			glm::vec3 position(radius * sinf(angle), y, radius * cosf(angle));
+			AddVertex(position, position, glm::vec2((float)i / (float)segments, (float)ring / (float)rings));
+		}
+	}
+
+	for (int ring = 0; ring < rings; ring++)
+	{
+		uint32_t bottom = (uint32_t)(ring * (segments + 1));
+		uint32_t top = bottom + (uint32_t)(segments + 1);
+		for (uint32_t i = 0; i < (uint32_t)segments; i++)
+		{
+			m_indices.push_back(bottom + i);
+			m_indices.push_back(bottom + i + 1);
+			m_indices.push_back(top + i + 1);
+			m_indices.push_back(bottom + i);
+			m_indices.push_back(top + i + 1);
+			m_indices.push_back(top + i);
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildTorus()
+ *
+ *  This method is used to build the torus from rings of the
+ *  tube around the Z axis.
+ ***********************************************************/
+void ShapeGeometry::BuildTorus(int segments)
+{
+	int tubeSegments = segments / 2;
+
+	for (int i = 0; i <= segments; i++)
+	{
+		float angle = 2.0f * g_Pi * (float)i / (float)segments;
+		glm::vec3 center(cosf(angle), sinf(angle), 0.0f);
+		for (int j = 0; j <= tubeSegments; j++)
+		{
+			float tubeAngle = 2.0f * g_Pi * (float)j / (float)tubeSegments;
+			glm::vec3 normal(cosf(tubeAngle) * center.x, cosf(tubeAngle) * center.y, sinf(tubeAngle));
+			AddVertex(center + g_TorusThickness * normal, normal, glm::vec2((float)i / (float)segments, (float)j / (float)tubeSegments));
+		}
+	}
+
+	for (int i = 0; i < segments; i++)
+	{
+		uint32_t ring = (uint32_t)(i * (tubeSegments + 1));
+		uint32_t nextRing = ring + (uint32_t)(tubeSegments + 1);
+		for (uint32_t j = 0; j < (uint32_t)tubeSegments; j++)
+		{
+			m_indices.push_back(ring + j);
+			m_indices.push_back(nextRing + j);
+			m_indices.push_back(nextRing + j + 1);
+			m_indices.push_back(ring + j);
+			m_indices.push_back(nextRing + j + 1);
+			m_indices.push_back(ring + j + 1);
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildRound()
+ *
+ *  This method is used to build a round shape from the
+ *  origin up to a height of 1, with a cap at the ends that
+ *  have a radius.  A top radius of 0 makes a cone.
+ ***********************************************************/
+void ShapeGeometry::BuildRound(float bottomRadius, float topRadius, int segments)
+{
+	// the sides, with the normals tilted by the slope
+	uint32_t first = (uint32_t)m_vertices.size();
+	for (int i = 0; i <= segments; i++)
+	{
+		float angle = 2.0f * g_Pi * (float)i / (float)segments;
+		glm::vec3 direction(sinf(angle), 0.0f, cosf(angle));
+		glm::vec3 normal = glm::normalize(glm::vec3(direction.x, bottomRadius - topRadius, direction.z));
+		float u = (float)i / (float)segments;
+		AddVertex(bottomRadius * direction, normal, glm::vec2(u, 0.0f));
+		AddVertex(topRadius * direction + glm::vec3(0.0f, 1.0f, 0.0f), normal, glm::vec2(u, 1.0f));
+	}
+	for (uint32_t i = 0; i < (uint32_t)segments; i++)
+	{
+		uint32_t bottom = first + 2 * i;
+		m_indices.push_back(bottom);
+		m_indices.push_back(bottom + 2);
+		m_indices.push_back(bottom + 3);
+		m_indices.push_back(bottom);
+		m_indices.push_back(bottom + 3);
+		m_indices.push_back(bottom + 1);
+	}
+
+	// the caps, as fans around their centers
+	for (int cap = 0; cap < 2; cap++)
+	{
+		float radius = (cap == 0) ? bottomRadius : topRadius;
+		if (radius <= 0.0f)
+		{
+			continue;
+		}
+
+		float y = (cap == 0) ? 0.0f : 1.0f;
+		glm::vec3 normal(0.0f, (cap == 0) ? -1.0f : 1.0f, 0.0f);
+		uint32_t center = AddVertex(glm::vec3(0.0f, y, 0.0f), normal, glm::vec2(0.5f, 0.5f));
+		for (int i = 0; i <= segments; i++)
+		{
+			float angle = 2.0f * g_Pi * (float)i / (float)segments;
+			glm::vec3 position(radius * sinf(angle), y, radius * cosf(angle));
+			AddVertex(position, normal, glm::vec2(0.5f + 0.5f * sinf(angle), 0.5f + 0.5f * cosf(angle)));
+		}
+		for (uint32_t i = 0; i < (uint32_t)segments; i++)
+		{
+			m_indices.push_back(center);
+			if (cap == 0)
+			{
+				m_indices.push_back(center + i + 2);
+				m_indices.push_back(center + i + 1);
+			}
+			else
+			{
+				m_indices.push_back(center + i + 1);
+				m_indices.push_back(center + i + 2);
+			}
+		}
+	}
+}
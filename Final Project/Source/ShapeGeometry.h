@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// shapegeometry.h
+// ============
+// build the vertices of the basic shape meshes in memory
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+/***********************************************************
+ *  ShapeGeometry
+ *
+ *  This class contains the code for building the triangles
+ *  of the basic shape meshes in memory, for the backends
+ *  that cannot draw the OpenGL buffers that the shape meshes
+ *  are loaded into.  The shapes have the same sizes as the
+ *  loaded ones: the box and the prism fill the unit cube
+ *  around the origin, the plane spans -1 to 1 on the X and
+ *  Z axes, the round shapes have a radius of 1 and stand on
+ *  the origin with a height of 1, the sphere has a radius of
+ *  1, and the torus lies around the Z axis.
+ ***********************************************************/
+class ShapeGeometry
+{
+public:
+	// a vertex with the same attributes as the vertex shader reads
+	struct VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 textureCoordinate;
+	};
+
+	// constructor
+	ShapeGeometry();
+
+	// build the triangles of a shape, with the given number of
+	// segments around the round shapes
+	void Build(RenderBackend::SHAPE_MESH shape, int segments);
+
+	// get the vertices, and the three indices of every triangle
+	const std::vector<VERTEX>& GetVertices() const;
+	const std::vector<uint32_t>& GetIndices() const;
+
+private:
+	std::vector<VERTEX> m_vertices;
+	std::vector<uint32_t> m_indices;
+
+	// add a vertex and return its index
+	uint32_t AddVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& textureCoordinate);
+	// add a flat quad from its corners in counter clockwise order
+	void AddQuad(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3);
+
+	void BuildBox();
+	void BuildPlane();
+	void BuildPrism();
+	void BuildSphere(int segments);
+	void BuildTorus(int segments);
+	// build a cylinder, a tapered cylinder or a cone from its radii
+	void BuildRound(float bottomRadius, float topRadius, int segments);
+};
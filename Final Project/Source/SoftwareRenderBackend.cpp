@@ -0,0 +1,1517 @@
+///////////////////////////////////////////////////////////////////////////////
+// softwarerenderbackend.cpp
+// ============
+// rasterize the scene on the CPU with a pool of threads
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SoftwareRenderBackend.h"
+#include "FramePacer.h"
+#include "FrameProfiler.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define SOFTWARERENDERBACKEND_USE_SSE2
+#endif
+
+// declaration of global variables
+namespace
+{
+	// names of the uniforms that the backend shades with
+	const char* g_ModelName = "model";
+	const char* g_ViewName = "view";
+	const char* g_ProjectionName = "projection";
+	const char* g_ViewPositionName = "viewPosition";
+	const char* g_ColorValueName = "objectColor";
+	const char* g_TextureValueName = "objectTexture";
+	const char* g_UseTextureName = "bUseTexture";
+	const char* g_UseLightingName = "bUseLighting";
+	const char* g_UVScaleName = "UVscale";
+	const char* g_UVOffsetName = "UVoffset";
+	const char* g_LightArrayName = "lightSources[";
+
+	// segments around the round shapes
+	const int g_ShapeSegments = 24;
+	// most threads that rasterize the tiles, including the render thread
+	const int g_MaxThreads = 16;
+
+	// the fragments that the rasterizer computes four at a time
+	struct FRAGMENT_QUAD
+	{
+		float depth[4];
+		float inverseW[4];
+		float varyings[8][4];
+	};
+
+	/***********************************************************
+	 *  WrapCoordinate()
+	 *
+	 *  Wrap a texel coordinate into the texture, so textures
+	 *  repeat like they do with OpenGL.
+	 ***********************************************************/
+	inline int WrapCoordinate(int coordinate, int size)
+	{
+		coordinate %= size;
+		return((coordinate < 0) ? (coordinate + size) : coordinate);
+	}
+
+	/***********************************************************
+	 *  PackColor()
+	 *
+	 *  Write a color as RGBA bytes.
+	 ***********************************************************/
+	inline void PackColor(const glm::vec4& color, unsigned char* pOutput)
+	{
+		glm::vec4 clamped = glm::clamp(color, 0.0f, 1.0f);
+		pOutput[0] = (unsigned char)(clamped.r * 255.0f + 0.5f);
+		pOutput[1] = (unsigned char)(clamped.g * 255.0f + 0.5f);
+		pOutput[2] = (unsigned char)(clamped.b * 255.0f + 0.5f);
+		pOutput[3] = (unsigned char)(clamped.a * 255.0f + 0.5f);
+	}
+
+	/***********************************************************
+	 *  UnpackColor()
+	 *
+	 *  Read a color from RGBA bytes.
+	 ***********************************************************/
+	inline glm::vec4 UnpackColor(const unsigned char* pInput)
+	{
+		const float scale = 1.0f / 255.0f;
+		return(glm::vec4(pInput[0] * scale, pInput[1] * scale, pInput[2] * scale, pInput[3] * scale));
+	}
+}
+
+/***********************************************************
+ *  SoftwareRenderBackend()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SoftwareRenderBackend::SoftwareRenderBackend()
+{
+	// the shapes are built once, with the sizes of the loaded meshes
+	ShapeGeometry geometry;
+	for (int i = 0; i < SHAPE_COUNT; i++)
+	{
+		geometry.Build((SHAPE_MESH)i, g_ShapeSegments);
+		m_shapes[i].vertices = geometry.GetVertices();
+		m_shapes[i].indices = geometry.GetIndices();
+	}
+
+	m_model = glm::mat4(1.0f);
+	m_view = glm::mat4(1.0f);
+	m_projection = glm::mat4(1.0f);
+	m_viewPosition = glm::vec3(0.0f);
+	// the lights and the material start out black, like unset uniforms
+	for (int i = 0; i < LIGHT_COUNT; i++)
+	{
+		m_lights[i].position = glm::vec3(0.0f);
+		m_lights[i].radius = 0.0f;
+		m_lights[i].ambientColor = glm::vec3(0.0f);
+		m_lights[i].diffuseColor = glm::vec3(0.0f);
+		m_lights[i].specularColor = glm::vec3(0.0f);
+		m_lights[i].focalStrength = 0.0f;
+		m_lights[i].specularIntensity = 0.0f;
+	}
+	m_activeLightCount = 0;
+	m_state.material.ambientColor = glm::vec3(0.0f);
+	m_state.material.ambientStrength = 0.0f;
+	m_state.material.diffuseColor = glm::vec3(0.0f);
+	m_state.material.specularColor = glm::vec3(0.0f);
+	m_state.material.shininess = 0.0f;
+	m_state.color = glm::vec4(1.0f);
+	m_state.uvScale = glm::vec2(1.0f, 1.0f);
+	m_state.uvOffset = glm::vec2(0.0f, 0.0f);
+	m_state.pTexture = NULL;
+	m_state.bUseLighting = false;
+	m_state.bDepthTest = true;
+	m_state.bDepthWrite = true;
+	m_state.bColorWrite = true;
+	m_state.bBlend = false;
+	m_state.depthFunction = DEPTH_LESS;
+	m_bUseTexture = false;
+	m_textureUnit = 0;
+
+	m_width = 0;
+	m_height = 0;
+	m_stride = 0;
+	m_tilesX = 0;
+	m_tilesY = 0;
+
+	m_presentTexture = 0;
+	m_presentFramebuffer = 0;
+	m_presentWidth = 0;
+	m_presentHeight = 0;
+
+	int threadCount = (int)std::thread::hardware_concurrency();
+	threadCount = (threadCount < g_MaxThreads) ? threadCount : g_MaxThreads;
+	m_threadCount = (threadCount > 1) ? threadCount : 1;
+	m_nextTile = 0;
+	m_generation = 0;
+	m_busyWorkers = 0;
+	m_bShutdown = false;
+
+	m_frameCount = 0;
+	m_triangleTotal = 0;
+	m_binTotal = 0;
+	m_rasterTimeTotal = 0.0;
+}
+
+/***********************************************************
+ *  ~SoftwareRenderBackend()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SoftwareRenderBackend::~SoftwareRenderBackend()
+{
+	StopWorkers();
+
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		delete m_textures[i];
+	}
+	m_textures.clear();
+	for (size_t i = 0; i < m_destroyedTextures.size(); i++)
+	{
+		delete m_destroyedTextures[i];
+	}
+	m_destroyedTextures.clear();
+
+	if (0 != m_presentFramebuffer)
+	{
+		glDeleteFramebuffers(1, &m_presentFramebuffer);
+		m_presentFramebuffer = 0;
+	}
+	if (0 != m_presentTexture)
+	{
+		glDeleteTextures(1, &m_presentTexture);
+		m_presentTexture = 0;
+	}
+}
+
+/***********************************************************
+ *  SetThreadCount()
+ *
+ *  This method is used to set the number of threads that
+ *  rasterize the tiles, including the render thread.  The
+ *  workers are started again on the next frame.
+ ***********************************************************/
+void SoftwareRenderBackend::SetThreadCount(int threadCount)
+{
+	threadCount = (threadCount < g_MaxThreads) ? threadCount : g_MaxThreads;
+	threadCount = (threadCount > 1) ? threadCount : 1;
+	if (threadCount != m_threadCount)
+	{
+		StopWorkers();
+		m_threadCount = threadCount;
+	}
+}
+
+/***********************************************************
+ *  SetFramebufferSize()
+ *
+ *  This method is used to resize the color and depth buffers
+ *  and the tiles, which must be done between frames.
+ ***********************************************************/
+void SoftwareRenderBackend::SetFramebufferSize(int width, int height)
+{
+	width = (width > 0) ? width : 0;
+	height = (height > 0) ? height : 0;
+	if ((width == m_width) && (height == m_height))
+	{
+		return;
+	}
+
+	m_width = width;
+	m_height = height;
+	// the rows are padded so every group of four pixels can be
+	// loaded at once, even at the right edge of the frame
+	m_stride = (width + 3) & ~3;
+	m_tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	m_tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+	m_colorBuffer.assign((size_t)m_stride * height * 4, 0);
+	m_depthBuffer.assign((size_t)m_stride * height, 1.0f);
+	m_pixels.assign((size_t)width * height * 4, 0);
+	m_bins.resize((size_t)m_tilesX * m_tilesY);
+}
+
+/***********************************************************
+ *  Present()
+ *
+ *  This method is used to copy the last finished frame into
+ *  the bound draw framebuffer, stretched over the given
+ *  size.  The pixels are uploaded into a texture that is
+ *  blitted through a framebuffer of its own.
+ ***********************************************************/
+void SoftwareRenderBackend::Present(int width, int height)
+{
+	if ((m_width <= 0) || (m_height <= 0))
+	{
+		return;
+	}
+
+	GLint readFramebuffer = 0;
+	GLint boundTexture = 0;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+
+	if (0 == m_presentTexture)
+	{
+		glGenTextures(1, &m_presentTexture);
+		glGenFramebuffers(1, &m_presentFramebuffer);
+	}
+
+	glBindTexture(GL_TEXTURE_2D, m_presentTexture);
+	if ((m_presentWidth != m_width) || (m_presentHeight != m_height))
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_presentFramebuffer);
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_presentTexture, 0);
+		m_presentWidth = m_width;
+		m_presentHeight = m_height;
+	}
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, m_pixels.data());
+	glBindTexture(GL_TEXTURE_2D, boundTexture);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_presentFramebuffer);
+	glBlitFramebuffer(
+		0, 0, m_width, m_height,
+		0, 0, width, height,
+		GL_COLOR_BUFFER_BIT,
+		((width == m_width) && (height == m_height)) ? GL_NEAREST : GL_LINEAR);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the average triangles, tile
+ *  entries and rasterization time per frame.
+ ***********************************************************/
+void SoftwareRenderBackend::WriteReport(std::ostream& stream)
+{
+	stream << "# frames rasterized by the software backend" << std::endl;
+	stream << "frames: " << m_frameCount << std::endl;
+	stream << "threads: " << m_threadCount << std::endl;
+	stream << "tile_size: " << TILE_SIZE << std::endl;
+	if (m_frameCount == 0)
+	{
+		return;
+	}
+
+	stream << "triangles: " << (double)m_triangleTotal / (double)m_frameCount << std::endl;
+	stream << "tile_triangles: " << (double)m_binTotal / (double)m_frameCount << std::endl;
+	stream << "raster_ms: " << m_rasterTimeTotal * 1000.0 / (double)m_frameCount << std::endl;
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the report into a file.
+ ***********************************************************/
+bool SoftwareRenderBackend::WriteReport(const char* filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create software backend report file:" << filename << std::endl;
+		return(false);
+	}
+
+	WriteReport(file);
+	if (!file)
+	{
+		std::cout << "Could not write software backend report file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote software backend report file:" << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetName()
+ *
+ *  This method is used to get the name of the backend.
+ ***********************************************************/
+const char* SoftwareRenderBackend::GetName() const
+{
+	return("software");
+}
+
+/***********************************************************
+ *  SupportsOpenGLPasses()
+ *
+ *  This method is used to check whether the OpenGL passes
+ *  can run, which they cannot since nothing is drawn with
+ *  OpenGL until the frame is presented.
+ ***********************************************************/
+bool SoftwareRenderBackend::SupportsOpenGLPasses() const
+{
+	return(false);
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used to create a buffer, which the shapes
+ *  of the software backend do not need.
+ ***********************************************************/
+uint32_t SoftwareRenderBackend::CreateBuffer(BUFFER_TYPE type, const void* pData, size_t size)
+{
+	return(0);
+}
+
+/***********************************************************
+ *  UpdateBuffer()
+ *
+ *  This method is used to update a buffer.
+ ***********************************************************/
+void SoftwareRenderBackend::UpdateBuffer(uint32_t buffer, size_t offset, const void* pData, size_t size)
+{
+}
+
+/***********************************************************
+ *  DestroyBuffer()
+ *
+ *  This method is used to free a buffer.
+ ***********************************************************/
+void SoftwareRenderBackend::DestroyBuffer(uint32_t buffer)
+{
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used to copy RGBA pixels into a texture,
+ *  and to average them down into the smaller mip levels.
+ ***********************************************************/
+uint32_t SoftwareRenderBackend::CreateTexture(int width, int height, const unsigned char* pPixels, bool bGenerateMips)
+{
+	if ((NULL == pPixels) || (width <= 0) || (height <= 0))
+	{
+		return(0);
+	}
+
+	TEXTURE* pTexture = new TEXTURE();
+	pTexture->mips.resize(1);
+	pTexture->mips[0].width = width;
+	pTexture->mips[0].height = height;
+	pTexture->mips[0].texels.assign(pPixels, pPixels + (size_t)width * height * 4);
+
+	while ((bGenerateMips == true) &&
+		((pTexture->mips.back().width > 1) || (pTexture->mips.back().height > 1)))
+	{
+		MIP_LEVEL level;
+		const MIP_LEVEL& source = pTexture->mips.back();
+		level.width = (source.width > 1) ? (source.width / 2) : 1;
+		level.height = (source.height > 1) ? (source.height / 2) : 1;
+		level.texels.resize((size_t)level.width * level.height * 4);
+		for (int y = 0; y < level.height; y++)
+		{
+			int y0 = std::min(y * 2, source.height - 1);
+			int y1 = std::min(y * 2 + 1, source.height - 1);
+			for (int x = 0; x < level.width; x++)
+			{
+				int x0 = std::min(x * 2, source.width - 1);
+				int x1 = std::min(x * 2 + 1, source.width - 1);
+				for (int channel = 0; channel < 4; channel++)
+				{
+					int sum =
+						source.texels[((size_t)y0 * source.width + x0) * 4 + channel] +
+						source.texels[((size_t)y0 * source.width + x1) * 4 + channel] +
+						source.texels[((size_t)y1 * source.width + x0) * 4 + channel] +
+						source.texels[((size_t)y1 * source.width + x1) * 4 + channel];
+					level.texels[((size_t)y * level.width + x) * 4 + channel] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+		pTexture->mips.push_back(level);
+	}
+
+	m_textures.push_back(pTexture);
+
+	return((uint32_t)m_textures.size());
+}
+
+/***********************************************************
+ *  DestroyTexture()
+ *
+ *  This method is used to free a texture.  The draws of the
+ *  frame may still use it, so it is deleted once the frame
+ *  is finished.
+ ***********************************************************/
+void SoftwareRenderBackend::DestroyTexture(uint32_t texture)
+{
+	if ((texture == 0) || (texture > m_textures.size()) || (NULL == m_textures[texture - 1]))
+	{
+		return;
+	}
+
+	m_destroyedTextures.push_back(m_textures[texture - 1]);
+	m_textures[texture - 1] = NULL;
+	for (size_t i = 0; i < m_boundTextures.size(); i++)
+	{
+		if (m_boundTextures[i] == texture)
+		{
+			m_boundTextures[i] = 0;
+		}
+	}
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used to bind a texture to a texture unit.
+ ***********************************************************/
+void SoftwareRenderBackend::BindTexture(int unit, uint32_t texture)
+{
+	if (unit < 0)
+	{
+		return;
+	}
+
+	if (unit >= (int)m_boundTextures.size())
+	{
+		m_boundTextures.resize(unit + 1, 0);
+	}
+	m_boundTextures[unit] = texture;
+}
+
+/***********************************************************
+ *  CreateProgram()
+ *
+ *  This method is used to load a shader program, which the
+ *  software backend does not run, since it shades with the
+ *  lighting of the scene shaders.
+ ***********************************************************/
+uint32_t SoftwareRenderBackend::CreateProgram(const char* vertexShaderPath, const char* fragmentShaderPath)
+{
+	return(0);
+}
+
+/***********************************************************
+ *  DestroyProgram()
+ *
+ *  This method is used to free a shader program.
+ ***********************************************************/
+void SoftwareRenderBackend::DestroyProgram(uint32_t program)
+{
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used to select a shader program.
+ ***********************************************************/
+void SoftwareRenderBackend::UseProgram(uint32_t program)
+{
+}
+
+/***********************************************************
+ *  SetIntValue()
+ *
+ *  This method is used to set an integer or boolean uniform.
+ ***********************************************************/
+void SoftwareRenderBackend::SetIntValue(const char* name, int value)
+{
+	if (strcmp(name, g_UseTextureName) == 0)
+	{
+		m_bUseTexture = (value != 0);
+	}
+	else if (strcmp(name, g_TextureValueName) == 0)
+	{
+		m_textureUnit = value;
+	}
+	else if (strcmp(name, g_UseLightingName) == 0)
+	{
+		m_state.bUseLighting = (value != 0);
+	}
+}
+
+/***********************************************************
+ *  SetFloatValue()
+ *
+ *  This method is used to set a float uniform.
+ ***********************************************************/
+void SoftwareRenderBackend::SetFloatValue(const char* name, float value)
+{
+	if (SetLightValue(name, &value, 1) == true)
+	{
+		return;
+	}
+
+	if (strcmp(name, "material.ambientStrength") == 0)
+	{
+		m_state.material.ambientStrength = value;
+	}
+	else if (strcmp(name, "material.shininess") == 0)
+	{
+		m_state.material.shininess = value;
+	}
+}
+
+/***********************************************************
+ *  SetVec2Value()
+ *
+ *  This method is used to set a vec2 uniform.
+ ***********************************************************/
+void SoftwareRenderBackend::SetVec2Value(const char* name, const glm::vec2& value)
+{
+	if (strcmp(name, g_UVScaleName) == 0)
+	{
+		m_state.uvScale = value;
+	}
+	else if (strcmp(name, g_UVOffsetName) == 0)
+	{
+		m_state.uvOffset = value;
+	}
+}
+
+/***********************************************************
+ *  SetVec3Value()
+ *
+ *  This method is used to set a vec3 uniform.
+ ***********************************************************/
+void SoftwareRenderBackend::SetVec3Value(const char* name, const glm::vec3& value)
+{
+	if (SetLightValue(name, &value[0], 3) == true)
+	{
+		return;
+	}
+
+	if (strcmp(name, g_ViewPositionName) == 0)
+	{
+		m_viewPosition = value;
+	}
+	else if (strcmp(name, "material.ambientColor") == 0)
+	{
+		m_state.material.ambientColor = value;
+	}
+	else if (strcmp(name, "material.diffuseColor") == 0)
+	{
+		m_state.material.diffuseColor = value;
+	}
+	else if (strcmp(name, "material.specularColor") == 0)
+	{
+		m_state.material.specularColor = value;
+	}
+}
+
+/***********************************************************
+ *  SetVec4Value()
+ *
+ *  This method is used to set a vec4 uniform.
+ ***********************************************************/
+void SoftwareRenderBackend::SetVec4Value(const char* name, const glm::vec4& value)
+{
+	if (strcmp(name, g_ColorValueName) == 0)
+	{
+		m_state.color = value;
+	}
+}
+
+/***********************************************************
+ *  SetMat4Value()
+ *
+ *  This method is used to set a mat4 uniform.
+ ***********************************************************/
+void SoftwareRenderBackend::SetMat4Value(const char* name, const glm::mat4& value)
+{
+	if (strcmp(name, g_ModelName) == 0)
+	{
+		m_model = value;
+	}
+	else if (strcmp(name, g_ViewName) == 0)
+	{
+		m_view = value;
+	}
+	else if (strcmp(name, g_ProjectionName) == 0)
+	{
+		m_projection = value;
+	}
+}
+
+/***********************************************************
+ *  SetLightValue()
+ *
+ *  This method is used to set a member of one of the
+ *  lightSources uniforms, and returns whether the name was
+ *  a light uniform.
+ ***********************************************************/
+bool SoftwareRenderBackend::SetLightValue(const char* name, const float* pValues, int valueCount)
+{
+	size_t prefixLength = strlen(g_LightArrayName);
+	if (strncmp(name, g_LightArrayName, prefixLength) != 0)
+	{
+		return(false);
+	}
+
+	// the names look like lightSources[0].position
+	int index = name[prefixLength] - '0';
+	if ((index < 0) || (index >= LIGHT_COUNT) ||
+		(name[prefixLength + 1] != ']') || (name[prefixLength + 2] != '.'))
+	{
+		return(true);
+	}
+
+	LIGHT& light = m_lights[index];
+	const char* member = name + prefixLength + 3;
+	if (valueCount == 3)
+	{
+		glm::vec3 value(pValues[0], pValues[1], pValues[2]);
+		if (strcmp(member, "position") == 0)
+		{
+			light.position = value;
+		}
+		else if (strcmp(member, "ambientColor") == 0)
+		{
+			light.ambientColor = value;
+		}
+		else if (strcmp(member, "diffuseColor") == 0)
+		{
+			light.diffuseColor = value;
+		}
+		else if (strcmp(member, "specularColor") == 0)
+		{
+			light.specularColor = value;
+		}
+	}
+	else if (valueCount == 1)
+	{
+		if (strcmp(member, "radius") == 0)
+		{
+			light.radius = pValues[0];
+		}
+		else if (strcmp(member, "focalStrength") == 0)
+		{
+			light.focalStrength = pValues[0];
+		}
+		else if (strcmp(member, "specularIntensity") == 0)
+		{
+			light.specularIntensity = pValues[0];
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetState()
+ *
+ *  This method is used to turn a render state on or off.
+ ***********************************************************/
+void SoftwareRenderBackend::SetState(RENDER_STATE state, bool bEnabled)
+{
+	switch (state)
+	{
+	case STATE_DEPTH_TEST:
+		m_state.bDepthTest = bEnabled;
+		break;
+	case STATE_DEPTH_WRITE:
+		m_state.bDepthWrite = bEnabled;
+		break;
+	case STATE_COLOR_WRITE:
+		m_state.bColorWrite = bEnabled;
+		break;
+	case STATE_BLEND:
+		m_state.bBlend = bEnabled;
+		break;
+	default:
+		break;
+	}
+}
+
+/***********************************************************
+ *  SetDepthFunction()
+ *
+ *  This method is used to set the comparison of the depth
+ *  test.
+ ***********************************************************/
+void SoftwareRenderBackend::SetDepthFunction(DEPTH_FUNCTION function)
+{
+	m_state.depthFunction = function;
+}
+
+/***********************************************************
+ *  DrawShape()
+ *
+ *  This method is used to transform the triangles of a shape
+ *  with the current uniforms, and to add them to the tiles
+ *  they cover.  The uniforms and render state are copied, so
+ *  they can change before the frame is rasterized.
+ ***********************************************************/
+void SoftwareRenderBackend::DrawShape(SHAPE_MESH shape)
+{
+	if ((m_width <= 0) || (m_height <= 0) || (shape < 0) || (shape >= SHAPE_COUNT))
+	{
+		return;
+	}
+
+	DRAW_STATE state = m_state;
+	state.pTexture = NULL;
+	if ((m_bUseTexture == true) && (m_textureUnit >= 0) && (m_textureUnit < (int)m_boundTextures.size()))
+	{
+		uint32_t texture = m_boundTextures[m_textureUnit];
+		if ((texture > 0) && (texture <= m_textures.size()))
+		{
+			state.pTexture = m_textures[texture - 1];
+		}
+	}
+	m_draws.push_back(state);
+	int draw = (int)m_draws.size() - 1;
+
+	// the vertices are transformed like the vertex shader does
+	const SHAPE& mesh = m_shapes[shape];
+	glm::mat4 modelViewProjection = m_projection * m_view * m_model;
+	glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(m_model)));
+	m_clipVertices.resize(mesh.vertices.size());
+	for (size_t i = 0; i < mesh.vertices.size(); i++)
+	{
+		TransformVertex(mesh.vertices[i], modelViewProjection, normalMatrix, m_clipVertices[i]);
+	}
+
+	for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+	{
+		ClipTriangle(
+			m_clipVertices[mesh.indices[i]],
+			m_clipVertices[mesh.indices[i + 1]],
+			m_clipVertices[mesh.indices[i + 2]],
+			draw);
+	}
+}
+
+/***********************************************************
+ *  TransformVertex()
+ *
+ *  This method is used to transform a vertex into clip
+ *  space, with its world position, normal and texture
+ *  coordinate as the values interpolated over triangles.
+ ***********************************************************/
+void SoftwareRenderBackend::TransformVertex(
+	const ShapeGeometry::VERTEX& vertex,
+	const glm::mat4& modelViewProjection,
+	const glm::mat3& normalMatrix,
+	CLIP_VERTEX& output)
+{
+	glm::vec4 position(vertex.position, 1.0f);
+	glm::vec3 worldPosition = glm::vec3(m_model * position);
+	glm::vec3 normal = normalMatrix * vertex.normal;
+
+	output.position = modelViewProjection * position;
+	output.varyings[0] = worldPosition.x;
+	output.varyings[1] = worldPosition.y;
+	output.varyings[2] = worldPosition.z;
+	output.varyings[3] = normal.x;
+	output.varyings[4] = normal.y;
+	output.varyings[5] = normal.z;
+	output.varyings[6] = vertex.textureCoordinate.x;
+	output.varyings[7] = vertex.textureCoordinate.y;
+}
+
+/***********************************************************
+ *  ClipTriangle()
+ *
+ *  This method is used to drop the triangles outside of the
+ *  view, and to cut the ones that cross the near plane into
+ *  the pieces in front of it.  The other frustum planes are
+ *  handled by the pixel bounds and the depth range.
+ ***********************************************************/
+void SoftwareRenderBackend::ClipTriangle(const CLIP_VERTEX& v0, const CLIP_VERTEX& v1, const CLIP_VERTEX& v2, int draw)
+{
+	const glm::vec4& p0 = v0.position;
+	const glm::vec4& p1 = v1.position;
+	const glm::vec4& p2 = v2.position;
+	if (((p0.x > p0.w) && (p1.x > p1.w) && (p2.x > p2.w)) ||
+		((p0.x < -p0.w) && (p1.x < -p1.w) && (p2.x < -p2.w)) ||
+		((p0.y > p0.w) && (p1.y > p1.w) && (p2.y > p2.w)) ||
+		((p0.y < -p0.w) && (p1.y < -p1.w) && (p2.y < -p2.w)) ||
+		((p0.z > p0.w) && (p1.z > p1.w) && (p2.z > p2.w)) ||
+		((p0.z < -p0.w) && (p1.z < -p1.w) && (p2.z < -p2.w)))
+	{
+		return;
+	}
+
+	if ((p0.z >= -p0.w) && (p1.z >= -p1.w) && (p2.z >= -p2.w))
+	{
+		SetupTriangle(v0, v1, v2, draw);
+		return;
+	}
+
+	// cut the triangle at the near plane, which leaves a triangle
+	// or a quad that is drawn as a fan
+	const CLIP_VERTEX* pInput[3] = { &v0, &v1, &v2 };
+	CLIP_VERTEX polygon[4];
+	int count = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		const CLIP_VERTEX& current = *pInput[i];
+		const CLIP_VERTEX& next = *pInput[(i + 1) % 3];
+		float currentDistance = current.position.z + current.position.w;
+		float nextDistance = next.position.z + next.position.w;
+
+		if (currentDistance >= 0.0f)
+		{
+			polygon[count++] = current;
+		}
+		if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+		{
+			float t = currentDistance / (currentDistance - nextDistance);
+			CLIP_VERTEX& cut = polygon[count++];
+			cut.position = current.position + t * (next.position - current.position);
+			for (int k = 0; k < VARYING_COUNT; k++)
+			{
+				cut.varyings[k] = current.varyings[k] + t * (next.varyings[k] - current.varyings[k]);
+			}
+		}
+	}
+
+	for (int i = 1; i + 1 < count; i++)
+	{
+		SetupTriangle(polygon[0], polygon[i], polygon[i + 1], draw);
+	}
+}
+
+/***********************************************************
+ *  SetupTriangle()
+ *
+ *  This method is used to project a triangle onto the screen,
+ *  to compute its edge functions and the planes of its
+ *  interpolated values, and to add it to the bins of the
+ *  tiles that it covers.
+ ***********************************************************/
+void SoftwareRenderBackend::SetupTriangle(const CLIP_VERTEX& v0, const CLIP_VERTEX& v1, const CLIP_VERTEX& v2, int draw)
+{
+	const CLIP_VERTEX* pVertices[3] = { &v0, &v1, &v2 };
+	float screenX[3];
+	float screenY[3];
+	float depth[3];
+	float inverseW[3];
+	for (int i = 0; i < 3; i++)
+	{
+		const glm::vec4& position = pVertices[i]->position;
+		inverseW[i] = 1.0f / position.w;
+		screenX[i] = (position.x * inverseW[i] * 0.5f + 0.5f) * (float)m_width;
+		screenY[i] = (position.y * inverseW[i] * 0.5f + 0.5f) * (float)m_height;
+		depth[i] = position.z * inverseW[i] * 0.5f + 0.5f;
+	}
+
+	float area = (screenX[1] - screenX[0]) * (screenY[2] - screenY[0]) - (screenX[2] - screenX[0]) * (screenY[1] - screenY[0]);
+	if (!(fabsf(area) > 0.0f))
+	{
+		return;
+	}
+
+	TRIANGLE triangle;
+	triangle.minX = std::max(0, (int)floorf(std::min(screenX[0], std::min(screenX[1], screenX[2]))));
+	triangle.minY = std::max(0, (int)floorf(std::min(screenY[0], std::min(screenY[1], screenY[2]))));
+	triangle.maxX = std::min(m_width - 1, (int)ceilf(std::max(screenX[0], std::max(screenX[1], screenX[2]))));
+	triangle.maxY = std::min(m_height - 1, (int)ceilf(std::max(screenY[0], std::max(screenY[1], screenY[2]))));
+	if ((triangle.minX > triangle.maxX) || (triangle.minY > triangle.maxY))
+	{
+		return;
+	}
+
+	// every edge is positive on the side of the vertex opposite of
+	// it, where it reaches the doubled area of the triangle
+	float sign = (area > 0.0f) ? -1.0f : 1.0f;
+	for (int i = 0; i < 3; i++)
+	{
+		int a = (i + 1) % 3;
+		int b = (i + 2) % 3;
+		double edgeA = (double)screenY[b] - (double)screenY[a];
+		double edgeB = (double)screenX[a] - (double)screenX[b];
+		double edgeC = -(edgeA * screenX[a] + edgeB * screenY[a]);
+		triangle.edgeA[i] = sign * (float)edgeA;
+		triangle.edgeB[i] = sign * (float)edgeB;
+		triangle.edgeC[i] = sign * (float)edgeC;
+		// the two triangles of a shared edge have opposite edge
+		// functions, so exactly one of them owns its pixels
+		triangle.bEdgeInclusive[i] = (triangle.edgeA[i] > 0.0f) || ((triangle.edgeA[i] == 0.0f) && (triangle.edgeB[i] > 0.0f));
+	}
+
+	float inverseArea = 1.0f / fabsf(area);
+	triangle.originX = screenX[0];
+	triangle.originY = screenY[0];
+	triangle.depthPlane = glm::vec3(
+		(triangle.edgeA[0] * depth[0] + triangle.edgeA[1] * depth[1] + triangle.edgeA[2] * depth[2]) * inverseArea,
+		(triangle.edgeB[0] * depth[0] + triangle.edgeB[1] * depth[1] + triangle.edgeB[2] * depth[2]) * inverseArea,
+		depth[0]);
+	triangle.inverseWPlane = glm::vec3(
+		(triangle.edgeA[0] * inverseW[0] + triangle.edgeA[1] * inverseW[1] + triangle.edgeA[2] * inverseW[2]) * inverseArea,
+		(triangle.edgeB[0] * inverseW[0] + triangle.edgeB[1] * inverseW[1] + triangle.edgeB[2] * inverseW[2]) * inverseArea,
+		inverseW[0]);
+	for (int k = 0; k < VARYING_COUNT; k++)
+	{
+		float value0 = v0.varyings[k] * inverseW[0];
+		float value1 = v1.varyings[k] * inverseW[1];
+		float value2 = v2.varyings[k] * inverseW[2];
+		triangle.varyingPlanes[k] = glm::vec3(
+			(triangle.edgeA[0] * value0 + triangle.edgeA[1] * value1 + triangle.edgeA[2] * value2) * inverseArea,
+			(triangle.edgeB[0] * value0 + triangle.edgeB[1] * value1 + triangle.edgeB[2] * value2) * inverseArea,
+			value0);
+	}
+	triangle.draw = draw;
+
+	uint32_t index = (uint32_t)m_triangles.size();
+	m_triangles.push_back(triangle);
+
+	// add the triangle to the tiles of its bounds, skipping the
+	// tiles that are entirely outside of one of its edges
+	int firstTileX = triangle.minX / TILE_SIZE;
+	int lastTileX = triangle.maxX / TILE_SIZE;
+	int firstTileY = triangle.minY / TILE_SIZE;
+	int lastTileY = triangle.maxY / TILE_SIZE;
+	bool bSingleTile = (firstTileX == lastTileX) && (firstTileY == lastTileY);
+	for (int tileY = firstTileY; tileY <= lastTileY; tileY++)
+	{
+		for (int tileX = firstTileX; tileX <= lastTileX; tileX++)
+		{
+			bool bCovered = true;
+			for (int i = 0; (i < 3) && (bSingleTile == false) && (bCovered == true); i++)
+			{
+				float x = (float)(tileX * TILE_SIZE + ((triangle.edgeA[i] > 0.0f) ? TILE_SIZE : 0));
+				float y = (float)(tileY * TILE_SIZE + ((triangle.edgeB[i] > 0.0f) ? TILE_SIZE : 0));
+				bCovered = (triangle.edgeA[i] * x + triangle.edgeB[i] * y + triangle.edgeC[i]) >= 0.0f;
+			}
+			if (bCovered == true)
+			{
+				m_bins[tileY * m_tilesX + tileX].push_back(index);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used to rasterize the tiles of the frame
+ *  on the render thread and the workers, and to start the
+ *  next frame with empty tiles.
+ ***********************************************************/
+void SoftwareRenderBackend::EndFrame()
+{
+	PROFILE_CPU_SCOPE("SoftwareRasterize");
+
+	double startTime = FramePacer::GetTime();
+
+	// the unused lights are black, and are skipped by every fragment
+	m_activeLightCount = 0;
+	for (int i = 0; i < LIGHT_COUNT; i++)
+	{
+		const LIGHT& light = m_lights[i];
+		if ((light.ambientColor != glm::vec3(0.0f)) ||
+			(light.diffuseColor != glm::vec3(0.0f)) ||
+			((light.specularColor != glm::vec3(0.0f)) && (light.specularIntensity != 0.0f)))
+		{
+			m_activeLights[m_activeLightCount++] = i;
+		}
+	}
+
+	int tileCount = m_tilesX * m_tilesY;
+	if (tileCount > 0)
+	{
+		if ((int)m_workers.size() != m_threadCount - 1)
+		{
+			StartWorkers();
+		}
+
+		m_nextTile = 0;
+		bool bParallel = (m_workers.empty() == false) && (tileCount > 1);
+		if (bParallel == true)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_busyWorkers = (int)m_workers.size();
+				m_generation++;
+			}
+			m_startCondition.notify_all();
+		}
+
+		RasterizeTiles();
+
+		if (bParallel == true)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_doneCondition.wait(lock, [this]() { return(m_busyWorkers == 0); });
+		}
+	}
+
+	m_frameCount++;
+	m_triangleTotal += m_triangles.size();
+	m_rasterTimeTotal += FramePacer::GetTime() - startTime;
+
+	// the bins keep their memory from frame to frame
+	for (size_t i = 0; i < m_bins.size(); i++)
+	{
+		m_binTotal += m_bins[i].size();
+		m_bins[i].clear();
+	}
+	m_draws.clear();
+	m_triangles.clear();
+
+	for (size_t i = 0; i < m_destroyedTextures.size(); i++)
+	{
+		delete m_destroyedTextures[i];
+	}
+	m_destroyedTextures.clear();
+}
+
+/***********************************************************
+ *  RasterizeTiles()
+ *
+ *  This method is used to rasterize tiles until all of the
+ *  tiles of the frame have been taken.  The tiles are taken
+ *  one at a time, so the threads stay busy when some tiles
+ *  hold many more triangles than others.
+ ***********************************************************/
+void SoftwareRenderBackend::RasterizeTiles()
+{
+	int tileCount = m_tilesX * m_tilesY;
+	int tile = m_nextTile.fetch_add(1);
+	while (tile < tileCount)
+	{
+		RasterizeTile(tile);
+		tile = m_nextTile.fetch_add(1);
+	}
+}
+
+/***********************************************************
+ *  RasterizeTile()
+ *
+ *  This method is used to clear a tile, to draw its
+ *  triangles in the order they were submitted, and to copy
+ *  it into the finished frame.
+ ***********************************************************/
+void SoftwareRenderBackend::RasterizeTile(int tile)
+{
+	int tileX = (tile % m_tilesX) * TILE_SIZE;
+	int tileY = (tile / m_tilesX) * TILE_SIZE;
+	int endX = std::min(tileX + TILE_SIZE, m_stride);
+	int endY = std::min(tileY + TILE_SIZE, m_height);
+
+	for (int y = tileY; y < endY; y++)
+	{
+		unsigned char* pColor = &m_colorBuffer[((size_t)y * m_stride + tileX) * 4];
+		float* pDepth = &m_depthBuffer[(size_t)y * m_stride + tileX];
+		for (int x = tileX; x < endX; x++)
+		{
+			pColor[0] = 0;
+			pColor[1] = 0;
+			pColor[2] = 0;
+			pColor[3] = 255;
+			pColor += 4;
+			*pDepth++ = 1.0f;
+		}
+	}
+
+	const std::vector<uint32_t>& bin = m_bins[tile];
+	for (size_t i = 0; i < bin.size(); i++)
+	{
+		RasterizeTriangle(m_triangles[bin[i]], tileX, tileY);
+	}
+
+	int rowBytes = (std::min(tileX + TILE_SIZE, m_width) - tileX) * 4;
+	for (int y = tileY; y < endY; y++)
+	{
+		memcpy(
+			&m_pixels[((size_t)y * m_width + tileX) * 4],
+			&m_colorBuffer[((size_t)y * m_stride + tileX) * 4],
+			rowBytes);
+	}
+}
+
+/***********************************************************
+ *  RasterizeTriangle()
+ *
+ *  This method is used to draw the part of a triangle inside
+ *  of a tile.  The coverage, depth test and interpolation are
+ *  computed for four pixels of a row at once, and the pixels
+ *  that pass are shaded one by one.
+ ***********************************************************/
+void SoftwareRenderBackend::RasterizeTriangle(const TRIANGLE& triangle, int tileX, int tileY)
+{
+	const DRAW_STATE& state = m_draws[triangle.draw];
+
+	// the groups of four pixels start at multiples of four, which
+	// keeps them inside the tile and the padded rows
+	int startX = std::max(triangle.minX, tileX) & ~3;
+	int endX = std::min(triangle.maxX, std::min(tileX + TILE_SIZE - 1, m_width - 1));
+	int startY = std::max(triangle.minY, tileY);
+	int endY = std::min(triangle.maxY, std::min(tileY + TILE_SIZE - 1, m_height - 1));
+
+	bool bDepthWrite = (state.bDepthTest == true) && (state.bDepthWrite == true);
+	FRAGMENT_QUAD quad;
+
+#ifdef SOFTWARERENDERBACKEND_USE_SSE2
+	const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 originX = _mm_set1_ps(triangle.originX);
+	const __m128 depthX = _mm_set1_ps(triangle.depthPlane.x);
+	const __m128 inverseWX = _mm_set1_ps(triangle.inverseWPlane.x);
+	__m128 edgeA[3];
+	for (int i = 0; i < 3; i++)
+	{
+		edgeA[i] = _mm_set1_ps(triangle.edgeA[i]);
+	}
+#endif
+
+	for (int y = startY; y <= endY; y++)
+	{
+		float pixelY = (float)y + 0.5f;
+		float offsetY = pixelY - triangle.originY;
+		float rowEdges[3];
+		for (int i = 0; i < 3; i++)
+		{
+			rowEdges[i] = triangle.edgeB[i] * pixelY + triangle.edgeC[i];
+		}
+		float rowDepth = triangle.depthPlane.z + triangle.depthPlane.y * offsetY;
+		float rowInverseW = triangle.inverseWPlane.z + triangle.inverseWPlane.y * offsetY;
+		float* pDepthRow = &m_depthBuffer[(size_t)y * m_stride];
+		unsigned char* pColorRow = &m_colorBuffer[(size_t)y * m_stride * 4];
+
+		for (int x = startX; x <= endX; x += 4)
+		{
+			// lanes past the right edge of the frame are never drawn
+			int laneMask = (endX - x >= 3) ? 0xF : ((1 << (endX - x + 1)) - 1);
+
+#ifdef SOFTWARERENDERBACKEND_USE_SSE2
+			__m128 pixelX = _mm_add_ps(_mm_set1_ps((float)x), laneOffsets);
+			__m128 covered = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int i = 0; i < 3; i++)
+			{
+				__m128 edge = _mm_add_ps(_mm_mul_ps(edgeA[i], pixelX), _mm_set1_ps(rowEdges[i]));
+				covered = _mm_and_ps(covered, (triangle.bEdgeInclusive[i] == true) ? _mm_cmpge_ps(edge, zero) : _mm_cmpgt_ps(edge, zero));
+			}
+			__m128 offsetX = _mm_sub_ps(pixelX, originX);
+			__m128 fragmentDepth = _mm_add_ps(_mm_mul_ps(depthX, offsetX), _mm_set1_ps(rowDepth));
+			covered = _mm_and_ps(covered, _mm_and_ps(_mm_cmpge_ps(fragmentDepth, zero), _mm_cmple_ps(fragmentDepth, one)));
+			if (state.bDepthTest == true)
+			{
+				__m128 storedDepth = _mm_loadu_ps(pDepthRow + x);
+				if (state.depthFunction == DEPTH_LESS)
+				{
+					covered = _mm_and_ps(covered, _mm_cmplt_ps(fragmentDepth, storedDepth));
+				}
+				else if (state.depthFunction == DEPTH_LESS_EQUAL)
+				{
+					covered = _mm_and_ps(covered, _mm_cmple_ps(fragmentDepth, storedDepth));
+				}
+				else
+				{
+					covered = _mm_and_ps(covered, _mm_cmpeq_ps(fragmentDepth, storedDepth));
+				}
+			}
+			int mask = _mm_movemask_ps(covered) & laneMask;
+			if (mask == 0)
+			{
+				continue;
+			}
+
+			// the values are interpolated over W and divided by it
+			__m128 fragmentInverseW = _mm_add_ps(_mm_mul_ps(inverseWX, offsetX), _mm_set1_ps(rowInverseW));
+			__m128 fragmentW = _mm_div_ps(one, fragmentInverseW);
+			_mm_storeu_ps(quad.depth, fragmentDepth);
+			_mm_storeu_ps(quad.inverseW, fragmentInverseW);
+			for (int k = 0; k < VARYING_COUNT; k++)
+			{
+				const glm::vec3& plane = triangle.varyingPlanes[k];
+				__m128 value = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), offsetX), _mm_set1_ps(plane.z + plane.y * offsetY));
+				_mm_storeu_ps(quad.varyings[k], _mm_mul_ps(value, fragmentW));
+			}
+#else
+			int mask = 0;
+			for (int lane = 0; lane < 4; lane++)
+			{
+				float pixelX = (float)(x + lane) + 0.5f;
+				bool bCovered = ((laneMask >> lane) & 1) != 0;
+				for (int i = 0; (i < 3) && (bCovered == true); i++)
+				{
+					float edge = triangle.edgeA[i] * pixelX + rowEdges[i];
+					bCovered = (triangle.bEdgeInclusive[i] == true) ? (edge >= 0.0f) : (edge > 0.0f);
+				}
+				float offsetX = pixelX - triangle.originX;
+				float fragmentDepth = triangle.depthPlane.x * offsetX + rowDepth;
+				bCovered = bCovered && (fragmentDepth >= 0.0f) && (fragmentDepth <= 1.0f);
+				if ((bCovered == true) && (state.bDepthTest == true))
+				{
+					float storedDepth = pDepthRow[x + lane];
+					if (state.depthFunction == DEPTH_LESS)
+					{
+						bCovered = (fragmentDepth < storedDepth);
+					}
+					else if (state.depthFunction == DEPTH_LESS_EQUAL)
+					{
+						bCovered = (fragmentDepth <= storedDepth);
+					}
+					else
+					{
+						bCovered = (fragmentDepth == storedDepth);
+					}
+				}
+				if (bCovered == false)
+				{
+					continue;
+				}
+
+				mask |= (1 << lane);
+				float fragmentInverseW = triangle.inverseWPlane.x * offsetX + rowInverseW;
+				float fragmentW = 1.0f / fragmentInverseW;
+				quad.depth[lane] = fragmentDepth;
+				quad.inverseW[lane] = fragmentInverseW;
+				for (int k = 0; k < VARYING_COUNT; k++)
+				{
+					const glm::vec3& plane = triangle.varyingPlanes[k];
+					quad.varyings[k][lane] = (plane.x * offsetX + plane.z + plane.y * offsetY) * fragmentW;
+				}
+			}
+			if (mask == 0)
+			{
+				continue;
+			}
+#endif
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				if (((mask >> lane) & 1) == 0)
+				{
+					continue;
+				}
+
+				float varyings[VARYING_COUNT];
+				for (int k = 0; k < VARYING_COUNT; k++)
+				{
+					varyings[k] = quad.varyings[k][lane];
+				}
+
+				// the change of the texture coordinate to the next
+				// pixels selects the mip level, like the derivatives
+				// of the fragment shader
+				glm::vec2 uvDx(0.0f);
+				glm::vec2 uvDy(0.0f);
+				if (NULL != state.pTexture)
+				{
+					float inverseW = quad.inverseW[lane];
+					const glm::vec3& uPlane = triangle.varyingPlanes[6];
+					const glm::vec3& vPlane = triangle.varyingPlanes[7];
+					uvDx = glm::vec2(
+						(uPlane.x - varyings[6] * triangle.inverseWPlane.x) / inverseW,
+						(vPlane.x - varyings[7] * triangle.inverseWPlane.x) / inverseW) * state.uvScale;
+					uvDy = glm::vec2(
+						(uPlane.y - varyings[6] * triangle.inverseWPlane.y) / inverseW,
+						(vPlane.y - varyings[7] * triangle.inverseWPlane.y) / inverseW) * state.uvScale;
+				}
+
+				glm::vec4 color = ShadeFragment(state, varyings, uvDx, uvDy);
+				unsigned char* pColor = pColorRow + (size_t)(x + lane) * 4;
+				if (state.bBlend == true)
+				{
+					color = color * color.a + UnpackColor(pColor) * (1.0f - color.a);
+				}
+				if (state.bColorWrite == true)
+				{
+					PackColor(color, pColor);
+				}
+				if (bDepthWrite == true)
+				{
+					pDepthRow[x + lane] = quad.depth[lane];
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  ShadeFragment()
+ *
+ *  This method is used to compute the color of a fragment
+ *  the same way as the fragment shader, with the Phong
+ *  lighting of the uniform lights.
+ ***********************************************************/
+glm::vec4 SoftwareRenderBackend::ShadeFragment(const DRAW_STATE& state, const float* varyings, const glm::vec2& uvDx, const glm::vec2& uvDy) const
+{
+	glm::vec4 baseColor = state.color;
+	if (NULL != state.pTexture)
+	{
+		glm::vec2 textureCoordinate = glm::vec2(varyings[6], varyings[7]) * state.uvScale + state.uvOffset;
+		baseColor = SampleTexture(*state.pTexture, textureCoordinate, uvDx, uvDy);
+	}
+
+	if (state.bUseLighting == false)
+	{
+		return(baseColor);
+	}
+
+	const MATERIAL& material = state.material;
+	glm::vec3 position(varyings[0], varyings[1], varyings[2]);
+	glm::vec3 normal = glm::normalize(glm::vec3(varyings[3], varyings[4], varyings[5]));
+	glm::vec3 viewDirection = glm::normalize(m_viewPosition - position);
+
+	glm::vec3 phongResult(0.0f);
+	for (int i = 0; i < m_activeLightCount; i++)
+	{
+		const LIGHT& light = m_lights[m_activeLights[i]];
+
+		// a light with a radius fades out smoothly before reaching it
+		glm::vec3 toLight = light.position - position;
+		float lightDistance = glm::length(toLight);
+		float attenuation = 1.0f;
+		if (light.radius > 0.0f)
+		{
+			float ratio = lightDistance / light.radius;
+			float window = glm::clamp(1.0f - ratio * ratio * ratio * ratio, 0.0f, 1.0f);
+			attenuation = window * window / (1.0f + lightDistance * lightDistance);
+		}
+		if (attenuation <= 0.0f)
+		{
+			continue;
+		}
+
+		glm::vec3 ambient = light.ambientColor * material.ambientColor * material.ambientStrength;
+
+		glm::vec3 lightDirection = (lightDistance > 0.0f) ? (toLight / lightDistance) : glm::vec3(0.0f);
+		float impact = std::max(glm::dot(normal, lightDirection), 0.0f);
+		glm::vec3 diffuse = impact * light.diffuseColor * material.diffuseColor;
+
+		glm::vec3 reflectDirection = glm::reflect(-lightDirection, normal);
+		float highlight = glm::dot(viewDirection, reflectDirection);
+		if (highlight > 0.0f)
+		{
+			float specularComponent = powf(highlight, light.focalStrength);
+			diffuse += light.specularIntensity * specularComponent * light.specularColor * material.specularColor;
+		}
+
+		phongResult += (ambient + diffuse) * attenuation;
+	}
+
+	return(glm::vec4(phongResult * glm::vec3(baseColor), baseColor.a));
+}
+
+/***********************************************************
+ *  SampleTexture()
+ *
+ *  This method is used to sample a texture with bilinear
+ *  filtering and repeating coordinates, from the mip level
+ *  whose texels are closest to the size of a pixel.
+ ***********************************************************/
+glm::vec4 SoftwareRenderBackend::SampleTexture(const TEXTURE& texture, const glm::vec2& textureCoordinate, const glm::vec2& uvDx, const glm::vec2& uvDy) const
+{
+	const MIP_LEVEL& base = texture.mips[0];
+	glm::vec2 size((float)base.width, (float)base.height);
+	glm::vec2 texelDx = uvDx * size;
+	glm::vec2 texelDy = uvDy * size;
+	float footprint = std::max(glm::dot(texelDx, texelDx), glm::dot(texelDy, texelDy));
+
+	int level = 0;
+	if (footprint > 1.0f)
+	{
+		level = (int)(0.5f * log2f(footprint) + 0.5f);
+		level = std::min(level, (int)texture.mips.size() - 1);
+	}
+	const MIP_LEVEL& mip = texture.mips[level];
+
+	float u = textureCoordinate.x - floorf(textureCoordinate.x);
+	float v = textureCoordinate.y - floorf(textureCoordinate.y);
+	float x = u * (float)mip.width - 0.5f;
+	float y = v * (float)mip.height - 0.5f;
+	float x0 = floorf(x);
+	float y0 = floorf(y);
+	float fractionX = x - x0;
+	float fractionY = y - y0;
+	int left = WrapCoordinate((int)x0, mip.width);
+	int right = WrapCoordinate((int)x0 + 1, mip.width);
+	int bottom = WrapCoordinate((int)y0, mip.height);
+	int top = WrapCoordinate((int)y0 + 1, mip.height);
+
+	const unsigned char* pTexels = mip.texels.data();
+	glm::vec4 bottomLeft = UnpackColor(pTexels + ((size_t)bottom * mip.width + left) * 4);
+	glm::vec4 bottomRight = UnpackColor(pTexels + ((size_t)bottom * mip.width + right) * 4);
+	glm::vec4 topLeft = UnpackColor(pTexels + ((size_t)top * mip.width + left) * 4);
+	glm::vec4 topRight = UnpackColor(pTexels + ((size_t)top * mip.width + right) * 4);
+
+	return(glm::mix(
+		glm::mix(bottomLeft, bottomRight, fractionX),
+		glm::mix(topLeft, topRight, fractionX),
+		fractionY));
+}
+
+/***********************************************************
+ *  StartWorkers()
+ *
+ *  This method is used to start the worker threads, which
+ *  rasterize the tiles together with the render thread.
+ ***********************************************************/
+void SoftwareRenderBackend::StartWorkers()
+{
+	StopWorkers();
+
+	m_bShutdown = false;
+	for (int i = 1; i < m_threadCount; i++)
+	{
+		m_workers.push_back(std::thread(&SoftwareRenderBackend::WorkerLoop, this, m_generation));
+	}
+}
+
+/***********************************************************
+ *  StopWorkers()
+ *
+ *  This method is used to stop the worker threads and to
+ *  wait for them to finish.
+ ***********************************************************/
+void SoftwareRenderBackend::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bShutdown = true;
+	}
+	m_startCondition.notify_all();
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is run by every worker thread.  It waits for
+ *  the next frame, rasterizes tiles until none are left, and
+ *  reports back, until the workers are stopped.  The
+ *  workers start with the generation of the last frame, so
+ *  they never miss the frame they were started for.
+ ***********************************************************/
+void SoftwareRenderBackend::WorkerLoop(uint64_t generation)
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_startCondition.wait(lock, [this, generation]() { return((m_bShutdown == true) || (m_generation != generation)); });
+			if (m_bShutdown == true)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		RasterizeTiles();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_busyWorkers--;
+		}
+		m_doneCondition.notify_one();
+	}
+}
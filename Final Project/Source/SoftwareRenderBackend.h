@@ -0,0 +1,273 @@
+///////////////////////////////////////////////////////////////////////////////
+// softwarerenderbackend.h
+// ============
+// rasterize the scene on the CPU with a pool of threads
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderBackend.h"
+#include "ShapeGeometry.h"
+
+#include <GL/glew.h>
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <ostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+/***********************************************************
+ *  SoftwareRenderBackend
+ *
+ *  This class contains a render backend that draws the scene
+ *  on the CPU.  The draws of a frame are transformed, clipped
+ *  against the near plane and sorted into the screen tiles
+ *  they cover as they are submitted.  At the end of the frame
+ *  the tiles are rasterized by a pool of threads, four pixels
+ *  at a time, with the depth test, the textures, the Phong
+ *  lighting of the fragment shader and the blending of the
+ *  OpenGL pipeline.  Every tile is drawn by one thread in the
+ *  order of the draws, so no locks are needed on the buffers.
+ *  The finished frame is copied into the bound OpenGL
+ *  framebuffer to be shown or read back.
+ ***********************************************************/
+class SoftwareRenderBackend : public RenderBackend
+{
+public:
+	// constructor
+	SoftwareRenderBackend();
+	// destructor
+	virtual ~SoftwareRenderBackend();
+
+	// set the number of threads that rasterize the tiles,
+	// including the render thread
+	void SetThreadCount(int threadCount);
+	// resize the color and depth buffers for the next frames
+	void SetFramebufferSize(int width, int height);
+
+	// copy the last finished frame into the bound framebuffer,
+	// stretched over the given size
+	void Present(int width, int height);
+
+	// write the average triangles and rasterization time per frame
+	void WriteReport(std::ostream& stream);
+	bool WriteReport(const char* filename);
+
+	virtual const char* GetName() const;
+	virtual bool SupportsOpenGLPasses() const;
+
+	virtual uint32_t CreateBuffer(BUFFER_TYPE type, const void* pData, size_t size);
+	virtual void UpdateBuffer(uint32_t buffer, size_t offset, const void* pData, size_t size);
+	virtual void DestroyBuffer(uint32_t buffer);
+
+	virtual uint32_t CreateTexture(int width, int height, const unsigned char* pPixels, bool bGenerateMips);
+	virtual void DestroyTexture(uint32_t texture);
+	virtual void BindTexture(int unit, uint32_t texture);
+
+	virtual uint32_t CreateProgram(const char* vertexShaderPath, const char* fragmentShaderPath);
+	virtual void DestroyProgram(uint32_t program);
+	virtual void UseProgram(uint32_t program);
+
+	virtual void SetIntValue(const char* name, int value);
+	virtual void SetFloatValue(const char* name, float value);
+	virtual void SetVec2Value(const char* name, const glm::vec2& value);
+	virtual void SetVec3Value(const char* name, const glm::vec3& value);
+	virtual void SetVec4Value(const char* name, const glm::vec4& value);
+	virtual void SetMat4Value(const char* name, const glm::mat4& value);
+
+	virtual void SetState(RENDER_STATE state, bool bEnabled);
+	virtual void SetDepthFunction(DEPTH_FUNCTION function);
+
+	virtual void DrawShape(SHAPE_MESH shape);
+
+	virtual void EndFrame();
+
+private:
+	// size of the square screen tiles in pixels
+	static const int TILE_SIZE = 64;
+	// number of the uniform lights of the fragment shader
+	static const int LIGHT_COUNT = 4;
+	// values interpolated over the triangles: the world position,
+	// the normal and the texture coordinate
+	static const int VARYING_COUNT = 8;
+
+	struct MIP_LEVEL
+	{
+		int width;
+		int height;
+		// RGBA bytes of the texels, from the bottom row up
+		std::vector<unsigned char> texels;
+	};
+
+	struct TEXTURE
+	{
+		std::vector<MIP_LEVEL> mips;
+	};
+
+	struct MATERIAL
+	{
+		glm::vec3 ambientColor;
+		float ambientStrength;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+	};
+
+	struct LIGHT
+	{
+		glm::vec3 position;
+		float radius;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float focalStrength;
+		float specularIntensity;
+	};
+
+	// the uniforms and render state that a draw is shaded with
+	struct DRAW_STATE
+	{
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		glm::vec2 uvOffset;
+		MATERIAL material;
+		// texture of the draw, or NULL to use the color
+		const TEXTURE* pTexture;
+		bool bUseLighting;
+		bool bDepthTest;
+		bool bDepthWrite;
+		bool bColorWrite;
+		bool bBlend;
+		DEPTH_FUNCTION depthFunction;
+	};
+
+	// a vertex transformed into clip space
+	struct CLIP_VERTEX
+	{
+		glm::vec4 position;
+		float varyings[VARYING_COUNT];
+	};
+
+	// a triangle set up for rasterization, with its edges and its
+	// interpolated values as planes over the screen
+	struct TRIANGLE
+	{
+		// the edge functions A * x + B * y + C, which are positive
+		// inside, and whether the pixels right on them are inside,
+		// so the pixels of a shared edge are only drawn once
+		float edgeA[3];
+		float edgeB[3];
+		float edgeC[3];
+		bool bEdgeInclusive[3];
+		// the planes hold the value at the first vertex and its
+		// change along X and Y, with the varyings divided by W so
+		// they are interpolated with the right perspective
+		float originX;
+		float originY;
+		glm::vec3 depthPlane;
+		glm::vec3 inverseWPlane;
+		glm::vec3 varyingPlanes[VARYING_COUNT];
+		// pixel bounds, and the draw that the triangle belongs to
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+		int draw;
+	};
+
+	// the triangles of every shape
+	struct SHAPE
+	{
+		std::vector<ShapeGeometry::VERTEX> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	SHAPE m_shapes[SHAPE_COUNT];
+
+	// textures by handle, and the texture bound to every unit
+	std::vector<TEXTURE*> m_textures;
+	std::vector<TEXTURE*> m_destroyedTextures;
+	std::vector<uint32_t> m_boundTextures;
+
+	// current uniforms and render state
+	glm::mat4 m_model;
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	glm::vec3 m_viewPosition;
+	LIGHT m_lights[LIGHT_COUNT];
+	// the lights that reach anything in the frame being rasterized
+	int m_activeLights[LIGHT_COUNT];
+	int m_activeLightCount;
+	DRAW_STATE m_state;
+	bool m_bUseTexture;
+	int m_textureUnit;
+
+	// color and depth buffers, with rows padded to groups of four
+	// pixels, and the finished frame with tightly packed rows
+	int m_width;
+	int m_height;
+	int m_stride;
+	int m_tilesX;
+	int m_tilesY;
+	std::vector<unsigned char> m_colorBuffer;
+	std::vector<float> m_depthBuffer;
+	std::vector<unsigned char> m_pixels;
+
+	// draws and triangles of the frame, and the triangles that
+	// touch every tile in the order they were drawn
+	std::vector<DRAW_STATE> m_draws;
+	std::vector<TRIANGLE> m_triangles;
+	std::vector<std::vector<uint32_t> > m_bins;
+	std::vector<CLIP_VERTEX> m_clipVertices;
+
+	// texture and framebuffer that the frame is copied through
+	GLuint m_presentTexture;
+	GLuint m_presentFramebuffer;
+	int m_presentWidth;
+	int m_presentHeight;
+
+	// worker threads that rasterize the tiles
+	std::vector<std::thread> m_workers;
+	int m_threadCount;
+	std::atomic<int> m_nextTile;
+	std::mutex m_mutex;
+	std::condition_variable m_startCondition;
+	std::condition_variable m_doneCondition;
+	uint64_t m_generation;
+	int m_busyWorkers;
+	bool m_bShutdown;
+
+	// totals of the finished frames
+	uint64_t m_frameCount;
+	uint64_t m_triangleTotal;
+	uint64_t m_binTotal;
+	double m_rasterTimeTotal;
+
+	// transform a vertex of a shape into clip space
+	void TransformVertex(const ShapeGeometry::VERTEX& vertex, const glm::mat4& modelViewProjection, const glm::mat3& normalMatrix, CLIP_VERTEX& output);
+	// clip a triangle against the near plane and set up the pieces
+	void ClipTriangle(const CLIP_VERTEX& v0, const CLIP_VERTEX& v1, const CLIP_VERTEX& v2, int draw);
+	// set up a triangle in clip space and add it to its tiles
+	void SetupTriangle(const CLIP_VERTEX& v0, const CLIP_VERTEX& v1, const CLIP_VERTEX& v2, int draw);
+	// draw the triangles of the tiles taken from the shared counter
+	void RasterizeTiles();
+	void RasterizeTile(int tile);
+	void RasterizeTriangle(const TRIANGLE& triangle, int tileX, int tileY);
+	// shade a fragment with the uniforms of its draw
+	glm::vec4 ShadeFragment(const DRAW_STATE& state, const float* varyings, const glm::vec2& uvDx, const glm::vec2& uvDy) const;
+	glm::vec4 SampleTexture(const TEXTURE& texture, const glm::vec2& textureCoordinate, const glm::vec2& uvDx, const glm::vec2& uvDy) const;
+	// set a light uniform from its name
+	bool SetLightValue(const char* name, const float* pValues, int valueCount);
+	// start and stop the worker threads
+	void StartWorkers();
+	void StopWorkers();
+	void WorkerLoop(uint64_t generation);
+};
@@ -0,0 +1,367 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureatlas.cpp
+// ============
+// pack small scene textures into shared atlas textures
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureAtlas.h"
+
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// largest image dimension that is packed into an atlas
+	const int g_AtlasMaxTileSize = 512;
+}
+
+/***********************************************************
+ *  TextureAtlas()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureAtlas::TextureAtlas(int pageSize, int padding)
+{
+	m_pageSize = pageSize;
+	m_padding = padding;
+
+	// the gutter shrinks by half with every mip level, so only
+	// the levels that keep at least one gutter texel are used
+	m_maxMipLevel = 0;
+	while ((1 << (m_maxMipLevel + 1)) <= m_padding)
+	{
+		m_maxMipLevel++;
+	}
+}
+
+/***********************************************************
+ *  ~TextureAtlas()
+ *
+ *  The destructor for the class.  The page textures are
+ *  registered with the scene and freed with its textures.
+ ***********************************************************/
+TextureAtlas::~TextureAtlas()
+{
+	m_pages.clear();
+	m_tiles.clear();
+}
+
+/***********************************************************
+ *  IsCandidate()
+ *
+ *  This method is used for checking whether an image of the
+ *  passed in size should be packed into the atlas.
+ ***********************************************************/
+bool TextureAtlas::IsCandidate(int width, int height) const
+{
+	return((width > 0) && (height > 0) &&
+		(width <= g_AtlasMaxTileSize) && (height <= g_AtlasMaxTileSize) &&
+		(width + 2 * m_padding <= m_pageSize) && (height + 2 * m_padding <= m_pageSize));
+}
+
+/***********************************************************
+ *  AddPage()
+ *
+ *  This method is used for adding an empty atlas page whose
+ *  skyline spans the full page width.
+ ***********************************************************/
+TextureAtlas::ATLAS_PAGE& TextureAtlas::AddPage()
+{
+	ATLAS_PAGE page;
+	SKYLINE_NODE node;
+
+	node.x = 0;
+	node.y = 0;
+	node.width = m_pageSize;
+	page.skyline.push_back(node);
+	page.pixels.assign((size_t)m_pageSize * m_pageSize * 4, 0);
+	page.usedHeight = 0;
+	page.textureID = 0;
+	m_pages.push_back(page);
+
+	return(m_pages.back());
+}
+
+/***********************************************************
+ *  PackRect()
+ *
+ *  This method is used for finding the bottom-left position
+ *  for a rectangle on the page skyline and raising the
+ *  skyline over the placed rectangle.
+ ***********************************************************/
+bool TextureAtlas::PackRect(ATLAS_PAGE& page, int width, int height, int& x, int& y)
+{
+	int bestIndex = -1;
+	int bestY = m_pageSize;
+	int bestWidth = m_pageSize;
+
+	for (size_t i = 0; i < page.skyline.size(); i++)
+	{
+		int nodeX = page.skyline[i].x;
+		if (nodeX + width > m_pageSize)
+		{
+			break;
+		}
+
+		// the rectangle rests on the highest node that it spans
+		int restY = 0;
+		int remaining = width;
+		size_t j = i;
+		while ((remaining > 0) && (j < page.skyline.size()))
+		{
+			if (page.skyline[j].y > restY)
+			{
+				restY = page.skyline[j].y;
+			}
+			remaining -= page.skyline[j].width;
+			j++;
+		}
+
+		if (restY + height > m_pageSize)
+		{
+			continue;
+		}
+		if ((restY < bestY) ||
+			((restY == bestY) && (page.skyline[i].width < bestWidth)))
+		{
+			bestIndex = (int)i;
+			bestY = restY;
+			bestWidth = page.skyline[i].width;
+		}
+	}
+
+	if (bestIndex < 0)
+	{
+		return(false);
+	}
+
+	x = page.skyline[bestIndex].x;
+	y = bestY;
+
+	// insert the raised node and trim the nodes that it covers
+	SKYLINE_NODE node;
+	node.x = x;
+	node.y = y + height;
+	node.width = width;
+	page.skyline.insert(page.skyline.begin() + bestIndex, node);
+
+	size_t i = bestIndex + 1;
+	while (i < page.skyline.size())
+	{
+		int coveredEnd = node.x + node.width;
+		if (page.skyline[i].x >= coveredEnd)
+		{
+			break;
+		}
+
+		int shrink = coveredEnd - page.skyline[i].x;
+		page.skyline[i].x += shrink;
+		page.skyline[i].width -= shrink;
+		if (page.skyline[i].width <= 0)
+		{
+			page.skyline.erase(page.skyline.begin() + i);
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	// merge neighbouring nodes at the same height
+	i = 0;
+	while (i + 1 < page.skyline.size())
+	{
+		if (page.skyline[i].y == page.skyline[i + 1].y)
+		{
+			page.skyline[i].width += page.skyline[i + 1].width;
+			page.skyline.erase(page.skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	if (y + height > page.usedHeight)
+	{
+		page.usedHeight = y + height;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  AddImage()
+ *
+ *  This method is used for packing the pixels of an image
+ *  into the first atlas page with enough room, surrounded by
+ *  a gutter that replicates the image edges.
+ ***********************************************************/
+bool TextureAtlas::AddImage(
+	const unsigned char* pixels,
+	int width,
+	int height,
+	int colorChannels,
+	std::string tag)
+{
+	if ((IsCandidate(width, height) == false) ||
+		((colorChannels != 3) && (colorChannels != 4)))
+	{
+		return(false);
+	}
+
+	// pad the rectangle and round it up to the gutter alignment so
+	// that tiles never share texels at the lower mip levels
+	int alignment = 1 << m_maxMipLevel;
+	int paddedWidth = ((width + 2 * m_padding + alignment - 1) / alignment) * alignment;
+	int paddedHeight = ((height + 2 * m_padding + alignment - 1) / alignment) * alignment;
+
+	int pageIndex = -1;
+	int x = 0;
+	int y = 0;
+	for (size_t i = 0; (i < m_pages.size()) && (pageIndex < 0); i++)
+	{
+		if (PackRect(m_pages[i], paddedWidth, paddedHeight, x, y) == true)
+		{
+			pageIndex = (int)i;
+		}
+	}
+	if (pageIndex < 0)
+	{
+		AddPage();
+		if (PackRect(m_pages.back(), paddedWidth, paddedHeight, x, y) == false)
+		{
+			return(false);
+		}
+		pageIndex = (int)m_pages.size() - 1;
+	}
+
+	// copy the image and its clamped edges into the page
+	ATLAS_PAGE& page = m_pages[pageIndex];
+	for (int row = 0; row < paddedHeight; row++)
+	{
+		int sourceY = row - m_padding;
+		sourceY = (sourceY < 0) ? 0 : ((sourceY >= height) ? (height - 1) : sourceY);
+		unsigned char* destination = &page.pixels[((size_t)(y + row) * m_pageSize + x) * 4];
+		for (int column = 0; column < paddedWidth; column++)
+		{
+			int sourceX = column - m_padding;
+			sourceX = (sourceX < 0) ? 0 : ((sourceX >= width) ? (width - 1) : sourceX);
+			const unsigned char* source = &pixels[((size_t)sourceY * width + sourceX) * colorChannels];
+			destination[column * 4 + 0] = source[0];
+			destination[column * 4 + 1] = source[1];
+			destination[column * 4 + 2] = source[2];
+			destination[column * 4 + 3] = (colorChannels == 4) ? source[3] : 255;
+		}
+	}
+
+	ATLAS_TILE tile;
+	tile.tag = tag;
+	tile.page = pageIndex;
+	tile.bTranslucent = false;
+	for (size_t i = 3; (colorChannels == 4) && (i < (size_t)width * height * 4) && (tile.bTranslucent == false); i += 4)
+	{
+		tile.bTranslucent = (pixels[i] < 255);
+	}
+	m_tiles.push_back(tile);
+	m_tilePositions.push_back(glm::ivec2(x + m_padding, y + m_padding));
+	m_tileSizes.push_back(glm::ivec2(width, height));
+
+	return(true);
+}
+
+/***********************************************************
+ *  BuildPages()
+ *
+ *  This method is used for uploading every packed page into
+ *  an OpenGL texture.  Each page is cropped to the height in
+ *  use, and the tile texture coordinates are computed from
+ *  the final page size.
+ ***********************************************************/
+int TextureAtlas::BuildPages()
+{
+	for (size_t i = 0; i < m_pages.size(); i++)
+	{
+		ATLAS_PAGE& page = m_pages[i];
+		int alignment = 1 << m_maxMipLevel;
+		int pageHeight = ((page.usedHeight + alignment - 1) / alignment) * alignment;
+
+		glGenTextures(1, &page.textureID);
+		glBindTexture(GL_TEXTURE_2D, page.textureID);
+
+		// tiles never wrap, so the page itself is clamped
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		// the minified tiles blend the mip levels, which the gutters
+		// keep from sampling the neighbouring tiles
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		// limit the mip chain to the levels that stay inside the gutters
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_maxMipLevel);
+
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_pageSize, pageHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, page.pixels.data());
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		std::cout << "Successfully built texture atlas page:" << i << ", width:" << m_pageSize << ", height:" << pageHeight << std::endl;
+
+		for (size_t t = 0; t < m_tiles.size(); t++)
+		{
+			if (m_tiles[t].page == (int)i)
+			{
+				m_tiles[t].offset = glm::vec2(
+					(float)m_tilePositions[t].x / (float)m_pageSize,
+					(float)m_tilePositions[t].y / (float)pageHeight);
+				m_tiles[t].scale = glm::vec2(
+					(float)m_tileSizes[t].x / (float)m_pageSize,
+					(float)m_tileSizes[t].y / (float)pageHeight);
+			}
+		}
+
+		// the pixels are no longer needed once they are uploaded
+		std::vector<unsigned char>().swap(page.pixels);
+	}
+
+	return((int)m_pages.size());
+}
+
+/***********************************************************
+ *  GetPageCount()
+ *
+ *  This method is used for getting the number of pages.
+ ***********************************************************/
+int TextureAtlas::GetPageCount() const
+{
+	return((int)m_pages.size());
+}
+
+/***********************************************************
+ *  GetPageTexture()
+ *
+ *  This method is used for getting the OpenGL texture of
+ *  an atlas page.
+ ***********************************************************/
+GLuint TextureAtlas::GetPageTexture(int page) const
+{
+	return(m_pages[page].textureID);
+}
+
+/***********************************************************
+ *  FindTile()
+ *
+ *  This method is used for finding a packed tile by tag.
+ ***********************************************************/
+const TextureAtlas::ATLAS_TILE* TextureAtlas::FindTile(const char* tag) const
+{
+	for (size_t i = 0; i < m_tiles.size(); i++)
+	{
+		if (m_tiles[i].tag.compare(tag) == 0)
+		{
+			return(&m_tiles[i]);
+		}
+	}
+
+	return(NULL);
+}
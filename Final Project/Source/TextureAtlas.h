@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureatlas.h
+// ============
+// pack small scene textures into shared atlas textures
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureAtlas
+ *
+ *  This class contains the code for packing small texture
+ *  images into shared atlas pages with a skyline packer.
+ *  Every tile is surrounded by a gutter of replicated edge
+ *  texels and aligned to the gutter size, so the limited
+ *  mip chain of a page never bleeds between tiles.  The
+ *  pages are uncompressed RGBA8, since the gutters are made
+ *  from the decoded texels of the images.
+ ***********************************************************/
+class TextureAtlas
+{
+public:
+	// constructor
+	TextureAtlas(int pageSize = 2048, int padding = 8);
+	// destructor
+	~TextureAtlas();
+
+	struct ATLAS_TILE
+	{
+		std::string tag;
+		int page;
+		glm::vec2 offset;
+		glm::vec2 scale;
+		// whether the image has pixels that are not fully opaque
+		bool bTranslucent;
+	};
+
+	// check whether an image is small enough to be packed
+	bool IsCandidate(int width, int height) const;
+
+	// pack the image pixels into the first page with room
+	bool AddImage(
+		const unsigned char* pixels,
+		int width,
+		int height,
+		int colorChannels,
+		std::string tag);
+
+	// upload the packed pages into OpenGL textures
+	int BuildPages();
+
+	// get the number of atlas pages and their textures
+	int GetPageCount() const;
+	GLuint GetPageTexture(int page) const;
+
+	// find a packed tile by tag
+	const ATLAS_TILE* FindTile(const char* tag) const;
+
+private:
+	struct SKYLINE_NODE
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	struct ATLAS_PAGE
+	{
+		std::vector<SKYLINE_NODE> skyline;
+		std::vector<unsigned char> pixels;
+		int usedHeight;
+		GLuint textureID;
+	};
+
+	// size of the square atlas pages in texels
+	int m_pageSize;
+	// gutter around every tile and alignment of the tiles
+	int m_padding;
+	// mip levels that stay inside the gutter
+	int m_maxMipLevel;
+	// packed atlas pages
+	std::vector<ATLAS_PAGE> m_pages;
+	// packed tiles, with texture coordinates relative to their page
+	std::vector<ATLAS_TILE> m_tiles;
+	// pixel rectangles of the packed tiles
+	std::vector<glm::ivec2> m_tilePositions;
+	std::vector<glm::ivec2> m_tileSizes;
+
+	// find a position for a rectangle in a page skyline
+	bool PackRect(ATLAS_PAGE& page, int width, int height, int& x, int& y);
+	// add a new empty page
+	ATLAS_PAGE& AddPage();
+};
@@ -0,0 +1,820 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecooker.cpp
+// ============
+// offline conversion of texture images into block-compressed mip chains
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureCooker.h"
+
+// the stb_image implementation is compiled in SceneManager.cpp
+#include "stb_image.h"
+
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define TEXTURECOOKER_USE_SSE2
+#endif
+
+// declaration of global variables and helper functions
+namespace
+{
+	// identifier and version stored at the start of every cooked file
+	const char g_CookedMagic[4] = { 'C', 'T', 'E', 'X' };
+	const uint32_t g_CookedVersion = 1;
+	// extension used for the cooked container files
+	const char* g_CookedExtension = ".ctex";
+	// largest width or height that a cooked texture is read with
+	const int g_MaxCookedSize = 16384;
+
+	// BC7 mode 6 interpolation weights for 4-bit indices
+	const int g_BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	/***********************************************************
+	 *  PackRGB565()
+	 *
+	 *  Quantize an 8-bit RGB color into a 5:6:5 color value.
+	 ***********************************************************/
+	uint16_t PackRGB565(const int* rgb)
+	{
+		return((uint16_t)(((rgb[0] * 31 + 127) / 255) << 11 |
+			((rgb[1] * 63 + 127) / 255) << 5 |
+			((rgb[2] * 31 + 127) / 255)));
+	}
+
+	/***********************************************************
+	 *  UnpackRGB565()
+	 *
+	 *  Expand a 5:6:5 color value back into 8-bit RGB.
+	 ***********************************************************/
+	void UnpackRGB565(uint16_t color, int* rgb)
+	{
+		int r = (color >> 11) & 31;
+		int g = (color >> 5) & 63;
+		int b = color & 31;
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	/***********************************************************
+	 *  EncodeColorBlock()
+	 *
+	 *  Encode the RGB channels of a 4x4 RGBA block into an
+	 *  8-byte BC1 color block, using the inset bounding box
+	 *  of the block colors as the endpoints.
+	 ***********************************************************/
+	void EncodeColorBlock(const unsigned char* block, unsigned char* output)
+	{
+		int minColor[3] = { 255, 255, 255 };
+		int maxColor[3] = { 0, 0, 0 };
+
+		for (int i = 0; i < 16; i++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				int value = block[i * 4 + c];
+				if (value < minColor[c]) minColor[c] = value;
+				if (value > maxColor[c]) maxColor[c] = value;
+			}
+		}
+
+		// inset the bounding box to reduce the error of the extremes
+		for (int c = 0; c < 3; c++)
+		{
+			int inset = (maxColor[c] - minColor[c]) >> 4;
+			minColor[c] = minColor[c] + inset;
+			maxColor[c] = maxColor[c] - inset;
+		}
+
+		uint16_t color0 = PackRGB565(maxColor);
+		uint16_t color1 = PackRGB565(minColor);
+		uint32_t indices = 0;
+
+		// four-color mode requires color0 to be greater than color1
+		if (color0 < color1)
+		{
+			uint16_t swap = color0;
+			color0 = color1;
+			color1 = swap;
+		}
+
+		if (color0 != color1)
+		{
+			int palette[4][3];
+			UnpackRGB565(color0, palette[0]);
+			UnpackRGB565(color1, palette[1]);
+			for (int c = 0; c < 3; c++)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			for (int i = 0; i < 16; i++)
+			{
+				int bestIndex = 0;
+				int bestError = 0x7FFFFFFF;
+				for (int p = 0; p < 4; p++)
+				{
+					int dr = block[i * 4 + 0] - palette[p][0];
+					int dg = block[i * 4 + 1] - palette[p][1];
+					int db = block[i * 4 + 2] - palette[p][2];
+					int error = dr * dr + dg * dg + db * db;
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = p;
+					}
+				}
+				indices |= (uint32_t)bestIndex << (i * 2);
+			}
+		}
+
+		output[0] = (unsigned char)(color0 & 0xFF);
+		output[1] = (unsigned char)(color0 >> 8);
+		output[2] = (unsigned char)(color1 & 0xFF);
+		output[3] = (unsigned char)(color1 >> 8);
+		output[4] = (unsigned char)(indices & 0xFF);
+		output[5] = (unsigned char)((indices >> 8) & 0xFF);
+		output[6] = (unsigned char)((indices >> 16) & 0xFF);
+		output[7] = (unsigned char)((indices >> 24) & 0xFF);
+	}
+
+	/***********************************************************
+	 *  EncodeAlphaBlock()
+	 *
+	 *  Encode the alpha channel of a 4x4 RGBA block into the
+	 *  8-byte interpolated alpha block used by BC3.
+	 ***********************************************************/
+	void EncodeAlphaBlock(const unsigned char* block, unsigned char* output)
+	{
+		int minAlpha = 255;
+		int maxAlpha = 0;
+
+		for (int i = 0; i < 16; i++)
+		{
+			int alpha = block[i * 4 + 3];
+			if (alpha < minAlpha) minAlpha = alpha;
+			if (alpha > maxAlpha) maxAlpha = alpha;
+		}
+
+		uint64_t indices = 0;
+		if (maxAlpha != minAlpha)
+		{
+			// eight-alpha mode is selected when alpha0 > alpha1
+			int palette[8];
+			palette[0] = maxAlpha;
+			palette[1] = minAlpha;
+			for (int p = 1; p < 7; p++)
+			{
+				palette[p + 1] = ((7 - p) * maxAlpha + p * minAlpha) / 7;
+			}
+
+			for (int i = 0; i < 16; i++)
+			{
+				int bestIndex = 0;
+				int bestError = 0x7FFFFFFF;
+				for (int p = 0; p < 8; p++)
+				{
+					int error = block[i * 4 + 3] - palette[p];
+					error = error * error;
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = p;
+					}
+				}
+				indices |= (uint64_t)bestIndex << (i * 3);
+			}
+		}
+
+		output[0] = (unsigned char)maxAlpha;
+		output[1] = (unsigned char)minAlpha;
+		for (int i = 0; i < 6; i++)
+		{
+			output[2 + i] = (unsigned char)((indices >> (i * 8)) & 0xFF);
+		}
+	}
+
+	/***********************************************************
+	 *  WriteBits()
+	 *
+	 *  Append a value into a little-endian 128-bit block at
+	 *  the passed in bit position.
+	 ***********************************************************/
+	void WriteBits(unsigned char* output, int& bitPosition, uint32_t value, int bitCount)
+	{
+		for (int i = 0; i < bitCount; i++)
+		{
+			if ((value >> i) & 1)
+			{
+				output[bitPosition >> 3] |= (unsigned char)(1 << (bitPosition & 7));
+			}
+			bitPosition++;
+		}
+	}
+
+	/***********************************************************
+	 *  EncodeBC7Block()
+	 *
+	 *  Encode a 4x4 RGBA block as a BC7 mode 6 block - one
+	 *  subset with 7.7.7.7 endpoints plus a p-bit each and
+	 *  sixteen interpolation steps.
+	 ***********************************************************/
+	void EncodeBC7Block(const unsigned char* block, unsigned char* output)
+	{
+		int minColor[4] = { 255, 255, 255, 255 };
+		int maxColor[4] = { 0, 0, 0, 0 };
+
+		for (int i = 0; i < 16; i++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				int value = block[i * 4 + c];
+				if (value < minColor[c]) minColor[c] = value;
+				if (value > maxColor[c]) maxColor[c] = value;
+			}
+		}
+
+		// quantize each endpoint to 7 bits per channel, picking the
+		// shared p-bit that reproduces the endpoint most closely
+		int endpoints[2][4];
+		int quantized[2][4];
+		int pBits[2];
+		const int* sourceEndpoints[2] = { minColor, maxColor };
+		for (int e = 0; e < 2; e++)
+		{
+			int bestError = 0x7FFFFFFF;
+			for (int p = 0; p < 2; p++)
+			{
+				int error = 0;
+				int candidate[4];
+				for (int c = 0; c < 4; c++)
+				{
+					int value = (sourceEndpoints[e][c] - p + 1) >> 1;
+					if (value < 0) value = 0;
+					if (value > 127) value = 127;
+					candidate[c] = value;
+					int decoded = (value << 1) | p;
+					error += (decoded - sourceEndpoints[e][c]) * (decoded - sourceEndpoints[e][c]);
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					pBits[e] = p;
+					for (int c = 0; c < 4; c++)
+					{
+						quantized[e][c] = candidate[c];
+						endpoints[e][c] = (candidate[c] << 1) | p;
+					}
+				}
+			}
+		}
+
+		// build the interpolated palette and select the indices
+		int palette[16][4];
+		for (int i = 0; i < 16; i++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				palette[i][c] = ((64 - g_BC7Weights[i]) * endpoints[0][c] + g_BC7Weights[i] * endpoints[1][c] + 32) >> 6;
+			}
+		}
+
+		int indices[16];
+		for (int i = 0; i < 16; i++)
+		{
+			int bestError = 0x7FFFFFFF;
+			indices[i] = 0;
+			for (int p = 0; p < 16; p++)
+			{
+				int error = 0;
+				for (int c = 0; c < 4; c++)
+				{
+					int delta = block[i * 4 + c] - palette[p][c];
+					error += delta * delta;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[i] = p;
+				}
+			}
+		}
+
+		// the most significant bit of the anchor index is implied to be
+		// zero, so swap the endpoints when the first index requires it
+		if (indices[0] >= 8)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				int swap = quantized[0][c];
+				quantized[0][c] = quantized[1][c];
+				quantized[1][c] = swap;
+			}
+			int swap = pBits[0];
+			pBits[0] = pBits[1];
+			pBits[1] = swap;
+			for (int i = 0; i < 16; i++)
+			{
+				indices[i] = 15 - indices[i];
+			}
+		}
+
+		memset(output, 0, 16);
+		int bitPosition = 0;
+		// mode 6 is identified by six zero bits followed by a one bit
+		WriteBits(output, bitPosition, 1 << 6, 7);
+		for (int c = 0; c < 4; c++)
+		{
+			WriteBits(output, bitPosition, quantized[0][c], 7);
+			WriteBits(output, bitPosition, quantized[1][c], 7);
+		}
+		WriteBits(output, bitPosition, pBits[0], 1);
+		WriteBits(output, bitPosition, pBits[1], 1);
+		WriteBits(output, bitPosition, indices[0], 3);
+		for (int i = 1; i < 16; i++)
+		{
+			WriteBits(output, bitPosition, indices[i], 4);
+		}
+	}
+
+	/***********************************************************
+	 *  GetBlockBytes()
+	 *
+	 *  Get the number of bytes in one 4x4 block of a format.
+	 ***********************************************************/
+	int GetBlockBytes(TextureCooker::COOK_FORMAT format)
+	{
+		return((format == TextureCooker::COOK_FORMAT_BC1) ? 8 : 16);
+	}
+
+	/***********************************************************
+	 *  GetInternalFormat()
+	 *
+	 *  Get the OpenGL internal format for a cooked format.
+	 ***********************************************************/
+	GLenum GetInternalFormat(TextureCooker::COOK_FORMAT format)
+	{
+		switch (format)
+		{
+		case TextureCooker::COOK_FORMAT_BC1:
+			return(GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+		case TextureCooker::COOK_FORMAT_BC3:
+			return(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+		default:
+			return(GL_COMPRESSED_RGBA_BPTC_UNORM);
+		}
+	}
+}
+
+/***********************************************************
+ *  TextureCooker()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureCooker::TextureCooker()
+{
+	m_threadCount = (int)std::thread::hardware_concurrency();
+	if (m_threadCount < 1)
+	{
+		m_threadCount = 1;
+	}
+}
+
+/***********************************************************
+ *  ~TextureCooker()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureCooker::~TextureCooker()
+{
+}
+
+/***********************************************************
+ *  SetThreadCount()
+ *
+ *  This method is used to set the number of worker threads
+ *  that encode the compressed blocks.
+ ***********************************************************/
+void TextureCooker::SetThreadCount(int threadCount)
+{
+	m_threadCount = (threadCount > 0) ? threadCount : 1;
+}
+
+/***********************************************************
+ *  CookTexture()
+ *
+ *  This method is used for loading an image file, building
+ *  the full mip chain, encoding every level into the
+ *  requested block-compressed format and writing the result
+ *  into the cooked container file.
+ ***********************************************************/
+bool TextureCooker::CookTexture(
+	const char* inputFilename,
+	const char* outputFilename,
+	COOK_FORMAT format)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+
+	// the cooked data must match the orientation of the images
+	// that are loaded at runtime, so flip them the same way
+	stbi_set_flip_vertically_on_load(true);
+
+	// always expand to RGBA so the filter and encoders see one layout
+	unsigned char* image = stbi_load(
+		inputFilename,
+		&width,
+		&height,
+		&colorChannels,
+		4);
+	if (NULL == image)
+	{
+		std::cout << "Could not load image:" << inputFilename << std::endl;
+		return(false);
+	}
+
+	if (format == COOK_FORMAT_AUTO)
+	{
+		format = (colorChannels == 4) ? COOK_FORMAT_BC3 : COOK_FORMAT_BC1;
+	}
+
+	COOKED_TEXTURE texture;
+	texture.internalFormat = GetInternalFormat(format);
+	texture.width = width;
+	texture.height = height;
+
+	// the current and next mip levels in uncompressed RGBA
+	std::vector<unsigned char> level(image, image + (size_t)width * height * 4);
+	std::vector<unsigned char> nextLevel;
+	stbi_image_free(image);
+
+	int mipWidth = width;
+	int mipHeight = height;
+	while (true)
+	{
+		COOKED_MIP mip;
+		mip.width = mipWidth;
+		mip.height = mipHeight;
+		EncodeMip(level.data(), mipWidth, mipHeight, format, mip.data);
+		texture.mips.push_back(mip);
+
+		if ((mipWidth == 1) && (mipHeight == 1))
+		{
+			break;
+		}
+
+		int nextWidth = (mipWidth > 1) ? (mipWidth / 2) : 1;
+		int nextHeight = (mipHeight > 1) ? (mipHeight / 2) : 1;
+		nextLevel.resize((size_t)nextWidth * nextHeight * 4);
+		GenerateNextMip(level.data(), mipWidth, mipHeight, nextLevel.data(), nextWidth, nextHeight);
+		level.swap(nextLevel);
+		mipWidth = nextWidth;
+		mipHeight = nextHeight;
+	}
+
+	if (WriteCookedTexture(outputFilename, texture) == false)
+	{
+		return(false);
+	}
+
+	size_t cookedBytes = 0;
+	for (size_t i = 0; i < texture.mips.size(); i++)
+	{
+		cookedBytes += texture.mips[i].data.size();
+	}
+	std::cout << "Successfully cooked image:" << inputFilename << ", width:" << width << ", height:" << height
+		<< ", mips:" << texture.mips.size() << ", bytes:" << cookedBytes << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GenerateNextMip()
+ *
+ *  This method is used for downsampling an RGBA8 image to
+ *  the next mip level with a 2x2 box filter.  Odd source
+ *  dimensions clamp to the last row and column.
+ ***********************************************************/
+void TextureCooker::GenerateNextMip(
+	const unsigned char* source,
+	int sourceWidth,
+	int sourceHeight,
+	unsigned char* destination,
+	int destWidth,
+	int destHeight)
+{
+	for (int y = 0; y < destHeight; y++)
+	{
+		int y0 = (y * 2 < sourceHeight) ? (y * 2) : (sourceHeight - 1);
+		int y1 = (y * 2 + 1 < sourceHeight) ? (y * 2 + 1) : (sourceHeight - 1);
+		const unsigned char* row0 = source + (size_t)y0 * sourceWidth * 4;
+		const unsigned char* row1 = source + (size_t)y1 * sourceWidth * 4;
+		unsigned char* outRow = destination + (size_t)y * destWidth * 4;
+		int x = 0;
+
+#ifdef TEXTURECOOKER_USE_SSE2
+		// four destination pixels are produced from eight source
+		// pixels of each row per iteration
+		if (sourceWidth >= destWidth * 2)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i rounding = _mm_set1_epi16(2);
+			for (; x + 4 <= destWidth; x += 4)
+			{
+				__m128i top0 = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+				__m128i top1 = _mm_loadu_si128((const __m128i*)(row0 + x * 8 + 16));
+				__m128i bottom0 = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+				__m128i bottom1 = _mm_loadu_si128((const __m128i*)(row1 + x * 8 + 16));
+
+				// vertical sums in 16-bit lanes, two source pixels per register
+				__m128i sum0 = _mm_add_epi16(_mm_unpacklo_epi8(top0, zero), _mm_unpacklo_epi8(bottom0, zero));
+				__m128i sum1 = _mm_add_epi16(_mm_unpackhi_epi8(top0, zero), _mm_unpackhi_epi8(bottom0, zero));
+				__m128i sum2 = _mm_add_epi16(_mm_unpacklo_epi8(top1, zero), _mm_unpacklo_epi8(bottom1, zero));
+				__m128i sum3 = _mm_add_epi16(_mm_unpackhi_epi8(top1, zero), _mm_unpackhi_epi8(bottom1, zero));
+
+				// horizontal sums of each adjacent pixel pair
+				sum0 = _mm_add_epi16(sum0, _mm_srli_si128(sum0, 8));
+				sum1 = _mm_add_epi16(sum1, _mm_srli_si128(sum1, 8));
+				sum2 = _mm_add_epi16(sum2, _mm_srli_si128(sum2, 8));
+				sum3 = _mm_add_epi16(sum3, _mm_srli_si128(sum3, 8));
+
+				__m128i low = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(sum0, sum1), rounding), 2);
+				__m128i high = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(sum2, sum3), rounding), 2);
+				_mm_storeu_si128((__m128i*)(outRow + x * 4), _mm_packus_epi16(low, high));
+			}
+		}
+#endif
+
+		for (; x < destWidth; x++)
+		{
+			int x0 = (x * 2 < sourceWidth) ? (x * 2) : (sourceWidth - 1);
+			int x1 = (x * 2 + 1 < sourceWidth) ? (x * 2 + 1) : (sourceWidth - 1);
+			for (int c = 0; c < 4; c++)
+			{
+				int sum = row0[x0 * 4 + c] + row0[x1 * 4 + c] + row1[x0 * 4 + c] + row1[x1 * 4 + c];
+				outRow[x * 4 + c] = (unsigned char)((sum + 2) >> 2);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  EncodeMip()
+ *
+ *  This method is used for encoding one RGBA8 mip level into
+ *  compressed 4x4 blocks.  The block rows are divided among
+ *  the worker threads.
+ ***********************************************************/
+void TextureCooker::EncodeMip(
+	const unsigned char* pixels,
+	int width,
+	int height,
+	COOK_FORMAT format,
+	std::vector<unsigned char>& output)
+{
+	int blocksWide = (width + 3) / 4;
+	int blocksHigh = (height + 3) / 4;
+	int blockBytes = GetBlockBytes(format);
+
+	output.resize((size_t)blocksWide * blocksHigh * blockBytes);
+	unsigned char* blocks = output.data();
+
+	// encode the blocks in the passed in range of block rows
+	auto encodeRows = [=](int firstRow, int lastRow)
+	{
+		unsigned char block[64];
+		for (int by = firstRow; by < lastRow; by++)
+		{
+			for (int bx = 0; bx < blocksWide; bx++)
+			{
+				// gather the 4x4 texels, clamping at the image edges
+				for (int ty = 0; ty < 4; ty++)
+				{
+					int y = (by * 4 + ty < height) ? (by * 4 + ty) : (height - 1);
+					for (int tx = 0; tx < 4; tx++)
+					{
+						int x = (bx * 4 + tx < width) ? (bx * 4 + tx) : (width - 1);
+						memcpy(&block[(ty * 4 + tx) * 4], &pixels[((size_t)y * width + x) * 4], 4);
+					}
+				}
+
+				unsigned char* destination = blocks + ((size_t)by * blocksWide + bx) * blockBytes;
+				if (format == COOK_FORMAT_BC1)
+				{
+					EncodeColorBlock(block, destination);
+				}
+				else if (format == COOK_FORMAT_BC3)
+				{
+					EncodeAlphaBlock(block, destination);
+					EncodeColorBlock(block, destination + 8);
+				}
+				else
+				{
+					EncodeBC7Block(block, destination);
+				}
+			}
+		}
+	};
+
+	int threadCount = (m_threadCount < blocksHigh) ? m_threadCount : blocksHigh;
+	if (threadCount <= 1)
+	{
+		encodeRows(0, blocksHigh);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	int rowsPerThread = (blocksHigh + threadCount - 1) / threadCount;
+	for (int i = 0; i < threadCount; i++)
+	{
+		int firstRow = i * rowsPerThread;
+		int lastRow = (firstRow + rowsPerThread < blocksHigh) ? (firstRow + rowsPerThread) : blocksHigh;
+		if (firstRow < lastRow)
+		{
+			workers.push_back(std::thread(encodeRows, firstRow, lastRow));
+		}
+	}
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+}
+
+/***********************************************************
+ *  WriteCookedTexture()
+ *
+ *  This method is used for writing the cooked texture into
+ *  the container file.  The layout is the magic and version,
+ *  the GL internal format, the base size and mip count,
+ *  followed by the size and data of every mip level.
+ ***********************************************************/
+bool TextureCooker::WriteCookedTexture(
+	const char* filename,
+	const COOKED_TEXTURE& texture)
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not write cooked texture:" << filename << std::endl;
+		return(false);
+	}
+
+	uint32_t header[5];
+	header[0] = g_CookedVersion;
+	header[1] = (uint32_t)texture.internalFormat;
+	header[2] = (uint32_t)texture.width;
+	header[3] = (uint32_t)texture.height;
+	header[4] = (uint32_t)texture.mips.size();
+	file.write(g_CookedMagic, sizeof(g_CookedMagic));
+	file.write((const char*)header, sizeof(header));
+
+	for (size_t i = 0; i < texture.mips.size(); i++)
+	{
+		uint32_t mipHeader[3];
+		mipHeader[0] = (uint32_t)texture.mips[i].width;
+		mipHeader[1] = (uint32_t)texture.mips[i].height;
+		mipHeader[2] = (uint32_t)texture.mips[i].data.size();
+		file.write((const char*)mipHeader, sizeof(mipHeader));
+		file.write((const char*)texture.mips[i].data.data(), texture.mips[i].data.size());
+	}
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  LoadCookedTexture()
+ *
+ *  This method is used for reading a cooked container file
+ *  into memory so the mip levels can be uploaded directly.
+ *  The header is checked against the format, the size and
+ *  the mip chain that the cooker writes, and every level is
+ *  checked against its block size and the rest of the file,
+ *  so a truncated or corrupt file is rejected before any of
+ *  it is uploaded, and the image file is loaded instead.
+ ***********************************************************/
+bool TextureCooker::LoadCookedTexture(
+	const char* filename,
+	COOKED_TEXTURE& texture)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		return(false);
+	}
+
+	// the size of the file bounds the size of the mip levels
+	file.seekg(0, std::ios::end);
+	uint64_t remainingBytes = (uint64_t)file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	char magic[4];
+	uint32_t header[5];
+	file.read(magic, sizeof(magic));
+	file.read((char*)header, sizeof(header));
+	if ((!file) ||
+		(memcmp(magic, g_CookedMagic, sizeof(magic)) != 0) ||
+		(header[0] != g_CookedVersion))
+	{
+		std::cout << "Invalid cooked texture:" << filename << std::endl;
+		return(false);
+	}
+	remainingBytes -= sizeof(magic) + sizeof(header);
+
+	// the format must be one that the cooker writes, and the mip
+	// chain cannot be longer than the one down to 1x1
+	uint64_t blockBytes = 0;
+	if (header[1] == GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+		blockBytes = 8;
+	else if ((header[1] == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) || (header[1] == GL_COMPRESSED_RGBA_BPTC_UNORM))
+		blockBytes = 16;
+	uint32_t largestSize = (header[2] > header[3]) ? header[2] : header[3];
+	uint32_t maxMipCount = 0;
+	for (uint32_t size = largestSize; size > 0; size >>= 1)
+	{
+		maxMipCount++;
+	}
+	if ((blockBytes == 0) ||
+		(header[2] == 0) || (header[3] == 0) ||
+		(largestSize > (uint32_t)g_MaxCookedSize) ||
+		(header[4] == 0) || (header[4] > maxMipCount))
+	{
+		std::cout << "Invalid cooked texture:" << filename << std::endl;
+		return(false);
+	}
+
+	texture.internalFormat = (GLenum)header[1];
+	texture.width = (int)header[2];
+	texture.height = (int)header[3];
+	texture.mips.resize(header[4]);
+
+	for (size_t i = 0; i < texture.mips.size(); i++)
+	{
+		uint32_t mipHeader[3];
+		file.read((char*)mipHeader, sizeof(mipHeader));
+		if ((!file) || (remainingBytes < sizeof(mipHeader)))
+		{
+			std::cout << "Truncated cooked texture:" << filename << std::endl;
+			return(false);
+		}
+		remainingBytes -= sizeof(mipHeader);
+
+		// every level halves the last one, and holds whole blocks
+		uint32_t mipWidth = (header[2] >> i) ? (header[2] >> i) : 1;
+		uint32_t mipHeight = (header[3] >> i) ? (header[3] >> i) : 1;
+		uint64_t mipBytes = (uint64_t)((mipWidth + 3) / 4) * ((mipHeight + 3) / 4) * blockBytes;
+		if ((mipHeader[0] != mipWidth) || (mipHeader[1] != mipHeight) || (mipHeader[2] != mipBytes))
+		{
+			std::cout << "Invalid cooked texture:" << filename << std::endl;
+			return(false);
+		}
+		if (mipBytes > remainingBytes)
+		{
+			std::cout << "Truncated cooked texture:" << filename << std::endl;
+			return(false);
+		}
+		remainingBytes -= mipBytes;
+
+		texture.mips[i].width = (int)mipWidth;
+		texture.mips[i].height = (int)mipHeight;
+		texture.mips[i].data.resize((size_t)mipBytes);
+		file.read((char*)texture.mips[i].data.data(), (std::streamsize)mipBytes);
+		if (!file)
+		{
+			std::cout << "Truncated cooked texture:" << filename << std::endl;
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetCookedFilename()
+ *
+ *  This method is used for getting the filename of the
+ *  cooked container that sits next to a source image.
+ ***********************************************************/
+std::string TextureCooker::GetCookedFilename(const char* sourceFilename)
+{
+	std::string filename = sourceFilename;
+	size_t extension = filename.find_last_of('.');
+	size_t separator = filename.find_last_of("/\\");
+
+	// only strip an extension that belongs to the file name
+	if ((extension != std::string::npos) &&
+		((separator == std::string::npos) || (extension > separator)))
+	{
+		filename.erase(extension);
+	}
+
+	return(filename + g_CookedExtension);
+}
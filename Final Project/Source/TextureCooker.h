@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecooker.h
+// ============
+// offline conversion of texture images into block-compressed mip chains
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureCooker
+ *
+ *  This class contains the code for precomputing the mip
+ *  chain of a texture image, encoding every mip level into
+ *  a GPU block-compressed format, and reading/writing the
+ *  cooked container that is uploaded at scene load time
+ *  with glCompressedTexImage2D().
+ ***********************************************************/
+class TextureCooker
+{
+public:
+	// constructor
+	TextureCooker();
+	// destructor
+	~TextureCooker();
+
+	// supported block-compressed output formats
+	enum COOK_FORMAT
+	{
+		COOK_FORMAT_AUTO,	// BC1 for opaque images, BC3 for images with alpha
+		COOK_FORMAT_BC1,
+		COOK_FORMAT_BC3,
+		COOK_FORMAT_BC7
+	};
+
+	struct COOKED_MIP
+	{
+		int width;
+		int height;
+		std::vector<unsigned char> data;
+	};
+
+	struct COOKED_TEXTURE
+	{
+		GLenum internalFormat;
+		int width;
+		int height;
+		std::vector<COOKED_MIP> mips;
+	};
+
+	// set the number of worker threads used for block encoding
+	void SetThreadCount(int threadCount);
+
+	// cook an image file into a block-compressed container file
+	bool CookTexture(
+		const char* inputFilename,
+		const char* outputFilename,
+		COOK_FORMAT format);
+
+	// read a previously cooked container file into memory
+	static bool LoadCookedTexture(
+		const char* filename,
+		COOKED_TEXTURE& texture);
+
+	// get the cooked container filename for a source image
+	static std::string GetCookedFilename(const char* sourceFilename);
+
+private:
+	// number of worker threads used for block encoding
+	int m_threadCount;
+
+	// downsample one RGBA8 mip level into the next smaller level
+	void GenerateNextMip(
+		const unsigned char* source,
+		int sourceWidth,
+		int sourceHeight,
+		unsigned char* destination,
+		int destWidth,
+		int destHeight);
+
+	// encode one RGBA8 mip level into 4x4 compressed blocks
+	void EncodeMip(
+		const unsigned char* pixels,
+		int width,
+		int height,
+		COOK_FORMAT format,
+		std::vector<unsigned char>& output);
+
+	// write the cooked texture into the container file
+	bool WriteCookedTexture(
+		const char* filename,
+		const COOKED_TEXTURE& texture);
+};
@@ -1,255 +1,664 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "ViewManager.h"
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>    
-
-// declaration of the global variables and defines
-namespace
-{
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1000;
-	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
-	// camera object used for viewing and interacting with
-	// the 3D scene
-	Camera* g_pCamera = nullptr;
-
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
-
-	// the following variable is false when orthographic projection
-	// is off and true when it is on
-	bool bOrthographicProjection = false;
-
-	//variable for perspective change
-	bool perspective = false;
-}
-
-/***********************************************************
- *  ViewManager()
- *
- *  The constructor for the class
- ***********************************************************/
-ViewManager::ViewManager(
-	ShaderManager *pShaderManager)
-{
-	// initialize the member variables
-	m_pShaderManager = pShaderManager;
-	m_pWindow = NULL;
-	g_pCamera = new Camera();
-	// default camera view parameters
-	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 23.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 80;
-}
-
-/***********************************************************
- *  ~ViewManager()
- *
- *  The destructor for the class
- ***********************************************************/
-ViewManager::~ViewManager()
-{
-	// free up allocated memory
-	m_pShaderManager = NULL;
-	m_pWindow = NULL;
-	if (NULL != g_pCamera)
-	{
-		delete g_pCamera;
-		g_pCamera = NULL;
-	}
-}
-
-/***********************************************************
- *  CreateDisplayWindow()
- *
- *  This method is used to create the main display window.
- ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
-{
-	GLFWwindow* window = nullptr;
-
-	// try to create the displayed OpenGL window
-	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
-		windowTitle,
-		NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return NULL;
-	}
-	glfwMakeContextCurrent(window);
-
-	// tell GLFW to capture all mouse events
-	//glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-	// this callback is used to receive mouse moving events
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-
-	// enable blending for supporting tranparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	m_pWindow = window;
-
-	return(window);
-}
-
-/***********************************************************
- *  Mouse_Position_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse is moved within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
-{
-	// when the first mouse move event is received, this needs to be recorded so that
-	// all subsequent mouse moves can correctly calculate the X position offset and Y
-	// position offset for proper operation
-	if (gFirstMouse)
-	{
-		gLastX = xMousePos;
-		gLastY = yMousePos;
-		gFirstMouse = false;
-	}
-
-	// calculate the X offset and Y offset values for moving the 3D camera accordingly
-	float xOffset = xMousePos - gLastX;
-	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
-
-	// set the current positions into the last position variables, as well as the speed of the camera movement
-	gLastX = xMousePos;
-	gLastY = yMousePos;
-	// move the 3D camera according to the calculated offsets
-	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
-}
-
-/***********************************************************
- *  ProcessKeyboardEvents()
- *
- *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
-{
-	// close the window if the escape key has been pressed
-	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(m_pWindow, true);
-	}
-
-	// if the camera object is null, then exit this method
-	if (NULL == g_pCamera)
-	{
-		return;
-	}
-
-	// process camera zooming in and out
-	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
-	}
-
-	// process camera panning left and right
-	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
-	}
-
-	// process camera panning up and down
-	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(UP, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
-	}
-	// changes views of scene
-	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
-	{
-		perspective = false;
-	}
-
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-	{
-		perspective = true;
-	}
-}
-
-/***********************************************************
- *  PrepareSceneView()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void ViewManager::PrepareSceneView()
-{
-	glm::mat4 view;
-	glm::mat4 projection;
-
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-	// define the current projection matrix
-	if (perspective == true) 
-	{
-		projection = glm::ortho(-5.0, 5.0, -5.0, 5.0, 0.1, 100.0);
-	}
-	else 
-	{
-		projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-	}
-
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
-	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
-	}
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewManager.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>    
+
+// declaration of the global variables and defines
+namespace
+{
+	// Variables for window width and height
+	const int WINDOW_WIDTH = 1000;
+	const int WINDOW_HEIGHT = 800;
+	const char* g_ViewName = "view";
+	const char* g_ProjectionName = "projection";
+	const char* g_UseCameraBlockName = "bUseCameraBlock";
+	// distances of the near and far clipping planes
+	const float g_NearPlane = 0.1f;
+	const float g_FarPlane = 100.0f;
+
+	// camera object used for viewing and interacting with
+	// the 3D scene
+	Camera* g_pCamera = nullptr;
+
+	// recorder that the input is recorded into or replayed from
+	InputRecorder* g_pInputRecorder = nullptr;
+
+	// the keyboard and mouse events that arrived since the last frame
+	InputQueue g_InputQueue;
+
+	// current size of the framebuffer, and whether it changed since
+	// the viewport was last set
+	int g_FramebufferWidth = WINDOW_WIDTH;
+	int g_FramebufferHeight = WINDOW_HEIGHT;
+	bool g_bFramebufferResized = true;
+
+	// time between current frame and last frame
+	float gDeltaTime = 0.0f; 
+	double gLastFrame = 0.0;
+
+	// the following variable is false when orthographic projection
+	// is off and true when it is on
+	bool bOrthographicProjection = false;
+
+	//variable for perspective change
+	bool perspective = false;
+}
+
+/***********************************************************
+ *  ViewManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewManager::ViewManager(
+	ShaderManager *pShaderManager)
+{
+	// initialize the member variables
+	m_pShaderManager = pShaderManager;
+	m_pWindow = NULL;
+	m_pFramePacer = NULL;
+	m_projectionZoom = 0.0f;
+	m_projectionAspect = (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT;
+	m_bProjectionOrthographic = false;
+	m_bViewValid = false;
+	m_bProjectionValid = false;
+	m_bLateLatch = true;
+	g_pCamera = new Camera();
+	// default camera view parameters
+	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 23.0f);
+	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+}
+
+/***********************************************************
+ *  ~ViewManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ViewManager::~ViewManager()
+{
+	// free up allocated memory
+	m_pShaderManager = NULL;
+	m_pWindow = NULL;
+	if (NULL != g_pCamera)
+	{
+		delete g_pCamera;
+		g_pCamera = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateDisplayWindow()
+ *
+ *  This method is used to create the main display window.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	// try to create the displayed OpenGL window
+	window = glfwCreateWindow(
+		WINDOW_WIDTH,
+		WINDOW_HEIGHT,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// tell GLFW to capture all mouse events
+	//glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+	// this callback is used to receive mouse moving events
+	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+	// this callback is used to record the key events
+	glfwSetKeyCallback(window, &ViewManager::Key_Callback);
+	// this callback is used to follow the size of the framebuffer,
+	// which can differ from the window size on high DPI displays
+	glfwSetFramebufferSizeCallback(window, &ViewManager::Framebuffer_Size_Callback);
+	glfwGetFramebufferSize(window, &g_FramebufferWidth, &g_FramebufferHeight);
+	g_bFramebufferResized = true;
+
+	// enable blending for supporting tranparent rendering
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  SetFramePacer()
+ *
+ *  This method is used to set the frame pacer whose smoothed
+ *  frame time is used for the camera movement.
+ ***********************************************************/
+void ViewManager::SetFramePacer(FramePacer* pFramePacer)
+{
+	m_pFramePacer = pFramePacer;
+}
+
+/***********************************************************
+ *  CreateCameraBuffer()
+ *
+ *  This method is used to create the persistently mapped
+ *  buffer that the camera block of the shaders reads, once
+ *  the shaders are loaded and in use.  Without it, the camera
+ *  is passed in the separate uniforms.
+ ***********************************************************/
+bool ViewManager::CreateCameraBuffer()
+{
+	if ((NULL == m_pShaderManager) || (m_cameraBuffer.Create() == false))
+	{
+		return(false);
+	}
+
+	return(BindCameraBlock(m_pShaderManager));
+}
+
+/***********************************************************
+ *  BindCameraBlock()
+ *
+ *  This method is used to connect the camera block of a
+ *  shader program to the camera buffer and turn it on in the
+ *  shaders.  The program is left in use.
+ ***********************************************************/
+bool ViewManager::BindCameraBlock(ShaderManager* pShaderManager)
+{
+	if ((NULL == pShaderManager) || (m_cameraBuffer.IsCreated() == false))
+	{
+		return(false);
+	}
+
+	m_cameraBuffer.BindProgram(pShaderManager->m_programID);
+	pShaderManager->use();
+	pShaderManager->setBoolValue(g_UseCameraBlockName, true);
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetLateLatch()
+ *
+ *  This method is used to turn on or off the sampling of the
+ *  mouse right before the draws of the frame are submitted.
+ ***********************************************************/
+void ViewManager::SetLateLatch(bool bLateLatch)
+{
+	m_bLateLatch = bLateLatch;
+}
+
+/***********************************************************
+ *  GetFrameInputTime()
+ *
+ *  This method is used to get the arrival time of the oldest
+ *  input event that the current frame shows, or -1 when the
+ *  frame has no new input.
+ ***********************************************************/
+double ViewManager::GetFrameInputTime() const
+{
+	return(g_InputQueue.GetFrameInputTime());
+}
+
+/***********************************************************
+ *  WasKeyPressed()
+ *
+ *  This method is used to check whether a key was pressed
+ *  since the last frame, for the keys that trigger an action
+ *  once instead of being held.
+ ***********************************************************/
+bool ViewManager::WasKeyPressed(int key) const
+{
+	return(g_InputQueue.WasKeyPressed(key));
+}
+
+/***********************************************************
+ *  SetCameraPose()
+ *
+ *  This method is used to move the camera to a position and
+ *  to point it along a view direction, as done by scripted
+ *  camera paths.
+ ***********************************************************/
+void ViewManager::SetCameraPose(glm::vec3 position, glm::vec3 front)
+{
+	if (NULL == g_pCamera)
+	{
+		return;
+	}
+
+	g_pCamera->Position = position;
+	g_pCamera->Front = glm::normalize(front);
+}
+
+/***********************************************************
+ *  SetInputRecorder()
+ *
+ *  This method is used to set the recorder that the keyboard
+ *  and mouse input is recorded into, or replayed from.
+ ***********************************************************/
+void ViewManager::SetInputRecorder(InputRecorder* pInputRecorder)
+{
+	g_pInputRecorder = pInputRecorder;
+}
+
+/***********************************************************
+ *  Mouse_Position_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse is moved within the active GLFW display window.
+ ***********************************************************/
+void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
+{
+	if (NULL != g_pInputRecorder)
+	{
+		// the live mouse is ignored while the input is replayed
+		if (g_pInputRecorder->IsReplaying() == true)
+		{
+			return;
+		}
+		g_pInputRecorder->RecordMouseMove(xMousePos, yMousePos);
+	}
+
+	// the camera is turned once per frame by the summed offset
+	g_InputQueue.PushMousePosition(xMousePos, yMousePos);
+}
+
+/***********************************************************
+ *  Key_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  a key is pressed or released.  The key state is kept in
+ *  the input queue, so the keys do not need to be polled.
+ ***********************************************************/
+void ViewManager::Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	// close the window if the escape key has been pressed, which
+	// also works while the input is replayed
+	if ((key == GLFW_KEY_ESCAPE) && (action == GLFW_PRESS))
+	{
+		glfwSetWindowShouldClose(window, true);
+	}
+
+	if (NULL != g_pInputRecorder)
+	{
+		// the live keyboard is ignored while the input is replayed
+		if (g_pInputRecorder->IsReplaying() == true)
+		{
+			return;
+		}
+		g_pInputRecorder->RecordKey(key, action);
+	}
+
+	g_InputQueue.PushKey(key, action);
+}
+
+/***********************************************************
+ *  Framebuffer_Size_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the framebuffer of the window is resized.  The new size
+ *  is only recorded here, and applied once by the next frame.
+ ***********************************************************/
+void ViewManager::Framebuffer_Size_Callback(GLFWwindow* window, int width, int height)
+{
+	g_FramebufferWidth = width;
+	g_FramebufferHeight = height;
+	g_bFramebufferResized = true;
+}
+
+/***********************************************************
+ *  GetFramebufferWidth()
+ *
+ *  This method is used to get the width of the framebuffer
+ *  of the display window in pixels.
+ ***********************************************************/
+int ViewManager::GetFramebufferWidth() const
+{
+	return(g_FramebufferWidth);
+}
+
+/***********************************************************
+ *  GetFramebufferHeight()
+ *
+ *  This method is used to get the height of the framebuffer
+ *  of the display window in pixels.
+ ***********************************************************/
+int ViewManager::GetFramebufferHeight() const
+{
+	return(g_FramebufferHeight);
+}
+
+/***********************************************************
+ *  ProcessKeyboardEvents()
+ *
+ *  This method is called to process the keyboard and mouse
+ *  input that was collected in the input queue since the
+ *  last frame.
+ ***********************************************************/
+void ViewManager::ProcessKeyboardEvents()
+{
+	// close the window when the replayed session is over
+	if ((NULL != g_pInputRecorder) && (g_pInputRecorder->IsReplayFinished() == true))
+	{
+		glfwSetWindowShouldClose(m_pWindow, true);
+	}
+
+	// if the camera object is null, then exit this method
+	if (NULL == g_pCamera)
+	{
+		return;
+	}
+
+	// turn the camera once by all of the mouse moves of the frame
+	if (g_InputQueue.HasMouseMovement() == true)
+	{
+		g_pCamera->ProcessMouseMovement(
+			(float)g_InputQueue.GetMouseOffsetX(),
+			(float)g_InputQueue.GetMouseOffsetY());
+	}
+
+	// process camera zooming in and out
+	if (IsKeyPressed(GLFW_KEY_W) == true)
+	{
+		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
+	}
+	if (IsKeyPressed(GLFW_KEY_S) == true)
+	{
+		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
+	}
+
+	// process camera panning left and right
+	if (IsKeyPressed(GLFW_KEY_A) == true)
+	{
+		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
+	}
+	if (IsKeyPressed(GLFW_KEY_D) == true)
+	{
+		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
+	}
+
+	// process camera panning up and down
+	if (IsKeyPressed(GLFW_KEY_Q) == true)
+	{
+		g_pCamera->ProcessKeyboard(UP, gDeltaTime);
+	}
+	if (IsKeyPressed(GLFW_KEY_E) == true)
+	{
+		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
+	}
+	// changes views of scene
+	if (IsKeyPressed(GLFW_KEY_O) == true)
+	{
+		perspective = false;
+	}
+
+	if (IsKeyPressed(GLFW_KEY_P) == true)
+	{
+		perspective = true;
+	}
+}
+
+/***********************************************************
+ *  IsKeyPressed()
+ *
+ *  This method is used to check whether a key is held in the
+ *  current frame, or was tapped since the last frame.  While
+ *  the input is replayed, the queue holds the recorded keys
+ *  instead of the live keyboard.
+ ***********************************************************/
+bool ViewManager::IsKeyPressed(int key)
+{
+	return(g_InputQueue.IsKeyDown(key));
+}
+
+/***********************************************************
+ *  GetViewMatrix()
+ *
+ *  This method is used to get the view matrix of the frame,
+ *  as latched before the draws.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetViewMatrix() const
+{
+	return(m_view);
+}
+
+/***********************************************************
+ *  GetProjectionMatrix()
+ *
+ *  This method is used to get the projection matrix of the
+ *  frame.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetProjectionMatrix() const
+{
+	return(m_projection);
+}
+
+/***********************************************************
+ *  GetNearPlane()
+ *
+ *  This method is used to get the distance of the near
+ *  clipping plane.
+ ***********************************************************/
+float ViewManager::GetNearPlane() const
+{
+	return(g_NearPlane);
+}
+
+/***********************************************************
+ *  GetFarPlane()
+ *
+ *  This method is used to get the distance of the far
+ *  clipping plane.
+ ***********************************************************/
+float ViewManager::GetFarPlane() const
+{
+	return(g_FarPlane);
+}
+
+/***********************************************************
+ *  InvalidateSceneView()
+ *
+ *  This method is used to upload the camera matrices on the
+ *  next frame, for when the shader uniforms were replaced.
+ ***********************************************************/
+void ViewManager::InvalidateSceneView()
+{
+	m_bViewValid = false;
+	m_bProjectionValid = false;
+}
+
+/***********************************************************
+ *  UpdateViewMatrix()
+ *
+ *  This method is used to recompute the view matrix when the
+ *  camera moved or turned, and returns whether it changed.
+ ***********************************************************/
+bool ViewManager::UpdateViewMatrix()
+{
+	if ((m_bViewValid == true) &&
+		(m_viewPosition == g_pCamera->Position) &&
+		(m_viewFront == g_pCamera->Front) &&
+		(m_viewUp == g_pCamera->Up))
+	{
+		return(false);
+	}
+
+	m_view = g_pCamera->GetViewMatrix();
+	m_viewPosition = g_pCamera->Position;
+	m_viewFront = g_pCamera->Front;
+	m_viewUp = g_pCamera->Up;
+	m_bViewValid = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  UpdateProjectionMatrix()
+ *
+ *  This method is used to recompute the projection matrix
+ *  when the field of view, the aspect ratio or the projection
+ *  mode changed, and returns whether it changed.
+ ***********************************************************/
+bool ViewManager::UpdateProjectionMatrix(float aspect)
+{
+	if ((m_bProjectionValid == true) &&
+		(m_projectionZoom == g_pCamera->Zoom) &&
+		(m_projectionAspect == aspect) &&
+		(m_bProjectionOrthographic == perspective))
+	{
+		return(false);
+	}
+
+	// define the current projection matrix
+	if (perspective == true) 
+	{
+		m_projection = glm::ortho(-5.0f, 5.0f, -5.0f, 5.0f, g_NearPlane, g_FarPlane);
+	}
+	else 
+	{
+		m_projection = glm::perspective(glm::radians(g_pCamera->Zoom), aspect, g_NearPlane, g_FarPlane);
+	}
+
+	m_projectionZoom = g_pCamera->Zoom;
+	m_projectionAspect = aspect;
+	m_bProjectionOrthographic = perspective;
+	m_bProjectionValid = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void ViewManager::PrepareSceneView()
+{
+	// per-frame timing, smoothed by the frame pacer when there is one
+	double currentFrame = FramePacer::GetTime();
+	if ((NULL != g_pInputRecorder) && (g_pInputRecorder->IsReplaying() == true))
+	{
+		// a replay advances by a fixed step and feeds the recorded
+		// events of that step into the input queue, so every run moves
+		// the camera the same way no matter how long the frames take
+		std::vector<InputRecorder::INPUT_EVENT>& events = m_replayEvents;
+		g_pInputRecorder->AdvanceReplay(events);
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			if (events[i].type == InputRecorder::EVENT_MOUSE_MOVE)
+			{
+				g_InputQueue.PushMousePosition(events[i].x, events[i].y);
+			}
+			else if (events[i].type == InputRecorder::EVENT_KEY)
+			{
+				g_InputQueue.PushKey(events[i].key, events[i].action);
+			}
+		}
+		gDeltaTime = (float)g_pInputRecorder->GetReplayTimeStep();
+	}
+	else if (NULL != m_pFramePacer)
+	{
+		gDeltaTime = (float)m_pFramePacer->GetSmoothedDeltaTime();
+	}
+	else
+	{
+		gDeltaTime = (float)(currentFrame - gLastFrame);
+	}
+	gLastFrame = currentFrame;
+
+	// take the input that arrived since the last frame, and apply it
+	// to the camera in a single update
+	g_InputQueue.BeginFrame();
+	ProcessKeyboardEvents();
+
+	// apply a resized framebuffer once, the render targets that
+	// follow the viewport size are reallocated when next used
+	if (g_bFramebufferResized == true)
+	{
+		g_bFramebufferResized = false;
+		glViewport(0, 0, g_FramebufferWidth, g_FramebufferHeight);
+	}
+}
+
+/***********************************************************
+ *  LatchSceneView()
+ *
+ *  This method is used to pass the camera of the frame to
+ *  the shaders, right before the draws are submitted.  The
+ *  events that arrived while the frame was being prepared
+ *  are read first, and their mouse moves turn the camera, so
+ *  the frame shows the latest mouse position.  A replay is
+ *  not sampled late, since it has to advance by fixed steps.
+ ***********************************************************/
+void ViewManager::LatchSceneView()
+{
+	if (NULL == g_pCamera)
+	{
+		return;
+	}
+
+	bool bReplaying = (NULL != g_pInputRecorder) && (g_pInputRecorder->IsReplaying() == true);
+	if ((m_bLateLatch == true) && (bReplaying == false))
+	{
+		glfwPollEvents();
+
+		double xOffset = 0.0;
+		double yOffset = 0.0;
+		if (g_InputQueue.TakeLateMouseOffset(xOffset, yOffset) == true)
+		{
+			g_pCamera->ProcessMouseMovement((float)xOffset, (float)yOffset);
+		}
+	}
+
+	// a minimized window has no size, and keeps the last aspect ratio
+	float aspect = m_projectionAspect;
+	if ((g_FramebufferWidth > 0) && (g_FramebufferHeight > 0))
+	{
+		aspect = (GLfloat)g_FramebufferWidth / (GLfloat)g_FramebufferHeight;
+	}
+
+	// the matrices are only recomputed and uploaded when they change
+	bool bViewChanged = UpdateViewMatrix();
+	bool bProjectionChanged = UpdateProjectionMatrix(aspect);
+
+	// the camera block is rewritten every frame, since every frame
+	// writes into its own slot of the buffer
+	if (m_cameraBuffer.IsCreated() == true)
+	{
+		m_cameraBuffer.Write(m_view, m_projection, g_pCamera->Position);
+	}
+	// otherwise, if the shader manager object is valid
+	else if (NULL != m_pShaderManager)
+	{
+		if (bViewChanged == true)
+		{
+			// set the view matrix into the shader for proper rendering
+			m_pShaderManager->setMat4Value(g_ViewName, m_view);
+			// set the view position of the camera into the shader for proper rendering
+			m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
+		}
+		if (bProjectionChanged == true)
+		{
+			// set the projection matrix into the shader for proper rendering
+			m_pShaderManager->setMat4Value(g_ProjectionName, m_projection);
+		}
+	}
 }
\ No newline at end of file
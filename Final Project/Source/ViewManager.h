@@ -1,45 +1,115 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "camera.h"
-
-// GLFW library
-#include "GLFW/glfw3.h" 
-
-class ViewManager
-{
-public:
-	// constructor
-	ViewManager(
-		ShaderManager* pShaderManager);
-	// destructor
-	~ViewManager();
-
-	// mouse position callback for mouse interaction with the 3D scene
-	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
-	GLFWwindow* m_pWindow;
-
-	// process keyboard events for interaction with the 3D scene
-	void ProcessKeyboardEvents();
-
-public:
-	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
-	
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "FramePacer.h"
+#include "InputRecorder.h"
+#include "InputQueue.h"
+#include "CameraBuffer.h"
+#include "camera.h"
+
+// GLFW library
+#include "GLFW/glfw3.h" 
+
+class ViewManager
+{
+public:
+	// constructor
+	ViewManager(
+		ShaderManager* pShaderManager);
+	// destructor
+	~ViewManager();
+
+	// mouse position callback for mouse interaction with the 3D scene
+	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
+	// key callback for collecting the keyboard input
+	static void Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+	// framebuffer size callback for resizing the viewport
+	static void Framebuffer_Size_Callback(GLFWwindow* window, int width, int height);
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// active OpenGL display window
+	GLFWwindow* m_pWindow;
+	// frame pacer that measures the frame delta time
+	FramePacer* m_pFramePacer;
+	// cached camera matrices and the camera values they were made from
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	glm::vec3 m_viewPosition;
+	glm::vec3 m_viewFront;
+	glm::vec3 m_viewUp;
+	float m_projectionZoom;
+	float m_projectionAspect;
+	bool m_bProjectionOrthographic;
+	bool m_bViewValid;
+	bool m_bProjectionValid;
+	// buffer that the camera block of the shaders is read from
+	CameraBuffer m_cameraBuffer;
+	// whether the mouse is sampled again before the draws
+	bool m_bLateLatch;
+	// events of the last replay step, kept to reuse their memory
+	std::vector<InputRecorder::INPUT_EVENT> m_replayEvents;
+
+	// process the queued keyboard and mouse input of the frame
+	void ProcessKeyboardEvents();
+	// check whether a key is held, live or in the replayed input
+	bool IsKeyPressed(int key);
+	// recompute the camera matrices when their inputs changed
+	bool UpdateViewMatrix();
+	bool UpdateProjectionMatrix(float aspect);
+
+public:
+	// create the initial OpenGL display window
+	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+
+	// set the frame pacer that the camera movement is timed with
+	void SetFramePacer(FramePacer* pFramePacer);
+
+	// create the buffer for the camera block of the loaded shaders
+	bool CreateCameraBuffer();
+	// read the camera block of another shader program from the buffer
+	bool BindCameraBlock(ShaderManager* pShaderManager);
+
+	// turn the late sampling of the mouse before the draws on or off
+	void SetLateLatch(bool bLateLatch);
+
+	// get the arrival time of the oldest input shown by the frame
+	double GetFrameInputTime() const;
+	// check whether a key was pressed since the last frame
+	bool WasKeyPressed(int key) const;
+
+	// set the recorder that the input is recorded into or replayed from
+	void SetInputRecorder(InputRecorder* pInputRecorder);
+
+	// place the camera at a position looking along a direction
+	void SetCameraPose(glm::vec3 position, glm::vec3 front);
+	
+	// get the size of the framebuffer of the display window
+	int GetFramebufferWidth() const;
+	int GetFramebufferHeight() const;
+
+	// get the camera matrices and clipping planes of the frame
+	const glm::mat4& GetViewMatrix() const;
+	const glm::mat4& GetProjectionMatrix() const;
+	float GetNearPlane() const;
+	float GetFarPlane() const;
+
+	// upload the camera matrices on the next frame even if unchanged
+	void InvalidateSceneView();
+
+	// prepare the conversion from 3D object display to 2D scene display
+	void PrepareSceneView();
+
+	// pass the camera to the shaders right before the draws
+	void LatchSceneView();
 };
\ No newline at end of file
@@ -0,0 +1,1201 @@
+///////////////////////////////////////////////////////////////////////////////
+// virtualtexturesystem.cpp
+// ============
+// stream the visible pages of very large textures into a page cache
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "VirtualTextureSystem.h"
+
+// the stb_image implementation is compiled in SceneManager.cpp
+#include "stb_image.h"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+// declaration of global variables and helper functions
+namespace
+{
+	// identifier and version stored at the start of every page file
+	const char g_PageFileMagic[4] = { 'V', 'T', 'E', 'X' };
+	const uint32_t g_PageFileVersion = 1;
+	// extension used for the page files
+	const char* g_PageFileExtension = ".vtex";
+	// size of the magic and the header values of a page file
+	const size_t g_PageFileHeaderBytes = 4 + 6 * sizeof(uint32_t);
+
+	// texels along each side of a page, without the border
+	const int g_VirtualPageSize = 128;
+	// texels copied from the neighbouring pages for bilinear filtering
+	const int g_VirtualPageBorder = 4;
+	// texels along each side of a page, including the border
+	const int g_VirtualPageStride = g_VirtualPageSize + 2 * g_VirtualPageBorder;
+	// page coordinates are stored in 8 bits in the page tables
+	const int g_MaxVirtualPages = 256;
+
+	// the feedback pass renders at a fraction of the viewport size
+	const int g_FeedbackScale = 8;
+	// the feedback pass is rendered every few frames
+	const uint64_t g_FeedbackInterval = 4;
+	// limits that keep the streaming work of a single frame small
+	const size_t g_MaxPendingPages = 64;
+	const int g_MaxPageUploadsPerFrame = 16;
+
+	/***********************************************************
+	 *  ResampleImage()
+	 *
+	 *  Bilinearly resample an RGBA image to a new size.
+	 ***********************************************************/
+	void ResampleImage(
+		const unsigned char* source,
+		int sourceWidth,
+		int sourceHeight,
+		std::vector<unsigned char>& destination,
+		int width,
+		int height)
+	{
+		destination.resize((size_t)width * height * 4);
+		for (int y = 0; y < height; y++)
+		{
+			float sourceY = ((y + 0.5f) * sourceHeight / height) - 0.5f;
+			sourceY = std::max(0.0f, std::min(sourceY, (float)(sourceHeight - 1)));
+			int y0 = (int)sourceY;
+			int y1 = std::min(y0 + 1, sourceHeight - 1);
+			float fy = sourceY - y0;
+
+			for (int x = 0; x < width; x++)
+			{
+				float sourceX = ((x + 0.5f) * sourceWidth / width) - 0.5f;
+				sourceX = std::max(0.0f, std::min(sourceX, (float)(sourceWidth - 1)));
+				int x0 = (int)sourceX;
+				int x1 = std::min(x0 + 1, sourceWidth - 1);
+				float fx = sourceX - x0;
+
+				const unsigned char* p00 = &source[((size_t)y0 * sourceWidth + x0) * 4];
+				const unsigned char* p01 = &source[((size_t)y0 * sourceWidth + x1) * 4];
+				const unsigned char* p10 = &source[((size_t)y1 * sourceWidth + x0) * 4];
+				const unsigned char* p11 = &source[((size_t)y1 * sourceWidth + x1) * 4];
+				unsigned char* result = &destination[((size_t)y * width + x) * 4];
+				for (int c = 0; c < 4; c++)
+				{
+					float top = p00[c] + (p01[c] - p00[c]) * fx;
+					float bottom = p10[c] + (p11[c] - p10[c]) * fx;
+					result[c] = (unsigned char)(top + (bottom - top) * fy + 0.5f);
+				}
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  DownsampleImage()
+	 *
+	 *  Halve an RGBA image with a 2x2 box filter.
+	 ***********************************************************/
+	void DownsampleImage(std::vector<unsigned char>& image, int width, int height)
+	{
+		int halfWidth = width / 2;
+		int halfHeight = height / 2;
+		std::vector<unsigned char> result((size_t)halfWidth * halfHeight * 4);
+
+		for (int y = 0; y < halfHeight; y++)
+		{
+			const unsigned char* row0 = &image[((size_t)y * 2) * width * 4];
+			const unsigned char* row1 = row0 + (size_t)width * 4;
+			unsigned char* destination = &result[(size_t)y * halfWidth * 4];
+			for (int x = 0; x < halfWidth * 4; x++)
+			{
+				int c = x % 4;
+				int sourceX = (x - c) * 2 + c;
+				destination[x] = (unsigned char)((row0[sourceX] + row0[sourceX + 4] + row1[sourceX] + row1[sourceX + 4] + 2) / 4);
+			}
+		}
+
+		image.swap(result);
+	}
+
+	/***********************************************************
+	 *  CopyPage()
+	 *
+	 *  Copy one page and its border out of a mip level.  The
+	 *  border wraps around the image edges, since the virtual
+	 *  textures repeat across the surfaces.
+	 ***********************************************************/
+	void CopyPage(
+		const std::vector<unsigned char>& image,
+		int width,
+		int height,
+		int pageX,
+		int pageY,
+		std::vector<unsigned char>& page)
+	{
+		for (int y = 0; y < g_VirtualPageStride; y++)
+		{
+			int sourceY = pageY * g_VirtualPageSize + y - g_VirtualPageBorder;
+			sourceY = ((sourceY % height) + height) % height;
+			for (int x = 0; x < g_VirtualPageStride; x++)
+			{
+				int sourceX = pageX * g_VirtualPageSize + x - g_VirtualPageBorder;
+				sourceX = ((sourceX % width) + width) % width;
+				memcpy(
+					&page[((size_t)y * g_VirtualPageStride + x) * 4],
+					&image[((size_t)sourceY * width + sourceX) * 4],
+					4);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  VirtualTextureSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+VirtualTextureSystem::VirtualTextureSystem(int pageTableUnit, int pageCacheUnit, int cachePagesPerSide)
+{
+	m_pageTableUnit = pageTableUnit;
+	m_pageCacheUnit = pageCacheUnit;
+	m_cachePagesPerSide = std::min(cachePagesPerSide, g_MaxVirtualPages);
+	m_pageCacheTexture = 0;
+	m_frame = 0;
+	m_feedbackFrame = 0;
+	m_feedbackFramebuffer = 0;
+	m_feedbackColorBuffer = 0;
+	m_feedbackDepthBuffer = 0;
+	m_feedbackPixelBuffer = 0;
+	m_feedbackFence = NULL;
+	m_feedbackWidth = 0;
+	m_feedbackHeight = 0;
+	m_savedFramebuffer = 0;
+	m_bSavedBlend = GL_FALSE;
+	m_bStopLoader = false;
+
+	// no more pages than the pending ones are ever queued, so
+	// the queues never grow while the frames are rendered
+	m_pendingPages.reserve(g_MaxPendingPages);
+	m_uploadQueue.resize(g_MaxPendingPages);
+	m_uploadQueueStart = 0;
+	m_uploadQueueCount = 0;
+	m_loadedPages.reserve(g_MaxPendingPages);
+}
+
+/***********************************************************
+ *  ~VirtualTextureSystem()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+VirtualTextureSystem::~VirtualTextureSystem()
+{
+	// stop the loader thread before the queues go away
+	{
+		std::lock_guard<std::mutex> lock(m_loaderMutex);
+		m_bStopLoader = true;
+	}
+	m_loaderCondition.notify_all();
+	if (m_loaderThread.joinable())
+	{
+		m_loaderThread.join();
+	}
+
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		glDeleteTextures(1, &m_textures[i].pageTableTexture);
+	}
+	m_textures.clear();
+
+	if (m_pageCacheTexture != 0)
+	{
+		glDeleteTextures(1, &m_pageCacheTexture);
+	}
+	if (m_feedbackFence != NULL)
+	{
+		glDeleteSync(m_feedbackFence);
+	}
+	if (m_feedbackFramebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_feedbackFramebuffer);
+		glDeleteRenderbuffers(1, &m_feedbackColorBuffer);
+		glDeleteRenderbuffers(1, &m_feedbackDepthBuffer);
+		glDeleteBuffers(1, &m_feedbackPixelBuffer);
+	}
+}
+
+/***********************************************************
+ *  GetPageFilename()
+ *
+ *  This method is used for getting the filename of the page
+ *  file that sits next to a source image.
+ ***********************************************************/
+std::string VirtualTextureSystem::GetPageFilename(const char* imageFilename)
+{
+	std::string filename = imageFilename;
+	size_t extension = filename.find_last_of('.');
+	size_t separator = filename.find_last_of("/\\");
+
+	// only strip an extension that belongs to the file name
+	if ((extension != std::string::npos) &&
+		((separator == std::string::npos) || (extension > separator)))
+	{
+		filename.erase(extension);
+	}
+
+	return(filename + g_PageFileExtension);
+}
+
+/***********************************************************
+ *  BuildPageFile()
+ *
+ *  This method is used for converting an image into a page
+ *  file.  The image is resampled to a power of two size, so
+ *  that every mip level has exactly half of the pages of the
+ *  level above it, and every mip level down to a single page
+ *  row or column is split into pages with a border.
+ ***********************************************************/
+bool VirtualTextureSystem::BuildPageFile(const char* imageFilename, const char* pageFilename)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+
+	// flip the image the same way as the regular texture loading
+	stbi_set_flip_vertically_on_load(true);
+	unsigned char* image = stbi_load(imageFilename, &width, &height, &colorChannels, 4);
+	if (NULL == image)
+	{
+		std::cout << "Could not load image:" << imageFilename << std::endl;
+		return(false);
+	}
+
+	int virtualWidth = g_VirtualPageSize;
+	int virtualHeight = g_VirtualPageSize;
+	while ((virtualWidth < width) && (virtualWidth < g_VirtualPageSize * g_MaxVirtualPages))
+	{
+		virtualWidth *= 2;
+	}
+	while ((virtualHeight < height) && (virtualHeight < g_VirtualPageSize * g_MaxVirtualPages))
+	{
+		virtualHeight *= 2;
+	}
+
+	std::vector<unsigned char> mip;
+	ResampleImage(image, width, height, mip, virtualWidth, virtualHeight);
+	stbi_image_free(image);
+
+	int mipCount = 0;
+	while (((virtualWidth >> mipCount) >= g_VirtualPageSize) &&
+		((virtualHeight >> mipCount) >= g_VirtualPageSize))
+	{
+		mipCount++;
+	}
+
+	std::ofstream file(pageFilename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not create virtual texture:" << pageFilename << std::endl;
+		return(false);
+	}
+
+	uint32_t header[6] = {
+		g_PageFileVersion,
+		(uint32_t)virtualWidth,
+		(uint32_t)virtualHeight,
+		(uint32_t)g_VirtualPageSize,
+		(uint32_t)g_VirtualPageBorder,
+		(uint32_t)mipCount };
+	file.write(g_PageFileMagic, sizeof(g_PageFileMagic));
+	file.write((const char*)header, sizeof(header));
+
+	// the pages are stored mip level by mip level, row by row
+	std::vector<unsigned char> page((size_t)g_VirtualPageStride * g_VirtualPageStride * 4);
+	int mipWidth = virtualWidth;
+	int mipHeight = virtualHeight;
+	for (int level = 0; level < mipCount; level++)
+	{
+		for (int pageY = 0; pageY < mipHeight / g_VirtualPageSize; pageY++)
+		{
+			for (int pageX = 0; pageX < mipWidth / g_VirtualPageSize; pageX++)
+			{
+				CopyPage(mip, mipWidth, mipHeight, pageX, pageY, page);
+				file.write((const char*)page.data(), page.size());
+			}
+		}
+
+		if (level + 1 < mipCount)
+		{
+			DownsampleImage(mip, mipWidth, mipHeight);
+			mipWidth /= 2;
+			mipHeight /= 2;
+		}
+	}
+
+	if (!file)
+	{
+		std::cout << "Could not write virtual texture:" << pageFilename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully built virtual texture:" << pageFilename << ", width:" << virtualWidth << ", height:" << virtualHeight << ", mips:" << mipCount << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReadPage()
+ *
+ *  This method is used for reading the pixels of one page
+ *  from an opened page file.
+ ***********************************************************/
+bool VirtualTextureSystem::ReadPage(std::istream& file, size_t fileOffset, std::vector<unsigned char>& pixels)
+{
+	pixels.resize((size_t)g_VirtualPageStride * g_VirtualPageStride * 4);
+
+	file.clear();
+	file.seekg((std::streamoff)fileOffset, std::ios::beg);
+	file.read((char*)pixels.data(), pixels.size());
+
+	return(!file.fail());
+}
+
+/***********************************************************
+ *  GetPageOffset()
+ *
+ *  This method is used for getting the position of a page
+ *  within the page file of a virtual texture.
+ ***********************************************************/
+size_t VirtualTextureSystem::GetPageOffset(const VIRTUAL_TEXTURE& texture, int mip, int x, int y) const
+{
+	size_t page = texture.mipFirstPage[mip] + (size_t)y * texture.mipPages[mip].x + x;
+
+	return(g_PageFileHeaderBytes + page * g_VirtualPageStride * g_VirtualPageStride * 4);
+}
+
+/***********************************************************
+ *  GetPageKey()
+ *
+ *  This method is used for packing the coordinates of a
+ *  virtual page into a single value.
+ ***********************************************************/
+uint32_t VirtualTextureSystem::GetPageKey(int texture, int mip, int x, int y)
+{
+	return(((uint32_t)texture << 24) | ((uint32_t)mip << 16) | ((uint32_t)y << 8) | (uint32_t)x);
+}
+
+/***********************************************************
+ *  CreatePageCache()
+ *
+ *  This method is used for creating the physical page cache
+ *  texture that the loaded pages of all virtual textures
+ *  share.  Its size never changes.
+ ***********************************************************/
+bool VirtualTextureSystem::CreatePageCache()
+{
+	int cacheSize = m_cachePagesPerSide * g_VirtualPageStride;
+
+	glGenTextures(1, &m_pageCacheTexture);
+	glActiveTexture(GL_TEXTURE0 + m_pageCacheUnit);
+	glBindTexture(GL_TEXTURE_2D, m_pageCacheTexture);
+
+	// the page borders make bilinear filtering safe without mipmaps
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, cacheSize, cacheSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+	CACHE_SLOT freeSlot;
+	freeSlot.texture = -1;
+	freeSlot.mip = 0;
+	freeSlot.x = 0;
+	freeSlot.y = 0;
+	freeSlot.lastUsedFrame = 0;
+	freeSlot.bLocked = false;
+	m_cacheSlots.assign((size_t)m_cachePagesPerSide * m_cachePagesPerSide, freeSlot);
+
+	std::cout << "Successfully created virtual texture page cache, width:" << cacheSize << ", height:" << cacheSize << ", pages:" << m_cacheSlots.size() << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  AddVirtualTexture()
+ *
+ *  This method is used for opening a page file as a new
+ *  virtual texture.  The pages of the coarsest mip level are
+ *  loaded right away and never evicted, so every page table
+ *  entry always has a resident page to fall back to.
+ ***********************************************************/
+int VirtualTextureSystem::AddVirtualTexture(const char* pageFilename, std::string tag)
+{
+	std::ifstream file(pageFilename, std::ios::binary);
+	if (!file)
+	{
+		return(-1);
+	}
+
+	char magic[4];
+	uint32_t header[6];
+	file.read(magic, sizeof(magic));
+	file.read((char*)header, sizeof(header));
+	if ((!file) ||
+		(memcmp(magic, g_PageFileMagic, sizeof(magic)) != 0) ||
+		(header[0] != g_PageFileVersion) ||
+		(header[3] != (uint32_t)g_VirtualPageSize) ||
+		(header[4] != (uint32_t)g_VirtualPageBorder) ||
+		(header[5] == 0) ||
+		(header[1] > (uint32_t)(g_VirtualPageSize * g_MaxVirtualPages)) ||
+		(header[2] > (uint32_t)(g_VirtualPageSize * g_MaxVirtualPages)))
+	{
+		std::cout << "Invalid virtual texture:" << pageFilename << std::endl;
+		return(-1);
+	}
+
+	// the texture index is stored in 8 bits in the feedback buffer
+	if (m_textures.size() >= 254)
+	{
+		std::cout << "Too many virtual textures:" << pageFilename << std::endl;
+		return(-1);
+	}
+
+	if ((m_pageCacheTexture == 0) && (CreatePageCache() == false))
+	{
+		return(-1);
+	}
+
+	VIRTUAL_TEXTURE texture;
+	texture.tag = tag;
+	texture.pageFilename = pageFilename;
+	texture.width = (int)header[1];
+	texture.height = (int)header[2];
+	texture.mipCount = (int)header[5];
+	texture.pageTableTexture = 0;
+	texture.bPageTableDirty = true;
+
+	size_t firstPage = 0;
+	for (int level = 0; level < texture.mipCount; level++)
+	{
+		glm::ivec2 pages(
+			(texture.width >> level) / g_VirtualPageSize,
+			(texture.height >> level) / g_VirtualPageSize);
+		texture.mipPages.push_back(pages);
+		texture.mipFirstPage.push_back(firstPage);
+		texture.pageSlots.push_back(std::vector<int>((size_t)pages.x * pages.y, -1));
+		texture.pageTable.push_back(std::vector<unsigned char>((size_t)pages.x * pages.y * 4, 0));
+		firstPage += (size_t)pages.x * pages.y;
+	}
+
+	// read the coarsest mip level before any cache page is used
+	int coarsestMip = texture.mipCount - 1;
+	glm::ivec2 coarsestPages = texture.mipPages[coarsestMip];
+	std::vector<std::vector<unsigned char>> coarsestPixels((size_t)coarsestPages.x * coarsestPages.y);
+	int freeSlots = 0;
+	for (size_t i = 0; i < m_cacheSlots.size(); i++)
+	{
+		if (m_cacheSlots[i].texture < 0)
+		{
+			freeSlots++;
+		}
+	}
+	if ((int)coarsestPixels.size() >= freeSlots)
+	{
+		std::cout << "Virtual texture page cache is too small for:" << pageFilename << std::endl;
+		return(-1);
+	}
+	for (int y = 0; y < coarsestPages.y; y++)
+	{
+		for (int x = 0; x < coarsestPages.x; x++)
+		{
+			if (ReadPage(file, GetPageOffset(texture, coarsestMip, x, y), coarsestPixels[(size_t)y * coarsestPages.x + x]) == false)
+			{
+				std::cout << "Could not read virtual texture:" << pageFilename << std::endl;
+				return(-1);
+			}
+		}
+	}
+
+	// integer page table entries hold the cache page and its mip level
+	glGenTextures(1, &texture.pageTableTexture);
+	glActiveTexture(GL_TEXTURE0 + m_pageTableUnit);
+	glBindTexture(GL_TEXTURE_2D, texture.pageTableTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.mipCount - 1);
+	for (int level = 0; level < texture.mipCount; level++)
+	{
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8UI,
+			texture.mipPages[level].x, texture.mipPages[level].y, 0,
+			GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, NULL);
+	}
+
+	int index = (int)m_textures.size();
+	m_textures.push_back(texture);
+
+	for (int y = 0; y < coarsestPages.y; y++)
+	{
+		for (int x = 0; x < coarsestPages.x; x++)
+		{
+			int slot = AllocateCacheSlot();
+			m_cacheSlots[slot].texture = index;
+			m_cacheSlots[slot].mip = coarsestMip;
+			m_cacheSlots[slot].x = x;
+			m_cacheSlots[slot].y = y;
+			m_cacheSlots[slot].lastUsedFrame = m_frame;
+			m_cacheSlots[slot].bLocked = true;
+			UploadPage(slot, coarsestPixels[(size_t)y * coarsestPages.x + x].data());
+			m_textures[index].pageSlots[coarsestMip][(size_t)y * coarsestPages.x + x] = slot;
+		}
+	}
+	UpdatePageTable(index);
+
+	// the loader thread is started with the first virtual texture
+	if (m_loaderThread.joinable() == false)
+	{
+		m_bStopLoader = false;
+		m_loaderThread = std::thread(&VirtualTextureSystem::LoaderThread, this);
+	}
+
+	std::cout << "Successfully loaded virtual texture:" << pageFilename << ", width:" << texture.width << ", height:" << texture.height << ", mips:" << texture.mipCount << std::endl;
+
+	return(index);
+}
+
+/***********************************************************
+ *  FindVirtualTexture()
+ *
+ *  This method is used for finding a virtual texture by tag.
+ ***********************************************************/
+int VirtualTextureSystem::FindVirtualTexture(const char* tag) const
+{
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		if (m_textures[i].tag.compare(tag) == 0)
+		{
+			return((int)i);
+		}
+	}
+
+	return(-1);
+}
+
+/***********************************************************
+ *  GetVirtualTexture()
+ *
+ *  This method is used for getting an opened virtual texture.
+ ***********************************************************/
+const VirtualTextureSystem::VIRTUAL_TEXTURE& VirtualTextureSystem::GetVirtualTexture(int index) const
+{
+	return(m_textures[index]);
+}
+
+/***********************************************************
+ *  GetVirtualTextureCount()
+ *
+ *  This method is used for getting the number of opened
+ *  virtual textures.
+ ***********************************************************/
+int VirtualTextureSystem::GetVirtualTextureCount() const
+{
+	return((int)m_textures.size());
+}
+
+/***********************************************************
+ *  BindPageTable()
+ *
+ *  This method is used for binding the page table of a
+ *  virtual texture to the page table texture unit.
+ ***********************************************************/
+void VirtualTextureSystem::BindPageTable(int index)
+{
+	glActiveTexture(GL_TEXTURE0 + m_pageTableUnit);
+	glBindTexture(GL_TEXTURE_2D, m_textures[index].pageTableTexture);
+}
+
+/***********************************************************
+ *  GetPageSize()
+ *
+ *  This method is used for getting the texels along each
+ *  side of a page, without the border.
+ ***********************************************************/
+int VirtualTextureSystem::GetPageSize() const
+{
+	return(g_VirtualPageSize);
+}
+
+/***********************************************************
+ *  GetPageBorder()
+ *
+ *  This method is used for getting the texels of the border
+ *  around every page.
+ ***********************************************************/
+int VirtualTextureSystem::GetPageBorder() const
+{
+	return(g_VirtualPageBorder);
+}
+
+/***********************************************************
+ *  GetPageCacheSize()
+ *
+ *  This method is used for getting the size of the page
+ *  cache texture in texels.
+ ***********************************************************/
+glm::vec2 VirtualTextureSystem::GetPageCacheSize() const
+{
+	float cacheSize = (float)(m_cachePagesPerSide * g_VirtualPageStride);
+
+	return(glm::vec2(cacheSize, cacheSize));
+}
+
+/***********************************************************
+ *  GetPageCacheBytes()
+ *
+ *  This method is used for getting the GPU memory used by
+ *  the page cache texture.
+ ***********************************************************/
+size_t VirtualTextureSystem::GetPageCacheBytes() const
+{
+	if (m_pageCacheTexture == 0)
+	{
+		return(0);
+	}
+
+	size_t cacheSize = (size_t)m_cachePagesPerSide * g_VirtualPageStride;
+
+	return(cacheSize * cacheSize * 4);
+}
+
+/***********************************************************
+ *  AllocateCacheSlot()
+ *
+ *  This method is used for finding a cache page for a newly
+ *  loaded page.  A free page is used first, otherwise the
+ *  least recently used page that the last feedback did not
+ *  request is evicted.
+ ***********************************************************/
+int VirtualTextureSystem::AllocateCacheSlot()
+{
+	int bestSlot = -1;
+
+	for (size_t i = 0; i < m_cacheSlots.size(); i++)
+	{
+		const CACHE_SLOT& slot = m_cacheSlots[i];
+		if (slot.texture < 0)
+		{
+			return((int)i);
+		}
+		if ((slot.bLocked == false) &&
+			(slot.lastUsedFrame < m_feedbackFrame) &&
+			((bestSlot < 0) || (slot.lastUsedFrame < m_cacheSlots[bestSlot].lastUsedFrame)))
+		{
+			bestSlot = (int)i;
+		}
+	}
+
+	if (bestSlot >= 0)
+	{
+		// the evicted page falls back to a coarser page in its page table
+		CACHE_SLOT& slot = m_cacheSlots[bestSlot];
+		VIRTUAL_TEXTURE& texture = m_textures[slot.texture];
+		texture.pageSlots[slot.mip][(size_t)slot.y * texture.mipPages[slot.mip].x + slot.x] = -1;
+		texture.bPageTableDirty = true;
+		slot.texture = -1;
+	}
+
+	return(bestSlot);
+}
+
+/***********************************************************
+ *  UploadPage()
+ *
+ *  This method is used for copying the pixels of a loaded
+ *  page into a page of the cache texture.
+ ***********************************************************/
+void VirtualTextureSystem::UploadPage(int slot, const unsigned char* pixels)
+{
+	int cacheX = (slot % m_cachePagesPerSide) * g_VirtualPageStride;
+	int cacheY = (slot / m_cachePagesPerSide) * g_VirtualPageStride;
+
+	glActiveTexture(GL_TEXTURE0 + m_pageCacheUnit);
+	glBindTexture(GL_TEXTURE_2D, m_pageCacheTexture);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, cacheX, cacheY,
+		g_VirtualPageStride, g_VirtualPageStride,
+		GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
+/***********************************************************
+ *  UpdatePageTable()
+ *
+ *  This method is used for rebuilding the page table of a
+ *  virtual texture from the coarsest mip level down.  Pages
+ *  that are not resident inherit the entry of their parent
+ *  page, which points to the nearest coarser resident page.
+ ***********************************************************/
+void VirtualTextureSystem::UpdatePageTable(int index)
+{
+	VIRTUAL_TEXTURE& texture = m_textures[index];
+
+	for (int level = texture.mipCount - 1; level >= 0; level--)
+	{
+		glm::ivec2 pages = texture.mipPages[level];
+		for (int y = 0; y < pages.y; y++)
+		{
+			for (int x = 0; x < pages.x; x++)
+			{
+				size_t page = (size_t)y * pages.x + x;
+				unsigned char* entry = &texture.pageTable[level][page * 4];
+				int slot = texture.pageSlots[level][page];
+				if (slot >= 0)
+				{
+					entry[0] = (unsigned char)(slot % m_cachePagesPerSide);
+					entry[1] = (unsigned char)(slot / m_cachePagesPerSide);
+					entry[2] = (unsigned char)level;
+					entry[3] = 255;
+				}
+				else
+				{
+					size_t parentPage = (size_t)(y / 2) * texture.mipPages[level + 1].x + (x / 2);
+					memcpy(entry, &texture.pageTable[level + 1][parentPage * 4], 4);
+				}
+			}
+		}
+	}
+
+	glActiveTexture(GL_TEXTURE0 + m_pageTableUnit);
+	glBindTexture(GL_TEXTURE_2D, texture.pageTableTexture);
+	for (int level = 0; level < texture.mipCount; level++)
+	{
+		glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0,
+			texture.mipPages[level].x, texture.mipPages[level].y,
+			GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, texture.pageTable[level].data());
+	}
+
+	texture.bPageTableDirty = false;
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for advancing the streaming once per
+ *  frame.  The finished feedback readback is turned into page
+ *  loads, the pages that the loader thread finished are
+ *  copied into the cache, and the changed page tables are
+ *  uploaded.
+ ***********************************************************/
+void VirtualTextureSystem::Update()
+{
+	m_frame++;
+
+	if (m_textures.empty())
+	{
+		return;
+	}
+
+	ProcessFeedback();
+	UploadLoadedPages();
+
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		if (m_textures[i].bPageTableDirty == true)
+		{
+			UpdatePageTable((int)i);
+		}
+	}
+}
+
+/***********************************************************
+ *  ProcessFeedback()
+ *
+ *  This method is used for reading the page requests of the
+ *  last feedback pass, once the GPU has finished writing
+ *  them.  Resident pages are marked as used, and for every
+ *  missing page the coarsest missing page on its mip chain
+ *  is loaded first, so the detail refines progressively.
+ ***********************************************************/
+void VirtualTextureSystem::ProcessFeedback()
+{
+	if (m_feedbackFence == NULL)
+	{
+		return;
+	}
+
+	// never wait for the GPU, the readback is checked again next frame
+	GLenum result = glClientWaitSync(m_feedbackFence, 0, 0);
+	if ((result != GL_ALREADY_SIGNALED) && (result != GL_CONDITION_SATISFIED))
+	{
+		return;
+	}
+	glDeleteSync(m_feedbackFence);
+	m_feedbackFence = NULL;
+
+	size_t texelCount = (size_t)m_feedbackWidth * m_feedbackHeight;
+	std::vector<uint32_t>& requests = m_feedbackRequests;
+	requests.clear();
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, m_feedbackPixelBuffer);
+	const unsigned char* pixels = (const unsigned char*)glMapBufferRange(
+		GL_PIXEL_PACK_BUFFER, 0, texelCount * 4, GL_MAP_READ_BIT);
+	if (NULL != pixels)
+	{
+		// each texel holds the page x, page y, mip level and texture + 1
+		for (size_t i = 0; i < texelCount; i++)
+		{
+			const unsigned char* texel = &pixels[i * 4];
+			if (texel[3] != 0)
+			{
+				requests.push_back(GetPageKey(texel[3] - 1, texel[2], texel[0], texel[1]));
+			}
+		}
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	std::sort(requests.begin(), requests.end());
+	requests.erase(std::unique(requests.begin(), requests.end()), requests.end());
+	m_feedbackFrame = m_frame;
+
+	std::vector<uint32_t>& missingPages = m_missingPages;
+	missingPages.clear();
+	for (size_t i = 0; i < requests.size(); i++)
+	{
+		int textureIndex = (int)(requests[i] >> 24);
+		int mip = (int)((requests[i] >> 16) & 0xFF);
+		int y = (int)((requests[i] >> 8) & 0xFF);
+		int x = (int)(requests[i] & 0xFF);
+		if ((textureIndex >= (int)m_textures.size()) ||
+			(mip >= m_textures[textureIndex].mipCount) ||
+			(x >= m_textures[textureIndex].mipPages[mip].x) ||
+			(y >= m_textures[textureIndex].mipPages[mip].y))
+		{
+			continue;
+		}
+
+		// walk up the mip chain to the page that is drawn instead
+		const VIRTUAL_TEXTURE& texture = m_textures[textureIndex];
+		int missingMip = -1;
+		int missingX = 0;
+		int missingY = 0;
+		for (int level = mip; level < texture.mipCount; level++)
+		{
+			int pageX = x >> (level - mip);
+			int pageY = y >> (level - mip);
+			int slot = texture.pageSlots[level][(size_t)pageY * texture.mipPages[level].x + pageX];
+			if (slot >= 0)
+			{
+				m_cacheSlots[slot].lastUsedFrame = m_frame;
+				break;
+			}
+			missingMip = level;
+			missingX = pageX;
+			missingY = pageY;
+		}
+
+		if (missingMip >= 0)
+		{
+			missingPages.push_back(GetPageKey(textureIndex, missingMip, missingX, missingY));
+		}
+	}
+
+	// request the coarsest missing pages first
+	std::sort(missingPages.begin(), missingPages.end(),
+		[](uint32_t a, uint32_t b)
+		{
+			uint32_t mipA = (a >> 16) & 0xFF;
+			uint32_t mipB = (b >> 16) & 0xFF;
+			return((mipA != mipB) ? (mipA > mipB) : (a < b));
+		});
+	missingPages.erase(std::unique(missingPages.begin(), missingPages.end()), missingPages.end());
+
+	for (size_t i = 0; (i < missingPages.size()) && (m_pendingPages.size() < g_MaxPendingPages); i++)
+	{
+		RequestPage(
+			(int)(missingPages[i] >> 24),
+			(int)((missingPages[i] >> 16) & 0xFF),
+			(int)(missingPages[i] & 0xFF),
+			(int)((missingPages[i] >> 8) & 0xFF));
+	}
+}
+
+/***********************************************************
+ *  RequestPage()
+ *
+ *  This method is used for queueing the load of a virtual
+ *  page on the loader thread, unless it is already queued.
+ ***********************************************************/
+void VirtualTextureSystem::RequestPage(int texture, int mip, int x, int y)
+{
+	uint32_t key = GetPageKey(texture, mip, x, y);
+	if (std::find(m_pendingPages.begin(), m_pendingPages.end(), key) != m_pendingPages.end())
+	{
+		return;
+	}
+
+	PAGE_REQUEST request;
+	request.texture = texture;
+	request.mip = mip;
+	request.x = x;
+	request.y = y;
+	request.pageFilename = m_textures[texture].pageFilename;
+	request.fileOffset = GetPageOffset(m_textures[texture], mip, x, y);
+	m_pendingPages.push_back(key);
+
+	{
+		std::lock_guard<std::mutex> lock(m_loaderMutex);
+		m_requestQueue.push_back(request);
+	}
+	m_loaderCondition.notify_one();
+}
+
+/***********************************************************
+ *  UploadLoadedPages()
+ *
+ *  This method is used for copying the pages that the loader
+ *  thread finished into the page cache.  Only a few pages are
+ *  copied per frame, the rest wait for the next frames.
+ ***********************************************************/
+void VirtualTextureSystem::UploadLoadedPages()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_loaderMutex);
+		for (size_t i = 0; i < m_loadedPages.size(); i++)
+		{
+			// every loaded page is still pending, so the ring only
+			// fills up if that ever stops being true, and the page
+			// is then dropped to be requested again
+			if (m_uploadQueueCount == m_uploadQueue.size())
+			{
+				const PAGE_REQUEST& request = m_loadedPages[i].request;
+				uint32_t key = GetPageKey(request.texture, request.mip, request.x, request.y);
+				m_pendingPages.erase(std::remove(m_pendingPages.begin(), m_pendingPages.end(), key), m_pendingPages.end());
+				continue;
+			}
+			size_t index = (m_uploadQueueStart + m_uploadQueueCount) % m_uploadQueue.size();
+			m_uploadQueue[index] = std::move(m_loadedPages[i]);
+			m_uploadQueueCount++;
+		}
+		m_loadedPages.clear();
+	}
+
+	int uploads = 0;
+	while ((m_uploadQueueCount > 0) && (uploads < g_MaxPageUploadsPerFrame))
+	{
+		const LOADED_PAGE& page = m_uploadQueue[m_uploadQueueStart];
+		const PAGE_REQUEST& request = page.request;
+		m_uploadQueueStart = (m_uploadQueueStart + 1) % m_uploadQueue.size();
+		m_uploadQueueCount--;
+
+		uint32_t key = GetPageKey(request.texture, request.mip, request.x, request.y);
+		m_pendingPages.erase(std::remove(m_pendingPages.begin(), m_pendingPages.end(), key), m_pendingPages.end());
+		if (page.bSuccess == false)
+		{
+			std::cout << "Could not read virtual texture page:" << request.pageFilename << std::endl;
+			continue;
+		}
+
+		VIRTUAL_TEXTURE& texture = m_textures[request.texture];
+		size_t pageIndex = (size_t)request.y * texture.mipPages[request.mip].x + request.x;
+		if (texture.pageSlots[request.mip][pageIndex] >= 0)
+		{
+			continue;
+		}
+
+		// the page is dropped when every cache page is still in use
+		int slot = AllocateCacheSlot();
+		if (slot < 0)
+		{
+			continue;
+		}
+
+		m_cacheSlots[slot].texture = request.texture;
+		m_cacheSlots[slot].mip = request.mip;
+		m_cacheSlots[slot].x = request.x;
+		m_cacheSlots[slot].y = request.y;
+		m_cacheSlots[slot].lastUsedFrame = m_frame;
+		m_cacheSlots[slot].bLocked = false;
+		UploadPage(slot, page.pixels.data());
+		texture.pageSlots[request.mip][pageIndex] = slot;
+		texture.bPageTableDirty = true;
+		uploads++;
+	}
+}
+
+/***********************************************************
+ *  LoaderThread()
+ *
+ *  This method runs on the loader thread and reads the
+ *  requested pages from the page files until it is stopped.
+ ***********************************************************/
+void VirtualTextureSystem::LoaderThread()
+{
+	std::vector<std::ifstream*> files;
+
+	while (true)
+	{
+		PAGE_REQUEST request;
+		{
+			std::unique_lock<std::mutex> lock(m_loaderMutex);
+			m_loaderCondition.wait(lock, [this]() { return(m_bStopLoader || !m_requestQueue.empty()); });
+			if (m_bStopLoader == true)
+			{
+				break;
+			}
+			request = m_requestQueue.front();
+			m_requestQueue.pop_front();
+		}
+
+		// every page file stays open for the lifetime of the thread
+		if ((size_t)request.texture >= files.size())
+		{
+			files.resize(request.texture + 1, NULL);
+		}
+		if (NULL == files[request.texture])
+		{
+			files[request.texture] = new std::ifstream(request.pageFilename.c_str(), std::ios::binary);
+		}
+
+		LOADED_PAGE page;
+		page.request = request;
+		page.bSuccess = ReadPage(*files[request.texture], request.fileOffset, page.pixels);
+
+		{
+			std::lock_guard<std::mutex> lock(m_loaderMutex);
+			m_loadedPages.push_back(std::move(page));
+		}
+	}
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		delete files[i];
+	}
+}
+
+/***********************************************************
+ *  CreateFeedbackFramebuffer()
+ *
+ *  This method is used for creating the small framebuffer
+ *  that the feedback pass renders into, and the pixel buffer
+ *  that it is read back through.
+ ***********************************************************/
+bool VirtualTextureSystem::CreateFeedbackFramebuffer(int width, int height)
+{
+	if (m_feedbackFramebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_feedbackFramebuffer);
+		glDeleteRenderbuffers(1, &m_feedbackColorBuffer);
+		glDeleteRenderbuffers(1, &m_feedbackDepthBuffer);
+		glDeleteBuffers(1, &m_feedbackPixelBuffer);
+		m_feedbackFramebuffer = 0;
+	}
+
+	glGenRenderbuffers(1, &m_feedbackColorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_feedbackColorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glGenRenderbuffers(1, &m_feedbackDepthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_feedbackDepthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_feedbackFramebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_feedbackFramebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_feedbackColorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_feedbackDepthBuffer);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_savedFramebuffer);
+
+	glGenBuffers(1, &m_feedbackPixelBuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, m_feedbackPixelBuffer);
+	glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, NULL, GL_STREAM_READ);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	m_feedbackWidth = width;
+	m_feedbackHeight = height;
+	// every texel can request a page, so the feedback is read
+	// without growing the lists of the requests
+	m_feedbackRequests.reserve((size_t)width * height);
+	m_missingPages.reserve((size_t)width * height);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Virtual texture feedback framebuffer is incomplete" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  BeginFeedbackPass()
+ *
+ *  This method is used for redirecting the rendering into
+ *  the feedback framebuffer.  It returns false on the frames
+ *  that skip the feedback pass, and while the last readback
+ *  is still in flight.
+ ***********************************************************/
+bool VirtualTextureSystem::BeginFeedbackPass()
+{
+	if ((m_textures.empty()) ||
+		(m_feedbackFence != NULL) ||
+		((m_frame % g_FeedbackInterval) != 0))
+	{
+		return(false);
+	}
+
+	glGetIntegerv(GL_VIEWPORT, m_savedViewport);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_savedFramebuffer);
+
+	int width = std::max(1, m_savedViewport[2] / g_FeedbackScale);
+	int height = std::max(1, m_savedViewport[3] / g_FeedbackScale);
+	if (((width != m_feedbackWidth) || (height != m_feedbackHeight) || (m_feedbackFramebuffer == 0)) &&
+		(CreateFeedbackFramebuffer(width, height) == false))
+	{
+		return(false);
+	}
+
+	m_bSavedBlend = glIsEnabled(GL_BLEND);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_feedbackFramebuffer);
+	glViewport(0, 0, m_feedbackWidth, m_feedbackHeight);
+	glDisable(GL_BLEND);
+
+	// pixels without a virtual texture request no pages
+	const GLfloat clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const GLfloat clearDepth = 1.0f;
+	glClearBufferfv(GL_COLOR, 0, clearColor);
+	glClearBufferfv(GL_DEPTH, 0, &clearDepth);
+
+	return(true);
+}
+
+/***********************************************************
+ *  EndFeedbackPass()
+ *
+ *  This method is used for starting the asynchronous
+ *  readback of the feedback framebuffer and restoring the
+ *  rendering state.
+ ***********************************************************/
+void VirtualTextureSystem::EndFeedbackPass()
+{
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, m_feedbackPixelBuffer);
+	glReadPixels(0, 0, m_feedbackWidth, m_feedbackHeight, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	m_feedbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_savedFramebuffer);
+	glViewport(m_savedViewport[0], m_savedViewport[1], m_savedViewport[2], m_savedViewport[3]);
+	if (m_bSavedBlend == GL_TRUE)
+	{
+		glEnable(GL_BLEND);
+	}
+}
+
+/***********************************************************
+ *  GetFeedbackLodBias()
+ *
+ *  This method is used for getting the mip bias that makes
+ *  the feedback pass request the mip levels of the full
+ *  resolution rendering.
+ ***********************************************************/
+float VirtualTextureSystem::GetFeedbackLodBias() const
+{
+	return(-std::log2((float)g_FeedbackScale));
+}
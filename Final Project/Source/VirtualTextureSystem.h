@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////////////
+// virtualtexturesystem.h
+// ============
+// stream the visible pages of very large textures into a page cache
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+/***********************************************************
+ *  VirtualTextureSystem
+ *
+ *  This class contains the code for sparse virtual texturing.
+ *  Every virtual texture is stored on disk as a mip chain of
+ *  fixed size pages.  A low resolution feedback pass records
+ *  the pages and mip levels that are visible, a loader thread
+ *  reads the missing pages from disk, and the loaded pages
+ *  are copied into a shared physical page cache texture.  A
+ *  page table texture per virtual texture maps every virtual
+ *  page to its page in the cache, or to the nearest coarser
+ *  page that is resident, so the GPU memory stays constant
+ *  no matter how large the source images are.
+ ***********************************************************/
+class VirtualTextureSystem
+{
+public:
+	// constructor
+	VirtualTextureSystem(int pageTableUnit, int pageCacheUnit, int cachePagesPerSide = 16);
+	// destructor
+	~VirtualTextureSystem();
+
+	struct VIRTUAL_TEXTURE
+	{
+		std::string tag;
+		std::string pageFilename;
+		int width;
+		int height;
+		int mipCount;
+		// number of pages of every mip level
+		std::vector<glm::ivec2> mipPages;
+		// index of the first page of every mip level in the file
+		std::vector<size_t> mipFirstPage;
+		// cache page of every virtual page, or -1 when not resident
+		std::vector<std::vector<int>> pageSlots;
+		// page table entries of every mip level, uploaded to the GPU
+		std::vector<std::vector<unsigned char>> pageTable;
+		GLuint pageTableTexture;
+		bool bPageTableDirty;
+	};
+
+	// build the page file of an image offline
+	static bool BuildPageFile(const char* imageFilename, const char* pageFilename);
+	// get the page file name used for an image file
+	static std::string GetPageFilename(const char* imageFilename);
+
+	// open a page file as a new virtual texture
+	int AddVirtualTexture(const char* pageFilename, std::string tag);
+	// find a virtual texture by tag
+	int FindVirtualTexture(const char* tag) const;
+	// get an opened virtual texture
+	const VIRTUAL_TEXTURE& GetVirtualTexture(int index) const;
+	int GetVirtualTextureCount() const;
+
+	// bind the page table of a virtual texture for drawing
+	void BindPageTable(int index);
+	// get the layout of the physical page cache
+	int GetPageSize() const;
+	int GetPageBorder() const;
+	glm::vec2 GetPageCacheSize() const;
+	size_t GetPageCacheBytes() const;
+
+	// process the feedback, upload the loaded pages and page tables
+	void Update();
+
+	// render into the feedback buffer on the frames that need it
+	bool BeginFeedbackPass();
+	void EndFeedbackPass();
+	// get the mip bias that compensates the feedback resolution
+	float GetFeedbackLodBias() const;
+
+private:
+	struct CACHE_SLOT
+	{
+		int texture;
+		int mip;
+		int x;
+		int y;
+		uint64_t lastUsedFrame;
+		bool bLocked;
+	};
+
+	struct PAGE_REQUEST
+	{
+		int texture;
+		int mip;
+		int x;
+		int y;
+		std::string pageFilename;
+		size_t fileOffset;
+	};
+
+	struct LOADED_PAGE
+	{
+		PAGE_REQUEST request;
+		std::vector<unsigned char> pixels;
+		bool bSuccess;
+	};
+
+	// texture units used for the page tables and the page cache
+	int m_pageTableUnit;
+	int m_pageCacheUnit;
+	// number of pages along each side of the page cache
+	int m_cachePagesPerSide;
+	// physical page cache texture and its pages
+	GLuint m_pageCacheTexture;
+	std::vector<CACHE_SLOT> m_cacheSlots;
+	// opened virtual textures
+	std::vector<VIRTUAL_TEXTURE> m_textures;
+	// number of the current frame
+	uint64_t m_frame;
+	// frame in which the last feedback was processed
+	uint64_t m_feedbackFrame;
+	// pages that are requested from the loader and not uploaded yet
+	std::vector<uint32_t> m_pendingPages;
+	// ring of the loaded pages that are waiting to be uploaded,
+	// with room for every pending page
+	std::vector<LOADED_PAGE> m_uploadQueue;
+	size_t m_uploadQueueStart;
+	size_t m_uploadQueueCount;
+	// pages read from the last feedback, and the missing ones,
+	// kept to reuse their memory
+	std::vector<uint32_t> m_feedbackRequests;
+	std::vector<uint32_t> m_missingPages;
+
+	// feedback framebuffer and its asynchronous readback
+	GLuint m_feedbackFramebuffer;
+	GLuint m_feedbackColorBuffer;
+	GLuint m_feedbackDepthBuffer;
+	GLuint m_feedbackPixelBuffer;
+	GLsync m_feedbackFence;
+	int m_feedbackWidth;
+	int m_feedbackHeight;
+	// state that the feedback pass restores when it ends
+	GLint m_savedFramebuffer;
+	GLint m_savedViewport[4];
+	GLboolean m_bSavedBlend;
+
+	// loader thread and the queues that it shares with the renderer
+	std::thread m_loaderThread;
+	std::mutex m_loaderMutex;
+	std::condition_variable m_loaderCondition;
+	std::deque<PAGE_REQUEST> m_requestQueue;
+	std::vector<LOADED_PAGE> m_loadedPages;
+	bool m_bStopLoader;
+
+	// read pages from disk on the loader thread
+	void LoaderThread();
+	// read one page from an opened page file
+	static bool ReadPage(std::istream& file, size_t fileOffset, std::vector<unsigned char>& pixels);
+	// create the physical page cache texture
+	bool CreatePageCache();
+	// find a free cache page, or the least recently used one
+	int AllocateCacheSlot();
+	// copy a loaded page into a cache page
+	void UploadPage(int slot, const unsigned char* pixels);
+	// create the feedback framebuffer for the current viewport
+	bool CreateFeedbackFramebuffer(int width, int height);
+	// read the requested pages from the last feedback pass
+	void ProcessFeedback();
+	// queue the load of a virtual page
+	void RequestPage(int texture, int mip, int x, int y);
+	// copy the loaded pages into the page cache
+	void UploadLoadedPages();
+	// rebuild and upload the page table of a virtual texture
+	void UpdatePageTable(int index);
+	// get the file offset and key of a virtual page
+	size_t GetPageOffset(const VIRTUAL_TEXTURE& texture, int mip, int x, int y) const;
+	static uint32_t GetPageKey(int texture, int mip, int x, int y);
+};
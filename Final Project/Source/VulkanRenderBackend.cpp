@@ -0,0 +1,2584 @@
+///////////////////////////////////////////////////////////////////////////////
+// vulkanrenderbackend.cpp
+// ============
+// draw the scene with Vulkan, recording the draws on a pool of threads
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "VulkanRenderBackend.h"
+
+#ifdef VULKANRENDERBACKEND_AVAILABLE
+
+#include "FramePacer.h"
+#include "FrameProfiler.h"
+
+// GLFW declares its Vulkan functions after the Vulkan header
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+// the Vulkan functions that the backend calls, which are loaded for
+// the instance and for the device once they are created
+#define VULKAN_INSTANCE_FUNCTIONS(FUNCTION) \
+	FUNCTION(vkDestroyInstance) \
+	FUNCTION(vkEnumeratePhysicalDevices) \
+	FUNCTION(vkGetPhysicalDeviceProperties) \
+	FUNCTION(vkGetPhysicalDeviceQueueFamilyProperties) \
+	FUNCTION(vkGetPhysicalDeviceMemoryProperties) \
+	FUNCTION(vkCreateDevice) \
+	FUNCTION(vkGetDeviceProcAddr)
+
+#define VULKAN_DEVICE_FUNCTIONS(FUNCTION) \
+	FUNCTION(vkDestroyDevice) \
+	FUNCTION(vkGetDeviceQueue) \
+	FUNCTION(vkDeviceWaitIdle) \
+	FUNCTION(vkQueueSubmit) \
+	FUNCTION(vkQueueWaitIdle) \
+	FUNCTION(vkCreateFence) \
+	FUNCTION(vkDestroyFence) \
+	FUNCTION(vkWaitForFences) \
+	FUNCTION(vkResetFences) \
+	FUNCTION(vkAllocateMemory) \
+	FUNCTION(vkFreeMemory) \
+	FUNCTION(vkMapMemory) \
+	FUNCTION(vkCreateBuffer) \
+	FUNCTION(vkDestroyBuffer) \
+	FUNCTION(vkGetBufferMemoryRequirements) \
+	FUNCTION(vkBindBufferMemory) \
+	FUNCTION(vkCreateImage) \
+	FUNCTION(vkDestroyImage) \
+	FUNCTION(vkGetImageMemoryRequirements) \
+	FUNCTION(vkBindImageMemory) \
+	FUNCTION(vkCreateImageView) \
+	FUNCTION(vkDestroyImageView) \
+	FUNCTION(vkCreateSampler) \
+	FUNCTION(vkDestroySampler) \
+	FUNCTION(vkCreateRenderPass) \
+	FUNCTION(vkDestroyRenderPass) \
+	FUNCTION(vkCreateFramebuffer) \
+	FUNCTION(vkDestroyFramebuffer) \
+	FUNCTION(vkCreateShaderModule) \
+	FUNCTION(vkDestroyShaderModule) \
+	FUNCTION(vkCreatePipelineCache) \
+	FUNCTION(vkDestroyPipelineCache) \
+	FUNCTION(vkCreateGraphicsPipelines) \
+	FUNCTION(vkDestroyPipeline) \
+	FUNCTION(vkCreatePipelineLayout) \
+	FUNCTION(vkDestroyPipelineLayout) \
+	FUNCTION(vkCreateDescriptorSetLayout) \
+	FUNCTION(vkDestroyDescriptorSetLayout) \
+	FUNCTION(vkCreateDescriptorPool) \
+	FUNCTION(vkDestroyDescriptorPool) \
+	FUNCTION(vkAllocateDescriptorSets) \
+	FUNCTION(vkFreeDescriptorSets) \
+	FUNCTION(vkUpdateDescriptorSets) \
+	FUNCTION(vkCreateCommandPool) \
+	FUNCTION(vkDestroyCommandPool) \
+	FUNCTION(vkResetCommandPool) \
+	FUNCTION(vkAllocateCommandBuffers) \
+	FUNCTION(vkFreeCommandBuffers) \
+	FUNCTION(vkBeginCommandBuffer) \
+	FUNCTION(vkEndCommandBuffer) \
+	FUNCTION(vkCmdBeginRenderPass) \
+	FUNCTION(vkCmdEndRenderPass) \
+	FUNCTION(vkCmdExecuteCommands) \
+	FUNCTION(vkCmdBindPipeline) \
+	FUNCTION(vkCmdBindDescriptorSets) \
+	FUNCTION(vkCmdBindVertexBuffers) \
+	FUNCTION(vkCmdBindIndexBuffer) \
+	FUNCTION(vkCmdDrawIndexed) \
+	FUNCTION(vkCmdSetViewport) \
+	FUNCTION(vkCmdSetScissor) \
+	FUNCTION(vkCmdCopyBuffer) \
+	FUNCTION(vkCmdCopyBufferToImage) \
+	FUNCTION(vkCmdCopyImageToBuffer) \
+	FUNCTION(vkCmdBlitImage) \
+	FUNCTION(vkCmdPipelineBarrier)
+
+#define VULKAN_DECLARE_FUNCTION(name) PFN_##name name = NULL;
+
+#define VULKAN_LOAD_INSTANCE_FUNCTION(name) \
+	name = (PFN_##name)glfwGetInstanceProcAddress(m_instance, #name); \
+	if (NULL == name) \
+	{ \
+		std::cout << "Could not load Vulkan function:" << #name << std::endl; \
+		return(false); \
+	}
+
+#define VULKAN_LOAD_DEVICE_FUNCTION(name) \
+	name = (PFN_##name)vkGetDeviceProcAddr(m_device, #name); \
+	if (NULL == name) \
+	{ \
+		std::cout << "Could not load Vulkan function:" << #name << std::endl; \
+		return(false); \
+	}
+
+// declaration of global variables
+namespace
+{
+	PFN_vkCreateInstance vkCreateInstance = NULL;
+	VULKAN_INSTANCE_FUNCTIONS(VULKAN_DECLARE_FUNCTION)
+	VULKAN_DEVICE_FUNCTIONS(VULKAN_DECLARE_FUNCTION)
+
+	// names of the uniforms that the backend shades with
+	const char* g_ModelName = "model";
+	const char* g_ViewName = "view";
+	const char* g_ProjectionName = "projection";
+	const char* g_ViewPositionName = "viewPosition";
+	const char* g_ColorValueName = "objectColor";
+	const char* g_TextureValueName = "objectTexture";
+	const char* g_UseTextureName = "bUseTexture";
+	const char* g_UseLightingName = "bUseLighting";
+	const char* g_UVScaleName = "UVscale";
+	const char* g_UVOffsetName = "UVoffset";
+	const char* g_LightArrayName = "lightSources[";
+
+	// segments around the round shapes
+	const int g_ShapeSegments = 24;
+	// most threads that record the draws, including the render thread
+	const int g_MaxThreads = 16;
+	// fewest draws that are worth recording on a thread of their own
+	const int g_MinGroupDraws = 64;
+	// most textures that descriptor sets are allocated for
+	const uint32_t g_MaxTextures = 1024;
+
+	// formats of the images that the frames are drawn into, where the
+	// color matches the RGBA bytes of the OpenGL texture it is shown with
+	const VkFormat g_ColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+	const VkFormat g_DepthFormat = VK_FORMAT_D32_SFLOAT;
+
+	/***********************************************************
+	 *  TransitionImage()
+	 *
+	 *  Record a barrier that moves mip levels of a color image
+	 *  from one layout into another.
+	 ***********************************************************/
+	void TransitionImage(
+		VkCommandBuffer commandBuffer,
+		VkImage image,
+		uint32_t baseMip,
+		uint32_t mipCount,
+		VkImageLayout oldLayout,
+		VkImageLayout newLayout,
+		VkAccessFlags sourceAccess,
+		VkAccessFlags destinationAccess,
+		VkPipelineStageFlags sourceStage,
+		VkPipelineStageFlags destinationStage)
+	{
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = sourceAccess;
+		barrier.dstAccessMask = destinationAccess;
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = baseMip;
+		barrier.subresourceRange.levelCount = mipCount;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, NULL, 0, NULL, 1, &barrier);
+	}
+}
+
+/***********************************************************
+ *  VulkanRenderBackend()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+VulkanRenderBackend::VulkanRenderBackend()
+{
+	m_instance = VK_NULL_HANDLE;
+	m_physicalDevice = VK_NULL_HANDLE;
+	m_device = VK_NULL_HANDLE;
+	m_queue = VK_NULL_HANDLE;
+	m_queueFamily = 0;
+	memset(&m_memoryProperties, 0, sizeof(m_memoryProperties));
+	m_drawUniformStride = sizeof(DRAW_UNIFORMS);
+
+	m_renderPass = VK_NULL_HANDLE;
+	m_frameSetLayout = VK_NULL_HANDLE;
+	m_textureSetLayout = VK_NULL_HANDLE;
+	m_pipelineLayout = VK_NULL_HANDLE;
+	m_vertexShader = VK_NULL_HANDLE;
+	m_fragmentShader = VK_NULL_HANDLE;
+	m_pipelineCache = VK_NULL_HANDLE;
+	for (int i = 0; i < PIPELINE_COUNT; i++)
+	{
+		m_pipelines[i] = VK_NULL_HANDLE;
+	}
+	m_descriptorPool = VK_NULL_HANDLE;
+	m_sampler = VK_NULL_HANDLE;
+	m_uploadPool = VK_NULL_HANDLE;
+
+	m_vertexBuffer.buffer = VK_NULL_HANDLE;
+	m_vertexBuffer.memory = VK_NULL_HANDLE;
+	m_vertexBuffer.pMapped = NULL;
+	m_indexBuffer = m_vertexBuffer;
+	for (int i = 0; i < SHAPE_COUNT; i++)
+	{
+		m_shapes[i].firstIndex = 0;
+		m_shapes[i].indexCount = 0;
+		m_shapes[i].vertexOffset = 0;
+	}
+	m_pWhiteTexture = NULL;
+
+	for (int i = 0; i < FRAMES_IN_FLIGHT; i++)
+	{
+		FRAME& frame = m_frames[i];
+		frame.fence = VK_NULL_HANDLE;
+		frame.bSubmitted = false;
+		frame.commandPool = VK_NULL_HANDLE;
+		frame.commandBuffer = VK_NULL_HANDLE;
+		frame.frameUniforms = m_vertexBuffer;
+		frame.drawUniforms = m_vertexBuffer;
+		frame.descriptorSet = VK_NULL_HANDLE;
+		frame.width = 0;
+		frame.height = 0;
+		frame.color.image = VK_NULL_HANDLE;
+		frame.color.memory = VK_NULL_HANDLE;
+		frame.color.view = VK_NULL_HANDLE;
+		frame.depth = frame.color;
+		frame.framebuffer = VK_NULL_HANDLE;
+		frame.readback = m_vertexBuffer;
+	}
+	m_submittedFrames = 0;
+	m_presentedFrame = 0;
+	m_presentLatency = FRAMES_IN_FLIGHT - 1;
+	m_width = 0;
+	m_height = 0;
+
+	m_view = glm::mat4(1.0f);
+	m_projection = glm::mat4(1.0f);
+	// the lights and the material start out black, like unset uniforms
+	m_uniforms.model = glm::mat4(1.0f);
+	m_uniforms.viewProjection = glm::mat4(1.0f);
+	m_uniforms.color = glm::vec4(1.0f);
+	m_uniforms.uvTransform = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+	m_uniforms.ambientColor = glm::vec4(0.0f);
+	m_uniforms.diffuseColor = glm::vec4(0.0f);
+	m_uniforms.specularColor = glm::vec4(0.0f);
+	for (int i = 0; i < 4; i++)
+	{
+		m_uniforms.options[i] = 0;
+	}
+	m_frameUniforms.viewPosition = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	for (int i = 0; i < LIGHT_COUNT; i++)
+	{
+		m_frameUniforms.lights[i].positionRadius = glm::vec4(0.0f);
+		m_frameUniforms.lights[i].ambientColor = glm::vec4(0.0f);
+		m_frameUniforms.lights[i].diffuseColor = glm::vec4(0.0f);
+		m_frameUniforms.lights[i].specularColor = glm::vec4(0.0f);
+	}
+	m_bDepthTest = true;
+	m_bDepthWrite = true;
+	m_bColorWrite = true;
+	m_bBlend = false;
+	m_depthFunction = DEPTH_LESS;
+	m_textureUnit = 0;
+
+	m_pRecordFrame = NULL;
+	m_groupCount = 0;
+
+	m_presentTexture = 0;
+	m_presentFramebuffer = 0;
+	m_presentWidth = 0;
+	m_presentHeight = 0;
+
+	int threadCount = (int)std::thread::hardware_concurrency();
+	threadCount = (threadCount < g_MaxThreads) ? threadCount : g_MaxThreads;
+	m_threadCount = (threadCount > 1) ? threadCount : 1;
+	m_nextGroup = 0;
+	m_generation = 0;
+	m_busyWorkers = 0;
+	m_bShutdown = false;
+
+	m_frameCount = 0;
+	m_drawTotal = 0;
+	m_recordTimeTotal = 0.0;
+	m_waitTimeTotal = 0.0;
+}
+
+/***********************************************************
+ *  ~VulkanRenderBackend()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+VulkanRenderBackend::~VulkanRenderBackend()
+{
+	StopWorkers();
+
+	if (VK_NULL_HANDLE != m_device)
+	{
+		vkDeviceWaitIdle(m_device);
+
+		for (size_t i = 0; i < m_textures.size(); i++)
+		{
+			FreeTexture(m_textures[i]);
+		}
+		m_textures.clear();
+		for (size_t i = 0; i < m_destroyedTextures.size(); i++)
+		{
+			FreeTexture(m_destroyedTextures[i]);
+		}
+		m_destroyedTextures.clear();
+		FreeTexture(m_pWhiteTexture);
+		m_pWhiteTexture = NULL;
+
+		for (int i = 0; i < FRAMES_IN_FLIGHT; i++)
+		{
+			DestroyFrame(m_frames[i]);
+		}
+		DestroyDeviceBuffer(m_vertexBuffer);
+		DestroyDeviceBuffer(m_indexBuffer);
+
+		for (int i = 0; i < PIPELINE_COUNT; i++)
+		{
+			if (VK_NULL_HANDLE != m_pipelines[i])
+			{
+				vkDestroyPipeline(m_device, m_pipelines[i], NULL);
+			}
+		}
+		if (VK_NULL_HANDLE != m_pipelineCache)
+		{
+			vkDestroyPipelineCache(m_device, m_pipelineCache, NULL);
+		}
+		if (VK_NULL_HANDLE != m_vertexShader)
+		{
+			vkDestroyShaderModule(m_device, m_vertexShader, NULL);
+		}
+		if (VK_NULL_HANDLE != m_fragmentShader)
+		{
+			vkDestroyShaderModule(m_device, m_fragmentShader, NULL);
+		}
+		if (VK_NULL_HANDLE != m_pipelineLayout)
+		{
+			vkDestroyPipelineLayout(m_device, m_pipelineLayout, NULL);
+		}
+		if (VK_NULL_HANDLE != m_frameSetLayout)
+		{
+			vkDestroyDescriptorSetLayout(m_device, m_frameSetLayout, NULL);
+		}
+		if (VK_NULL_HANDLE != m_textureSetLayout)
+		{
+			vkDestroyDescriptorSetLayout(m_device, m_textureSetLayout, NULL);
+		}
+		if (VK_NULL_HANDLE != m_descriptorPool)
+		{
+			vkDestroyDescriptorPool(m_device, m_descriptorPool, NULL);
+		}
+		if (VK_NULL_HANDLE != m_sampler)
+		{
+			vkDestroySampler(m_device, m_sampler, NULL);
+		}
+		if (VK_NULL_HANDLE != m_uploadPool)
+		{
+			vkDestroyCommandPool(m_device, m_uploadPool, NULL);
+		}
+		if (VK_NULL_HANDLE != m_renderPass)
+		{
+			vkDestroyRenderPass(m_device, m_renderPass, NULL);
+		}
+
+		vkDestroyDevice(m_device, NULL);
+		m_device = VK_NULL_HANDLE;
+	}
+
+	if ((VK_NULL_HANDLE != m_instance) && (NULL != vkDestroyInstance))
+	{
+		vkDestroyInstance(m_instance, NULL);
+		m_instance = VK_NULL_HANDLE;
+	}
+
+	if (0 != m_presentFramebuffer)
+	{
+		glDeleteFramebuffers(1, &m_presentFramebuffer);
+		m_presentFramebuffer = 0;
+	}
+	if (0 != m_presentTexture)
+	{
+		glDeleteTextures(1, &m_presentTexture);
+		m_presentTexture = 0;
+	}
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used to create the Vulkan device and the
+ *  objects that every frame uses, and to load the SPIR-V
+ *  shaders compiled from the Vulkan scene shaders.  It must
+ *  be called after GLFW is initialized, which finds the
+ *  Vulkan loader.
+ ***********************************************************/
+bool VulkanRenderBackend::Initialize(const char* vertexShaderPath, const char* fragmentShaderPath)
+{
+	if (VK_NULL_HANDLE != m_device)
+	{
+		return(true);
+	}
+
+	bool bSuccess = CreateDevice();
+	bSuccess = bSuccess && CreateRenderPass();
+	bSuccess = bSuccess && CreateLayouts();
+	if (bSuccess == true)
+	{
+		m_vertexShader = LoadShader(vertexShaderPath);
+		m_fragmentShader = LoadShader(fragmentShaderPath);
+		bSuccess = (VK_NULL_HANDLE != m_vertexShader) && (VK_NULL_HANDLE != m_fragmentShader);
+	}
+	bSuccess = bSuccess && CreateShapes();
+	bSuccess = bSuccess && CreateFrames();
+
+	// the draws without a texture sample a white texel
+	if (bSuccess == true)
+	{
+		const unsigned char white[4] = { 255, 255, 255, 255 };
+		m_pWhiteTexture = new TEXTURE();
+		m_pWhiteTexture->image.image = VK_NULL_HANDLE;
+		m_pWhiteTexture->image.memory = VK_NULL_HANDLE;
+		m_pWhiteTexture->image.view = VK_NULL_HANDLE;
+		m_pWhiteTexture->descriptorSet = VK_NULL_HANDLE;
+		bSuccess = UploadTexture(white, 1, 1, 1, *m_pWhiteTexture);
+	}
+
+	if (bSuccess == false)
+	{
+		std::cout << "Could not initialize the Vulkan backend" << std::endl;
+	}
+
+	return(bSuccess);
+}
+
+/***********************************************************
+ *  CreateDevice()
+ *
+ *  This method is used to create the Vulkan instance and a
+ *  device with a graphics queue.  A GPU is preferred, and a
+ *  CPU device like lavapipe is used when it is the only one,
+ *  so the backend can run without graphics hardware.
+ ***********************************************************/
+bool VulkanRenderBackend::CreateDevice()
+{
+	if (glfwVulkanSupported() == GLFW_FALSE)
+	{
+		std::cout << "Could not find a Vulkan loader" << std::endl;
+		return(false);
+	}
+
+	vkCreateInstance = (PFN_vkCreateInstance)glfwGetInstanceProcAddress(NULL, "vkCreateInstance");
+	if (NULL == vkCreateInstance)
+	{
+		std::cout << "Could not load Vulkan function:vkCreateInstance" << std::endl;
+		return(false);
+	}
+
+	VkApplicationInfo applicationInfo = {};
+	applicationInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+	applicationInfo.pApplicationName = "7-1_FinalProjectMilestones";
+	applicationInfo.apiVersion = VK_API_VERSION_1_0;
+
+	VkInstanceCreateInfo instanceInfo = {};
+	instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+	instanceInfo.pApplicationInfo = &applicationInfo;
+	if (vkCreateInstance(&instanceInfo, NULL, &m_instance) != VK_SUCCESS)
+	{
+		std::cout << "Could not create a Vulkan instance" << std::endl;
+		m_instance = VK_NULL_HANDLE;
+		return(false);
+	}
+	VULKAN_INSTANCE_FUNCTIONS(VULKAN_LOAD_INSTANCE_FUNCTION)
+
+	uint32_t deviceCount = 0;
+	vkEnumeratePhysicalDevices(m_instance, &deviceCount, NULL);
+	std::vector<VkPhysicalDevice> devices(deviceCount);
+	if (deviceCount > 0)
+	{
+		vkEnumeratePhysicalDevices(m_instance, &deviceCount, devices.data());
+	}
+
+	VkPhysicalDeviceProperties deviceProperties = {};
+	for (uint32_t i = 0; i < deviceCount; i++)
+	{
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(devices[i], &properties);
+
+		uint32_t familyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(devices[i], &familyCount, NULL);
+		std::vector<VkQueueFamilyProperties> families(familyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(devices[i], &familyCount, families.data());
+
+		for (uint32_t family = 0; family < familyCount; family++)
+		{
+			if ((families[family].queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0)
+			{
+				continue;
+			}
+
+			if ((VK_NULL_HANDLE == m_physicalDevice) ||
+				((deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU) &&
+				(properties.deviceType != VK_PHYSICAL_DEVICE_TYPE_CPU)))
+			{
+				m_physicalDevice = devices[i];
+				m_queueFamily = family;
+				deviceProperties = properties;
+			}
+			break;
+		}
+	}
+
+	if (VK_NULL_HANDLE == m_physicalDevice)
+	{
+		std::cout << "Could not find a Vulkan device with a graphics queue" << std::endl;
+		return(false);
+	}
+
+	float queuePriority = 1.0f;
+	VkDeviceQueueCreateInfo queueInfo = {};
+	queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queueInfo.queueFamilyIndex = m_queueFamily;
+	queueInfo.queueCount = 1;
+	queueInfo.pQueuePriorities = &queuePriority;
+
+	VkDeviceCreateInfo deviceInfo = {};
+	deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceInfo.queueCreateInfoCount = 1;
+	deviceInfo.pQueueCreateInfos = &queueInfo;
+	if (vkCreateDevice(m_physicalDevice, &deviceInfo, NULL, &m_device) != VK_SUCCESS)
+	{
+		std::cout << "Could not create the Vulkan device:" << deviceProperties.deviceName << std::endl;
+		m_device = VK_NULL_HANDLE;
+		return(false);
+	}
+	VULKAN_DEVICE_FUNCTIONS(VULKAN_LOAD_DEVICE_FUNCTION)
+
+	vkGetDeviceQueue(m_device, m_queueFamily, 0, &m_queue);
+	vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_memoryProperties);
+
+	// the uniforms of every draw start at an offset that the
+	// device can bind a uniform buffer from
+	VkDeviceSize alignment = deviceProperties.limits.minUniformBufferOffsetAlignment;
+	alignment = (alignment > 0) ? alignment : 1;
+	m_drawUniformStride = (sizeof(DRAW_UNIFORMS) + alignment - 1) / alignment * alignment;
+
+	VkCommandPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = m_queueFamily;
+	if (vkCreateCommandPool(m_device, &poolInfo, NULL, &m_uploadPool) != VK_SUCCESS)
+	{
+		std::cout << "Could not create the Vulkan upload command pool" << std::endl;
+		m_uploadPool = VK_NULL_HANDLE;
+		return(false);
+	}
+
+	std::cout << "Vulkan device: " << deviceProperties.deviceName << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateRenderPass()
+ *
+ *  This method is used to create the render pass that the
+ *  frames are drawn in.  The color image is left ready to
+ *  be copied into the readback buffer.
+ ***********************************************************/
+bool VulkanRenderBackend::CreateRenderPass()
+{
+	VkAttachmentDescription attachments[2] = {};
+	attachments[0].format = g_ColorFormat;
+	attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+	attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachments[0].finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	attachments[1].format = g_DepthFormat;
+	attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
+	attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	VkAttachmentReference colorReference = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+	VkAttachmentReference depthReference = { 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+	VkSubpassDescription subpass = {};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorReference;
+	subpass.pDepthStencilAttachment = &depthReference;
+
+	// the attachments are written after the last frame drawn into
+	// them, and the color is copied out once the pass is done
+	VkSubpassDependency dependencies[2] = {};
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+	dependencies[0].srcAccessMask = 0;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	dependencies[1].srcSubpass = 0;
+	dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+	VkRenderPassCreateInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassInfo.attachmentCount = 2;
+	renderPassInfo.pAttachments = attachments;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	renderPassInfo.dependencyCount = 2;
+	renderPassInfo.pDependencies = dependencies;
+	if (vkCreateRenderPass(m_device, &renderPassInfo, NULL, &m_renderPass) != VK_SUCCESS)
+	{
+		std::cout << "Could not create the Vulkan render pass" << std::endl;
+		m_renderPass = VK_NULL_HANDLE;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateLayouts()
+ *
+ *  This method is used to create the descriptor layouts of
+ *  the uniforms and textures, the pool their descriptor sets
+ *  come from, the sampler of the textures and the cache of
+ *  the pipelines.
+ ***********************************************************/
+bool VulkanRenderBackend::CreateLayouts()
+{
+	// the frame uniforms, and the uniforms of the draws with an
+	// offset that is set for every draw
+	VkDescriptorSetLayoutBinding frameBindings[2] = {};
+	frameBindings[0].binding = 0;
+	frameBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	frameBindings[0].descriptorCount = 1;
+	frameBindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	frameBindings[1].binding = 1;
+	frameBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	frameBindings[1].descriptorCount = 1;
+	frameBindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.bindingCount = 2;
+	layoutInfo.pBindings = frameBindings;
+	if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, NULL, &m_frameSetLayout) != VK_SUCCESS)
+	{
+		std::cout << "Could not create the Vulkan uniform layout" << std::endl;
+		m_frameSetLayout = VK_NULL_HANDLE;
+		return(false);
+	}
+
+	VkDescriptorSetLayoutBinding textureBinding = {};
+	textureBinding.binding = 0;
+	textureBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	textureBinding.descriptorCount = 1;
+	textureBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	layoutInfo.bindingCount = 1;
+	layoutInfo.pBindings = &textureBinding;
+	if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, NULL, &m_textureSetLayout) != VK_SUCCESS)
+	{
+		std::cout << "Could not create the Vulkan texture layout" << std::endl;
+		m_textureSetLayout = VK_NULL_HANDLE;
+		return(false);
+	}
+
+	VkDescriptorSetLayout setLayouts[2] = { m_frameSetLayout, m_textureSetLayout };
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 2;
+	pipelineLayoutInfo.pSetLayouts = setLayouts;
+	if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, NULL, &m_pipelineLayout) != VK_SUCCESS)
+	{
+		std::cout << "Could not create the Vulkan pipeline layout" << std::endl;
+		m_pipelineLayout = VK_NULL_HANDLE;
+		return(false);
+	}
+
+	// the texture sets are freed one at a time with their textures
+	VkDescriptorPoolSize poolSizes[3] = {};
+	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	poolSizes[0].descriptorCount = FRAMES_IN_FLIGHT;
+	poolSizes[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	poolSizes[1].descriptorCount = FRAMES_IN_FLIGHT;
+	poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	poolSizes[2].descriptorCount = g_MaxTextures + 1;
+
+	VkDescriptorPoolCreateInfo descriptorPoolInfo = {};
+	descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	descriptorPoolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+	descriptorPoolInfo.maxSets = FRAMES_IN_FLIGHT + g_MaxTextures + 1;
+	descriptorPoolInfo.poolSizeCount = 3;
+	descriptorPoolInfo.pPoolSizes = poolSizes;
+	if (vkCreateDescriptorPool(m_device, &descriptorPoolInfo, NULL, &m_descriptorPool) != VK_SUCCESS)
+	{
+		std::cout << "Could not create the Vulkan descriptor pool" << std::endl;
+		m_descriptorPool = VK_NULL_HANDLE;
+		return(false);
+	}
+
+	// the textures repeat and blend between their mip levels, like
+	// the OpenGL textures of the scene
+	VkSamplerCreateInfo samplerInfo = {};
+	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerInfo.magFilter = VK_FILTER_LINEAR;
+	samplerInfo.minFilter = VK_FILTER_LINEAR;
+	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerInfo.maxAnisotropy = 1.0f;
+	samplerInfo.minLod = 0.0f;
+	samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+	if (vkCreateSampler(m_device, &samplerInfo, NULL, &m_sampler) != VK_SUCCESS)
+	{
+		std::cout << "Could not create the Vulkan sampler" << std::endl;
+		m_sampler = VK_NULL_HANDLE;
+		return(false);
+	}
+
+	VkPipelineCacheCreateInfo cacheInfo = {};
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	if (vkCreatePipelineCache(m_device, &cacheInfo, NULL, &m_pipelineCache) != VK_SUCCESS)
+	{
+		m_pipelineCache = VK_NULL_HANDLE;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  LoadShader()
+ *
+ *  This method is used to load a shader module from a file
+ *  of SPIR-V code.
+ ***********************************************************/
+VkShaderModule VulkanRenderBackend::LoadShader(const char* filename)
+{
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		std::cout << "Could not open shader file:" << filename << std::endl;
+		return(VK_NULL_HANDLE);
+	}
+
+	std::streamsize size = file.tellg();
+	if ((size <= 0) || ((size % 4) != 0))
+	{
+		std::cout << "Not a SPIR-V shader file:" << filename << std::endl;
+		return(VK_NULL_HANDLE);
+	}
+
+	std::vector<uint32_t> code((size_t)size / 4);
+	file.seekg(0);
+	file.read((char*)code.data(), size);
+	if (!file)
+	{
+		std::cout << "Could not read shader file:" << filename << std::endl;
+		return(VK_NULL_HANDLE);
+	}
+
+	VkShaderModuleCreateInfo moduleInfo = {};
+	moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	moduleInfo.codeSize = (size_t)size;
+	moduleInfo.pCode = code.data();
+
+	VkShaderModule shaderModule = VK_NULL_HANDLE;
+	if (vkCreateShaderModule(m_device, &moduleInfo, NULL, &shaderModule) != VK_SUCCESS)
+	{
+		std::cout << "Could not create shader module:" << filename << std::endl;
+		return(VK_NULL_HANDLE);
+	}
+
+	return(shaderModule);
+}
+
+/***********************************************************
+ *  CreateShapes()
+ *
+ *  This method is used to build the triangles of every shape
+ *  and to upload them into one vertex and one index buffer.
+ ***********************************************************/
+bool VulkanRenderBackend::CreateShapes()
+{
+	std::vector<ShapeGeometry::VERTEX> vertices;
+	std::vector<uint32_t> indices;
+	ShapeGeometry geometry;
+	for (int i = 0; i < SHAPE_COUNT; i++)
+	{
+		geometry.Build((SHAPE_MESH)i, g_ShapeSegments);
+		m_shapes[i].firstIndex = (uint32_t)indices.size();
+		m_shapes[i].indexCount = (uint32_t)geometry.GetIndices().size();
+		m_shapes[i].vertexOffset = (int32_t)vertices.size();
+		vertices.insert(vertices.end(), geometry.GetVertices().begin(), geometry.GetVertices().end());
+		indices.insert(indices.end(), geometry.GetIndices().begin(), geometry.GetIndices().end());
+	}
+
+	bool bSuccess = UploadBuffer(
+		vertices.data(),
+		vertices.size() * sizeof(ShapeGeometry::VERTEX),
+		VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		m_vertexBuffer);
+	bSuccess = bSuccess && UploadBuffer(
+		indices.data(),
+		indices.size() * sizeof(uint32_t),
+		VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+		m_indexBuffer);
+	if (bSuccess == false)
+	{
+		std::cout << "Could not upload the Vulkan shape meshes" << std::endl;
+	}
+
+	return(bSuccess);
+}
+
+/***********************************************************
+ *  CreateFrames()
+ *
+ *  This method is used to create the fence, the command
+ *  pool and the uniform buffers of every frame in flight.
+ *  The images are created once the framebuffer size is known.
+ ***********************************************************/
+bool VulkanRenderBackend::CreateFrames()
+{
+	for (int i = 0; i < FRAMES_IN_FLIGHT; i++)
+	{
+		FRAME& frame = m_frames[i];
+
+		VkFenceCreateInfo fenceInfo = {};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		if (vkCreateFence(m_device, &fenceInfo, NULL, &frame.fence) != VK_SUCCESS)
+		{
+			frame.fence = VK_NULL_HANDLE;
+			return(false);
+		}
+
+		VkCommandPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = m_queueFamily;
+		if (vkCreateCommandPool(m_device, &poolInfo, NULL, &frame.commandPool) != VK_SUCCESS)
+		{
+			frame.commandPool = VK_NULL_HANDLE;
+			return(false);
+		}
+
+		VkCommandBufferAllocateInfo allocateInfo = {};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocateInfo.commandPool = frame.commandPool;
+		allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocateInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(m_device, &allocateInfo, &frame.commandBuffer) != VK_SUCCESS)
+		{
+			return(false);
+		}
+
+		// the uniforms are written by the CPU right before the frame
+		// is submitted, and read once by the GPU
+		VkMemoryPropertyFlags hostMemory = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		if ((CreateDeviceBuffer(sizeof(FRAME_UNIFORMS), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, hostMemory, frame.frameUniforms) == false) ||
+			(CreateDeviceBuffer(m_drawUniformStride * MAX_DRAWS, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, hostMemory, frame.drawUniforms) == false))
+		{
+			std::cout << "Could not create the Vulkan uniform buffers" << std::endl;
+			return(false);
+		}
+
+		VkDescriptorSetAllocateInfo setInfo = {};
+		setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		setInfo.descriptorPool = m_descriptorPool;
+		setInfo.descriptorSetCount = 1;
+		setInfo.pSetLayouts = &m_frameSetLayout;
+		if (vkAllocateDescriptorSets(m_device, &setInfo, &frame.descriptorSet) != VK_SUCCESS)
+		{
+			frame.descriptorSet = VK_NULL_HANDLE;
+			return(false);
+		}
+
+		VkDescriptorBufferInfo bufferInfos[2] = {};
+		bufferInfos[0].buffer = frame.frameUniforms.buffer;
+		bufferInfos[0].offset = 0;
+		bufferInfos[0].range = sizeof(FRAME_UNIFORMS);
+		bufferInfos[1].buffer = frame.drawUniforms.buffer;
+		bufferInfos[1].offset = 0;
+		bufferInfos[1].range = sizeof(DRAW_UNIFORMS);
+
+		VkWriteDescriptorSet writes[2] = {};
+		for (int binding = 0; binding < 2; binding++)
+		{
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = frame.descriptorSet;
+			writes[binding].dstBinding = binding;
+			writes[binding].descriptorCount = 1;
+			writes[binding].pBufferInfo = &bufferInfos[binding];
+		}
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		vkUpdateDescriptorSets(m_device, 2, writes, 0, NULL);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetPipeline()
+ *
+ *  This method is used to get the pipeline for the current
+ *  render state, which is created the first time the state
+ *  is drawn with.
+ ***********************************************************/
+VkPipeline VulkanRenderBackend::GetPipeline()
+{
+	int key = (m_bDepthTest ? 1 : 0) | (m_bDepthWrite ? 2 : 0) | (m_bColorWrite ? 4 : 0) | (m_bBlend ? 8 : 0) | ((int)m_depthFunction * 16);
+	if ((key < 0) || (key >= PIPELINE_COUNT))
+	{
+		return(VK_NULL_HANDLE);
+	}
+	if (VK_NULL_HANDLE != m_pipelines[key])
+	{
+		return(m_pipelines[key]);
+	}
+
+	VkPipelineShaderStageCreateInfo stages[2] = {};
+	stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	stages[0].module = m_vertexShader;
+	stages[0].pName = "main";
+	stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	stages[1].module = m_fragmentShader;
+	stages[1].pName = "main";
+
+	VkVertexInputBindingDescription vertexBinding = {};
+	vertexBinding.binding = 0;
+	vertexBinding.stride = sizeof(ShapeGeometry::VERTEX);
+	vertexBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+	VkVertexInputAttributeDescription attributes[3] = {};
+	attributes[0].location = 0;
+	attributes[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+	attributes[0].offset = offsetof(ShapeGeometry::VERTEX, position);
+	attributes[1].location = 1;
+	attributes[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+	attributes[1].offset = offsetof(ShapeGeometry::VERTEX, normal);
+	attributes[2].location = 2;
+	attributes[2].format = VK_FORMAT_R32G32_SFLOAT;
+	attributes[2].offset = offsetof(ShapeGeometry::VERTEX, textureCoordinate);
+
+	VkPipelineVertexInputStateCreateInfo vertexInput = {};
+	vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertexInput.vertexBindingDescriptionCount = 1;
+	vertexInput.pVertexBindingDescriptions = &vertexBinding;
+	vertexInput.vertexAttributeDescriptionCount = 3;
+	vertexInput.pVertexAttributeDescriptions = attributes;
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+	VkPipelineViewportStateCreateInfo viewportState = {};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+
+	// the scene draws both sides of its triangles
+	VkPipelineRasterizationStateCreateInfo rasterization = {};
+	rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterization.cullMode = VK_CULL_MODE_NONE;
+	rasterization.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	rasterization.lineWidth = 1.0f;
+
+	VkPipelineMultisampleStateCreateInfo multisample = {};
+	multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkCompareOp compareOps[3] = { VK_COMPARE_OP_LESS, VK_COMPARE_OP_LESS_OR_EQUAL, VK_COMPARE_OP_EQUAL };
+	VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depthStencil.depthTestEnable = m_bDepthTest ? VK_TRUE : VK_FALSE;
+	depthStencil.depthWriteEnable = m_bDepthWrite ? VK_TRUE : VK_FALSE;
+	depthStencil.depthCompareOp = compareOps[m_depthFunction];
+
+	// the blending of the transparent meshes matches the OpenGL
+	// blend function, for the alpha as well as the colors
+	VkPipelineColorBlendAttachmentState blendAttachment = {};
+	blendAttachment.blendEnable = m_bBlend ? VK_TRUE : VK_FALSE;
+	blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+	blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+	blendAttachment.colorWriteMask = m_bColorWrite ?
+		(VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT) : 0;
+
+	VkPipelineColorBlendStateCreateInfo colorBlend = {};
+	colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlend.attachmentCount = 1;
+	colorBlend.pAttachments = &blendAttachment;
+
+	// the viewport follows the framebuffer size
+	VkDynamicState dynamicStates[2] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	VkPipelineDynamicStateCreateInfo dynamicState = {};
+	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount = 2;
+	dynamicState.pDynamicStates = dynamicStates;
+
+	VkGraphicsPipelineCreateInfo pipelineInfo = {};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = 2;
+	pipelineInfo.pStages = stages;
+	pipelineInfo.pVertexInputState = &vertexInput;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterization;
+	pipelineInfo.pMultisampleState = &multisample;
+	pipelineInfo.pDepthStencilState = &depthStencil;
+	pipelineInfo.pColorBlendState = &colorBlend;
+	pipelineInfo.pDynamicState = &dynamicState;
+	pipelineInfo.layout = m_pipelineLayout;
+	pipelineInfo.renderPass = m_renderPass;
+	pipelineInfo.subpass = 0;
+	if (vkCreateGraphicsPipelines(m_device, m_pipelineCache, 1, &pipelineInfo, NULL, &m_pipelines[key]) != VK_SUCCESS)
+	{
+		std::cout << "Could not create the Vulkan pipeline for state:" << key << std::endl;
+		m_pipelines[key] = VK_NULL_HANDLE;
+	}
+
+	return(m_pipelines[key]);
+}
+
+/***********************************************************
+ *  AllocateMemory()
+ *
+ *  This method is used to allocate device memory of a type
+ *  that the requirements allow and that has the properties.
+ ***********************************************************/
+bool VulkanRenderBackend::AllocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, VkDeviceMemory& memory)
+{
+	for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++)
+	{
+		if (((requirements.memoryTypeBits & (1u << i)) != 0) &&
+			((m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties))
+		{
+			VkMemoryAllocateInfo allocateInfo = {};
+			allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocateInfo.allocationSize = requirements.size;
+			allocateInfo.memoryTypeIndex = i;
+			if (vkAllocateMemory(m_device, &allocateInfo, NULL, &memory) == VK_SUCCESS)
+			{
+				return(true);
+			}
+		}
+	}
+
+	memory = VK_NULL_HANDLE;
+
+	return(false);
+}
+
+/***********************************************************
+ *  CreateDeviceBuffer()
+ *
+ *  This method is used to create a buffer in memory with the
+ *  properties, which stays mapped when it is host visible.
+ ***********************************************************/
+bool VulkanRenderBackend::CreateDeviceBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, BUFFER& buffer)
+{
+	buffer.buffer = VK_NULL_HANDLE;
+	buffer.memory = VK_NULL_HANDLE;
+	buffer.pMapped = NULL;
+
+	VkBufferCreateInfo bufferInfo = {};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = size;
+	bufferInfo.usage = usage;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	if (vkCreateBuffer(m_device, &bufferInfo, NULL, &buffer.buffer) != VK_SUCCESS)
+	{
+		buffer.buffer = VK_NULL_HANDLE;
+		return(false);
+	}
+
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(m_device, buffer.buffer, &requirements);
+	if ((AllocateMemory(requirements, properties, buffer.memory) == false) ||
+		(vkBindBufferMemory(m_device, buffer.buffer, buffer.memory, 0) != VK_SUCCESS))
+	{
+		DestroyDeviceBuffer(buffer);
+		return(false);
+	}
+
+	if (((properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) &&
+		(vkMapMemory(m_device, buffer.memory, 0, VK_WHOLE_SIZE, 0, &buffer.pMapped) != VK_SUCCESS))
+	{
+		DestroyDeviceBuffer(buffer);
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyDeviceBuffer()
+ *
+ *  This method is used to free a buffer and its memory.
+ ***********************************************************/
+void VulkanRenderBackend::DestroyDeviceBuffer(BUFFER& buffer)
+{
+	if (VK_NULL_HANDLE != buffer.buffer)
+	{
+		vkDestroyBuffer(m_device, buffer.buffer, NULL);
+		buffer.buffer = VK_NULL_HANDLE;
+	}
+	// freeing the memory also unmaps it
+	if (VK_NULL_HANDLE != buffer.memory)
+	{
+		vkFreeMemory(m_device, buffer.memory, NULL);
+		buffer.memory = VK_NULL_HANDLE;
+	}
+	buffer.pMapped = NULL;
+}
+
+/***********************************************************
+ *  CreateDeviceImage()
+ *
+ *  This method is used to create a 2D image in device local
+ *  memory, with a view of all of its mip levels.
+ ***********************************************************/
+bool VulkanRenderBackend::CreateDeviceImage(int width, int height, uint32_t mipCount, VkFormat format, VkImageUsageFlags usage, VkImageAspectFlags aspect, IMAGE& image)
+{
+	image.image = VK_NULL_HANDLE;
+	image.memory = VK_NULL_HANDLE;
+	image.view = VK_NULL_HANDLE;
+
+	VkImageCreateInfo imageInfo = {};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = format;
+	imageInfo.extent.width = (uint32_t)width;
+	imageInfo.extent.height = (uint32_t)height;
+	imageInfo.extent.depth = 1;
+	imageInfo.mipLevels = mipCount;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = usage;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	if (vkCreateImage(m_device, &imageInfo, NULL, &image.image) != VK_SUCCESS)
+	{
+		image.image = VK_NULL_HANDLE;
+		return(false);
+	}
+
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(m_device, image.image, &requirements);
+	if ((AllocateMemory(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image.memory) == false) ||
+		(vkBindImageMemory(m_device, image.image, image.memory, 0) != VK_SUCCESS))
+	{
+		DestroyDeviceImage(image);
+		return(false);
+	}
+
+	VkImageViewCreateInfo viewInfo = {};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = image.image;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = format;
+	viewInfo.subresourceRange.aspectMask = aspect;
+	viewInfo.subresourceRange.baseMipLevel = 0;
+	viewInfo.subresourceRange.levelCount = mipCount;
+	viewInfo.subresourceRange.baseArrayLayer = 0;
+	viewInfo.subresourceRange.layerCount = 1;
+	if (vkCreateImageView(m_device, &viewInfo, NULL, &image.view) != VK_SUCCESS)
+	{
+		image.view = VK_NULL_HANDLE;
+		DestroyDeviceImage(image);
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyDeviceImage()
+ *
+ *  This method is used to free an image, its view and its
+ *  memory.
+ ***********************************************************/
+void VulkanRenderBackend::DestroyDeviceImage(IMAGE& image)
+{
+	if (VK_NULL_HANDLE != image.view)
+	{
+		vkDestroyImageView(m_device, image.view, NULL);
+		image.view = VK_NULL_HANDLE;
+	}
+	if (VK_NULL_HANDLE != image.image)
+	{
+		vkDestroyImage(m_device, image.image, NULL);
+		image.image = VK_NULL_HANDLE;
+	}
+	if (VK_NULL_HANDLE != image.memory)
+	{
+		vkFreeMemory(m_device, image.memory, NULL);
+		image.memory = VK_NULL_HANDLE;
+	}
+}
+
+/***********************************************************
+ *  BeginUpload()
+ *
+ *  This method is used to start a command buffer that copies
+ *  data to the device.
+ ***********************************************************/
+VkCommandBuffer VulkanRenderBackend::BeginUpload()
+{
+	VkCommandBufferAllocateInfo allocateInfo = {};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocateInfo.commandPool = m_uploadPool;
+	allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocateInfo.commandBufferCount = 1;
+
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	if (vkAllocateCommandBuffers(m_device, &allocateInfo, &commandBuffer) != VK_SUCCESS)
+	{
+		return(VK_NULL_HANDLE);
+	}
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+	return(commandBuffer);
+}
+
+/***********************************************************
+ *  EndUpload()
+ *
+ *  This method is used to submit the copies of an upload
+ *  command buffer and to wait for them, which only happens
+ *  while the scene is loaded.
+ ***********************************************************/
+void VulkanRenderBackend::EndUpload(VkCommandBuffer commandBuffer)
+{
+	vkEndCommandBuffer(commandBuffer);
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	vkQueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE);
+	vkQueueWaitIdle(m_queue);
+
+	vkFreeCommandBuffers(m_device, m_uploadPool, 1, &commandBuffer);
+}
+
+/***********************************************************
+ *  UploadBuffer()
+ *
+ *  This method is used to create a device local buffer and
+ *  to copy data into it through a staging buffer.
+ ***********************************************************/
+bool VulkanRenderBackend::UploadBuffer(const void* pData, VkDeviceSize size, VkBufferUsageFlags usage, BUFFER& buffer)
+{
+	BUFFER staging;
+	if (CreateDeviceBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, staging) == false)
+	{
+		return(false);
+	}
+	memcpy(staging.pMapped, pData, (size_t)size);
+
+	bool bSuccess = CreateDeviceBuffer(size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer);
+	VkCommandBuffer commandBuffer = bSuccess ? BeginUpload() : VK_NULL_HANDLE;
+	if (VK_NULL_HANDLE != commandBuffer)
+	{
+		VkBufferCopy region = {};
+		region.size = size;
+		vkCmdCopyBuffer(commandBuffer, staging.buffer, buffer.buffer, 1, &region);
+		EndUpload(commandBuffer);
+	}
+	else
+	{
+		bSuccess = false;
+	}
+
+	DestroyDeviceBuffer(staging);
+
+	return(bSuccess);
+}
+
+/***********************************************************
+ *  UploadTexture()
+ *
+ *  This method is used to create the image of a texture, to
+ *  copy its pixels into it, to blit them down into the
+ *  smaller mip levels, and to create the descriptor set it
+ *  is bound to the draws with.
+ ***********************************************************/
+bool VulkanRenderBackend::UploadTexture(const unsigned char* pPixels, int width, int height, uint32_t mipCount, TEXTURE& texture)
+{
+	VkDeviceSize size = (VkDeviceSize)width * height * 4;
+	BUFFER staging;
+	if (CreateDeviceBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, staging) == false)
+	{
+		return(false);
+	}
+	memcpy(staging.pMapped, pPixels, (size_t)size);
+
+	bool bSuccess = CreateDeviceImage(
+		width, height, mipCount, g_ColorFormat,
+		VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT,
+		texture.image);
+	VkCommandBuffer commandBuffer = bSuccess ? BeginUpload() : VK_NULL_HANDLE;
+	if (VK_NULL_HANDLE != commandBuffer)
+	{
+		VkImage image = texture.image.image;
+		TransitionImage(commandBuffer, image, 0, mipCount,
+			VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			0, VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+		VkBufferImageCopy region = {};
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.layerCount = 1;
+		region.imageExtent.width = (uint32_t)width;
+		region.imageExtent.height = (uint32_t)height;
+		region.imageExtent.depth = 1;
+		vkCmdCopyBufferToImage(commandBuffer, staging.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		// every level is filtered down from the one above it, which
+		// is then ready to be sampled
+		int levelWidth = width;
+		int levelHeight = height;
+		for (uint32_t level = 1; level < mipCount; level++)
+		{
+			TransitionImage(commandBuffer, image, level - 1, 1,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+			int nextWidth = (levelWidth > 1) ? (levelWidth / 2) : 1;
+			int nextHeight = (levelHeight > 1) ? (levelHeight / 2) : 1;
+			VkImageBlit blit = {};
+			blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			blit.srcSubresource.mipLevel = level - 1;
+			blit.srcSubresource.layerCount = 1;
+			blit.srcOffsets[1].x = levelWidth;
+			blit.srcOffsets[1].y = levelHeight;
+			blit.srcOffsets[1].z = 1;
+			blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			blit.dstSubresource.mipLevel = level;
+			blit.dstSubresource.layerCount = 1;
+			blit.dstOffsets[1].x = nextWidth;
+			blit.dstOffsets[1].y = nextHeight;
+			blit.dstOffsets[1].z = 1;
+			vkCmdBlitImage(commandBuffer,
+				image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				1, &blit, VK_FILTER_LINEAR);
+
+			TransitionImage(commandBuffer, image, level - 1, 1,
+				VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+			levelWidth = nextWidth;
+			levelHeight = nextHeight;
+		}
+
+		TransitionImage(commandBuffer, image, mipCount - 1, 1,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+		EndUpload(commandBuffer);
+	}
+	else
+	{
+		bSuccess = false;
+	}
+
+	DestroyDeviceBuffer(staging);
+
+	if (bSuccess == true)
+	{
+		VkDescriptorSetAllocateInfo setInfo = {};
+		setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		setInfo.descriptorPool = m_descriptorPool;
+		setInfo.descriptorSetCount = 1;
+		setInfo.pSetLayouts = &m_textureSetLayout;
+		if (vkAllocateDescriptorSets(m_device, &setInfo, &texture.descriptorSet) != VK_SUCCESS)
+		{
+			std::cout << "Could not allocate a Vulkan texture descriptor set" << std::endl;
+			texture.descriptorSet = VK_NULL_HANDLE;
+			return(false);
+		}
+
+		VkDescriptorImageInfo imageInfo = {};
+		imageInfo.sampler = m_sampler;
+		imageInfo.imageView = texture.image.view;
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkWriteDescriptorSet write = {};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = texture.descriptorSet;
+		write.dstBinding = 0;
+		write.descriptorCount = 1;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		write.pImageInfo = &imageInfo;
+		vkUpdateDescriptorSets(m_device, 1, &write, 0, NULL);
+	}
+
+	return(bSuccess);
+}
+
+/***********************************************************
+ *  FreeTexture()
+ *
+ *  This method is used to free the image and descriptor set
+ *  of a texture that no frame in flight uses anymore.
+ ***********************************************************/
+void VulkanRenderBackend::FreeTexture(TEXTURE* pTexture)
+{
+	if (NULL == pTexture)
+	{
+		return;
+	}
+
+	if (VK_NULL_HANDLE != pTexture->descriptorSet)
+	{
+		vkFreeDescriptorSets(m_device, m_descriptorPool, 1, &pTexture->descriptorSet);
+	}
+	DestroyDeviceImage(pTexture->image);
+	delete pTexture;
+}
+
+/***********************************************************
+ *  ResizeFrame()
+ *
+ *  This method is used to create the images that a frame is
+ *  drawn into, its framebuffer and its readback buffer for
+ *  the framebuffer size.  The frame must be finished.
+ ***********************************************************/
+bool VulkanRenderBackend::ResizeFrame(FRAME& frame)
+{
+	DestroyFrameTargets(frame);
+	if ((m_width <= 0) || (m_height <= 0))
+	{
+		return(true);
+	}
+
+	bool bSuccess = CreateDeviceImage(
+		m_width, m_height, 1, g_ColorFormat,
+		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT,
+		frame.color);
+	bSuccess = bSuccess && CreateDeviceImage(
+		m_width, m_height, 1, g_DepthFormat,
+		VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+		VK_IMAGE_ASPECT_DEPTH_BIT,
+		frame.depth);
+
+	if (bSuccess == true)
+	{
+		VkImageView attachments[2] = { frame.color.view, frame.depth.view };
+		VkFramebufferCreateInfo framebufferInfo = {};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = m_renderPass;
+		framebufferInfo.attachmentCount = 2;
+		framebufferInfo.pAttachments = attachments;
+		framebufferInfo.width = (uint32_t)m_width;
+		framebufferInfo.height = (uint32_t)m_height;
+		framebufferInfo.layers = 1;
+		if (vkCreateFramebuffer(m_device, &framebufferInfo, NULL, &frame.framebuffer) != VK_SUCCESS)
+		{
+			frame.framebuffer = VK_NULL_HANDLE;
+			bSuccess = false;
+		}
+	}
+
+	// the frame is read back on the CPU, from cached memory when
+	// the device has it
+	VkDeviceSize readbackSize = (VkDeviceSize)m_width * m_height * 4;
+	VkMemoryPropertyFlags hostMemory = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	if ((bSuccess == true) &&
+		(CreateDeviceBuffer(readbackSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, hostMemory | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, frame.readback) == false))
+	{
+		bSuccess = CreateDeviceBuffer(readbackSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, hostMemory, frame.readback);
+	}
+
+	if (bSuccess == false)
+	{
+		std::cout << "Could not create the Vulkan images of size:" << m_width << "x" << m_height << std::endl;
+		DestroyFrameTargets(frame);
+		return(false);
+	}
+
+	frame.width = m_width;
+	frame.height = m_height;
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyFrameTargets()
+ *
+ *  This method is used to free the images, the framebuffer
+ *  and the readback buffer of a frame.
+ ***********************************************************/
+void VulkanRenderBackend::DestroyFrameTargets(FRAME& frame)
+{
+	if (VK_NULL_HANDLE != frame.framebuffer)
+	{
+		vkDestroyFramebuffer(m_device, frame.framebuffer, NULL);
+		frame.framebuffer = VK_NULL_HANDLE;
+	}
+	DestroyDeviceImage(frame.color);
+	DestroyDeviceImage(frame.depth);
+	DestroyDeviceBuffer(frame.readback);
+	frame.width = 0;
+	frame.height = 0;
+}
+
+/***********************************************************
+ *  DestroyFrame()
+ *
+ *  This method is used to free everything that a frame in
+ *  flight owns, once the device is idle.
+ ***********************************************************/
+void VulkanRenderBackend::DestroyFrame(FRAME& frame)
+{
+	DestroyFrameTargets(frame);
+
+	for (size_t i = 0; i < frame.destroyedTextures.size(); i++)
+	{
+		FreeTexture(frame.destroyedTextures[i]);
+	}
+	frame.destroyedTextures.clear();
+
+	// the command buffers are freed with their pools
+	for (size_t i = 0; i < frame.groupPools.size(); i++)
+	{
+		vkDestroyCommandPool(m_device, frame.groupPools[i], NULL);
+	}
+	frame.groupPools.clear();
+	frame.groupBuffers.clear();
+	if (VK_NULL_HANDLE != frame.commandPool)
+	{
+		vkDestroyCommandPool(m_device, frame.commandPool, NULL);
+		frame.commandPool = VK_NULL_HANDLE;
+		frame.commandBuffer = VK_NULL_HANDLE;
+	}
+
+	DestroyDeviceBuffer(frame.frameUniforms);
+	DestroyDeviceBuffer(frame.drawUniforms);
+	if (VK_NULL_HANDLE != frame.fence)
+	{
+		vkDestroyFence(m_device, frame.fence, NULL);
+		frame.fence = VK_NULL_HANDLE;
+	}
+	frame.bSubmitted = false;
+}
+
+/***********************************************************
+ *  WaitForFrame()
+ *
+ *  This method is used to wait for the fence of a frame, so
+ *  its command buffers, uniforms and images can be used for
+ *  the next frame, and to free the textures it was the last
+ *  frame to use.
+ ***********************************************************/
+void VulkanRenderBackend::WaitForFrame(FRAME& frame)
+{
+	if (frame.bSubmitted == false)
+	{
+		return;
+	}
+
+	vkWaitForFences(m_device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+	vkResetFences(m_device, 1, &frame.fence);
+	frame.bSubmitted = false;
+
+	for (size_t i = 0; i < frame.destroyedTextures.size(); i++)
+	{
+		FreeTexture(frame.destroyedTextures[i]);
+	}
+	frame.destroyedTextures.clear();
+}
+
+/***********************************************************
+ *  SetThreadCount()
+ *
+ *  This method is used to set the number of threads that
+ *  record the draws, including the render thread.  The
+ *  workers are started again on the next frame.
+ ***********************************************************/
+void VulkanRenderBackend::SetThreadCount(int threadCount)
+{
+	threadCount = (threadCount < g_MaxThreads) ? threadCount : g_MaxThreads;
+	threadCount = (threadCount > 1) ? threadCount : 1;
+	if (threadCount != m_threadCount)
+	{
+		StopWorkers();
+		m_threadCount = threadCount;
+	}
+}
+
+/***********************************************************
+ *  SetPresentLatency()
+ *
+ *  This method is used to set how many frames the shown
+ *  frame is behind the last frame drawn.  With 0, every
+ *  frame is waited for before it is shown, which the batch
+ *  renderer needs to capture the frame it just drew.
+ ***********************************************************/
+void VulkanRenderBackend::SetPresentLatency(int frames)
+{
+	frames = (frames < FRAMES_IN_FLIGHT - 1) ? frames : (FRAMES_IN_FLIGHT - 1);
+	m_presentLatency = (frames > 0) ? frames : 0;
+}
+
+/***********************************************************
+ *  SetFramebufferSize()
+ *
+ *  This method is used to set the size of the frames, whose
+ *  images are created again when they are next drawn.
+ ***********************************************************/
+void VulkanRenderBackend::SetFramebufferSize(int width, int height)
+{
+	m_width = (width > 0) ? width : 0;
+	m_height = (height > 0) ? height : 0;
+}
+
+/***********************************************************
+ *  Present()
+ *
+ *  This method is used to copy a finished frame into the
+ *  bound draw framebuffer, stretched over the given size.
+ *  The frame that is the present latency behind the last one
+ *  is waited for, so the GPU can keep drawing the frames
+ *  after it, and its pixels are uploaded into a texture that
+ *  is blitted through a framebuffer of its own.
+ ***********************************************************/
+void VulkanRenderBackend::Present(int width, int height)
+{
+	if (m_submittedFrames == 0)
+	{
+		return;
+	}
+
+	uint64_t latency = (uint64_t)m_presentLatency;
+	latency = (latency < m_submittedFrames) ? latency : (m_submittedFrames - 1);
+	uint64_t frameNumber = m_submittedFrames - latency;
+	FRAME& frame = m_frames[(frameNumber - 1) % FRAMES_IN_FLIGHT];
+	if ((frame.width <= 0) || (frame.height <= 0))
+	{
+		return;
+	}
+
+	GLint readFramebuffer = 0;
+	GLint boundTexture = 0;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+
+	if (0 == m_presentTexture)
+	{
+		glGenTextures(1, &m_presentTexture);
+		glGenFramebuffers(1, &m_presentFramebuffer);
+	}
+
+	glBindTexture(GL_TEXTURE_2D, m_presentTexture);
+	if ((m_presentWidth != frame.width) || (m_presentHeight != frame.height))
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, frame.width, frame.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_presentFramebuffer);
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_presentTexture, 0);
+		m_presentWidth = frame.width;
+		m_presentHeight = frame.height;
+		m_presentedFrame = 0;
+	}
+
+	// the pixels are only uploaded once for every frame, and the
+	// fence is left signaled for the next frame drawn with them
+	if (frameNumber != m_presentedFrame)
+	{
+		PROFILE_CPU_SCOPE("VulkanReadback");
+		if (frame.bSubmitted == true)
+		{
+			double startTime = FramePacer::GetTime();
+			vkWaitForFences(m_device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+			m_waitTimeTotal += FramePacer::GetTime() - startTime;
+		}
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, frame.width, frame.height, GL_RGBA, GL_UNSIGNED_BYTE, frame.readback.pMapped);
+		m_presentedFrame = frameNumber;
+	}
+	glBindTexture(GL_TEXTURE_2D, boundTexture);
+
+	// the rows of the image start at the bottom of the view, like
+	// the rows of an OpenGL framebuffer
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_presentFramebuffer);
+	glBlitFramebuffer(
+		0, 0, frame.width, frame.height,
+		0, 0, width, height,
+		GL_COLOR_BUFFER_BIT,
+		((width == frame.width) && (height == frame.height)) ? GL_NEAREST : GL_LINEAR);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the average draws, the time
+ *  spent recording them and the time spent waiting for the
+ *  GPU per frame.
+ ***********************************************************/
+void VulkanRenderBackend::WriteReport(std::ostream& stream)
+{
+	stream << "# frames drawn by the Vulkan backend" << std::endl;
+	stream << "frames: " << m_frameCount << std::endl;
+	stream << "threads: " << m_threadCount << std::endl;
+	stream << "frames_in_flight: " << FRAMES_IN_FLIGHT << std::endl;
+	stream << "present_latency: " << m_presentLatency << std::endl;
+	if (m_frameCount == 0)
+	{
+		return;
+	}
+
+	stream << "draws: " << (double)m_drawTotal / (double)m_frameCount << std::endl;
+	stream << "record_ms: " << m_recordTimeTotal * 1000.0 / (double)m_frameCount << std::endl;
+	stream << "fence_wait_ms: " << m_waitTimeTotal * 1000.0 / (double)m_frameCount << std::endl;
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used to write the report into a file.
+ ***********************************************************/
+bool VulkanRenderBackend::WriteReport(const char* filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not create Vulkan backend report file:" << filename << std::endl;
+		return(false);
+	}
+
+	WriteReport(file);
+	if (!file)
+	{
+		std::cout << "Could not write Vulkan backend report file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully wrote Vulkan backend report file:" << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetName()
+ *
+ *  This method is used to get the name of the backend.
+ ***********************************************************/
+const char* VulkanRenderBackend::GetName() const
+{
+	return("vulkan");
+}
+
+/***********************************************************
+ *  SupportsOpenGLPasses()
+ *
+ *  This method is used to check whether the OpenGL passes
+ *  can run, which they cannot since nothing is drawn with
+ *  OpenGL until the frame is presented.
+ ***********************************************************/
+bool VulkanRenderBackend::SupportsOpenGLPasses() const
+{
+	return(false);
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used to create a buffer, which the shapes
+ *  of the Vulkan backend do not need, since they are built
+ *  into buffers of its own.
+ ***********************************************************/
+uint32_t VulkanRenderBackend::CreateBuffer(BUFFER_TYPE type, const void* pData, size_t size)
+{
+	return(0);
+}
+
+/***********************************************************
+ *  UpdateBuffer()
+ *
+ *  This method is used to update a buffer.
+ ***********************************************************/
+void VulkanRenderBackend::UpdateBuffer(uint32_t buffer, size_t offset, const void* pData, size_t size)
+{
+}
+
+/***********************************************************
+ *  DestroyBuffer()
+ *
+ *  This method is used to free a buffer.
+ ***********************************************************/
+void VulkanRenderBackend::DestroyBuffer(uint32_t buffer)
+{
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used to upload RGBA pixels into a texture,
+ *  with a full chain of mip levels when they are requested.
+ ***********************************************************/
+uint32_t VulkanRenderBackend::CreateTexture(int width, int height, const unsigned char* pPixels, bool bGenerateMips)
+{
+	if ((VK_NULL_HANDLE == m_device) || (NULL == pPixels) || (width <= 0) || (height <= 0))
+	{
+		return(0);
+	}
+
+	uint32_t mipCount = 1;
+	if (bGenerateMips == true)
+	{
+		int size = std::max(width, height);
+		while (size > 1)
+		{
+			size /= 2;
+			mipCount++;
+		}
+	}
+
+	TEXTURE* pTexture = new TEXTURE();
+	pTexture->image.image = VK_NULL_HANDLE;
+	pTexture->image.memory = VK_NULL_HANDLE;
+	pTexture->image.view = VK_NULL_HANDLE;
+	pTexture->descriptorSet = VK_NULL_HANDLE;
+	if (UploadTexture(pPixels, width, height, mipCount, *pTexture) == false)
+	{
+		std::cout << "Could not create a Vulkan texture of size:" << width << "x" << height << std::endl;
+		FreeTexture(pTexture);
+		return(0);
+	}
+
+	m_textures.push_back(pTexture);
+
+	return((uint32_t)m_textures.size());
+}
+
+/***********************************************************
+ *  DestroyTexture()
+ *
+ *  This method is used to free a texture.  The frames in
+ *  flight and the draws of this frame may still use it, so
+ *  it is freed once this frame is finished.
+ ***********************************************************/
+void VulkanRenderBackend::DestroyTexture(uint32_t texture)
+{
+	if ((texture == 0) || (texture > m_textures.size()) || (NULL == m_textures[texture - 1]))
+	{
+		return;
+	}
+
+	m_destroyedTextures.push_back(m_textures[texture - 1]);
+	m_textures[texture - 1] = NULL;
+	for (size_t i = 0; i < m_boundTextures.size(); i++)
+	{
+		if (m_boundTextures[i] == texture)
+		{
+			m_boundTextures[i] = 0;
+		}
+	}
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used to bind a texture to a texture unit.
+ ***********************************************************/
+void VulkanRenderBackend::BindTexture(int unit, uint32_t texture)
+{
+	if (unit < 0)
+	{
+		return;
+	}
+
+	if (unit >= (int)m_boundTextures.size())
+	{
+		m_boundTextures.resize(unit + 1, 0);
+	}
+	m_boundTextures[unit] = texture;
+}
+
+/***********************************************************
+ *  CreateProgram()
+ *
+ *  This method is used to load a shader program, which the
+ *  Vulkan backend does not need, since it draws with the
+ *  SPIR-V shaders it was initialized with.
+ ***********************************************************/
+uint32_t VulkanRenderBackend::CreateProgram(const char* vertexShaderPath, const char* fragmentShaderPath)
+{
+	return(0);
+}
+
+/***********************************************************
+ *  DestroyProgram()
+ *
+ *  This method is used to free a shader program.
+ ***********************************************************/
+void VulkanRenderBackend::DestroyProgram(uint32_t program)
+{
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used to select a shader program.
+ ***********************************************************/
+void VulkanRenderBackend::UseProgram(uint32_t program)
+{
+}
+
+/***********************************************************
+ *  SetIntValue()
+ *
+ *  This method is used to set an integer or boolean uniform.
+ ***********************************************************/
+void VulkanRenderBackend::SetIntValue(const char* name, int value)
+{
+	if (strcmp(name, g_UseTextureName) == 0)
+	{
+		m_uniforms.options[0] = (value != 0) ? 1 : 0;
+	}
+	else if (strcmp(name, g_TextureValueName) == 0)
+	{
+		m_textureUnit = value;
+	}
+	else if (strcmp(name, g_UseLightingName) == 0)
+	{
+		m_uniforms.options[1] = (value != 0) ? 1 : 0;
+	}
+}
+
+/***********************************************************
+ *  SetFloatValue()
+ *
+ *  This method is used to set a float uniform.
+ ***********************************************************/
+void VulkanRenderBackend::SetFloatValue(const char* name, float value)
+{
+	if (SetLightValue(name, &value, 1) == true)
+	{
+		return;
+	}
+
+	if (strcmp(name, "material.ambientStrength") == 0)
+	{
+		m_uniforms.ambientColor.w = value;
+	}
+	else if (strcmp(name, "material.shininess") == 0)
+	{
+		m_uniforms.specularColor.w = value;
+	}
+}
+
+/***********************************************************
+ *  SetVec2Value()
+ *
+ *  This method is used to set a vec2 uniform.
+ ***********************************************************/
+void VulkanRenderBackend::SetVec2Value(const char* name, const glm::vec2& value)
+{
+	if (strcmp(name, g_UVScaleName) == 0)
+	{
+		m_uniforms.uvTransform.x = value.x;
+		m_uniforms.uvTransform.y = value.y;
+	}
+	else if (strcmp(name, g_UVOffsetName) == 0)
+	{
+		m_uniforms.uvTransform.z = value.x;
+		m_uniforms.uvTransform.w = value.y;
+	}
+}
+
+/***********************************************************
+ *  SetVec3Value()
+ *
+ *  This method is used to set a vec3 uniform.
+ ***********************************************************/
+void VulkanRenderBackend::SetVec3Value(const char* name, const glm::vec3& value)
+{
+	if (SetLightValue(name, &value[0], 3) == true)
+	{
+		return;
+	}
+
+	if (strcmp(name, g_ViewPositionName) == 0)
+	{
+		m_frameUniforms.viewPosition = glm::vec4(value, 1.0f);
+	}
+	else if (strcmp(name, "material.ambientColor") == 0)
+	{
+		m_uniforms.ambientColor = glm::vec4(value, m_uniforms.ambientColor.w);
+	}
+	else if (strcmp(name, "material.diffuseColor") == 0)
+	{
+		m_uniforms.diffuseColor = glm::vec4(value, m_uniforms.diffuseColor.w);
+	}
+	else if (strcmp(name, "material.specularColor") == 0)
+	{
+		m_uniforms.specularColor = glm::vec4(value, m_uniforms.specularColor.w);
+	}
+}
+
+/***********************************************************
+ *  SetVec4Value()
+ *
+ *  This method is used to set a vec4 uniform.
+ ***********************************************************/
+void VulkanRenderBackend::SetVec4Value(const char* name, const glm::vec4& value)
+{
+	if (strcmp(name, g_ColorValueName) == 0)
+	{
+		m_uniforms.color = value;
+	}
+}
+
+/***********************************************************
+ *  SetMat4Value()
+ *
+ *  This method is used to set a mat4 uniform.
+ ***********************************************************/
+void VulkanRenderBackend::SetMat4Value(const char* name, const glm::mat4& value)
+{
+	if (strcmp(name, g_ModelName) == 0)
+	{
+		m_uniforms.model = value;
+	}
+	else if (strcmp(name, g_ViewName) == 0)
+	{
+		m_view = value;
+	}
+	else if (strcmp(name, g_ProjectionName) == 0)
+	{
+		m_projection = value;
+	}
+}
+
+/***********************************************************
+ *  SetLightValue()
+ *
+ *  This method is used to set a member of one of the
+ *  lightSources uniforms, and returns whether the name was
+ *  a light uniform.
+ ***********************************************************/
+bool VulkanRenderBackend::SetLightValue(const char* name, const float* pValues, int valueCount)
+{
+	size_t prefixLength = strlen(g_LightArrayName);
+	if (strncmp(name, g_LightArrayName, prefixLength) != 0)
+	{
+		return(false);
+	}
+
+	// the names look like lightSources[0].position
+	int index = name[prefixLength] - '0';
+	if ((index < 0) || (index >= LIGHT_COUNT) ||
+		(name[prefixLength + 1] != ']') || (name[prefixLength + 2] != '.'))
+	{
+		return(true);
+	}
+
+	LIGHT_UNIFORMS& light = m_frameUniforms.lights[index];
+	const char* member = name + prefixLength + 3;
+	if (valueCount == 3)
+	{
+		glm::vec3 value(pValues[0], pValues[1], pValues[2]);
+		if (strcmp(member, "position") == 0)
+		{
+			light.positionRadius = glm::vec4(value, light.positionRadius.w);
+		}
+		else if (strcmp(member, "ambientColor") == 0)
+		{
+			light.ambientColor = glm::vec4(value, light.ambientColor.w);
+		}
+		else if (strcmp(member, "diffuseColor") == 0)
+		{
+			light.diffuseColor = glm::vec4(value, light.diffuseColor.w);
+		}
+		else if (strcmp(member, "specularColor") == 0)
+		{
+			light.specularColor = glm::vec4(value, light.specularColor.w);
+		}
+	}
+	else if (valueCount == 1)
+	{
+		if (strcmp(member, "radius") == 0)
+		{
+			light.positionRadius.w = pValues[0];
+		}
+		else if (strcmp(member, "focalStrength") == 0)
+		{
+			light.ambientColor.w = pValues[0];
+		}
+		else if (strcmp(member, "specularIntensity") == 0)
+		{
+			light.diffuseColor.w = pValues[0];
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetState()
+ *
+ *  This method is used to turn a render state on or off.
+ ***********************************************************/
+void VulkanRenderBackend::SetState(RENDER_STATE state, bool bEnabled)
+{
+	switch (state)
+	{
+	case STATE_DEPTH_TEST:
+		m_bDepthTest = bEnabled;
+		break;
+	case STATE_DEPTH_WRITE:
+		m_bDepthWrite = bEnabled;
+		break;
+	case STATE_COLOR_WRITE:
+		m_bColorWrite = bEnabled;
+		break;
+	case STATE_BLEND:
+		m_bBlend = bEnabled;
+		break;
+	default:
+		break;
+	}
+}
+
+/***********************************************************
+ *  SetDepthFunction()
+ *
+ *  This method is used to set the comparison of the depth
+ *  test.
+ ***********************************************************/
+void VulkanRenderBackend::SetDepthFunction(DEPTH_FUNCTION function)
+{
+	m_depthFunction = function;
+}
+
+/***********************************************************
+ *  DrawShape()
+ *
+ *  This method is used to collect a draw of a shape with the
+ *  current uniforms, the pipeline of the render state and
+ *  the bound texture, to be recorded at the end of the frame.
+ ***********************************************************/
+void VulkanRenderBackend::DrawShape(SHAPE_MESH shape)
+{
+	if ((VK_NULL_HANDLE == m_device) || (m_width <= 0) || (m_height <= 0) ||
+		(shape < 0) || (shape >= SHAPE_COUNT) || (m_draws.size() >= (size_t)MAX_DRAWS))
+	{
+		return;
+	}
+
+	DRAW draw;
+	draw.pipeline = GetPipeline();
+	if (VK_NULL_HANDLE == draw.pipeline)
+	{
+		return;
+	}
+
+	draw.uniforms = m_uniforms;
+	draw.uniforms.viewProjection = m_projection * m_view;
+	draw.textureSet = m_pWhiteTexture->descriptorSet;
+	draw.shape = shape;
+
+	// the draws whose texture is missing use their color instead
+	draw.uniforms.options[0] = 0;
+	if ((m_uniforms.options[0] != 0) && (m_textureUnit >= 0) && (m_textureUnit < (int)m_boundTextures.size()))
+	{
+		uint32_t texture = m_boundTextures[m_textureUnit];
+		if ((texture > 0) && (texture <= m_textures.size()) && (NULL != m_textures[texture - 1]))
+		{
+			draw.textureSet = m_textures[texture - 1]->descriptorSet;
+			draw.uniforms.options[0] = 1;
+		}
+	}
+
+	m_draws.push_back(draw);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used to record the draws of the frame and
+ *  to submit them.  The oldest frame in flight is waited for,
+ *  since its command buffers and buffers are used again.
+ *  The draws are split into groups of consecutive draws,
+ *  which the render thread and the workers record into
+ *  secondary command buffers at the same time, and the
+ *  primary command buffer runs them in order in the render
+ *  pass before it copies the image out for the readback.
+ ***********************************************************/
+void VulkanRenderBackend::EndFrame()
+{
+	PROFILE_CPU_SCOPE("VulkanEndFrame");
+
+	if (VK_NULL_HANDLE == m_device)
+	{
+		m_draws.clear();
+		return;
+	}
+
+	FRAME& frame = m_frames[m_submittedFrames % FRAMES_IN_FLIGHT];
+	{
+		PROFILE_CPU_SCOPE("VulkanWaitForFrame");
+		double waitStartTime = FramePacer::GetTime();
+		WaitForFrame(frame);
+		m_waitTimeTotal += FramePacer::GetTime() - waitStartTime;
+	}
+
+	double startTime = FramePacer::GetTime();
+
+	bool bReady = true;
+	if ((frame.width != m_width) || (frame.height != m_height))
+	{
+		bReady = ResizeFrame(frame);
+	}
+	if ((bReady == false) || (frame.width <= 0) || (frame.height <= 0))
+	{
+		m_draws.clear();
+		return;
+	}
+
+	// the groups are large enough to be worth a thread, and each
+	// group has a command pool of its own in every frame
+	int drawCount = (int)m_draws.size();
+	m_groupCount = (drawCount + g_MinGroupDraws - 1) / g_MinGroupDraws;
+	m_groupCount = (m_groupCount < m_threadCount) ? m_groupCount : m_threadCount;
+	while ((int)frame.groupPools.size() < m_groupCount)
+	{
+		VkCommandPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = m_queueFamily;
+		VkCommandPool commandPool = VK_NULL_HANDLE;
+		if (vkCreateCommandPool(m_device, &poolInfo, NULL, &commandPool) != VK_SUCCESS)
+		{
+			break;
+		}
+
+		VkCommandBufferAllocateInfo allocateInfo = {};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocateInfo.commandPool = commandPool;
+		allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		allocateInfo.commandBufferCount = 1;
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		if (vkAllocateCommandBuffers(m_device, &allocateInfo, &commandBuffer) != VK_SUCCESS)
+		{
+			vkDestroyCommandPool(m_device, commandPool, NULL);
+			break;
+		}
+
+		frame.groupPools.push_back(commandPool);
+		frame.groupBuffers.push_back(commandBuffer);
+	}
+	m_groupCount = (m_groupCount < (int)frame.groupPools.size()) ? m_groupCount : (int)frame.groupPools.size();
+
+	memcpy(frame.frameUniforms.pMapped, &m_frameUniforms, sizeof(FRAME_UNIFORMS));
+
+	if (m_groupCount > 0)
+	{
+		PROFILE_CPU_SCOPE("VulkanRecordDraws");
+
+		if ((int)m_workers.size() != m_threadCount - 1)
+		{
+			StartWorkers();
+		}
+
+		m_pRecordFrame = &frame;
+		m_nextGroup = 0;
+		bool bParallel = (m_workers.empty() == false) && (m_groupCount > 1);
+		if (bParallel == true)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_busyWorkers = (int)m_workers.size();
+				m_generation++;
+			}
+			m_startCondition.notify_all();
+		}
+
+		RecordGroups();
+
+		if (bParallel == true)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_doneCondition.wait(lock, [this]() { return(m_busyWorkers == 0); });
+		}
+		m_pRecordFrame = NULL;
+	}
+
+	vkResetCommandPool(m_device, frame.commandPool, 0);
+	VkCommandBuffer commandBuffer = frame.commandBuffer;
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+	// the frame is cleared like the OpenGL framebuffers of the scene
+	VkClearValue clearValues[2] = {};
+	clearValues[0].color.float32[3] = 1.0f;
+	clearValues[1].depthStencil.depth = 1.0f;
+
+	VkRenderPassBeginInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = m_renderPass;
+	renderPassInfo.framebuffer = frame.framebuffer;
+	renderPassInfo.renderArea.extent.width = (uint32_t)frame.width;
+	renderPassInfo.renderArea.extent.height = (uint32_t)frame.height;
+	renderPassInfo.clearValueCount = 2;
+	renderPassInfo.pClearValues = clearValues;
+	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+	if (m_groupCount > 0)
+	{
+		vkCmdExecuteCommands(commandBuffer, (uint32_t)m_groupCount, frame.groupBuffers.data());
+	}
+	vkCmdEndRenderPass(commandBuffer);
+
+	VkBufferImageCopy region = {};
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount = 1;
+	region.imageExtent.width = (uint32_t)frame.width;
+	region.imageExtent.height = (uint32_t)frame.height;
+	region.imageExtent.depth = 1;
+	vkCmdCopyImageToBuffer(commandBuffer, frame.color.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, frame.readback.buffer, 1, &region);
+
+	VkBufferMemoryBarrier readbackBarrier = {};
+	readbackBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	readbackBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	readbackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	readbackBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	readbackBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	readbackBarrier.buffer = frame.readback.buffer;
+	readbackBarrier.offset = 0;
+	readbackBarrier.size = VK_WHOLE_SIZE;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, NULL, 1, &readbackBarrier, 0, NULL);
+	vkEndCommandBuffer(commandBuffer);
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	if (vkQueueSubmit(m_queue, 1, &submitInfo, frame.fence) == VK_SUCCESS)
+	{
+		frame.bSubmitted = true;
+		m_submittedFrames++;
+	}
+	else
+	{
+		std::cout << "Could not submit the Vulkan frame" << std::endl;
+	}
+
+	// the textures freed during the frame are freed for good once
+	// the frame is finished
+	frame.destroyedTextures.insert(frame.destroyedTextures.end(), m_destroyedTextures.begin(), m_destroyedTextures.end());
+	m_destroyedTextures.clear();
+
+	m_frameCount++;
+	m_drawTotal += m_draws.size();
+	m_recordTimeTotal += FramePacer::GetTime() - startTime;
+	m_draws.clear();
+}
+
+/***********************************************************
+ *  RecordGroups()
+ *
+ *  This method is used to record groups of draws until all
+ *  of the groups of the frame have been taken.
+ ***********************************************************/
+void VulkanRenderBackend::RecordGroups()
+{
+	int group = m_nextGroup.fetch_add(1);
+	while (group < m_groupCount)
+	{
+		RecordGroup(group);
+		group = m_nextGroup.fetch_add(1);
+	}
+}
+
+/***********************************************************
+ *  RecordGroup()
+ *
+ *  This method is used to write the uniforms of a group of
+ *  draws and to record the draws into the secondary command
+ *  buffer of the group, binding only the pipelines and
+ *  textures that change from draw to draw.
+ ***********************************************************/
+void VulkanRenderBackend::RecordGroup(int group)
+{
+	FRAME& frame = *m_pRecordFrame;
+	size_t drawCount = m_draws.size();
+	size_t firstDraw = drawCount * group / m_groupCount;
+	size_t lastDraw = drawCount * (group + 1) / m_groupCount;
+
+	// the pool is only used by the thread that took the group
+	vkResetCommandPool(m_device, frame.groupPools[group], 0);
+	VkCommandBuffer commandBuffer = frame.groupBuffers[group];
+
+	VkCommandBufferInheritanceInfo inheritanceInfo = {};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritanceInfo.renderPass = m_renderPass;
+	inheritanceInfo.subpass = 0;
+	inheritanceInfo.framebuffer = frame.framebuffer;
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	beginInfo.pInheritanceInfo = &inheritanceInfo;
+	vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+	VkViewport viewport = {};
+	viewport.width = (float)frame.width;
+	viewport.height = (float)frame.height;
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+	VkRect2D scissor = {};
+	scissor.extent.width = (uint32_t)frame.width;
+	scissor.extent.height = (uint32_t)frame.height;
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	VkDeviceSize vertexOffset = 0;
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_vertexBuffer.buffer, &vertexOffset);
+	vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+
+	unsigned char* pUniforms = (unsigned char*)frame.drawUniforms.pMapped;
+	VkPipeline pipeline = VK_NULL_HANDLE;
+	VkDescriptorSet textureSet = VK_NULL_HANDLE;
+	for (size_t i = firstDraw; i < lastDraw; i++)
+	{
+		const DRAW& draw = m_draws[i];
+		VkDeviceSize uniformOffset = m_drawUniformStride * i;
+		memcpy(pUniforms + uniformOffset, &draw.uniforms, sizeof(DRAW_UNIFORMS));
+
+		if (draw.pipeline != pipeline)
+		{
+			pipeline = draw.pipeline;
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		}
+
+		uint32_t dynamicOffset = (uint32_t)uniformOffset;
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &frame.descriptorSet, 1, &dynamicOffset);
+		if (draw.textureSet != textureSet)
+		{
+			textureSet = draw.textureSet;
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 1, 1, &textureSet, 0, NULL);
+		}
+
+		const SHAPE& shape = m_shapes[draw.shape];
+		vkCmdDrawIndexed(commandBuffer, shape.indexCount, 1, shape.firstIndex, shape.vertexOffset, 0);
+	}
+
+	vkEndCommandBuffer(commandBuffer);
+}
+
+/***********************************************************
+ *  StartWorkers()
+ *
+ *  This method is used to start the worker threads, which
+ *  wait for the groups of the next frame.
+ ***********************************************************/
+void VulkanRenderBackend::StartWorkers()
+{
+	StopWorkers();
+
+	m_bShutdown = false;
+	for (int i = 1; i < m_threadCount; i++)
+	{
+		m_workers.push_back(std::thread(&VulkanRenderBackend::WorkerLoop, this, m_generation));
+	}
+}
+
+/***********************************************************
+ *  StopWorkers()
+ *
+ *  This method is used to stop the worker threads and to
+ *  wait for them to finish.
+ ***********************************************************/
+void VulkanRenderBackend::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bShutdown = true;
+	}
+	m_startCondition.notify_all();
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is run by every worker thread.  It waits for
+ *  the next frame, records groups of draws until none are
+ *  left, and reports back, until the workers are stopped.
+ ***********************************************************/
+void VulkanRenderBackend::WorkerLoop(uint64_t generation)
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_startCondition.wait(lock, [this, generation]() { return((m_bShutdown == true) || (m_generation != generation)); });
+			if (m_bShutdown == true)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		RecordGroups();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_busyWorkers--;
+		}
+		m_doneCondition.notify_one();
+	}
+}
+
+#endif
@@ -0,0 +1,349 @@
+///////////////////////////////////////////////////////////////////////////////
+// vulkanrenderbackend.h
+// ============
+// draw the scene with Vulkan, recording the draws on a pool of threads
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// the backend is only built when the Vulkan headers are installed,
+// and the Vulkan loader is found when the application runs, so the
+// application still builds and runs without the Vulkan SDK
+#if defined(__has_include)
+#if __has_include(<vulkan/vulkan.h>)
+#define VULKANRENDERBACKEND_AVAILABLE
+#endif
+#endif
+
+#ifdef VULKANRENDERBACKEND_AVAILABLE
+
+#include "RenderBackend.h"
+#include "ShapeGeometry.h"
+
+// the functions are loaded from the Vulkan loader through GLFW
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include <GL/glew.h>
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <ostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+/***********************************************************
+ *  VulkanRenderBackend
+ *
+ *  This class contains a render backend that draws the scene
+ *  with Vulkan into an image of its own.  The draws of a
+ *  frame are collected as they are submitted, and at the end
+ *  of the frame they are split into groups that a pool of
+ *  threads record into secondary command buffers at the same
+ *  time, each from a command pool of its own.  The primary
+ *  command buffer runs the groups in the order of the draws,
+ *  and copies the image into a buffer that the frame is read
+ *  back from.  A few frames are kept in flight, each with its
+ *  own fence, buffers and images, so the CPU records the next
+ *  frame while the GPU draws the last one.  The finished
+ *  frames are copied into the bound OpenGL framebuffer to be
+ *  shown or read back, like the software backend does.
+ ***********************************************************/
+class VulkanRenderBackend : public RenderBackend
+{
+public:
+	// constructor
+	VulkanRenderBackend();
+	// destructor
+	virtual ~VulkanRenderBackend();
+
+	// create the device, and load the compiled SPIR-V shaders
+	bool Initialize(const char* vertexShaderPath, const char* fragmentShaderPath);
+
+	// set the number of threads that record the draws, including
+	// the render thread
+	void SetThreadCount(int threadCount);
+	// set how many frames the shown frame is behind the last one
+	// drawn, where 0 waits for every frame to finish
+	void SetPresentLatency(int frames);
+	// resize the images for the next frames
+	void SetFramebufferSize(int width, int height);
+
+	// copy a finished frame into the bound framebuffer, stretched
+	// over the given size
+	void Present(int width, int height);
+
+	// write the average draws and recording time per frame
+	void WriteReport(std::ostream& stream);
+	bool WriteReport(const char* filename);
+
+	virtual const char* GetName() const;
+	virtual bool SupportsOpenGLPasses() const;
+
+	virtual uint32_t CreateBuffer(BUFFER_TYPE type, const void* pData, size_t size);
+	virtual void UpdateBuffer(uint32_t buffer, size_t offset, const void* pData, size_t size);
+	virtual void DestroyBuffer(uint32_t buffer);
+
+	virtual uint32_t CreateTexture(int width, int height, const unsigned char* pPixels, bool bGenerateMips);
+	virtual void DestroyTexture(uint32_t texture);
+	virtual void BindTexture(int unit, uint32_t texture);
+
+	virtual uint32_t CreateProgram(const char* vertexShaderPath, const char* fragmentShaderPath);
+	virtual void DestroyProgram(uint32_t program);
+	virtual void UseProgram(uint32_t program);
+
+	virtual void SetIntValue(const char* name, int value);
+	virtual void SetFloatValue(const char* name, float value);
+	virtual void SetVec2Value(const char* name, const glm::vec2& value);
+	virtual void SetVec3Value(const char* name, const glm::vec3& value);
+	virtual void SetVec4Value(const char* name, const glm::vec4& value);
+	virtual void SetMat4Value(const char* name, const glm::mat4& value);
+
+	virtual void SetState(RENDER_STATE state, bool bEnabled);
+	virtual void SetDepthFunction(DEPTH_FUNCTION function);
+
+	virtual void DrawShape(SHAPE_MESH shape);
+
+	virtual void EndFrame();
+
+private:
+	// frames that are drawn at the same time
+	static const int FRAMES_IN_FLIGHT = 2;
+	// number of the uniform lights of the fragment shader
+	static const int LIGHT_COUNT = 4;
+	// most draws of a frame, which the uniform buffers are sized for
+	static const int MAX_DRAWS = 8192;
+	// pipelines for every combination of the render states
+	static const int PIPELINE_COUNT = 48;
+
+	// uniforms of a draw, laid out like the std140 block of the
+	// shaders, with the scalars packed into the w components
+	struct DRAW_UNIFORMS
+	{
+		glm::mat4 model;
+		glm::mat4 viewProjection;
+		glm::vec4 color;
+		// the UV scale in xy, and the UV offset in zw
+		glm::vec4 uvTransform;
+		// the ambient strength and the shininess are in the w
+		// components of the ambient and specular colors
+		glm::vec4 ambientColor;
+		glm::vec4 diffuseColor;
+		glm::vec4 specularColor;
+		// whether the draw uses its texture and the lighting
+		int32_t options[4];
+	};
+
+	// the lights, laid out like the clustered lights of the
+	// fragment shader
+	struct LIGHT_UNIFORMS
+	{
+		glm::vec4 positionRadius;
+		// the w components hold the focal strength and specular intensity
+		glm::vec4 ambientColor;
+		glm::vec4 diffuseColor;
+		glm::vec4 specularColor;
+	};
+
+	// uniforms shared by all of the draws of a frame
+	struct FRAME_UNIFORMS
+	{
+		glm::vec4 viewPosition;
+		LIGHT_UNIFORMS lights[LIGHT_COUNT];
+	};
+
+	// a draw collected for the threads that record the frame
+	struct DRAW
+	{
+		DRAW_UNIFORMS uniforms;
+		VkPipeline pipeline;
+		VkDescriptorSet textureSet;
+		SHAPE_MESH shape;
+	};
+
+	struct BUFFER
+	{
+		VkBuffer buffer;
+		VkDeviceMemory memory;
+		// address of host visible memory, or NULL
+		void* pMapped;
+	};
+
+	struct IMAGE
+	{
+		VkImage image;
+		VkDeviceMemory memory;
+		VkImageView view;
+	};
+
+	struct TEXTURE
+	{
+		IMAGE image;
+		VkDescriptorSet descriptorSet;
+	};
+
+	// the triangles of a shape in the shared mesh buffers
+	struct SHAPE
+	{
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		int32_t vertexOffset;
+	};
+
+	// everything that a frame in flight uses until its fence
+	struct FRAME
+	{
+		VkFence fence;
+		bool bSubmitted;
+		VkCommandPool commandPool;
+		VkCommandBuffer commandBuffer;
+		// a command pool and secondary command buffer for every
+		// group of draws, so the groups are recorded at the same time
+		std::vector<VkCommandPool> groupPools;
+		std::vector<VkCommandBuffer> groupBuffers;
+		BUFFER frameUniforms;
+		BUFFER drawUniforms;
+		VkDescriptorSet descriptorSet;
+		// images drawn into, and the buffer they are copied into
+		int width;
+		int height;
+		IMAGE color;
+		IMAGE depth;
+		VkFramebuffer framebuffer;
+		BUFFER readback;
+		// textures freed during the frame, which are destroyed once
+		// the frame is finished
+		std::vector<TEXTURE*> destroyedTextures;
+	};
+
+	VkInstance m_instance;
+	VkPhysicalDevice m_physicalDevice;
+	VkDevice m_device;
+	VkQueue m_queue;
+	uint32_t m_queueFamily;
+	VkPhysicalDeviceMemoryProperties m_memoryProperties;
+	VkDeviceSize m_drawUniformStride;
+
+	VkRenderPass m_renderPass;
+	VkDescriptorSetLayout m_frameSetLayout;
+	VkDescriptorSetLayout m_textureSetLayout;
+	VkPipelineLayout m_pipelineLayout;
+	VkShaderModule m_vertexShader;
+	VkShaderModule m_fragmentShader;
+	VkPipelineCache m_pipelineCache;
+	VkPipeline m_pipelines[PIPELINE_COUNT];
+	VkDescriptorPool m_descriptorPool;
+	VkSampler m_sampler;
+	VkCommandPool m_uploadPool;
+
+	// the shapes share a vertex and an index buffer
+	BUFFER m_vertexBuffer;
+	BUFFER m_indexBuffer;
+	SHAPE m_shapes[SHAPE_COUNT];
+
+	// textures by handle, the texture bound to every unit, and the
+	// white texture of the draws without one
+	std::vector<TEXTURE*> m_textures;
+	std::vector<uint32_t> m_boundTextures;
+	TEXTURE* m_pWhiteTexture;
+	// textures freed since the last frame, which its draws may use
+	std::vector<TEXTURE*> m_destroyedTextures;
+
+	FRAME m_frames[FRAMES_IN_FLIGHT];
+	// frames submitted so far, and the frame last copied out
+	uint64_t m_submittedFrames;
+	uint64_t m_presentedFrame;
+	int m_presentLatency;
+	int m_width;
+	int m_height;
+
+	// current uniforms and render state
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	DRAW_UNIFORMS m_uniforms;
+	FRAME_UNIFORMS m_frameUniforms;
+	bool m_bDepthTest;
+	bool m_bDepthWrite;
+	bool m_bColorWrite;
+	bool m_bBlend;
+	DEPTH_FUNCTION m_depthFunction;
+	int m_textureUnit;
+
+	// draws of the frame, and the frame they are recorded for
+	std::vector<DRAW> m_draws;
+	FRAME* m_pRecordFrame;
+	int m_groupCount;
+
+	// texture and framebuffer that the frames are copied through
+	GLuint m_presentTexture;
+	GLuint m_presentFramebuffer;
+	int m_presentWidth;
+	int m_presentHeight;
+
+	// worker threads that record the groups of draws
+	std::vector<std::thread> m_workers;
+	int m_threadCount;
+	std::atomic<int> m_nextGroup;
+	std::mutex m_mutex;
+	std::condition_variable m_startCondition;
+	std::condition_variable m_doneCondition;
+	uint64_t m_generation;
+	int m_busyWorkers;
+	bool m_bShutdown;
+
+	// totals of the finished frames
+	uint64_t m_frameCount;
+	uint64_t m_drawTotal;
+	double m_recordTimeTotal;
+	double m_waitTimeTotal;
+
+	// create the parts of the device that every frame uses
+	bool CreateDevice();
+	bool CreateRenderPass();
+	bool CreateLayouts();
+	bool CreateShapes();
+	bool CreateFrames();
+	VkShaderModule LoadShader(const char* filename);
+	// get the pipeline for the current render state
+	VkPipeline GetPipeline();
+
+	// create and free buffers and images in device memory
+	bool AllocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, VkDeviceMemory& memory);
+	bool CreateDeviceBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, BUFFER& buffer);
+	void DestroyDeviceBuffer(BUFFER& buffer);
+	bool CreateDeviceImage(int width, int height, uint32_t mipCount, VkFormat format, VkImageUsageFlags usage, VkImageAspectFlags aspect, IMAGE& image);
+	void DestroyDeviceImage(IMAGE& image);
+	// copy data into a device local buffer or image through a
+	// staging buffer, and wait for the copy
+	bool UploadBuffer(const void* pData, VkDeviceSize size, VkBufferUsageFlags usage, BUFFER& buffer);
+	bool UploadTexture(const unsigned char* pPixels, int width, int height, uint32_t mipCount, TEXTURE& texture);
+	VkCommandBuffer BeginUpload();
+	void EndUpload(VkCommandBuffer commandBuffer);
+	void FreeTexture(TEXTURE* pTexture);
+
+	// create the images of a frame for the framebuffer size
+	bool ResizeFrame(FRAME& frame);
+	void DestroyFrameTargets(FRAME& frame);
+	void DestroyFrame(FRAME& frame);
+	// wait for a frame to finish, and free what it was using
+	void WaitForFrame(FRAME& frame);
+
+	// set a light uniform from its name
+	bool SetLightValue(const char* name, const float* pValues, int valueCount);
+
+	// record the groups of draws taken from the shared counter
+	void RecordGroups();
+	void RecordGroup(int group);
+	// start and stop the worker threads
+	void StartWorkers();
+	void StopWorkers();
+	void WorkerLoop(uint64_t generation);
+};
+
+#endif